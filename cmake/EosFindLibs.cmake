@@ -78,6 +78,7 @@ if(NOT PACKAGEONLY)
   if (NOT CLIENT)
     find_package(eosfolly REQUIRED)
     find_package(davix)
+    find_package(uring)
     find_package(ldap REQUIRED)
     # @TODO (esindril): Completely drop cppunit once everything is moved to gtest
     find_package(CPPUnit REQUIRED)
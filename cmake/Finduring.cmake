@@ -0,0 +1,36 @@
+# - Locate liburing library
+# Defines:
+#
+#  URING_FOUND         -  system has liburing
+#  URING_INCLUDE_DIRS  -  liburing include directories
+#  URING_LIBRARIES     -  liburing libraries
+
+include(FindPackageHandleStandardArgs)
+
+if (URING_INCLUDE_DIRS AND URING_LIBRARIES)
+  set(URING_FIND_QUIETLY TRUE)
+else()
+  find_path(
+    URING_INCLUDE_DIR
+    NAMES liburing.h
+    HINTS
+    /usr ${URING_DIR} $ENV{URING_DIR}
+    PATH_SUFFIXES include)
+
+  find_library(
+    URING_LIBRARY
+    NAMES uring
+    HINTS
+    /usr ${URING_DIR} $ENV{URING_DIR}
+    PATH_SUFFIXES lib lib64)
+
+  set(URING_INCLUDE_DIRS ${URING_INCLUDE_DIR})
+  set(URING_LIBRARIES ${URING_LIBRARY})
+
+  find_package_handle_standard_args(
+    uring
+    DEFAULT_MSG
+    URING_LIBRARY URING_INCLUDE_DIR)
+
+  mark_as_advanced(URING_LIBRARY URING_INCLUDE_DIR)
+endif()
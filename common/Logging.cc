@@ -24,6 +24,8 @@
 #include "common/Namespace.hh"
 #include "common/Logging.hh"
 #include "XrdSys/XrdSysPthread.hh"
+#include <algorithm>
+#include <chrono>
 #include <new>
 #include <type_traits>
 
@@ -63,12 +65,137 @@ Logging::GetInstance()
   return gLogging;
 }
 
+//------------------------------------------------------------------------------
+//! Single producer/single consumer ring of formatted log messages. The owning
+//! thread fills the slots, the writer thread empties them. Slots keep their
+//! string capacity, so a warm ring does not allocate.
+//------------------------------------------------------------------------------
+class LogRing
+{
+public:
+  //! Slot string capacity kept after a message was written
+  static constexpr size_t kMaxSlotCapacity = 64 * 1024;
+
+  struct Record {
+    struct timeval tv;
+    int priority;
+    int uid;
+    int gid;
+    int lineno;
+    size_t body; ///< offset of the message body in line
+    std::string line;
+    std::string file;
+    std::string sourceline;
+    std::string func;
+    std::string name;
+  };
+
+  explicit LogRing(size_t size):
+    mDetached(false), mSlots(size), mHead(0), mTail(0) {}
+
+  //----------------------------------------------------------------------------
+  //! Producer: get the next free slot or nullptr if the ring is full
+  //----------------------------------------------------------------------------
+  Record*
+  Reserve()
+  {
+    uint64_t head = mHead.load(std::memory_order_relaxed);
+
+    if (head - mTail.load(std::memory_order_acquire) >= mSlots.size()) {
+      return nullptr;
+    }
+
+    return &mSlots[head % mSlots.size()];
+  }
+
+  //----------------------------------------------------------------------------
+  //! Producer: publish the slot returned by Reserve
+  //----------------------------------------------------------------------------
+  void
+  Commit()
+  {
+    mHead.store(mHead.load(std::memory_order_relaxed) + 1,
+                std::memory_order_release);
+  }
+
+  //----------------------------------------------------------------------------
+  //! Consumer: append all published records to batch
+  //!
+  //! @return number of records appended
+  //----------------------------------------------------------------------------
+  size_t
+  Peek(std::vector<Record*>& batch)
+  {
+    uint64_t tail = mTail.load(std::memory_order_relaxed);
+    uint64_t head = mHead.load(std::memory_order_acquire);
+
+    for (uint64_t i = tail; i < head; ++i) {
+      batch.push_back(&mSlots[i % mSlots.size()]);
+    }
+
+    return head - tail;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Consumer: release n records returned by Peek
+  //----------------------------------------------------------------------------
+  void
+  Pop(size_t n)
+  {
+    mTail.store(mTail.load(std::memory_order_relaxed) + n,
+                std::memory_order_release);
+  }
+
+  size_t
+  Pending() const
+  {
+    return mHead.load(std::memory_order_acquire) -
+           mTail.load(std::memory_order_acquire);
+  }
+
+  size_t
+  Size() const
+  {
+    return mSlots.size();
+  }
+
+  std::atomic<bool> mDetached; ///< owning thread exited
+
+private:
+  std::vector<Record> mSlots;
+  std::atomic<uint64_t> mHead;
+  std::atomic<uint64_t> mTail;
+};
+
+//------------------------------------------------------------------------------
+//! Thread local reference to the ring of a thread, flags the ring on thread
+//! exit so that the writer can release it once it is empty
+//------------------------------------------------------------------------------
+struct LogRingHolder {
+  std::shared_ptr<LogRing> ring;
+
+  ~LogRingHolder()
+  {
+    if (ring) {
+      ring->mDetached = true;
+    }
+  }
+};
+
+static thread_local LogRingHolder tLogRing;
+
+//! Set while the calling thread writes suppressed message summaries, which
+//! must not be rate limited themselves
+static thread_local bool tSuppressedSummary = false;
+
 //------------------------------------------------------------------------------
 // Constructor
 //------------------------------------------------------------------------------
 Logging::Logging():
   gLogMask(0), gPriorityLevel(0), gToSysLog(false),  gUnit("none"),
-  gShortFormat(0)
+  gShortFormat(0), mAsync(false), mWriterRunning(false), mWakeup(false),
+  mDroppedReported(0), mRateGeneration(1), mRateLimited(false), mSuppressed(0),
+  mSummaryRunning(false)
 {
   // Initialize the log array and sets the log circular size
   gLogCircularIndex.resize(LOG_DEBUG + 1);
@@ -78,6 +205,23 @@ Logging::Logging():
   for (int i = 0; i <= LOG_DEBUG; i++) {
     gLogCircularIndex[i] = 0;
     gLogMemory[i].resize(gCircularIndexSize);
+    mDropped[i] = 0;
+  }
+
+  for (size_t i = 0; i < kCallSites; ++i) {
+    mCallSites[i].key = 0;
+    mCallSites[i].generation = 0;
+    mCallSites[i].limited = false;
+    mCallSites[i].sample = false;
+    mCallSites[i].max = 0;
+    mCallSites[i].period = 0;
+    mCallSites[i].window = 0;
+    mCallSites[i].count = 0;
+    mCallSites[i].suppressed = 0;
+    mCallSites[i].func = nullptr;
+    mCallSites[i].srcfile = nullptr;
+    mCallSites[i].line = 0;
+    mCallSites[i].priority = 0;
   }
 
   gZeroVid.name = "-";
@@ -91,6 +235,27 @@ Logging::Logging():
       gToSysLog = true;
     }
   }
+
+  // the writer thread is started with the first message, not from the
+  // static initialization
+  if (getenv("EOS_LOG_ASYNC")) {
+    XrdOucString async = getenv("EOS_LOG_ASYNC");
+
+    if ((async == "1") || (async == "true")) {
+      mAsync = true;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Destructor
+//------------------------------------------------------------------------------
+Logging::~Logging()
+{
+  StopSummary();
+  StopWriter();
+  std::lock_guard<std::mutex> lock(mDrainMutex);
+  Drain();
 }
 
 //------------------------------------------------------------------------------
@@ -121,6 +286,18 @@ Logging::shouldlog(const char* func, int priority)
   return true;
 }
 
+//------------------------------------------------------------------------------
+// Append the number of suppressed messages of a call site to a message
+//------------------------------------------------------------------------------
+static void
+AppendSuppressed(char* ptr, size_t size, int len, uint64_t suppressed)
+{
+  if ((len >= 0) && ((size_t) len < size)) {
+    snprintf(ptr + len, size - len, " [%llu messages suppressed]",
+             (unsigned long long) suppressed);
+  }
+}
+
 //------------------------------------------------------------------------------
 // Logging function
 //------------------------------------------------------------------------------
@@ -152,30 +329,11 @@ Logging::log(const char* func, const char* file, int line, const char* logid,
     }
   }
 
-  static char* buffer = 0;
-
-  if (!buffer) {
-    // 1 M print buffer
-    buffer = (char*) malloc(logmsgbuffersize);
-  }
-
   XrdOucString File = file;
   // we show only one hierarchy directory like Acl (assuming that we have only
   // file names like *.cc and *.hh
   File.erase(0, File.rfind("/") + 1);
   File.erase(File.length() - 3);
-  static time_t current_time;
-  static struct timeval tv;
-  static struct timezone tz;
-  struct tm tm;
-  XrdSysMutexHelper scope_lock(gMutex);
-  va_list args;
-  va_start(args, msg);
-  gettimeofday(&tv, &tz);
-  current_time = tv.tv_sec;
-  static char linen[16];
-  sprintf(linen, "%d", line);
-  static char fcident[1024];
   XrdOucString truncname = vid.name;
 
   // we show only the last 16 bytes of the name
@@ -184,113 +342,763 @@ Logging::log(const char* func, const char* file, int line, const char* logid,
     truncname.erase(0, truncname.length() - 16);
   }
 
+  // drop rate limited messages before formatting them
+  uint64_t suppressed = 0;
+
+  if (!silent && mRateLimited && !tSuppressedSummary &&
+      !CallSitePass(func, File.c_str(), file, line, priority, suppressed)) {
+    return "";
+  }
+
   char sourceline[64];
+  snprintf(sourceline, sizeof(sourceline) - 1, "%s:%d", File.c_str(), line);
+  va_list args;
+  va_start(args, msg);
+
+  if (mAsync) {
+    const char* rptr = LogAsync(func, File.c_str(), line, sourceline,
+                                truncname.c_str(), logid, vid, cident,
+                                priority, suppressed, msg, args);
+    va_end(args);
+    return rptr;
+  }
+
+  static char* buffer = 0;
+
+  if (!buffer) {
+    // 1 M print buffer
+    buffer = (char*) malloc(logmsgbuffersize);
+  }
+
+  static struct timeval tv;
+  static struct timezone tz;
+  XrdSysMutexHelper scope_lock(gMutex);
+  gettimeofday(&tv, &tz);
+  char* ptr = buffer + FormatHeader(buffer, logmsgbuffersize, tv, func,
+                                    sourceline, logid, vid, cident,
+                                    truncname.c_str(), priority);
+  // limit the length of the output to buffer-1 length
+  int len = vsnprintf(ptr, logmsgbuffersize - (ptr - buffer + 1), msg, args);
+  va_end(args);
+
+  if (suppressed) {
+    AppendSuppressed(ptr, logmsgbuffersize - (ptr - buffer + 1), len,
+                     suppressed);
+  }
+
+  if (!silent && rate_limit(tv, priority, file, line)) {
+    return "";
+  }
+
+  if (!silent) {
+    WriteOut(buffer, ptr, priority, File.c_str(), sourceline, func, vid.uid,
+             vid.gid, truncname.c_str(), true);
+  }
+
+  return StoreMemory(priority, buffer);
+}
+
+//------------------------------------------------------------------------------
+// Set the call site rate limits
+//------------------------------------------------------------------------------
+size_t
+Logging::SetRateLimits(const std::vector<std::string>& rules)
+{
+  auto parsed = std::make_shared<std::vector<LogRateRule>>();
+
+  for (const auto& rule : rules) {
+    // rate:<unit>:<max>/<seconds> or sample:<unit>:<n>
+    LogRateRule r;
+    size_t pos1 = rule.find(':');
+    size_t pos2 = rule.rfind(':');
+
+    if ((pos1 == std::string::npos) || (pos2 == pos1)) {
+      continue;
+    }
+
+    std::string type = rule.substr(0, pos1);
+    std::string limit = rule.substr(pos2 + 1);
+    r.unit = rule.substr(pos1 + 1, pos2 - pos1 - 1);
+    r.sample = (type == "sample");
+    r.period = 0;
+    char* end = 0;
+    r.max = strtoul(limit.c_str(), &end, 10);
+
+    if (!r.sample) {
+      if (!end || (*end != '/')) {
+        continue;
+      }
+
+      r.period = strtoul(end + 1, &end, 10);
+    }
+
+    if (r.unit.empty() || !end || *end || (r.sample && !r.max) ||
+        (!r.sample && !r.period)) {
+      continue;
+    }
+
+    parsed->push_back(r);
+  }
+
+  std::atomic_store(&mRateRules,
+                    std::shared_ptr<const std::vector<LogRateRule>>(parsed));
+  mRateGeneration++;
+  mRateLimited = !parsed->empty();
+
+  if (mRateLimited) {
+    StartSummary();
+  }
+
+  return parsed->size();
+}
+
+//------------------------------------------------------------------------------
+// Log the summaries of the suppressed messages
+//------------------------------------------------------------------------------
+size_t
+Logging::FlushSuppressed()
+{
+  size_t nsites = 0;
+  tSuppressedSummary = true;
+
+  for (size_t i = 0; i < kCallSites; ++i) {
+    LogCallSite& site = mCallSites[i];
+
+    if (!site.key || !site.suppressed) {
+      continue;
+    }
+
+    const char* func = site.func;
+    const char* srcfile = site.srcfile;
+    uint64_t suppressed = site.suppressed.exchange(0);
+
+    if (!suppressed || !func || !srcfile) {
+      continue;
+    }
+
+    log(func, srcfile, site.line, "static..............................",
+        gZeroVid, "", site.priority,
+        "msg=\"rate limited call site\" [%llu messages suppressed]",
+        (unsigned long long) suppressed);
+    ++nsites;
+  }
+
+  tSuppressedSummary = false;
+  return nsites;
+}
+
+//------------------------------------------------------------------------------
+// Start the suppressed message summary thread
+//------------------------------------------------------------------------------
+void
+Logging::StartSummary()
+{
+  std::lock_guard<std::mutex> lock(mSummaryMutex);
+
+  if (mSummaryRunning) {
+    return;
+  }
+
+  mSummaryRunning = true;
+  mSummaryThread = std::thread([this]() {
+    std::unique_lock<std::mutex> lock(mSummaryMutex);
+
+    while (mSummaryRunning) {
+      mSummaryCv.wait_for(lock, std::chrono::seconds(kSuppressedInterval),
+      [this] {
+        return !mSummaryRunning;
+      });
+
+      if (mSummaryRunning) {
+        lock.unlock();
+        FlushSuppressed();
+        lock.lock();
+      }
+    }
+  });
+}
+
+//------------------------------------------------------------------------------
+// Stop the suppressed message summary thread
+//------------------------------------------------------------------------------
+void
+Logging::StopSummary()
+{
+  std::thread summary;
+  {
+    std::lock_guard<std::mutex> lock(mSummaryMutex);
+    mSummaryRunning = false;
+    std::swap(summary, mSummaryThread);
+  }
+  mSummaryCv.notify_one();
+
+  if (summary.joinable()) {
+    summary.join();
+  }
+}
+
+//------------------------------------------------------------------------------
+// Count a suppressed message of a call site and remember where it comes from
+// for the periodic summary
+//------------------------------------------------------------------------------
+static void
+SuppressAt(LogCallSite& site, const char* func, const char* srcfile, int line,
+           int priority)
+{
+  // __FUNCTION__ and __FILE__ are literals, keeping the pointers is safe
+  site.func.store(func, std::memory_order_relaxed);
+  site.srcfile.store(srcfile, std::memory_order_relaxed);
+  site.line.store(line, std::memory_order_relaxed);
+  site.priority.store(priority, std::memory_order_relaxed);
+  site.suppressed++;
+}
+
+//------------------------------------------------------------------------------
+// Apply the rate limit of a call site
+//------------------------------------------------------------------------------
+bool
+Logging::CallSitePass(const char* func, const char* file, const char* srcfile,
+                      int line, int priority, uint64_t& suppressed)
+{
+  // __FILE__ is a literal, its address identifies the source file
+  uint64_t key = (((uint64_t)(uintptr_t) srcfile) * 0x9e3779b97f4a7c15ULL) ^
+                 (uint64_t) line;
+  key |= 1;
+  size_t slot = (key >> 20) % kCallSites;
+  LogCallSite* site = nullptr;
+
+  for (size_t probe = 0; probe < 8; ++probe) {
+    LogCallSite& s = mCallSites[(slot + probe) % kCallSites];
+    uint64_t expected = s.key.load(std::memory_order_acquire);
+
+    if (expected == key) {
+      site = &s;
+      break;
+    }
+
+    if (!expected && s.key.compare_exchange_strong(expected, key)) {
+      site = &s;
+      break;
+    }
+
+    if (expected == key) {
+      site = &s;
+      break;
+    }
+  }
+
+  if (!site) {
+    // table crowded, don't limit
+    return true;
+  }
+
+  uint64_t generation = mRateGeneration;
+
+  if (site->generation != generation) {
+    // resolve the rule for this call site, functions win over files
+    auto rules = std::atomic_load(&mRateRules);
+    const LogRateRule* match = nullptr;
+
+    for (int pass = 0; rules && !match && (pass < 3); ++pass) {
+      for (const auto& rule : *rules) {
+        if (((pass == 0) && (rule.unit == func)) ||
+            ((pass == 1) && (rule.unit == file)) ||
+            ((pass == 2) && (rule.unit == "*"))) {
+          match = &rule;
+          break;
+        }
+      }
+    }
+
+    site->limited = (match != nullptr);
+
+    if (match) {
+      site->sample = match->sample;
+      site->max = match->max;
+      site->period = match->period;
+    }
+
+    site->count = 0;
+    site->window = 0;
+    site->generation = generation;
+  }
+
+  if (!site->limited) {
+    return true;
+  }
+
+  uint64_t n = 0;
+
+  if (site->sample) {
+    n = site->count++;
+
+    if (n % site->max) {
+      SuppressAt(*site, func, srcfile, line, priority);
+      mSuppressed++;
+      return false;
+    }
+  } else {
+    uint64_t now = time(0);
+    uint64_t window = site->window;
+
+    if ((now >= (window + site->period)) &&
+        site->window.compare_exchange_strong(window, now)) {
+      site->count = 0;
+    }
+
+    n = site->count++;
+
+    if (n >= site->max) {
+      SuppressAt(*site, func, srcfile, line, priority);
+      mSuppressed++;
+      return false;
+    }
+  }
+
+  suppressed = site->suppressed.exchange(0);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Format the message header
+//------------------------------------------------------------------------------
+size_t
+Logging::FormatHeader(char* buffer, size_t size, const struct timeval& tv,
+                      const char* func, const char* sourceline,
+                      const char* logid, const Mapping::VirtualIdentity& vid,
+                      const char* cident, const char* truncname, int priority)
+{
+  struct tm tm;
+  time_t current_time = tv.tv_sec;
+  localtime_r(&current_time, &tm);
+  int len = 0;
 
   if (gShortFormat) {
-    localtime_r(&current_time, &tm);
-    snprintf(sourceline, sizeof(sourceline) - 1, "%s:%s", File.c_str(), linen);
     XrdOucString slog = logid;
 
     if (slog.beginswith("logid:")) {
       slog.erase(0, 6);
-      sprintf(buffer,
-              "%02d%02d%02d %02d:%02d:%02d t=%lu.%06lu f=%-16s l=%s %s s=%-24s ",
-              tm.tm_year - 100, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour,
-              tm.tm_min, tm.tm_sec, current_time, (unsigned long) tv.tv_usec,
-              func, GetPriorityString(priority), slog.c_str(), sourceline);
+      len = snprintf(buffer, size,
+                     "%02d%02d%02d %02d:%02d:%02d t=%lu.%06lu f=%-16s l=%s %s s=%-24s ",
+                     tm.tm_year - 100, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour,
+                     tm.tm_min, tm.tm_sec, current_time, (unsigned long) tv.tv_usec,
+                     func, GetPriorityString(priority), slog.c_str(), sourceline);
     } else {
-      sprintf(buffer,
-              "%02d%02d%02d %02d:%02d:%02d t=%lu.%06lu f=%-16s l=%s tid=%016lx s=%-24s ",
-              tm.tm_year - 100, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour,
-              tm.tm_min, tm.tm_sec, current_time, (unsigned long) tv.tv_usec,
-              func, GetPriorityString(priority), (unsigned long) XrdSysThread::ID(),
-              sourceline);
+      len = snprintf(buffer, size,
+                     "%02d%02d%02d %02d:%02d:%02d t=%lu.%06lu f=%-16s l=%s tid=%016lx s=%-24s ",
+                     tm.tm_year - 100, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour,
+                     tm.tm_min, tm.tm_sec, current_time, (unsigned long) tv.tv_usec,
+                     func, GetPriorityString(priority), (unsigned long) XrdSysThread::ID(),
+                     sourceline);
     }
   } else {
-    sprintf(fcident, "tident=%s sec=%-5s uid=%d gid=%d name=%s geo=\"%s\"", cident,
-            vid.prot.c_str(), vid.uid, vid.gid, truncname.c_str(), vid.geolocation.c_str());
-    localtime_r(&current_time, &tm);
-    snprintf(sourceline, sizeof(sourceline) - 1, "%s:%s", File.c_str(), linen);
-    sprintf(buffer,
-            "%02d%02d%02d %02d:%02d:%02d time=%lu.%06lu func=%-24s level=%s logid=%s unit=%s tid=%016lx source=%-30s %s ",
-            tm.tm_year - 100, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min,
-            tm.tm_sec, current_time, (unsigned long) tv.tv_usec, func,
-            GetPriorityString(priority), logid, gUnit.c_str(),
-            (unsigned long) XrdSysThread::ID(), sourceline, fcident);
-  }
-
-  char* ptr = buffer + strlen(buffer);
-  // limit the length of the output to buffer-1 length
-  vsnprintf(ptr, logmsgbuffersize - (ptr - buffer + 1), msg, args);
+    char fcident[1024];
+    snprintf(fcident, sizeof(fcident),
+             "tident=%s sec=%-5s uid=%d gid=%d name=%s geo=\"%s\"", cident,
+             vid.prot.c_str(), vid.uid, vid.gid, truncname, vid.geolocation.c_str());
+    len = snprintf(buffer, size,
+                   "%02d%02d%02d %02d:%02d:%02d time=%lu.%06lu func=%-24s level=%s logid=%s unit=%s tid=%016lx source=%-30s %s ",
+                   tm.tm_year - 100, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min,
+                   tm.tm_sec, current_time, (unsigned long) tv.tv_usec, func,
+                   GetPriorityString(priority), logid, gUnit.c_str(),
+                   (unsigned long) XrdSysThread::ID(), sourceline, fcident);
+  }
 
-  if (!silent && rate_limit(tv, priority, file, line)) {
-    return "";
+  if (len < 0) {
+    buffer[0] = 0;
+    return 0;
   }
 
-  if (!silent && gToSysLog) {
+  return ((size_t) len < size) ? len : (size - 1);
+}
+
+//------------------------------------------------------------------------------
+// Write a message to syslog, the fan-out files and stderr
+//------------------------------------------------------------------------------
+void
+Logging::WriteOut(char* buffer, const char* ptr, int priority, const char* file,
+                  const char* sourceline, const char* func, int uid, int gid,
+                  const char* truncname, bool flush)
+{
+  if (gToSysLog) {
     syslog(priority, "%s", ptr);
   }
 
-  if (!silent) {
-    if (gLogFanOut.size()) {
-      // we do log-message fanout
-      if (gLogFanOut.count("*")) {
-        fprintf(gLogFanOut["*"], "%s\n", buffer);
+  if (gLogFanOut.size()) {
+    // we do log-message fanout
+    if (gLogFanOut.count("*")) {
+      fprintf(gLogFanOut["*"], "%s\n", buffer);
+
+      if (flush) {
         fflush(gLogFanOut["*"]);
       }
+    }
+
+    if (gLogFanOut.count(file)) {
+      buffer[15] = 0;
+      fprintf(gLogFanOut[file], "%s %s%s%s %-30s %s \n",
+              buffer,
+              GetLogColour(GetPriorityString(priority)),
+              GetPriorityString(priority),
+              EOS_TEXTNORMAL,
+              sourceline,
+              ptr);
+
+      if (flush) {
+        fflush(gLogFanOut[file]);
+      }
 
-      if (gLogFanOut.count(File.c_str())) {
+      buffer[15] = ' ';
+    } else {
+      if (gLogFanOut.count("#")) {
         buffer[15] = 0;
-        fprintf(gLogFanOut[File.c_str()], "%s %s%s%s %-30s %s \n",
+        fprintf(gLogFanOut["#"], "%s %s%s%s [%05d/%05d] %16s ::%-16s %s \n",
                 buffer,
                 GetLogColour(GetPriorityString(priority)),
                 GetPriorityString(priority),
                 EOS_TEXTNORMAL,
-                sourceline,
-                ptr);
-        fflush(gLogFanOut[File.c_str()]);
-        buffer[15] = ' ';
-      } else {
-        if (gLogFanOut.count("#")) {
-          buffer[15] = 0;
-          fprintf(gLogFanOut["#"], "%s %s%s%s [%05d/%05d] %16s ::%-16s %s \n",
-                  buffer,
-                  GetLogColour(GetPriorityString(priority)),
-                  GetPriorityString(priority),
-                  EOS_TEXTNORMAL,
-                  vid.uid,
-                  vid.gid,
-                  truncname.c_str(),
-                  func,
-                  ptr
-                 );
+                uid,
+                gid,
+                truncname,
+                func,
+                ptr
+               );
+
+        if (flush) {
           fflush(gLogFanOut["#"]);
-          buffer[15] = ' ';
         }
-      }
 
-      fprintf(stderr, "%s\n", buffer);
-      fflush(stderr);
-    } else {
-      fprintf(stderr, "%s\n", buffer);
-      fflush(stderr);
+        buffer[15] = ' ';
+      }
     }
   }
 
-  va_end(args);
-  const char* rptr;
+  if (flush) {
+    fprintf(stderr, "%s\n", buffer);
+    fflush(stderr);
+  } else {
+    // stderr is unbuffered, collect the batch to write it at once
+    mStderrBatch.append(buffer);
+    mStderrBatch.append("\n");
+  }
+}
 
-  if (silent) {
+//------------------------------------------------------------------------------
+// Store a message in the in-memory log
+//------------------------------------------------------------------------------
+const char*
+Logging::StoreMemory(int priority, const char* buffer)
+{
+  if (priority == LOG_SILENT) {
     priority = LOG_DEBUG;
   }
 
-  // store into global log memory
-  gLogMemory[priority][(gLogCircularIndex[priority]) % gCircularIndexSize] =
-    buffer;
-  rptr = gLogMemory[priority][(gLogCircularIndex[priority]) %
-                              gCircularIndexSize].c_str();
+  XrdOucString& entry =
+    gLogMemory[priority][(gLogCircularIndex[priority]) % gCircularIndexSize];
+  entry = buffer;
   gLogCircularIndex[priority]++;
-  return rptr;
+  return entry.c_str();
+}
+
+//------------------------------------------------------------------------------
+// Queue a message in the ring of the calling thread
+//------------------------------------------------------------------------------
+const char*
+Logging::LogAsync(const char* func, const char* file, int line,
+                  const char* sourceline, const char* truncname,
+                  const char* logid, const Mapping::VirtualIdentity& vid,
+                  const char* cident, int priority, uint64_t suppressed,
+                  const char* msg, va_list args)
+{
+  static const size_t logmsgbuffersize = 1024 * 1024;
+  // the returned message stays valid until the next message of this thread
+  static thread_local std::unique_ptr<char[]> buffer;
+
+  if (!buffer) {
+    buffer.reset(new char[logmsgbuffersize]);
+  }
+
+  struct timeval tv;
+  gettimeofday(&tv, 0);
+  char* ptr = buffer.get() + FormatHeader(buffer.get(), logmsgbuffersize, tv,
+                                          func, sourceline, logid, vid, cident,
+                                          truncname, priority);
+  size_t msgsize = logmsgbuffersize - (ptr - buffer.get() + 1);
+  int len = vsnprintf(ptr, msgsize, msg, args);
+
+  if (len < 0) {
+    *ptr = 0;
+  } else if (suppressed) {
+    AppendSuppressed(ptr, msgsize, len, suppressed);
+  }
+
+  // a writer that cannot be started means SetAsync(false) raced with this
+  // message, it is then written by the Flush below
+  bool writer = (mWriterRunning || StartWriter());
+  LogRing* ring = GetThreadRing();
+  LogRing::Record* rec = ring->Reserve();
+
+  if (!rec && (priority <= LOG_ERR)) {
+    // errors wait up to 10ms for the writer before they are dropped
+    WakeWriter();
+
+    for (int i = 0; !rec && (i < 100); ++i) {
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+      rec = ring->Reserve();
+    }
+  }
+
+  if (!rec) {
+    mDropped[(priority == LOG_SILENT) ? LOG_DEBUG : priority]++;
+    return buffer.get();
+  }
+
+  rec->tv = tv;
+  rec->priority = priority;
+  rec->uid = vid.uid;
+  rec->gid = vid.gid;
+  rec->lineno = line;
+  rec->body = ptr - buffer.get();
+  rec->line.assign(buffer.get());
+  rec->file.assign(file);
+  rec->sourceline.assign(sourceline);
+  rec->func.assign(func);
+  rec->name.assign(truncname);
+  ring->Commit();
+  // pairs with the fence in SetAsync: either SetAsync's Flush sees this record
+  // or this thread sees the asynchronous mode disabled and flushes it itself
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  if (!writer || !mAsync) {
+    Flush();
+    return buffer.get();
+  }
+
+  // notifying without holding the mutex can lose a wake up, the writer
+  // polls anyway
+  if (ring->Pending() > (ring->Size() / 2)) {
+    WakeWriter();
+  }
+
+  return buffer.get();
+}
+
+//------------------------------------------------------------------------------
+// Get the ring of the calling thread
+//------------------------------------------------------------------------------
+LogRing*
+Logging::GetThreadRing()
+{
+  if (!tLogRing.ring) {
+    tLogRing.ring = std::make_shared<LogRing>(EOSCOMMONLOGGING_ASYNCRINGSIZE);
+    std::lock_guard<std::mutex> lock(mRingsMutex);
+    mRings.push_back(tLogRing.ring);
+  }
+
+  return tLogRing.ring.get();
+}
+
+//------------------------------------------------------------------------------
+// Enable or disable asynchronous logging
+//------------------------------------------------------------------------------
+void
+Logging::SetAsync(bool onoff)
+{
+  {
+    // producers recheck the mode under this mutex before starting the writer
+    std::lock_guard<std::mutex> lock(mWriterMutex);
+    mAsync = onoff;
+  }
+
+  if (!onoff) {
+    StopWriter();
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    Flush();
+  }
+}
+
+//------------------------------------------------------------------------------
+// Write all pending messages
+//------------------------------------------------------------------------------
+void
+Logging::Flush()
+{
+  std::lock_guard<std::mutex> lock(mDrainMutex);
+  Drain();
+}
+
+//------------------------------------------------------------------------------
+// Get the number of dropped messages
+//------------------------------------------------------------------------------
+unsigned long long
+Logging::GetDropped(int priority) const
+{
+  if ((priority >= 0) && (priority <= LOG_DEBUG)) {
+    return mDropped[priority];
+  }
+
+  unsigned long long total = 0;
+
+  for (int i = 0; i <= LOG_DEBUG; ++i) {
+    total += mDropped[i];
+  }
+
+  return total;
+}
+
+//------------------------------------------------------------------------------
+// Start the writer thread
+//------------------------------------------------------------------------------
+bool
+Logging::StartWriter()
+{
+  std::lock_guard<std::mutex> lock(mWriterMutex);
+
+  if (mWriterRunning) {
+    return true;
+  }
+
+  if (!mAsync) {
+    return false;
+  }
+
+  mWriterRunning = true;
+  mWriterThread = std::thread(&Logging::Writer, this);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Stop the writer thread
+//------------------------------------------------------------------------------
+void
+Logging::StopWriter()
+{
+  std::thread writer;
+  {
+    std::lock_guard<std::mutex> lock(mWriterMutex);
+
+    if (!mWriterRunning) {
+      return;
+    }
+
+    mWriterRunning = false;
+    std::swap(writer, mWriterThread);
+  }
+  mWriterCv.notify_one();
+
+  if (writer.joinable()) {
+    writer.join();
+  }
+}
+
+//------------------------------------------------------------------------------
+// Wake up the writer thread
+//------------------------------------------------------------------------------
+void
+Logging::WakeWriter()
+{
+  mWakeup = true;
+  mWriterCv.notify_one();
+}
+
+//------------------------------------------------------------------------------
+// Writer thread loop
+//------------------------------------------------------------------------------
+void
+Logging::Writer()
+{
+  while (mWriterRunning) {
+    {
+      std::unique_lock<std::mutex> lock(mWriterMutex);
+      mWriterCv.wait_for(lock, std::chrono::milliseconds(10), [this] {
+        return mWakeup || !mWriterRunning;
+      });
+      mWakeup = false;
+    }
+    std::lock_guard<std::mutex> lock(mDrainMutex);
+    Drain();
+  }
+}
+
+//------------------------------------------------------------------------------
+// Write one batch of all pending messages
+//------------------------------------------------------------------------------
+void
+Logging::Drain()
+{
+  std::vector<std::shared_ptr<LogRing>> rings;
+  {
+    std::lock_guard<std::mutex> lock(mRingsMutex);
+    rings = mRings;
+  }
+  std::vector<LogRing::Record*> batch;
+  std::vector<size_t> counts(rings.size());
+
+  for (size_t i = 0; i < rings.size(); ++i) {
+    counts[i] = rings[i]->Peek(batch);
+  }
+
+  // keep the output in time order across threads
+  std::stable_sort(batch.begin(), batch.end(),
+  [](const LogRing::Record * a, const LogRing::Record * b) {
+    return timercmp(&a->tv, &b->tv, <);
+  });
+  unsigned long long dropped = GetDropped();
+
+  if (batch.size() || (dropped != mDroppedReported)) {
+    XrdSysMutexHelper scope_lock(gMutex);
+
+    if (dropped != mDroppedReported) {
+      fprintf(stderr,
+              "                 ---- %llu log messages dropped by the async logger ----\n",
+              dropped - mDroppedReported);
+      mDroppedReported = dropped;
+    }
+
+    for (auto rec : batch) {
+      bool silent = (rec->priority == LOG_SILENT);
+
+      if (!silent && rate_limit(rec->tv, rec->priority, rec->file.c_str(),
+                                rec->lineno)) {
+        continue;
+      }
+
+      if (!silent) {
+        char* buffer = &rec->line[0];
+        WriteOut(buffer, buffer + rec->body, rec->priority, rec->file.c_str(),
+                 rec->sourceline.c_str(), rec->func.c_str(), rec->uid, rec->gid,
+                 rec->name.c_str(), false);
+      }
+
+      StoreMemory(rec->priority, rec->line.c_str());
+
+      // don't let a single huge message pin its memory in the slot
+      if (rec->line.capacity() > LogRing::kMaxSlotCapacity) {
+        std::string().swap(rec->line);
+      }
+    }
+
+    for (auto& it : gLogFanOut) {
+      fflush(it.second);
+    }
+
+    if (mStderrBatch.size()) {
+      fwrite(mStderrBatch.data(), 1, mStderrBatch.size(), stderr);
+      fflush(stderr);
+      mStderrBatch.clear();
+    }
+  }
+
+  for (size_t i = 0; i < rings.size(); ++i) {
+    rings[i]->Pop(counts[i]);
+  }
+
+  // release the rings of exited threads once they are empty
+  std::lock_guard<std::mutex> lock(mRingsMutex);
+  mRings.erase(std::remove_if(mRings.begin(), mRings.end(),
+  [](const std::shared_ptr<LogRing>& ring) {
+    return ring->mDetached && !ring->Pending();
+  }), mRings.end());
 }
 
 bool
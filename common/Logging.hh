@@ -41,6 +41,11 @@
  * all messages which are not in any other fan-out (besides '*') into that file.
  * The fan-out functionality assumes that
  * source filenames follow the pattern <fan-out-name>.xx !!!!
+ * With 'SetAsync' (or EOS_LOG_ASYNC=1 in the environment) messages are
+ * formatted by the calling thread into a thread local ring buffer and written
+ * in batches by a dedicated writer thread. When a ring is full, messages of
+ * priority warning and below are dropped and counted, errors wait a short
+ * time for the writer before being dropped.
  */
 
 #ifndef __EOSCOMMON_LOGGING_HH__
@@ -52,11 +57,18 @@
 #include "XrdSys/XrdSysPthread.hh"
 #include "XrdSys/XrdSysLogger.hh"
 #include "XrdSec/XrdSecEntity.hh"
+#include <stdarg.h>
 #include <string.h>
 #include <sys/syslog.h>
 #include <sys/time.h>
+#include <stdint.h>
 #include <uuid/uuid.h>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 #include <sstream>
 
@@ -204,6 +216,7 @@ EOSCOMMONNAMESPACE_BEGIN
 #define EOS_LOGS_SILENT   eos::common::Logging::GetInstance().shouldlog(__FUNCTION__,(LOG_SILENT)  )
 
 #define EOSCOMMONLOGGING_CIRCULARINDEXSIZE 10000
+#define EOSCOMMONLOGGING_ASYNCRINGSIZE 256
 
 //------------------------------------------------------------------------------
 //! Class implementing EOS logging
@@ -320,6 +333,37 @@ public:
   Mapping::VirtualIdentity vid; //< the client identity
 };
 
+class LogRing;
+
+//------------------------------------------------------------------------------
+//! Rate limit applied to the call sites of a function or source file
+//------------------------------------------------------------------------------
+struct LogRateRule {
+  std::string unit; ///< function name, source file name or '*'
+  bool sample; ///< let one out of max messages pass
+  unsigned long max; ///< messages per period or sampling interval
+  unsigned long period; ///< period in seconds
+};
+
+//------------------------------------------------------------------------------
+//! Rate limiting state of one call site, identified by its file and line
+//------------------------------------------------------------------------------
+struct LogCallSite {
+  std::atomic<uint64_t> key; ///< hash of file and line, 0 if unused
+  std::atomic<uint64_t> generation; ///< rules generation of the limits below
+  std::atomic<bool> limited; ///< a rule applies to this site
+  std::atomic<bool> sample; ///< sampling instead of rate limit
+  std::atomic<unsigned long> max; ///< see LogRateRule
+  std::atomic<unsigned long> period; ///< see LogRateRule
+  std::atomic<uint64_t> window; ///< start of the current period
+  std::atomic<uint64_t> count; ///< messages in the current period
+  std::atomic<uint64_t> suppressed; ///< suppressed since the last message
+  std::atomic<const char*> func; ///< function of the last suppressed message
+  std::atomic<const char*> srcfile; ///< __FILE__ of the call site
+  std::atomic<int> line; ///< line of the call site
+  std::atomic<int> priority; ///< priority of the last suppressed message
+};
+
 //------------------------------------------------------------------------------
 //! Class wrapping global singleton objects for logging
 //------------------------------------------------------------------------------
@@ -360,7 +404,7 @@ public:
   //----------------------------------------------------------------------------
   //! Destructor
   //----------------------------------------------------------------------------
-  ~Logging() = default;
+  ~Logging();
 
   //----------------------------------------------------------------------------
   //! Get current loglevel
@@ -396,8 +440,38 @@ public:
     gToSysLog = onoff;
   }
 
+  //----------------------------------------------------------------------------
+  //! Enable or disable asynchronous logging. Disabling stops the writer
+  //! thread and writes all pending messages.
+  //----------------------------------------------------------------------------
+  void SetAsync(bool onoff);
+
+  bool
+  IsAsync() const
+  {
+    return mAsync;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Write all messages pending in the asynchronous rings
+  //----------------------------------------------------------------------------
+  void Flush();
+
+  //----------------------------------------------------------------------------
+  //! Get the number of messages dropped in asynchronous mode
+  //!
+  //! @param priority priority level or -1 for all levels
+  //----------------------------------------------------------------------------
+  unsigned long long GetDropped(int priority = -1) const;
+
   //----------------------------------------------------------------------------
   //! Set the log filter
+  //!
+  //! Entries 'rate:<unit>:<max>/<seconds>' allow at most <max> messages per
+  //! call site and period, entries 'sample:<unit>:<n>' let one out of <n>
+  //! messages of a call site pass. <unit> is a function name, a source file
+  //! name as used for the fan-out or '*' for all call sites. All other entries
+  //! are function names to deny or, if prefixed by 'PASS:', to allow.
   //----------------------------------------------------------------------------
   void
   SetFilter(const char* filter)
@@ -406,7 +480,24 @@ public:
     char del = ',';
     XrdOucString token;
     XrdOucString pass_tag = "PASS:";
-    XrdOucString sfilter = filter;
+    XrdOucString input = filter;
+    XrdOucString sfilter;
+    std::vector<std::string> rate_rules;
+
+    // Extract the call site rate limits
+    while ((pos = input.tokenize(token, pos, del)) != -1) {
+      if (token.beginswith("rate:") || token.beginswith("sample:")) {
+        rate_rules.push_back(token.c_str());
+      } else if (token.length()) {
+        if (sfilter.length()) {
+          sfilter += del;
+        }
+
+        sfilter += token;
+      }
+    }
+
+    SetRateLimits(rate_rules);
     // Clear both maps
     gDenyFilter.Purge();
     gAllowFilter.Purge();
@@ -430,6 +521,34 @@ public:
     }
   }
 
+  //----------------------------------------------------------------------------
+  //! Set the call site rate limits
+  //!
+  //! @param rules list of 'rate:<unit>:<max>/<seconds>' and
+  //!        'sample:<unit>:<n>' entries, an empty list disables rate limiting
+  //!
+  //! @return number of valid rules
+  //----------------------------------------------------------------------------
+  size_t SetRateLimits(const std::vector<std::string>& rules);
+
+  //----------------------------------------------------------------------------
+  //! Get the number of messages suppressed by the call site rate limits
+  //----------------------------------------------------------------------------
+  unsigned long long
+  GetSuppressed() const
+  {
+    return mSuppressed;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Log a summary line for every call site which suppressed messages since
+  //! its last message and reset the counts. Called every
+  //! kSuppressedInterval seconds once rate limits are set.
+  //!
+  //! @return number of call sites reported
+  //----------------------------------------------------------------------------
+  size_t FlushSuppressed();
+
   //----------------------------------------------------------------------------
   //! Return priority as string
   //----------------------------------------------------------------------------
@@ -621,6 +740,135 @@ public:
   //---------------------------------------------------------------------------
 
   bool rate_limit(struct timeval& tv, int priority, const char* file, int line);
+
+private:
+  //! Number of call sites tracked by the rate limits
+  static constexpr size_t kCallSites = 4096;
+  //! Interval in seconds of the suppressed message summaries
+  static constexpr int kSuppressedInterval = 60;
+
+  //----------------------------------------------------------------------------
+  //! Apply the rate limit of a call site
+  //!
+  //! @param func name of the calling function
+  //! @param file short name of the source file
+  //! @param srcfile source file as given by __FILE__
+  //! @param line line in the source file
+  //! @param priority priority of the message
+  //! @param suppressed number of messages of this call site suppressed since
+  //!        the last message which passed
+  //!
+  //! @return true if the message should be logged, otherwise false
+  //----------------------------------------------------------------------------
+  bool CallSitePass(const char* func, const char* file, const char* srcfile,
+                    int line, int priority, uint64_t& suppressed);
+
+  //----------------------------------------------------------------------------
+  //! Start the thread writing the suppressed message summaries if not
+  //! running yet
+  //----------------------------------------------------------------------------
+  void StartSummary();
+
+  //----------------------------------------------------------------------------
+  //! Stop the suppressed message summary thread
+  //----------------------------------------------------------------------------
+  void StopSummary();
+
+  //----------------------------------------------------------------------------
+  //! Format the message header into buffer
+  //!
+  //! @return length of the header
+  //----------------------------------------------------------------------------
+  size_t FormatHeader(char* buffer, size_t size, const struct timeval& tv,
+                      const char* func, const char* sourceline,
+                      const char* logid, const Mapping::VirtualIdentity& vid,
+                      const char* cident, const char* truncname, int priority);
+
+  //----------------------------------------------------------------------------
+  //! Write a formatted message to syslog, the fan-out files and stderr. The
+  //! caller has to hold gMutex.
+  //!
+  //! @param buffer formatted message including the header
+  //! @param ptr start of the message body in buffer
+  //! @param flush flush the streams after writing, otherwise the stderr
+  //!        output is collected in mStderrBatch
+  //----------------------------------------------------------------------------
+  void WriteOut(char* buffer, const char* ptr, int priority, const char* file,
+                const char* sourceline, const char* func, int uid, int gid,
+                const char* truncname, bool flush);
+
+  //----------------------------------------------------------------------------
+  //! Store a formatted message in the in-memory log. The caller has to hold
+  //! gMutex.
+  //!
+  //! @return pointer to the stored message
+  //----------------------------------------------------------------------------
+  const char* StoreMemory(int priority, const char* buffer);
+
+  //----------------------------------------------------------------------------
+  //! Queue a message in the ring of the calling thread
+  //----------------------------------------------------------------------------
+  const char* LogAsync(const char* func, const char* file, int line,
+                       const char* sourceline, const char* truncname,
+                       const char* logid, const Mapping::VirtualIdentity& vid,
+                       const char* cident, int priority, uint64_t suppressed,
+                       const char* msg, va_list args);
+
+  //----------------------------------------------------------------------------
+  //! Get the ring of the calling thread, registers it on first use
+  //----------------------------------------------------------------------------
+  LogRing* GetThreadRing();
+
+  //----------------------------------------------------------------------------
+  //! Start the writer thread if not running yet and the asynchronous mode is
+  //! still enabled
+  //!
+  //! @return true if the writer thread is running
+  //----------------------------------------------------------------------------
+  bool StartWriter();
+
+  //----------------------------------------------------------------------------
+  //! Stop the writer thread
+  //----------------------------------------------------------------------------
+  void StopWriter();
+
+  //----------------------------------------------------------------------------
+  //! Writer thread loop
+  //----------------------------------------------------------------------------
+  void Writer();
+
+  //----------------------------------------------------------------------------
+  //! Write one batch of all pending messages, the caller has to hold
+  //! mDrainMutex
+  //----------------------------------------------------------------------------
+  void Drain();
+
+  //----------------------------------------------------------------------------
+  //! Wake up the writer thread
+  //----------------------------------------------------------------------------
+  void WakeWriter();
+
+  std::atomic<bool> mAsync; ///< asynchronous mode enabled
+  std::atomic<bool> mWriterRunning; ///< writer thread started
+  std::atomic<bool> mWakeup; ///< writer thread has work
+  std::thread mWriterThread; ///< writer thread
+  std::mutex mWriterMutex; ///< protects writer start/stop and wake up
+  std::condition_variable mWriterCv; ///< wakes up the writer thread
+  std::mutex mDrainMutex; ///< serializes draining of the rings
+  std::mutex mRingsMutex; ///< protects mRings
+  std::vector<std::shared_ptr<LogRing>> mRings; ///< rings of all threads
+  std::atomic<unsigned long long> mDropped[LOG_DEBUG + 1]; ///< dropped msgs
+  unsigned long long mDroppedReported; ///< dropped msgs already reported
+  std::string mStderrBatch; ///< stderr output of the batch being written
+  std::shared_ptr<const std::vector<LogRateRule>> mRateRules; ///< see SetFilter
+  std::atomic<uint64_t> mRateGeneration; ///< incremented on rule changes
+  std::atomic<bool> mRateLimited; ///< rate rules are defined
+  std::atomic<unsigned long long> mSuppressed; ///< suppressed messages
+  LogCallSite mCallSites[kCallSites]; ///< open addressing call site table
+  bool mSummaryRunning; ///< summary thread started, protected by mSummaryMutex
+  std::thread mSummaryThread; ///< writes the suppressed message summaries
+  std::mutex mSummaryMutex; ///< protects the summary thread start/stop
+  std::condition_variable mSummaryCv; ///< wakes up the summary thread
 };
 
 extern Logging& gLogging; ///< Global logging object
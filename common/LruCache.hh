@@ -0,0 +1,143 @@
+//------------------------------------------------------------------------------
+//! @file LruCache.hh
+//! @brief Size bounded cache evicting the least recently used entries
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2019 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#pragma once
+#include "common/Namespace.hh"
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+EOSCOMMONNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! Class LruCache - cache holding at most a given number of entries, once the
+//! limit is reached the least recently used entry is evicted. The class is
+//! not thread-safe, the caller is responsible for the locking.
+//------------------------------------------------------------------------------
+template <typename Key, typename Value>
+class LruCache
+{
+public:
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //!
+  //! @param max_size max number of entries, 0 disables the cache
+  //----------------------------------------------------------------------------
+  LruCache(size_t max_size): mMaxSize(max_size) {}
+
+  //----------------------------------------------------------------------------
+  //! Get entry and mark it as the most recently used one
+  //!
+  //! @param key key to look up
+  //! @param value if not null, filled with the cached value
+  //!
+  //! @return true if entry is cached, otherwise false
+  //----------------------------------------------------------------------------
+  bool Get(const Key& key, Value* value)
+  {
+    auto it = mIndex.find(key);
+
+    if (it == mIndex.end()) {
+      return false;
+    }
+
+    mList.splice(mList.begin(), mList, it->second);
+
+    if (value) {
+      *value = it->second->second;
+    }
+
+    return true;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Add or update entry, evicting the least recently used one if needed
+  //!
+  //! @param key key
+  //! @param value value
+  //----------------------------------------------------------------------------
+  void Put(const Key& key, const Value& value)
+  {
+    if (mMaxSize == 0) {
+      return;
+    }
+
+    auto it = mIndex.find(key);
+
+    if (it != mIndex.end()) {
+      it->second->second = value;
+      mList.splice(mList.begin(), mList, it->second);
+      return;
+    }
+
+    mList.emplace_front(key, value);
+    mIndex[key] = mList.begin();
+
+    if (mIndex.size() > mMaxSize) {
+      mIndex.erase(mList.back().first);
+      mList.pop_back();
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  //! Remove entry
+  //!
+  //! @param key key
+  //----------------------------------------------------------------------------
+  void Erase(const Key& key)
+  {
+    auto it = mIndex.find(key);
+
+    if (it != mIndex.end()) {
+      mList.erase(it->second);
+      mIndex.erase(it);
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  //! Remove all entries
+  //----------------------------------------------------------------------------
+  void Clear()
+  {
+    mIndex.clear();
+    mList.clear();
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get number of cached entries
+  //----------------------------------------------------------------------------
+  size_t Size() const
+  {
+    return mIndex.size();
+  }
+
+private:
+  size_t mMaxSize; ///< Max number of entries
+  //! Entries ordered by last access, most recent one at the front
+  std::list<std::pair<Key, Value>> mList;
+  //! Index of the entries in the list
+  std::unordered_map<Key, typename std::list<std::pair<Key, Value>>::iterator>
+      mIndex;
+};
+
+EOSCOMMONNAMESPACE_END
@@ -40,6 +40,7 @@
 #define EOS_COMMON_PATH_ATOMIC_FILE_PREFIX ".sys.a#."
 #define EOS_COMMON_PATH_ATOMIC_FILE_VERSION_PREFIX ".sys.a#.v#"
 #define EOS_COMMON_PATH_BACKUP_FILE_PREFIX ".sys.b#."
+#define EOS_COMMON_PATH_S3_UPLOAD_FILE_PREFIX ".sys.u#."
 
 EOSCOMMONNAMESPACE_BEGIN
 
@@ -102,6 +102,11 @@ Report::Report(XrdOucEnv& report)
   wt = atof(report.Get("wt") ? report.Get("wt") : "0.0");
   osize = strtoull(report.Get("osize") ? report.Get("osize") : "0", 0, 10);
   csize = strtoull(report.Get("csize") ? report.Get("csize") : "0", 0, 10);
+  rb_hist = report.Get("rb_hist") ? report.Get("rb_hist") : "";
+  wb_hist = report.Get("wb_hist") ? report.Get("wb_hist") : "";
+  rlat_hist = report.Get("rlat_hist") ? report.Get("rlat_hist") : "";
+  rvlat_hist = report.Get("rvlat_hist") ? report.Get("rvlat_hist") : "";
+  wlat_hist = report.Get("wlat_hist") ? report.Get("wlat_hist") : "";
   // sec extensions
   sec_prot = report.Get("sec.prot") ? report.Get("sec.prot") : "";
   sec_name = report.Get("sec.name") ? report.Get("sec.name") : "";
@@ -157,7 +162,8 @@ Report::Dump(XrdOucString& out, bool dumpsec)
            "sbwdb=%llu sxlfwdb=%llu sxlbwdb=%llu nrc=%llu nwc=%llu "
            "nfwds=%llu nbwds=%llu nxlfwds=%llu nxlbwds=%llu rt=%.02f rvt=%.02f"
            "wt=%.02f osize=%llu csize=%llu ots=%llu.%llu cts=%llu.%llu "
-           "td=%s host=%s logid=%s",
+           "td=%s host=%s logid=%s rb_hist=%s wb_hist=%s rlat_hist=%s "
+           "rvlat_hist=%s wlat_hist=%s",
            uid, gid, rb, rb_min, rb_max, rb_sigma,
            rv_op, rvb_min, rvb_max, rvb_sum, rvb_sigma,
            rs_op, rsb_min, rsb_max, rsb_sum, rsb_sigma,
@@ -166,7 +172,9 @@ Report::Dump(XrdOucString& out, bool dumpsec)
            sbwdb, sxlfwdb, sxlbwdb, nrc, nwc,
            nfwds, nbwds, nxlfwds, nxlbwds, rt, rvt,
            wt, osize, csize, ots, otms, cts, ctms,
-           td.c_str(), host.c_str(), logid.c_str());
+           td.c_str(), host.c_str(), logid.c_str(), rb_hist.c_str(),
+           wb_hist.c_str(), rlat_hist.c_str(), rvlat_hist.c_str(),
+           wlat_hist.c_str());
   out += dumpline;
 
   if (dumpsec) {
@@ -110,6 +110,11 @@ public:
   float wt;                ///< disk time spent for write
   unsigned long long osize;//< size when file was opened
   unsigned long long csize;//< size when file was closed
+  std::string rb_hist;     //< log2 histogram of read sizes
+  std::string wb_hist;     //< log2 histogram of write sizes
+  std::string rlat_hist;   //< log2 histogram of read latencies in us
+  std::string rvlat_hist;  //< log2 histogram of readv latencies in us
+  std::string wlat_hist;   //< log2 histogram of write latencies in us
 
   // deletion specific entries
   unsigned long long dsize; //< size of a delete file
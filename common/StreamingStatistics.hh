@@ -0,0 +1,207 @@
+// ----------------------------------------------------------------------
+// File: StreamingStatistics.hh
+// Author: Andreas-Joachim Peters - CERN
+// ----------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2018 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#ifndef __EOSCOMMON_STREAMINGSTATISTICS_HH__
+#define __EOSCOMMON_STREAMINGSTATISTICS_HH__
+
+#include "common/Namespace.hh"
+#include <cmath>
+#include <cstdint>
+#include <string>
+
+EOSCOMMONNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! Histogram with power-of-two buckets: bucket 0 counts the value 0, bucket
+//! i > 0 counts the values in [2^(i-1), 2^i). Uses constant memory for the
+//! full 64-bit range.
+//------------------------------------------------------------------------------
+class LogHistogram
+{
+public:
+  static constexpr int kNumBuckets = 65;
+
+  LogHistogram()
+  {
+    Reset();
+  }
+
+  void
+  Reset()
+  {
+    for (int i = 0; i < kNumBuckets; ++i) {
+      mBuckets[i] = 0;
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get bucket index for a value
+  //----------------------------------------------------------------------------
+  static int
+  GetBucket(uint64_t value)
+  {
+    return value ? (64 - __builtin_clzll(value)) : 0;
+  }
+
+  void
+  Add(uint64_t value)
+  {
+    ++mBuckets[GetBucket(value)];
+  }
+
+  uint64_t
+  GetCount(int bucket) const
+  {
+    return mBuckets[bucket];
+  }
+
+  //----------------------------------------------------------------------------
+  //! Serialize the non-empty buckets as "<bucket>:<count>,..." - the format
+  //! contains neither '&' nor '=' so it can be embedded into env strings.
+  //! An empty histogram is serialized as an empty string.
+  //----------------------------------------------------------------------------
+  std::string
+  ToString() const
+  {
+    std::string out;
+
+    for (int i = 0; i < kNumBuckets; ++i) {
+      if (mBuckets[i]) {
+        if (!out.empty()) {
+          out += ",";
+        }
+
+        out += std::to_string(i);
+        out += ":";
+        out += std::to_string(mBuckets[i]);
+      }
+    }
+
+    return out;
+  }
+
+private:
+  uint64_t mBuckets[kNumBuckets];
+};
+
+//------------------------------------------------------------------------------
+//! Constant memory estimator of count, sum, min, max, mean and standard
+//! deviation using Welford's online algorithm, plus a log-bucket histogram
+//! of the observed values.
+//------------------------------------------------------------------------------
+class StreamingStatistics
+{
+public:
+  StreamingStatistics()
+  {
+    Reset();
+  }
+
+  void
+  Reset()
+  {
+    mCount = mSum = mMin = mMax = 0;
+    mMean = mM2 = 0;
+    mHistogram.Reset();
+  }
+
+  //----------------------------------------------------------------------------
+  //! Account one observation
+  //----------------------------------------------------------------------------
+  void
+  Add(uint64_t value)
+  {
+    if (!mCount || (value < mMin)) {
+      mMin = value;
+    }
+
+    if (value > mMax) {
+      mMax = value;
+    }
+
+    ++mCount;
+    mSum += value;
+    double delta = value - mMean;
+    mMean += delta / mCount;
+    mM2 += delta * (value - mMean);
+    mHistogram.Add(value);
+  }
+
+  uint64_t
+  GetCount() const
+  {
+    return mCount;
+  }
+
+  uint64_t
+  GetSum() const
+  {
+    return mSum;
+  }
+
+  uint64_t
+  GetMin() const
+  {
+    return mMin;
+  }
+
+  uint64_t
+  GetMax() const
+  {
+    return mMax;
+  }
+
+  double
+  GetMean() const
+  {
+    return mMean;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Population standard deviation
+  //----------------------------------------------------------------------------
+  double
+  GetSigma() const
+  {
+    return mCount ? sqrt(mM2 / mCount) : 0;
+  }
+
+  const LogHistogram&
+  GetHistogram() const
+  {
+    return mHistogram;
+  }
+
+private:
+  uint64_t mCount;
+  uint64_t mSum;
+  uint64_t mMin;
+  uint64_t mMax;
+  double mMean;
+  double mM2; ///< sum of squared differences from the current mean
+  LogHistogram mHistogram;
+};
+
+EOSCOMMONNAMESPACE_END
+
+#endif
@@ -76,7 +76,7 @@ CRC32CFunctionPtr detectBestCRC32C()
 
   if (hasSSE42) {
 #ifdef __LP64__
-    return crc32cHardware64;
+    return crc32cHardware64Parallel;
 #else
     return crc32cHardware32;
 #endif
@@ -298,4 +298,153 @@ uint32_t crc32cHardware64(uint32_t crc, const void* data, size_t length)
 #endif
 }
 
+// GF(2) helpers used to shift a CRC register over a run of zero bytes, as in
+// zlib's crc32_combine but for the Castagnoli polynomial
+static uint32_t gf2MatrixTimes(const uint32_t* mat, uint32_t vec)
+{
+  uint32_t sum = 0;
+
+  while (vec) {
+    if (vec & 1) {
+      sum ^= *mat;
+    }
+
+    vec >>= 1;
+    mat++;
+  }
+
+  return sum;
+}
+
+static void gf2MatrixSquare(uint32_t* square, const uint32_t* mat)
+{
+  for (int n = 0; n < 32; n++) {
+    square[n] = gf2MatrixTimes(mat, mat[n]);
+  }
+}
+
+uint32_t crc32cShift(uint32_t crc, size_t length)
+{
+  uint32_t even[32]; // even-power-of-two zeros operator
+  uint32_t odd[32];  // odd-power-of-two zeros operator
+
+  if (length == 0) {
+    return crc;
+  }
+
+  // Operator for one zero bit in odd
+  odd[0] = 0x82F63B78;
+  uint32_t row = 1;
+
+  for (int n = 1; n < 32; n++) {
+    odd[n] = row;
+    row <<= 1;
+  }
+
+  // Operator for two zero bits in even, four zero bits in odd
+  gf2MatrixSquare(even, odd);
+  gf2MatrixSquare(odd, even);
+
+  // Apply length zeros to crc, the first square puts the operator for one
+  // zero byte (eight zero bits) in even
+  do {
+    gf2MatrixSquare(even, odd);
+
+    if (length & 1) {
+      crc = gf2MatrixTimes(even, crc);
+    }
+
+    length >>= 1;
+
+    if (length == 0) {
+      break;
+    }
+
+    gf2MatrixSquare(odd, even);
+
+    if (length & 1) {
+      crc = gf2MatrixTimes(odd, crc);
+    }
+
+    length >>= 1;
+  } while (length);
+
+  return crc;
+}
+
+uint32_t crc32cCombine(uint32_t crc1, uint32_t crc2, size_t length2)
+{
+  return crc32cShift(crc1, length2) ^ crc2;
+}
+
+#ifdef __LP64__
+// Block length of each of the three interleaved streams. The CRC32
+// instruction has a latency of three cycles but a throughput of one per
+// cycle, so running three independent streams keeps the unit busy. The
+// partial results are merged with a table driven shift over one block.
+static const size_t kParallelBlock = 8192;
+
+struct ShiftTable {
+  uint32_t table[4][256];
+
+  ShiftTable()
+  {
+    for (int k = 0; k < 4; k++) {
+      for (uint32_t b = 0; b < 256; b++) {
+        table[k][b] = crc32cShift(b << (8 * k), kParallelBlock);
+      }
+    }
+  }
+
+  inline uint32_t Shift(uint32_t crc) const
+  {
+    return table[0][crc & 0xff] ^ table[1][(crc >> 8) & 0xff] ^
+           table[2][(crc >> 16) & 0xff] ^ table[3][crc >> 24];
+  }
+};
+
+static const ShiftTable& parallelShiftTable()
+{
+  static const ShiftTable table;
+  return table;
+}
+#endif
+
+// Hardware-accelerated CRC-32C running three interleaved streams
+uint32_t crc32cHardware64Parallel(uint32_t crc, const void* data,
+                                  size_t length)
+{
+#ifndef __LP64__
+  return crc32cHardware32(crc, data, length);
+#else
+  const char* p_buf = (const char*) data;
+
+  if (length >= 3 * kParallelBlock) {
+    const ShiftTable& shift = parallelShiftTable();
+
+    while (length >= 3 * kParallelBlock) {
+      uint64_t crc0 = crc;
+      uint64_t crc1 = 0;
+      uint64_t crc2 = 0;
+      const char* p_end = p_buf + kParallelBlock;
+
+      while (p_buf < p_end) {
+        crc0 = __builtin_ia32_crc32di(crc0, *(uint64_t*) p_buf);
+        crc1 = __builtin_ia32_crc32di(crc1, *(uint64_t*)(p_buf + kParallelBlock));
+        crc2 = __builtin_ia32_crc32di(crc2,
+                                      *(uint64_t*)(p_buf + 2 * kParallelBlock));
+        p_buf += sizeof(uint64_t);
+      }
+
+      crc = shift.Shift((uint32_t) crc0) ^ (uint32_t) crc1;
+      crc = shift.Shift(crc) ^ (uint32_t) crc2;
+      p_buf += 2 * kParallelBlock;
+      length -= 3 * kParallelBlock;
+    }
+  }
+
+  return crc32cHardware64(crc, p_buf, length);
+#endif
+}
+
 }  // namespace checksum
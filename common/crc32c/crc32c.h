@@ -41,6 +41,22 @@ uint32_t crc32cSlicingBy4(uint32_t crc, const void* data, size_t length);
 uint32_t crc32cSlicingBy8(uint32_t crc, const void* data, size_t length);
 uint32_t crc32cHardware32(uint32_t crc, const void* data, size_t length);
 uint32_t crc32cHardware64(uint32_t crc, const void* data, size_t length);
+uint32_t crc32cHardware64Parallel(uint32_t crc, const void* data,
+                                  size_t length);
+
+/** Advances a (non-finalized) CRC32-C register over length zero bytes.
+@arg crc CRC32C register value.
+@arg length number of zero bytes to shift in.
+*/
+uint32_t crc32cShift(uint32_t crc, size_t length);
+
+/** Combines two finalized CRC32-C values of adjacent blocks, the same way
+zlib's crc32_combine does it for CRC32.
+@arg crc1 CRC32C of the first block.
+@arg crc2 CRC32C of the second block.
+@arg length2 length of the second block in bytes.
+*/
+uint32_t crc32cCombine(uint32_t crc1, uint32_t crc2, size_t length2);
 
 }  // namespace checksum
 #endif
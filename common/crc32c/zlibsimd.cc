@@ -0,0 +1,286 @@
+// ----------------------------------------------------------------------
+// File: zlibsimd.cc
+// Author: Andreas-Joachim Peters - CERN
+// ----------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2018 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+// SIMD kernels for zlib compatible Adler-32 and CRC32. The Adler-32 kernel
+// follows the SSSE3 block scheme used by Chromium's zlib, the CRC32 kernel
+// the carry-less multiplication folding described in Intel's "Fast CRC
+// Computation for Generic Polynomials Using PCLMULQDQ Instruction".
+
+#include "zlibsimd.h"
+#include <zlib.h>
+
+#if defined(__x86_64__)
+#include <tmmintrin.h>
+#include <smmintrin.h>
+#include <wmmintrin.h>
+#define ZLIBSIMD_X86 1
+#endif
+
+namespace checksum
+{
+
+static uint32_t adler32_CPUDetection(uint32_t adler, const void* data,
+                                     size_t length)
+{
+  ZlibChecksumFunctionPtr best = detectBestAdler32();
+  adler32Fast = best;
+  return best(adler, data, length);
+}
+
+static uint32_t crc32_CPUDetection(uint32_t crc, const void* data,
+                                   size_t length)
+{
+  ZlibChecksumFunctionPtr best = detectBestCRC32();
+  crc32Fast = best;
+  return best(crc, data, length);
+}
+
+ZlibChecksumFunctionPtr adler32Fast = adler32_CPUDetection;
+ZlibChecksumFunctionPtr crc32Fast = crc32_CPUDetection;
+
+ZlibChecksumFunctionPtr detectBestAdler32()
+{
+#ifdef ZLIBSIMD_X86
+
+  if (__builtin_cpu_supports("ssse3")) {
+    return adler32Ssse3;
+  }
+
+#endif
+  return adler32Zlib;
+}
+
+ZlibChecksumFunctionPtr detectBestCRC32()
+{
+#ifdef ZLIBSIMD_X86
+
+  if (__builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1")) {
+    return crc32Pclmul;
+  }
+
+#endif
+  return crc32Zlib;
+}
+
+uint32_t adler32Zlib(uint32_t adler, const void* data, size_t length)
+{
+  return ::adler32(adler, (const Bytef*) data, length);
+}
+
+uint32_t crc32Zlib(uint32_t crc, const void* data, size_t length)
+{
+  return ::crc32(crc, (const Bytef*) data, length);
+}
+
+#ifdef ZLIBSIMD_X86
+static const uint32_t kAdlerBase = 65521; // largest prime smaller than 65536
+static const uint32_t kAdlerNmax = 5552;  // max bytes before s2 overflows
+static const size_t kAdlerBlock = 32;
+
+__attribute__((target("ssse3")))
+uint32_t adler32Ssse3(uint32_t adler, const void* data, size_t length)
+{
+  // Below a few blocks the setup cost is not worth it
+  if (length < 2 * kAdlerBlock) {
+    return adler32Zlib(adler, data, length);
+  }
+
+  const unsigned char* buf = (const unsigned char*) data;
+  uint32_t s1 = adler & 0xffff;
+  uint32_t s2 = adler >> 16;
+  size_t blocks = length / kAdlerBlock;
+  length -= blocks * kAdlerBlock;
+  const __m128i tap1 = _mm_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25,
+                                     24, 23, 22, 21, 20, 19, 18, 17);
+  const __m128i tap2 = _mm_setr_epi8(16, 15, 14, 13, 12, 11, 10, 9,
+                                     8, 7, 6, 5, 4, 3, 2, 1);
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i ones = _mm_set1_epi16(1);
+
+  while (blocks) {
+    // At most kAdlerNmax bytes can be summed before reducing modulo base
+    size_t n = kAdlerNmax / kAdlerBlock;
+
+    if (n > blocks) {
+      n = blocks;
+    }
+
+    blocks -= n;
+    __m128i v_ps = _mm_set_epi32(0, 0, 0, s1 * n);
+    __m128i v_s2 = _mm_set_epi32(0, 0, 0, s2);
+    __m128i v_s1 = _mm_setzero_si128();
+
+    do {
+      const __m128i bytes1 = _mm_loadu_si128((const __m128i*) buf);
+      const __m128i bytes2 = _mm_loadu_si128((const __m128i*)(buf + 16));
+      // Every block adds the running byte sum once per byte to s2
+      v_ps = _mm_add_epi32(v_ps, v_s1);
+      v_s1 = _mm_add_epi32(v_s1, _mm_sad_epu8(bytes1, zero));
+      const __m128i mad1 = _mm_maddubs_epi16(bytes1, tap1);
+      v_s2 = _mm_add_epi32(v_s2, _mm_madd_epi16(mad1, ones));
+      v_s1 = _mm_add_epi32(v_s1, _mm_sad_epu8(bytes2, zero));
+      const __m128i mad2 = _mm_maddubs_epi16(bytes2, tap2);
+      v_s2 = _mm_add_epi32(v_s2, _mm_madd_epi16(mad2, ones));
+      buf += kAdlerBlock;
+    } while (--n);
+
+    v_s2 = _mm_add_epi32(v_s2, _mm_slli_epi32(v_ps, 5));
+    // Horizontal sums of the lanes
+    v_s1 = _mm_add_epi32(v_s1, _mm_shuffle_epi32(v_s1, _MM_SHUFFLE(1, 0, 3, 2)));
+    s1 += _mm_cvtsi128_si32(v_s1);
+    v_s2 = _mm_add_epi32(v_s2, _mm_shuffle_epi32(v_s2, _MM_SHUFFLE(2, 3, 0, 1)));
+    v_s2 = _mm_add_epi32(v_s2, _mm_shuffle_epi32(v_s2, _MM_SHUFFLE(1, 0, 3, 2)));
+    s2 = _mm_cvtsi128_si32(v_s2);
+    s1 %= kAdlerBase;
+    s2 %= kAdlerBase;
+  }
+
+  // Leftover bytes, less than one block
+  while (length--) {
+    s1 += *buf++;
+    s2 += s1;
+  }
+
+  s1 %= kAdlerBase;
+  s2 %= kAdlerBase;
+  return s1 | (s2 << 16);
+}
+
+__attribute__((target("pclmul,sse4.1")))
+uint32_t crc32Pclmul(uint32_t crc, const void* data, size_t length)
+{
+  // The folding needs at least one 64 byte block and works on 16 byte units,
+  // the tail is handed over to zlib
+  if (length < 64) {
+    return crc32Zlib(crc, data, length);
+  }
+
+  const unsigned char* buf = (const unsigned char*) data;
+  size_t chunk = length & ~(size_t) 15;
+  size_t tail = length - chunk;
+  // Bit-reflected folding constants and Barrett reduction constants for the
+  // CRC32 polynomial 0x04C11DB7
+  static const uint64_t k1k2[2] __attribute__((aligned(16))) = {
+    0x0154442bd4ULL, 0x01c6e41596ULL
+  };
+  static const uint64_t k3k4[2] __attribute__((aligned(16))) = {
+    0x01751997d0ULL, 0x00ccaa009eULL
+  };
+  static const uint64_t k5k0[2] __attribute__((aligned(16))) = {
+    0x0163cd6124ULL, 0x0000000000ULL
+  };
+  static const uint64_t poly[2] __attribute__((aligned(16))) = {
+    0x01db710641ULL, 0x01f7011641ULL
+  };
+  __m128i x0, x1, x2, x3, x4, x5, x6, x7, x8, y5, y6, y7, y8;
+  x1 = _mm_loadu_si128((const __m128i*)(buf + 0x00));
+  x2 = _mm_loadu_si128((const __m128i*)(buf + 0x10));
+  x3 = _mm_loadu_si128((const __m128i*)(buf + 0x20));
+  x4 = _mm_loadu_si128((const __m128i*)(buf + 0x30));
+  x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(~crc));
+  x0 = _mm_load_si128((const __m128i*) k1k2);
+  buf += 64;
+  chunk -= 64;
+
+  // Fold four 128-bit lanes in parallel
+  while (chunk >= 64) {
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+    x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+    x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+    x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+    x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+    y5 = _mm_loadu_si128((const __m128i*)(buf + 0x00));
+    y6 = _mm_loadu_si128((const __m128i*)(buf + 0x10));
+    y7 = _mm_loadu_si128((const __m128i*)(buf + 0x20));
+    y8 = _mm_loadu_si128((const __m128i*)(buf + 0x30));
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), y5);
+    x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), y6);
+    x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), y7);
+    x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), y8);
+    buf += 64;
+    chunk -= 64;
+  }
+
+  // Fold the four lanes into one
+  x0 = _mm_load_si128((const __m128i*) k3k4);
+  x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+  x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+  x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+  x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+  x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+  x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+  x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+  x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+  x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+  // Single fold of the remaining 16 byte units
+  while (chunk >= 16) {
+    x2 = _mm_loadu_si128((const __m128i*) buf);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+    buf += 16;
+    chunk -= 16;
+  }
+
+  // Fold 128 bits to 64 bits
+  x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+  x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+  x1 = _mm_srli_si128(x1, 8);
+  x1 = _mm_xor_si128(x1, x2);
+  x0 = _mm_loadl_epi64((const __m128i*) k5k0);
+  x2 = _mm_srli_si128(x1, 4);
+  x1 = _mm_and_si128(x1, x3);
+  x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+  // Barrett reduction to 32 bits
+  x0 = _mm_load_si128((const __m128i*) poly);
+  x2 = _mm_and_si128(x1, x3);
+  x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+  x2 = _mm_and_si128(x2, x3);
+  x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+  crc = ~(uint32_t) _mm_extract_epi32(x1, 1);
+
+  if (tail) {
+    crc = crc32Zlib(crc, buf, tail);
+  }
+
+  return crc;
+}
+#else
+uint32_t adler32Ssse3(uint32_t adler, const void* data, size_t length)
+{
+  return adler32Zlib(adler, data, length);
+}
+
+uint32_t crc32Pclmul(uint32_t crc, const void* data, size_t length)
+{
+  return crc32Zlib(crc, data, length);
+}
+#endif
+
+}  // namespace checksum
@@ -0,0 +1,55 @@
+// ----------------------------------------------------------------------
+// File: zlibsimd.h
+// Author: Andreas-Joachim Peters - CERN
+// ----------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2018 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#ifndef COMMON_CRC32C_ZLIBSIMD_H__
+#define COMMON_CRC32C_ZLIBSIMD_H__
+
+#include <cstddef>
+#include <stdint.h>
+
+namespace checksum
+{
+
+/** Pointer to a function computing a zlib compatible Adler-32 or CRC32.
+@arg value Previous checksum value, or adler32(0, 0, 0)/crc32(0, 0, 0).
+@arg data Pointer to the data to be checksummed.
+@arg length length of the data in bytes.
+*/
+typedef uint32_t (*ZlibChecksumFunctionPtr)(uint32_t value, const void* data,
+    size_t length);
+
+/** These map automatically to the "best" implementation on first use and
+produce exactly the same values as zlib's adler32/crc32. */
+extern ZlibChecksumFunctionPtr adler32Fast;
+extern ZlibChecksumFunctionPtr crc32Fast;
+
+ZlibChecksumFunctionPtr detectBestAdler32();
+ZlibChecksumFunctionPtr detectBestCRC32();
+
+uint32_t adler32Zlib(uint32_t adler, const void* data, size_t length);
+uint32_t adler32Ssse3(uint32_t adler, const void* data, size_t length);
+uint32_t crc32Zlib(uint32_t crc, const void* data, size_t length);
+uint32_t crc32Pclmul(uint32_t crc, const void* data, size_t length);
+
+}  // namespace checksum
+#endif // COMMON_CRC32C_ZLIBSIMD_H__
@@ -35,6 +35,9 @@
 #include "common/Namespace.hh"
 /*----------------------------------------------------------------------------*/
 /*----------------------------------------------------------------------------*/
+#include <sys/types.h>
+#include <stdint.h>
+#include <unistd.h>
 #include <map>
 #include <string>
 /*----------------------------------------------------------------------------*/
@@ -95,8 +98,10 @@ protected:
   int          mResponseCode;          //!< the response code to be determined
 
 public:
-  off_t        mResponseLength;        //!< length of the response
+  off_t        mResponseLength;        //!< length of the response, -1 if unknown
   bool         mUseFileReaderCallback; //!< read the file using callbacks
+  int          mResponseFd;            //!< local file sent without copy, -1 if none
+  off_t        mResponseFdOffset;      //!< offset of the response in mResponseFd
 
 public:
 
@@ -104,12 +109,18 @@ public:
    * Constructor
    */
   HttpResponse () :
-    mResponseCode(OK), mResponseLength(0), mUseFileReaderCallback(false) {};
+    mResponseCode(OK), mResponseLength(0), mUseFileReaderCallback(false),
+    mResponseFd(-1), mResponseFdOffset(0) {};
 
   /**
-   * Destructor
+   * Destructor, closes a response file descriptor which was not handed over
    */
-  virtual ~HttpResponse () {};
+  virtual ~HttpResponse ()
+  {
+    if (mResponseFd >= 0) {
+      close(mResponseFd);
+    }
+  };
 
   /**
    * Build an appropriate response to the given request. This will be
@@ -165,6 +176,20 @@ public:
   inline size_t
   GetBodySize () { return mResponseBody.length(); }
 
+  /**
+   * Produce the next part of a body which is generated while it is sent,
+   * used when mUseFileReaderCallback is set on the MGM
+   *
+   * @param pos  the position of the part in the body
+   * @param buf  the buffer to fill
+   * @param max  the size of the buffer
+   *
+   * @return the number of bytes written to buf, -1 at the end of the body
+   *         and -2 on error
+   */
+  virtual ssize_t
+  ReadBody (uint64_t pos, char *buf, size_t max) { return -2; }
+
   /**
    * @return the server response code
    */
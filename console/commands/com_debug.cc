@@ -99,7 +99,13 @@ com_debug(char* arg1)
   fprintf(stdout,
           "                  The default filter list is: 'Process,AddQuota,Update,UpdateHint,UpdateQuotaStatus,SetConfigValue,Deletion,GetQuota,PrintOut,RegisterNode,SharedHash,listenFsChange,\n");
   fprintf(stdout,
-          "                  placeNewReplicas,placeNewReplicasOneGroup,accessReplicas,accessReplicasOneGroup,accessHeadReplicaMultipleGroup,updateTreeInfo,updateAtomicPenalties,updateFastStructures,work'.\n\n");
+          "                  placeNewReplicas,placeNewReplicasOneGroup,accessReplicas,accessReplicasOneGroup,accessHeadReplicaMultipleGroup,updateTreeInfo,updateAtomicPenalties,updateFastStructures,work'.\n");
+  fprintf(stdout,
+          "                  Entries 'rate:<unit>:<max>/<seconds>' log at most <max> messages per source line and period,\n");
+  fprintf(stdout,
+          "                  entries 'sample:<unit>:<n>' log one out of <n> messages per source line. <unit> is a function name,\n");
+  fprintf(stdout,
+          "                  a source file name without suffix or '*'. The number of suppressed messages is appended to the next logged one.\n\n");
   fprintf(stdout,
           "The allowed debug levels are: debug info warning notice err crit alert emerg\n\n");
   fprintf(stdout, "Examples:\n");
@@ -111,6 +117,10 @@ com_debug(char* arg1)
           "  debug crit /eos/*/mgm                set MGM into debug mode 'crit'\n\n");
   fprintf(stdout,
           "  debug debug --filter MgmOfsMessage   set MGM into debug mode 'debug' and filter only messages coming from unit 'MgmOfsMessage'.\n\n");
+  fprintf(stdout,
+          "  debug info --filter rate:*:100/60,sample:ReplicaParLayout:1000\n"
+          "                                       set MGM into debug mode 'info', log at most 100 messages per minute and source line\n"
+          "                                       and only every 1000th message of the source file 'ReplicaParLayout'.\n\n");
   global_retc = EINVAL;
   return (0);
 }
@@ -164,6 +164,11 @@ void com_fs_help()
       << "    s3credentials=<accesskey>:<secretkey>" << std::endl
       << "      the access and secret key pair used to authenticate" << std::endl
       << "      with the S3 storage endpoint" << std::endl
+      << "    ioengine=psync|uring" << std::endl
+      << "      engine used for vector reads of local files: psync (default)"
+      << std::endl
+      << "      or io_uring batched submission, only without block checksums"
+      << std::endl
       << std::endl
       << "  fs dropdeletion <fsid> " << std::endl
       << "    drop all pending deletions on the filesystem" << std::endl
@@ -133,11 +133,13 @@ NsHelper::ParseCommand(const char* arg)
     NsProto_CompactProto* compact = ns->mutable_compact();
 
     if (!(option = tokenizer.GetToken())) {
-      return false;
+      compact->set_status(true);
     } else {
       soption = option;
 
-      if (soption == "off") {
+      if (soption == "status") {
+        compact->set_status(true);
+      } else if (soption == "off") {
         compact->set_on(false);
       } else if (soption == "on") {
         compact->set_on(true);
@@ -184,6 +186,16 @@ NsHelper::ParseCommand(const char* arg)
               } else {
                 return false;
               }
+
+              if ((option = tokenizer.GetToken())) {
+                soption = option;
+
+                if (soption == "incremental") {
+                  compact->set_incremental(true);
+                } else {
+                  return false;
+                }
+              }
             }
           }
         }
@@ -399,7 +411,12 @@ void com_ns_help()
       << "    --smplrate100    : set timing sample rate at 100% (severe slow-down)"
       << std::endl
       << std::endl
-      << "  ns compact off|on <delay> [<interval>] [<type>]" << std::endl
+      << "  ns compact [status]" << std::endl
+      << "    show the online compaction state, the progress and the namespace lock"
+      << std::endl
+      << "    pauses of an incremental compaction" << std::endl
+      << std::endl
+      << "  ns compact off|on <delay> [<interval>] [<type>] [incremental]" << std::endl
       << "    enable online compaction after <delay> seconds" << std::endl
       << "    <interval> : if >0 then compaction is repeated automatically " <<
       std::endl
@@ -410,6 +427,9 @@ void com_ns_help()
       << std::endl
       << "                 'files-repair', 'directories-repair' or 'all-repair'. "
       << std::endl
+      << "    incremental : compact the changelog in segments in the background, the"
+      << std::endl
+      << "                  namespace is locked only for short periods" << std::endl
       << std::endl
       << "  ns master [<option>]" << std::endl
       << "    master/slave operations. Option can be:" << std::endl
@@ -161,7 +161,21 @@ RecycleHelper::ParseCommand(const char* arg)
 
       if (soption == "-g") {
         purge->set_all(true);
-        break;
+      } else if ((soption == "--rate") || (soption == "--threads")) {
+        const char* value = tokenizer.GetToken();
+        char* end = nullptr;
+        unsigned long num = (value ? strtoul(value, &end, 10) : 0);
+
+        if (!value || *end) {
+          std::cerr << "error: " << soption << " needs a number" << std::endl;
+          return false;
+        }
+
+        if (soption == "--rate") {
+          purge->set_rate(num);
+        } else {
+          purge->set_threads(num);
+        }
       } else {
         if (!CheckDateFormat(soption)) {
           std::cerr << "error: \"" << soption << "\" does not respect the "
@@ -170,7 +184,6 @@ RecycleHelper::ParseCommand(const char* arg)
         }
 
         purge->set_date(soption);
-        break;
       }
     }
 
@@ -321,12 +334,16 @@ void com_recycle_help()
       << "    -m     : display info in monitoring format" << std::endl
       << "    -n     : dispaly numeric uid/gid(s) instead of names" << std::endl
       << std::endl
-      << "  recycle purge [-g|<date>]" << std::endl
+      << "  recycle purge [-g|<date>] [--rate <n>] [--threads <n>]" << std::endl
       << "    purge files in the recycle bin" << std::endl
       << "    -g     : empties the recycle bin of all users (if done by root or admin)"
       << std::endl
       << "    <date> : can be <year>, <year>/<month> or <year>/<month>/<day>"
       << std::endl
+      << "    --rate <n>    : delete at most <n> entries per second [default=no limit]"
+      << std::endl
+      << "    --threads <n> : number of parallel deletions [default=4, max=16]"
+      << std::endl
       << std::endl
       << "   recycle restore [-f|--force-original-name] [-r|--restore-versions] <recycle-key>"
       << std::endl
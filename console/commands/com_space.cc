@@ -515,6 +515,8 @@ com_space_usage:
           "       space config <space-name> space.lru=on|off                    : enable/disable the LRU policy engine [default=off]\n");
   fprintf(stdout,
           "       space config <space-name> space.lru.interval=<sec>            : configure the default lru scan interval\n");
+  fprintf(stdout,
+          "       space config <space-name> space.lru.rescan=<sec>              : configure the lru full namespace scan interval\n");
   fprintf(stdout,
           "       space config <space-name> space.headroom=<size>               : configure the default disk headroom if not defined on a filesystem (see fs for details)\n");
   fprintf(stdout,
@@ -0,0 +1,479 @@
+//------------------------------------------------------------------------------
+// File: DeletionEngine.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2019 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "fst/DeletionEngine.hh"
+#include "fst/Deletion.hh"
+#include "fst/FmdDbMap.hh"
+#include "fst/XrdFstOfs.hh"
+#include "common/FileId.hh"
+#include <cstdlib>
+#ifndef __APPLE__
+#include <sys/syscall.h>
+#endif
+#include <unistd.h>
+
+//------------------------------------------------------------------------------
+// We're missing ioprio.h
+//------------------------------------------------------------------------------
+#define IOPRIO_CLASS_SHIFT (13)
+#define IOPRIO_PRIO_VALUE(class, data) (((class) << IOPRIO_CLASS_SHIFT) | data)
+
+enum {
+  IOPRIO_CLASS_NONE,
+  IOPRIO_CLASS_RT,
+  IOPRIO_CLASS_BE,
+  IOPRIO_CLASS_IDLE,
+};
+
+enum {
+  IOPRIO_WHO_PROCESS = 1,
+};
+
+EOSFSTNAMESPACE_BEGIN
+
+constexpr std::chrono::seconds DeletionEngine::sRatePeriod;
+constexpr size_t DeletionEngine::sMaxDropLength;
+
+//------------------------------------------------------------------------------
+// Build the drop notifications sent to the MGM for a batch
+//------------------------------------------------------------------------------
+std::vector<std::string>
+DeletionEngine::BuildDropRequests(eos::common::FileSystem::fsid_t fsid,
+                                  const std::vector<std::string>& hexfids,
+                                  const std::string& local_prefix)
+{
+  std::vector<std::string> requests;
+  std::string fid_list;
+
+  for (size_t i = 0; i < hexfids.size(); ++i) {
+    if (!fid_list.empty()) {
+      fid_list += ",";
+    }
+
+    fid_list += hexfids[i];
+
+    if ((i + 1 == hexfids.size()) || (fid_list.length() >= sMaxDropLength)) {
+      std::string request = "/?mgm.pcmd=drop&mgm.fsid=";
+      request += std::to_string(fsid);
+      request += "&mgm.fids=";
+      request += fid_list;
+      request += "&mgm.localprefix=";
+      request += local_prefix;
+      requests.push_back(request);
+      fid_list.clear();
+    }
+  }
+
+  return requests;
+}
+
+//------------------------------------------------------------------------------
+// Parse IO priority specification
+//------------------------------------------------------------------------------
+bool
+DeletionEngine::ParseIoPriority(const std::string& spec, int& ioprio)
+{
+  if (spec == "idle") {
+    ioprio = IOPRIO_PRIO_VALUE(IOPRIO_CLASS_IDLE, 0);
+    return true;
+  }
+
+  if ((spec.length() != 4) || (spec[2] != ':') ||
+      (spec[3] < '0') || (spec[3] > '7')) {
+    return false;
+  }
+
+  int level = spec[3] - '0';
+
+  if (spec.compare(0, 2, "be") == 0) {
+    ioprio = IOPRIO_PRIO_VALUE(IOPRIO_CLASS_BE, level);
+  } else if (spec.compare(0, 2, "rt") == 0) {
+    ioprio = IOPRIO_PRIO_VALUE(IOPRIO_CLASS_RT, level);
+  } else {
+    return false;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+DeletionEngine::DeletionEngine():
+  mNumThreads(16), mThreadsPerFs(2), mBatchSize(256),
+  mIoPriority(IOPRIO_PRIO_VALUE(IOPRIO_CLASS_BE, 4)), mLastFsid(0)
+{
+  SetLogId("DeletionEngine", "<service>");
+
+  if (getenv("EOS_FST_DELETION_THREADS")) {
+    mNumThreads = std::max(1, atoi(getenv("EOS_FST_DELETION_THREADS")));
+  }
+
+  if (getenv("EOS_FST_DELETION_THREADS_PER_FS")) {
+    mThreadsPerFs = std::max(1, atoi(getenv("EOS_FST_DELETION_THREADS_PER_FS")));
+  }
+
+  if (getenv("EOS_FST_DELETION_BATCH")) {
+    mBatchSize = std::max(1, atoi(getenv("EOS_FST_DELETION_BATCH")));
+  }
+
+  if (getenv("EOS_FST_DELETION_IOPRIO")) {
+    if (!ParseIoPriority(getenv("EOS_FST_DELETION_IOPRIO"), mIoPriority)) {
+      eos_err("msg=\"invalid EOS_FST_DELETION_IOPRIO, using be:4\" value=\"%s\"",
+              getenv("EOS_FST_DELETION_IOPRIO"));
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Destructor
+//------------------------------------------------------------------------------
+DeletionEngine::~DeletionEngine()
+{
+  Stop();
+}
+
+//------------------------------------------------------------------------------
+// Start the worker threads
+//------------------------------------------------------------------------------
+void
+DeletionEngine::Start()
+{
+  if (!mWorkers.empty()) {
+    return;
+  }
+
+  eos_info("msg=\"starting deletion engine\" threads=%u threads_per_fs=%u "
+           "batch=%lu", mNumThreads, mThreadsPerFs, mBatchSize);
+
+  for (unsigned int i = 0; i < mNumThreads; ++i) {
+    mWorkers.emplace_back(new AssistedThread(&DeletionEngine::Worker, this));
+  }
+}
+
+//------------------------------------------------------------------------------
+// Stop the worker threads
+//------------------------------------------------------------------------------
+void
+DeletionEngine::Stop()
+{
+  for (auto& worker : mWorkers) {
+    worker->stop();
+  }
+
+  mCv.notify_all();
+  mWorkers.clear();
+}
+
+//------------------------------------------------------------------------------
+// Add deletion to the queue of its file system
+//------------------------------------------------------------------------------
+void
+DeletionEngine::Add(std::unique_ptr<Deletion> del)
+{
+  if (!del || del->fIdVector.empty()) {
+    return;
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    auto it = mQueues.find(del->fsId);
+
+    if (it == mQueues.end()) {
+      it = mQueues.emplace(del->fsId, FsQueue()).first;
+      it->second.mRateStart = std::chrono::steady_clock::now();
+    }
+
+    it->second.mNumFids += del->fIdVector.size();
+    it->second.mPending.push_back(std::move(del));
+  }
+  mCv.notify_one();
+}
+
+//------------------------------------------------------------------------------
+// Get number of file ids waiting to be deleted on all file systems
+//------------------------------------------------------------------------------
+uint64_t
+DeletionEngine::GetBacklog()
+{
+  uint64_t backlog = 0;
+  std::unique_lock<std::mutex> lock(mMutex);
+
+  for (const auto& elem : mQueues) {
+    backlog += elem.second.mNumFids + elem.second.mInFlight;
+  }
+
+  return backlog;
+}
+
+//------------------------------------------------------------------------------
+// Get deletion statistics of a file system
+//------------------------------------------------------------------------------
+DeletionEngine::Stats
+DeletionEngine::GetStats(eos::common::FileSystem::fsid_t fsid)
+{
+  Stats stats;
+  std::unique_lock<std::mutex> lock(mMutex);
+  auto it = mQueues.find(fsid);
+
+  if (it != mQueues.end()) {
+    UpdateRate(it->second, std::chrono::steady_clock::now());
+    stats.mBacklog = it->second.mNumFids + it->second.mInFlight;
+    stats.mDeleted = it->second.mDeleted;
+    stats.mFailed = it->second.mFailed;
+    stats.mRate = it->second.mRate;
+  }
+
+  return stats;
+}
+
+//------------------------------------------------------------------------------
+// Get aggregated deletion statistics of all file systems
+//------------------------------------------------------------------------------
+DeletionEngine::Stats
+DeletionEngine::GetStats()
+{
+  Stats stats;
+  auto now = std::chrono::steady_clock::now();
+  std::unique_lock<std::mutex> lock(mMutex);
+
+  for (auto& elem : mQueues) {
+    UpdateRate(elem.second, now);
+    stats.mBacklog += elem.second.mNumFids + elem.second.mInFlight;
+    stats.mDeleted += elem.second.mDeleted;
+    stats.mFailed += elem.second.mFailed;
+    stats.mRate += elem.second.mRate;
+  }
+
+  return stats;
+}
+
+//------------------------------------------------------------------------------
+// Update the deletion rate of a file system queue
+//------------------------------------------------------------------------------
+void
+DeletionEngine::UpdateRate(FsQueue& queue,
+                           std::chrono::steady_clock::time_point now)
+{
+  auto elapsed = now - queue.mRateStart;
+
+  if (elapsed >= sRatePeriod) {
+    queue.mRate = (queue.mDeleted - queue.mRateCount) /
+                  std::chrono::duration<double>(elapsed).count();
+    queue.mRateCount = queue.mDeleted;
+    queue.mRateStart = now;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Take the next batch to process
+//------------------------------------------------------------------------------
+std::unique_ptr<Deletion>
+DeletionEngine::TakeBatch()
+{
+  if (mQueues.empty()) {
+    return nullptr;
+  }
+
+  auto it = mQueues.upper_bound(mLastFsid);
+
+  for (size_t i = 0; i < mQueues.size(); ++i, ++it) {
+    if (it == mQueues.end()) {
+      it = mQueues.begin();
+    }
+
+    FsQueue& queue = it->second;
+
+    if (queue.mPending.empty() || (queue.mNumWorkers >= mThreadsPerFs)) {
+      continue;
+    }
+
+    // Merge consecutive deletions of the same file system and manager until
+    // the batch is full
+    std::vector<unsigned long long> fids;
+    const Deletion& first = *queue.mPending.front();
+    std::unique_ptr<Deletion> batch(new Deletion(fids, first.fsId,
+                                    first.localPrefix.c_str(),
+                                    first.managerId.c_str(),
+                                    first.opaque.c_str()));
+
+    while (!queue.mPending.empty() && (fids.size() < mBatchSize)) {
+      Deletion& front = *queue.mPending.front();
+
+      if (!(front.localPrefix == batch->localPrefix) ||
+          !(front.managerId == batch->managerId)) {
+        break;
+      }
+
+      size_t ntake = std::min(mBatchSize - fids.size(), front.fIdVector.size());
+      fids.insert(fids.end(), front.fIdVector.end() - ntake,
+                  front.fIdVector.end());
+      front.fIdVector.resize(front.fIdVector.size() - ntake);
+
+      if (front.fIdVector.empty()) {
+        queue.mPending.pop_front();
+      }
+    }
+
+    queue.mNumFids -= fids.size();
+    queue.mInFlight += fids.size();
+    ++queue.mNumWorkers;
+    batch->fIdVector = std::move(fids);
+    mLastFsid = it->first;
+    return batch;
+  }
+
+  return nullptr;
+}
+
+//------------------------------------------------------------------------------
+// Worker loop
+//------------------------------------------------------------------------------
+void
+DeletionEngine::Worker(ThreadAssistant& assistant) noexcept
+{
+#ifndef __APPLE__
+
+  if (mIoPriority) {
+    pid_t tid = (pid_t) syscall(SYS_gettid);
+
+    if (syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, tid, mIoPriority)) {
+      eos_warning("msg=\"cannot set io priority of deletion worker\" "
+                  "errno=%d", errno);
+    }
+  }
+
+#endif
+
+  while (!assistant.terminationRequested()) {
+    std::unique_ptr<Deletion> batch;
+    {
+      std::unique_lock<std::mutex> lock(mMutex);
+      batch = TakeBatch();
+
+      if (!batch) {
+        mCv.wait_for(lock, std::chrono::seconds(1));
+        continue;
+      }
+    }
+    uint64_t ndeleted = ProcessBatch(*batch);
+    {
+      std::unique_lock<std::mutex> lock(mMutex);
+      FsQueue& queue = mQueues[batch->fsId];
+      --queue.mNumWorkers;
+      queue.mInFlight -= batch->fIdVector.size();
+      queue.mDeleted += ndeleted;
+      queue.mFailed += batch->fIdVector.size() - ndeleted;
+      UpdateRate(queue, std::chrono::steady_clock::now());
+    }
+    // A worker slot on this file system is free again
+    mCv.notify_one();
+  }
+}
+
+//------------------------------------------------------------------------------
+// Delete all the files of a batch
+//------------------------------------------------------------------------------
+uint64_t
+DeletionEngine::ProcessBatch(Deletion& batch)
+{
+  std::vector<unsigned long long> unlinked;
+  std::vector<std::string> hexfids;
+  unlinked.reserve(batch.fIdVector.size());
+  hexfids.reserve(batch.fIdVector.size());
+  eos_debug("msg=\"deleting batch\" fsid=%lu num_files=%lu", batch.fsId,
+            batch.fIdVector.size());
+
+  for (const auto& fid : batch.fIdVector) {
+    XrdOucString hexstring = "";
+    eos::common::FileId::Fid2Hex(fid, hexstring);
+    XrdOucErrInfo error;
+    XrdOucString OpaqueString = "";
+    OpaqueString += "&mgm.fsid=";
+    OpaqueString += (int) batch.fsId;
+    OpaqueString += "&mgm.fid=";
+    OpaqueString += hexstring;
+    OpaqueString += "&mgm.localprefix=";
+    OpaqueString += batch.localPrefix;
+    XrdOucEnv Opaque(OpaqueString.c_str());
+
+    // The Fmd records are removed below for the whole batch
+    if (gOFS._rem("/DELETION", error, (const XrdSecEntity*) 0, &Opaque,
+                  0, 0, 0, true, false) == SFS_OK) {
+      unlinked.push_back(fid);
+    } else {
+      eos_warning("unable to remove fid %s fsid %lu localprefix=%s",
+                  hexstring.c_str(), batch.fsId, batch.localPrefix.c_str());
+    }
+
+    hexfids.push_back(hexstring.c_str());
+  }
+
+  size_t ndeleted = gFmdDbMapHandler.LocalDeleteFmd(unlinked, batch.fsId);
+
+  if (ndeleted != unlinked.size()) {
+    eos_warning("msg=\"some Fmd records not removed\" fsid=%lu unlinked=%lu "
+                "ndeleted=%lu", batch.fsId, unlinked.size(), ndeleted);
+  }
+
+  // Update the manager with one drop message per list of file ids
+  bool per_fid = false;
+
+  for (const auto& request : BuildDropRequests(batch.fsId, hexfids,
+       batch.localPrefix.c_str())) {
+    XrdOucErrInfo error;
+    XrdOucString capOpaqueString = request.c_str();
+
+    if (gOFS.CallManager(&error, 0, 0 , capOpaqueString) == SFS_OK) {
+      continue;
+    }
+
+    eos_warning("msg=\"batched drop failed, sending one message per file id\" "
+                "fsid=%lu manager=%s", batch.fsId, batch.managerId.c_str());
+    per_fid = true;
+    break;
+  }
+
+  if (per_fid) {
+    // MGMs not yet knowing about mgm.fids reject the batched message
+    for (const auto& hexfid : hexfids) {
+      XrdOucErrInfo error;
+      XrdOucString capOpaqueString = "/?mgm.pcmd=drop";
+      capOpaqueString += "&mgm.fsid=";
+      capOpaqueString += (int) batch.fsId;
+      capOpaqueString += "&mgm.fid=";
+      capOpaqueString += hexfid.c_str();
+      capOpaqueString += "&mgm.localprefix=";
+      capOpaqueString += batch.localPrefix;
+      int rc = gOFS.CallManager(&error, 0, 0 , capOpaqueString);
+
+      if (rc) {
+        eos_err("unable to drop file id %s fsid %u at manager %s",
+                hexfid.c_str(), batch.fsId, batch.managerId.c_str());
+      }
+    }
+  }
+
+  return unlinked.size();
+}
+
+EOSFSTNAMESPACE_END
@@ -0,0 +1,218 @@
+//------------------------------------------------------------------------------
+//! @file DeletionEngine.hh
+//! @brief Engine removing the files scheduled for deletion by the MGM
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2019 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#pragma once
+#include "fst/Namespace.hh"
+#include "common/AssistedThread.hh"
+#include "common/FileSystem.hh"
+#include "common/Logging.hh"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+EOSFSTNAMESPACE_BEGIN
+
+class Deletion;
+
+//------------------------------------------------------------------------------
+//! Class DeletionEngine - keeps one queue of pending deletions per file system
+//! and runs a pool of workers which take batches of file ids from these
+//! queues. At most a configurable number of workers are active on the same
+//! file system so that the deletions of one disk do not starve the others,
+//! and the workers run with a configurable IO priority so that deletions
+//! backlogs don't compete with the client IO. The Fmd records of a batch are
+//! removed together once the files are unlinked.
+//!
+//! Configuration taken from the environment:
+//! EOS_FST_DELETION_THREADS - total number of workers (default 16)
+//! EOS_FST_DELETION_THREADS_PER_FS - max workers per file system (default 2)
+//! EOS_FST_DELETION_BATCH - max number of file ids per batch (default 256)
+//! EOS_FST_DELETION_IOPRIO - IO priority of the workers: "idle", "be:<0-7>"
+//!                           or "rt:<0-7>" (default be:4)
+//------------------------------------------------------------------------------
+class DeletionEngine: public eos::common::LogId
+{
+public:
+  //----------------------------------------------------------------------------
+  //! Deletion statistics of a file system
+  //----------------------------------------------------------------------------
+  struct Stats {
+    uint64_t mBacklog {0}; ///< Number of file ids waiting to be deleted
+    uint64_t mDeleted {0}; ///< Total number of files deleted
+    uint64_t mFailed {0}; ///< Total number of failed deletions
+    double mRate {0}; ///< Deletions per second over the last sampling period
+  };
+
+  //----------------------------------------------------------------------------
+  //! Parse IO priority specification
+  //!
+  //! @param spec priority as "idle", "be:<level>" or "rt:<level>"
+  //! @param ioprio parsed priority value as expected by ioprio_set
+  //!
+  //! @return true if successful, otherwise false
+  //----------------------------------------------------------------------------
+  static bool ParseIoPriority(const std::string& spec, int& ioprio);
+
+  //----------------------------------------------------------------------------
+  //! Build the drop notifications sent to the MGM for a batch, each one
+  //! holding a comma separated list of at most sMaxDropLength characters
+  //!
+  //! @param fsid file system id
+  //! @param hexfids file ids in hex format
+  //! @param local_prefix local prefix of the file system
+  //!
+  //! @return list of opaque strings to be sent with CallManager
+  //----------------------------------------------------------------------------
+  static std::vector<std::string>
+  BuildDropRequests(eos::common::FileSystem::fsid_t fsid,
+                    const std::vector<std::string>& hexfids,
+                    const std::string& local_prefix);
+
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //----------------------------------------------------------------------------
+  DeletionEngine();
+
+  //----------------------------------------------------------------------------
+  //! Destructor
+  //----------------------------------------------------------------------------
+  ~DeletionEngine();
+
+  //----------------------------------------------------------------------------
+  //! Start the worker threads
+  //----------------------------------------------------------------------------
+  void Start();
+
+  //----------------------------------------------------------------------------
+  //! Stop the worker threads, pending deletions are kept
+  //----------------------------------------------------------------------------
+  void Stop();
+
+  //----------------------------------------------------------------------------
+  //! Add deletion to the queue of its file system
+  //!
+  //! @param del deletion object
+  //----------------------------------------------------------------------------
+  void Add(std::unique_ptr<Deletion> del);
+
+  //----------------------------------------------------------------------------
+  //! Get number of file ids waiting to be deleted on all file systems
+  //----------------------------------------------------------------------------
+  uint64_t GetBacklog();
+
+  //----------------------------------------------------------------------------
+  //! Get deletion statistics of a file system
+  //!
+  //! @param fsid file system id
+  //!
+  //! @return statistics object
+  //----------------------------------------------------------------------------
+  Stats GetStats(eos::common::FileSystem::fsid_t fsid);
+
+  //----------------------------------------------------------------------------
+  //! Get aggregated deletion statistics of all file systems
+  //----------------------------------------------------------------------------
+  Stats GetStats();
+
+  //----------------------------------------------------------------------------
+  //! Get number of file ids under which a refill of the queues is requested
+  //----------------------------------------------------------------------------
+  uint64_t GetLowWatermark() const
+  {
+    return mNumThreads * mBatchSize;
+  }
+
+private:
+  //! Period over which the deletion rate is computed
+  static constexpr std::chrono::seconds sRatePeriod {10};
+  //! Max length of the list of file ids in one drop notification
+  static constexpr size_t sMaxDropLength {4096};
+
+  //----------------------------------------------------------------------------
+  //! Per file system queue of deletions
+  //----------------------------------------------------------------------------
+  struct FsQueue {
+    std::deque<std::unique_ptr<Deletion>> mPending; ///< Queued deletions
+    uint64_t mNumFids {0}; ///< Number of file ids in the queued deletions
+    uint64_t mInFlight {0}; ///< Number of file ids being deleted
+    unsigned int mNumWorkers {0}; ///< Number of workers on this file system
+    uint64_t mDeleted {0}; ///< Total number of files deleted
+    uint64_t mFailed {0}; ///< Total number of failed deletions
+    double mRate {0}; ///< Rate computed over the last completed period
+    uint64_t mRateCount {0}; ///< Value of mDeleted at the period start
+    std::chrono::steady_clock::time_point mRateStart; ///< Start of the period
+  };
+
+  unsigned int mNumThreads; ///< Total number of workers
+  unsigned int mThreadsPerFs; ///< Max number of workers per file system
+  size_t mBatchSize; ///< Max number of file ids per batch
+  int mIoPriority; ///< IO priority of the workers, 0 to leave unchanged
+  std::mutex mMutex; ///< Mutex protecting the queues
+  std::condition_variable mCv; ///< Notify workers about new deletions
+  std::map<eos::common::FileSystem::fsid_t, FsQueue> mQueues; ///< Queues
+  //! File system id after which the next worker starts looking for work
+  eos::common::FileSystem::fsid_t mLastFsid;
+  std::vector<std::unique_ptr<AssistedThread>> mWorkers; ///< Worker threads
+
+  //----------------------------------------------------------------------------
+  //! Worker loop
+  //!
+  //! @param assistant thread running the loop
+  //----------------------------------------------------------------------------
+  void Worker(ThreadAssistant& assistant) noexcept;
+
+  //----------------------------------------------------------------------------
+  //! Take the next batch to process, round-robin over the file systems which
+  //! have pending deletions and less than mThreadsPerFs active workers
+  //!
+  //! @return deletion holding at most mBatchSize file ids or nullptr
+  //! @note must be called with mMutex locked
+  //----------------------------------------------------------------------------
+  std::unique_ptr<Deletion> TakeBatch();
+
+  //----------------------------------------------------------------------------
+  //! Delete all the files of a batch
+  //!
+  //! @param batch deletion batch
+  //!
+  //! @return number of files successfully deleted
+  //----------------------------------------------------------------------------
+  uint64_t ProcessBatch(Deletion& batch);
+
+  //----------------------------------------------------------------------------
+  //! Update the deletion rate of a file system queue
+  //!
+  //! @param queue file system queue
+  //! @param now current time
+  //! @note must be called with mMutex locked
+  //----------------------------------------------------------------------------
+  static void UpdateRate(FsQueue& queue,
+                         std::chrono::steady_clock::time_point now);
+};
+
+EOSFSTNAMESPACE_END
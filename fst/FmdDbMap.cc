@@ -51,7 +51,9 @@ using eos::common::LayoutId;
 //------------------------------------------------------------------------------
 // Constructor
 //------------------------------------------------------------------------------
-FmdDbMapHandler::FmdDbMapHandler()
+FmdDbMapHandler::FmdDbMapHandler():
+  mCommitWindow(10), mCommitMaxBatch(1000), mCacheMaxEntries(10000),
+  mCommitThreadRunning(false)
 {
   using eos::common::FileSystem;
   SetLogId("CommonFmdDbMapHandler");
@@ -59,6 +61,26 @@ FmdDbMapHandler::FmdDbMapHandler()
   lvdboption.BloomFilterNbits = 0;
   mFsMtxMap.set_deleted_key(std::numeric_limits<FileSystem::fsid_t>::max() - 2);
   mFsMtxMap.set_empty_key(std::numeric_limits<FileSystem::fsid_t>::max() - 1);
+
+  // Group commit window, setting it to 0 gives back synchronous commits
+  if (getenv("EOS_FST_FMD_COMMIT_WINDOW_MS")) {
+    try {
+      mCommitWindow = std::chrono::milliseconds
+                      (std::stoul(getenv("EOS_FST_FMD_COMMIT_WINDOW_MS")));
+    } catch (...) {}
+  }
+
+  if (getenv("EOS_FST_FMD_COMMIT_BATCH")) {
+    try {
+      mCommitMaxBatch = std::max(1ul, std::stoul(getenv("EOS_FST_FMD_COMMIT_BATCH")));
+    } catch (...) {}
+  }
+
+  if (getenv("EOS_FST_FMD_CACHE_SIZE")) {
+    try {
+      mCacheMaxEntries = std::stoul(getenv("EOS_FST_FMD_CACHE_SIZE"));
+    } catch (...) {}
+  }
 }
 
 //------------------------------------------------------------------------------
@@ -393,6 +415,13 @@ FmdDbMapHandler::SetDBFile(const char* meta_dir, int fsid)
       eos_err("msg=\"failed to insert new db in map, fsid=%lli", fsid);
       return false;
     }
+
+    mCommitState[fsid] = std::make_shared<FsCommitState>(mCacheMaxEntries);
+  }
+
+  if (mCommitWindow.count() && !mCommitThreadRunning) {
+    mCommitThread.reset(&FmdDbMapHandler::CommitLoop, this);
+    mCommitThreadRunning = true;
   }
 
   // Create / or attach the db (try to repair if needed)
@@ -430,9 +459,18 @@ FmdDbMapHandler::ShutdownDB(eos::common::FileSystem::fsid_t fsid, bool do_lock)
   }
 
   if (mDbMap.count(fsid)) {
+    {
+      FsWriteLock fs_wr_lock(fsid);
+
+      if (!FlushPending(fsid)) {
+        eos_err("msg=\"failed to flush queued updates\" fsid=%lu", fsid);
+      }
+    }
+
     if (mDbMap[fsid]->detachDb()) {
       delete mDbMap[fsid];
       mDbMap.erase(fsid);
+      mCommitState.erase(fsid);
       return true;
     }
   }
@@ -592,20 +630,77 @@ bool
 FmdDbMapHandler::LocalDeleteFmd(eos::common::FileId::fileid_t fid,
                                 eos::common::FileSystem::fsid_t fsid)
 {
-  bool rc = true;
-  eos::common::RWMutexReadLock lock(mMapMutex);
-  FsWriteLock wlock(fsid);
+  CommitTicket ticket;
+  {
+    eos::common::RWMutexReadLock lock(mMapMutex);
+    FsWriteLock wlock(fsid);
 
-  if (LocalExistFmd(fid, fsid)) {
-    if (mDbMap[fsid]->remove(eos::common::Slice((const char*)&fid, sizeof(fid)))) {
+    if (!LocalExistFmd(fid, fsid)) {
+      return false;
+    }
+
+    if (!LocalRemoveFmd(fid, fsid, ticket)) {
       eos_err("unable to delete fid=%08llx from fst table", fid);
-      rc = false;
+      return false;
     }
-  } else {
-    rc = false;
   }
+  return WaitCommitted(fsid, ticket);
+}
+//------------------------------------------------------------------------------
+// Delete the records associated with a list of fids and filesystem fsid
+//------------------------------------------------------------------------------
+size_t
+FmdDbMapHandler::LocalDeleteFmd(const
+                                std::vector<eos::common::FileId::fileid_t>& fids,
+                                eos::common::FileSystem::fsid_t fsid)
+{
+  size_t ndeleted = 0;
 
-  return rc;
+  if (fids.empty()) {
+    return ndeleted;
+  }
+
+  CommitTicket ticket;
+  {
+    eos::common::RWMutexReadLock lock(mMapMutex);
+    FsWriteLock wlock(fsid);
+
+    if (!mDbMap.count(fsid)) {
+      return ndeleted;
+    }
+
+    bool sequence = (mCommitWindow.count() == 0);
+
+    if (sequence) {
+      mDbMap[fsid]->beginSetSequence();
+    }
+
+    for (const auto& fid : fids) {
+      if (LocalExistFmd(fid, fsid)) {
+        if (LocalRemoveFmd(fid, fsid, ticket)) {
+          ++ndeleted;
+        } else {
+          eos_err("unable to delete fid=%08llx from fst table", fid);
+        }
+      }
+    }
+
+    // All the removals of the sequence are written in one go and counted
+    if (sequence && (mDbMap[fsid]->endSetSequence() != ndeleted)) {
+      eos_err("msg=\"failed to commit deletions\" fsid=%lu num_fids=%lu",
+              (unsigned long) fsid, ndeleted);
+      return 0;
+    }
+  }
+
+  // The last ticket covers all the deletions queued above
+  if (!WaitCommitted(fsid, ticket)) {
+    eos_err("msg=\"failed to persist deletions\" fsid=%lu num_fids=%lu",
+            (unsigned long) fsid, ndeleted);
+    return 0;
+  }
+
+  return ndeleted;
 }
 
 //------------------------------------------------------------------------------
@@ -634,15 +729,18 @@ FmdDbMapHandler::Commit(FmdHelper* fmd, bool lockit)
   }
 
   if (mDbMap.count(fsid)) {
-    bool res = LocalPutFmd(fid, fsid, fmd->mProtoFmd);
+    CommitTicket ticket;
+    bool res = LocalPutFmd(fid, fsid, fmd->mProtoFmd, ticket);
 
-    // Updateed in-memory
-    if (lockit) {
-      FsUnlockWrite(fsid);
-      mMapMutex.UnLockRead();
+    if (!lockit) {
+      // The caller holds the locks and we cannot wait, write the queue inline
+      return (res && ((ticket.mSeq == 0) || FlushPending(fsid)));
     }
 
-    return res;
+    // Updateed in-memory
+    FsUnlockWrite(fsid);
+    mMapMutex.UnLockRead();
+    return (res && WaitCommitted(fsid, ticket));
   } else {
     eos_crit("no %s DB open for fsid=%llu", eos::common::DbMap::getDbType().c_str(),
              (unsigned long) fsid);
@@ -656,6 +754,283 @@ FmdDbMapHandler::Commit(FmdHelper* fmd, bool lockit)
   return false;
 }
 
+//------------------------------------------------------------------------------
+// Look up Fmd record in the commit queue, the cache and the local database
+//------------------------------------------------------------------------------
+bool
+FmdDbMapHandler::LocalLookupFmd(eos::common::FileId::fileid_t fid,
+                                eos::common::FileSystem::fsid_t fsid, Fmd* fmd)
+{
+  FsCommitState& state = *mCommitState[fsid];
+  {
+    std::unique_lock<std::mutex> lock(state.mMutex);
+    auto it_pend = state.mPending.find(fid);
+
+    if (it_pend != state.mPending.end()) {
+      if (!it_pend->second) {
+        return false;
+      }
+
+      if (fmd) {
+        *fmd = *it_pend->second;
+      }
+
+      return true;
+    }
+
+    if (state.mCache.Get(fid, fmd)) {
+      return true;
+    }
+  }
+  // The record can only change with the file system write-locked so it's
+  // safe to do the DB lookup without holding the state mutex
+  eos::common::DbMap::Tval val;
+
+  if (!mDbMap[fsid]->get(eos::common::Slice((const char*)&fid, sizeof(fid)),
+                         &val)) {
+    return false;
+  }
+
+  Fmd dbfmd;
+  dbfmd.ParseFromString(val.value);
+  {
+    std::unique_lock<std::mutex> lock(state.mMutex);
+    state.mCache.Put(fid, dbfmd);
+  }
+
+  if (fmd) {
+    *fmd = std::move(dbfmd);
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Store Fmd record in the local database or in the commit queue
+//------------------------------------------------------------------------------
+bool
+FmdDbMapHandler::LocalPutFmd(eos::common::FileId::fileid_t fid,
+                             eos::common::FileSystem::fsid_t fsid,
+                             const Fmd& fmd, CommitTicket& ticket)
+{
+  FsCommitState& state = *mCommitState[fsid];
+  ticket.mState.reset();
+  ticket.mSeq = 0;
+
+  if (mCommitWindow.count() == 0) {
+    std::string sval;
+    fmd.SerializePartialToString(&sval);
+
+    if (mDbMap[fsid]->set(eos::common::Slice((const char*)&fid, sizeof(fid)),
+                          sval, "")) {
+      return false;
+    }
+
+    std::unique_lock<std::mutex> lock(state.mMutex);
+    state.mCache.Put(fid, fmd);
+    return true;
+  }
+
+  size_t num_pending = 0;
+  {
+    std::unique_lock<std::mutex> lock(state.mMutex);
+    state.mPending[fid].reset(new Fmd(fmd));
+    state.mCache.Put(fid, fmd);
+    num_pending = state.mPending.size();
+    ticket.mState = mCommitState[fsid];
+    ticket.mSeq = ++state.mQueuedSeq;
+  }
+
+  if (num_pending >= mCommitMaxBatch) {
+    mCommitCv.notify_one();
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Remove Fmd record from the local database or queue its deletion
+//------------------------------------------------------------------------------
+bool
+FmdDbMapHandler::LocalRemoveFmd(eos::common::FileId::fileid_t fid,
+                                eos::common::FileSystem::fsid_t fsid,
+                                CommitTicket& ticket)
+{
+  FsCommitState& state = *mCommitState[fsid];
+  ticket.mState.reset();
+  ticket.mSeq = 0;
+  {
+    std::unique_lock<std::mutex> lock(state.mMutex);
+    state.mCache.Erase(fid);
+
+    if (mCommitWindow.count()) {
+      // A null entry masks the DB record until the deletion is committed
+      state.mPending[fid].reset();
+      ticket.mState = mCommitState[fsid];
+      ticket.mSeq = ++state.mQueuedSeq;
+      return true;
+    }
+  }
+  // Inside a set sequence remove returns the number of queued operations
+  return (mDbMap[fsid]->remove(eos::common::Slice((const char*)&fid,
+                               sizeof(fid))) >= 0);
+}
+
+//------------------------------------------------------------------------------
+// Write all queued updates of a file system in a single batch
+//------------------------------------------------------------------------------
+bool
+FmdDbMapHandler::FlushPending(eos::common::FileSystem::fsid_t fsid)
+{
+  auto it_state = mCommitState.find(fsid);
+
+  if ((it_state == mCommitState.end()) || it_state->second->mPending.empty()) {
+    return true;
+  }
+
+  FsCommitState& state = *it_state->second;
+  std::unordered_map<eos::common::FileId::fileid_t, std::unique_ptr<Fmd>>
+      pending;
+  uint64_t batch_seq = 0;
+  {
+    std::unique_lock<std::mutex> lock(state.mMutex);
+    std::swap(pending, state.mPending);
+    batch_seq = state.mQueuedSeq;
+  }
+  eos::common::DbMap* db_map = mDbMap[fsid];
+  std::string sval;
+  // The set sequence is committed as one LevelDB write batch
+  db_map->beginSetSequence();
+
+  for (const auto& elem : pending) {
+    eos::common::Slice key((const char*)&elem.first, sizeof(elem.first));
+
+    if (elem.second) {
+      elem.second->SerializePartialToString(&sval);
+      db_map->set(key, sval, "");
+    } else {
+      db_map->remove(key);
+    }
+  }
+
+  if (db_map->endSetSequence() != pending.size()) {
+    eos_err("msg=\"failed to commit batch, queued again\" fsid=%lu "
+            "num_updates=%lu", (unsigned long) fsid, pending.size());
+    // Nothing can be queued while we hold the file system write lock so the
+    // whole batch goes back and is retried with the next flush
+    std::unique_lock<std::mutex> lock(state.mMutex);
+
+    for (auto& elem : pending) {
+      state.mPending.emplace(elem.first, std::move(elem.second));
+    }
+
+    return false;
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(state.mMutex);
+    state.mDurableSeq = batch_seq;
+  }
+  eos_debug("msg=\"committed batch\" fsid=%lu num_updates=%lu",
+            (unsigned long) fsid, pending.size());
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Wait until a queued update is written to the local database
+//------------------------------------------------------------------------------
+bool
+FmdDbMapHandler::WaitCommitted(eos::common::FileSystem::fsid_t fsid,
+                               const CommitTicket& ticket)
+{
+  if (ticket.mSeq == 0) {
+    return true;
+  }
+
+  auto is_durable = [&ticket]() {
+    std::unique_lock<std::mutex> lock(ticket.mState->mMutex);
+    return (ticket.mState->mDurableSeq >= ticket.mSeq);
+  };
+
+  if (is_durable()) {
+    return true;
+  }
+
+  // Updates queued while we wait for the file system lock end up in the same
+  // batch and their owners find them already written
+  eos::common::RWMutexReadLock rd_lock(mMapMutex);
+  auto it_state = mCommitState.find(fsid);
+
+  if ((it_state == mCommitState.end()) || (it_state->second != ticket.mState)) {
+    // The DB was detached in the meantime and flushed on the way
+    return is_durable();
+  }
+
+  FsWriteLock fs_wr_lock(fsid);
+
+  if (is_durable()) {
+    return true;
+  }
+
+  return (FlushPending(fsid) && is_durable());
+}
+
+//------------------------------------------------------------------------------
+// Drop all cached records of a file system
+//------------------------------------------------------------------------------
+void
+FmdDbMapHandler::DropCache(eos::common::FileSystem::fsid_t fsid)
+{
+  auto it_state = mCommitState.find(fsid);
+
+  if (it_state != mCommitState.end()) {
+    std::unique_lock<std::mutex> lock(it_state->second->mMutex);
+    it_state->second->mCache.Clear();
+  }
+}
+
+//------------------------------------------------------------------------------
+// Loop flushing the commit queues of all file systems
+//------------------------------------------------------------------------------
+void
+FmdDbMapHandler::CommitLoop(ThreadAssistant& assistant) noexcept
+{
+  eos_static_info("msg=\"starting Fmd group commit thread\" window_ms=%lli "
+                  "max_batch=%lu", (long long) mCommitWindow.count(),
+                  mCommitMaxBatch);
+
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mCommitMutex);
+      mCommitCv.wait_for(lock, mCommitWindow);
+    }
+    eos::common::RWMutexReadLock rd_lock(mMapMutex);
+
+    for (const auto& elem : mCommitState) {
+      {
+        std::unique_lock<std::mutex> lock(elem.second->mMutex);
+
+        if (elem.second->mPending.empty()) {
+          continue;
+        }
+      }
+      FsWriteLock fs_wr_lock(elem.first);
+
+      if (!FlushPending(elem.first)) {
+        eos_static_err("msg=\"failed to flush queued Fmd updates\" fsid=%lu",
+                       (unsigned long) elem.first);
+      }
+    }
+
+    // Last round done after the termination request so that nothing is left
+    if (assistant.terminationRequested()) {
+      break;
+    }
+  }
+
+  eos_static_info("%s", "msg=\"stopped Fmd group commit thread\"");
+}
+
 //------------------------------------------------------------------------------
 // Update fmd from disk i.e. physical file extended attributes
 //------------------------------------------------------------------------------
@@ -676,10 +1051,17 @@ FmdDbMapHandler::UpdateFromDisk(eos::common::FileSystem::fsid_t fsid,
             "fcxerror=%d bcxerror=%d flaglayouterror=%d",
             (unsigned long) fsid, fid, disksize, diskchecksum.c_str(), checktime,
             filecxerror, blockcxerror, flaglayouterror);
-  eos::common::RWMutexReadLock lock(mMapMutex);
-  FsWriteLock vlock(fsid);
+  CommitTicket ticket;
+  {
+    eos::common::RWMutexReadLock lock(mMapMutex);
+    FsWriteLock vlock(fsid);
+
+    if (!mDbMap.count(fsid)) {
+      eos_crit("no %s DB open for fsid=%llu",
+               eos::common::DbMap::getDbType().c_str(), (unsigned long) fsid);
+      return false;
+    }
 
-  if (mDbMap.count(fsid)) {
     Fmd valfmd = LocalRetrieveFmd(fid, fsid);
     // Update in-memory
     valfmd.set_disksize(disksize);
@@ -698,12 +1080,11 @@ FmdDbMapHandler::UpdateFromDisk(eos::common::FileSystem::fsid_t fsid,
       valfmd.set_layouterror(LayoutId::kOrphan);
     }
 
-    return LocalPutFmd(fid, fsid, valfmd);
-  } else {
-    eos_crit("no %s DB open for fsid=%llu", eos::common::DbMap::getDbType().c_str(),
-             (unsigned long) fsid);
-    return false;
+    if (!LocalPutFmd(fid, fsid, valfmd, ticket)) {
+      return false;
+    }
   }
+  return WaitCommitted(fsid, ticket);
 }
 
 //------------------------------------------------------------------------------
@@ -730,10 +1111,17 @@ FmdDbMapHandler::UpdateFromMgm(eos::common::FileSystem::fsid_t fsid,
 
   eos_debug("fsid=%lu fid=%08llx cid=%llu lid=%lx mgmsize=%llu mgmchecksum=%s",
             (unsigned long) fsid, fid, cid, lid, mgmsize, mgmchecksum.c_str());
-  eos::common::RWMutexReadLock lock(mMapMutex);
-  FsWriteLock wlock(fsid);
+  CommitTicket ticket;
+  {
+    eos::common::RWMutexReadLock lock(mMapMutex);
+    FsWriteLock wlock(fsid);
+
+    if (!mDbMap.count(fsid)) {
+      eos_crit("no %s DB open for fsid=%llu",
+               eos::common::DbMap::getDbType().c_str(), (unsigned long) fsid);
+      return false;
+    }
 
-  if (mDbMap.count(fsid)) {
     Fmd valfmd = LocalRetrieveFmd(fid, fsid);
 
     if (!LocalExistFmd(fid, fsid)) {
@@ -762,12 +1150,12 @@ FmdDbMapHandler::UpdateFromMgm(eos::common::FileSystem::fsid_t fsid,
     valfmd.set_checksum(
       std::string(valfmd.checksum()).erase(std::min(valfmd.checksum().length(),
                                            cslen)));
-    return LocalPutFmd(fid, fsid, valfmd);
-  } else {
-    eos_crit("no %s DB open for fsid=%llu", eos::common::DbMap::getDbType().c_str(),
-             (unsigned long) fsid);
-    return false;
+
+    if (!LocalPutFmd(fid, fsid, valfmd, ticket)) {
+      return false;
+    }
   }
+  return WaitCommitted(fsid, ticket);
 }
 
 //------------------------------------------------------------------------------
@@ -780,6 +1168,13 @@ FmdDbMapHandler::ResetDiskInformation(eos::common::FileSystem::fsid_t fsid)
   FsWriteLock wlock(fsid);
 
   if (mDbMap.count(fsid)) {
+    if (!FlushPending(fsid)) {
+      eos_err("unable to flush queued updates for fsid=%lu", fsid);
+      return false;
+    }
+
+    // All the records are rewritten below
+    DropCache(fsid);
     const eos::common::DbMapTypes::Tkey* k;
     const eos::common::DbMapTypes::Tval* v;
     eos::common::DbMapTypes::Tval val;
@@ -824,6 +1219,13 @@ FmdDbMapHandler::ResetMgmInformation(eos::common::FileSystem::fsid_t fsid)
   FsWriteLock vlock(fsid);
 
   if (mDbMap.count(fsid)) {
+    if (!FlushPending(fsid)) {
+      eos_err("unable to flush queued updates for fsid=%lu", fsid);
+      return false;
+    }
+
+    // All the records are rewritten below
+    DropCache(fsid);
     const eos::common::DbMapTypes::Tkey* k;
     const eos::common::DbMapTypes::Tval* v;
     eos::common::DbMapTypes::Tval val;
@@ -1321,12 +1723,18 @@ FmdDbMapHandler::RemoveGhostEntries(const char* path,
   if (!IsSyncing(fsid)) {
     {
       eos::common::RWMutexReadLock rd_lock(mMapMutex);
-      FsReadLock fs_rd_lock(fsid);
 
       if (!mDbMap.count(fsid)) {
         return true;
       }
 
+      {
+        FsWriteLock fs_wr_lock(fsid);
+        (void) FlushPending(fsid);
+      }
+
+      FsReadLock fs_rd_lock(fsid);
+
       const eos::common::DbMapTypes::Tkey* k;
       const eos::common::DbMapTypes::Tval* v;
       eos::common::DbMap* db_map = mDbMap.find(fsid)->second;
@@ -1395,6 +1803,11 @@ FmdDbMapHandler::GetInconsistencyStatistics(eos::common::FileSystem::fsid_t
     return false;
   }
 
+  {
+    FsWriteLock fs_wr_lock(fsid);
+    (void) FlushPending(fsid);
+  }
+
   // query in-memory
   statistics["mem_n"] = 0; // number of files in DB
   statistics["d_sync_n"] = 0; // number of synced files from disk
@@ -1509,6 +1922,14 @@ FmdDbMapHandler::ResetDB(eos::common::FileSystem::fsid_t fsid)
   // Erase the hash entry
   if (mDbMap.count(fsid)) {
     FsWriteLock fs_wr_lock(fsid);
+    {
+      // Queued updates are dropped together with the DB contents
+      FsCommitState& state = *mCommitState[fsid];
+      std::unique_lock<std::mutex> state_lock(state.mMutex);
+      state.mPending.clear();
+      state.mCache.Clear();
+      state.mDurableSeq = state.mQueuedSeq;
+    }
 
     // Delete in the in-memory hash
     if (!mDbMap[fsid]->clear()) {
@@ -1532,6 +1953,10 @@ FmdDbMapHandler::TrimDB()
 {
   for (auto it = mDbMap.begin(); it != mDbMap.end(); ++it) {
     eos_static_info("Trimming fsid=%llu ", it->first);
+    {
+      FsWriteLock fs_wr_lock(it->first);
+      (void) FlushPending(it->first);
+    }
 
     if (!it->second->trimDb()) {
       eos_static_err("Cannot trim the DB file for fsid=%llu ", it->first);
@@ -1552,9 +1977,10 @@ long long
 FmdDbMapHandler::GetNumFiles(eos::common::FileSystem::fsid_t fsid)
 {
   eos::common::RWMutexReadLock lock(mMapMutex);
-  FsReadLock fs_rd_lock(fsid);
+  FsWriteLock fs_wr_lock(fsid);
 
   if (mDbMap.count(fsid)) {
+    (void) FlushPending(fsid);
     return mDbMap[fsid]->size();
   } else {
     return 0ll;
@@ -24,11 +24,19 @@
 #include "fst/Namespace.hh"
 #include "fst/Fmd.hh"
 #include "common/DbMap.hh"
+#include "common/AssistedThread.hh"
 #include "common/FileId.hh"
+#include "common/LruCache.hh"
 #include "common/LayoutId.hh"
 #include "XrdSys/XrdSysPthread.hh"
 #include "namespace/interface/IFileMD.hh"
 #include "namespace/ns_quarkdb/FileMD.hh"
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 #ifdef __APPLE__
 #define ECOMM 70
@@ -167,9 +175,26 @@ public:
                       eos::common::FileSystem::fsid_t fsid);
 
   //----------------------------------------------------------------------------
-  //! Commit modified Fmd record to the local database
+  //! Delete the records associated with a list of fids and filesystem fsid.
+  //! The file system lock is taken only once and without group commits the
+  //! deletions are written to the local database in a single batch.
+  //!
+  //! @param fids list of file ids
+  //! @param fsid filesystem id
+  //!
+  //! @return number of records deleted
+  //----------------------------------------------------------------------------
+  size_t LocalDeleteFmd(const std::vector<eos::common::FileId::fileid_t>& fids,
+                        eos::common::FileSystem::fsid_t fsid);
+
+  //----------------------------------------------------------------------------
+  //! Commit modified Fmd record to the local database. With group commits
+  //! enabled the call returns only once the batch holding the record has been
+  //! written.
   //!
   //! @param fmd pointer to Fmd
+  //! @param lockit if false the caller already holds the mMapMutex and the
+  //!        file system write lock, the queue is then flushed inline
   //!
   //! @return true if record was committed, otherwise false
   //----------------------------------------------------------------------------
@@ -377,6 +402,9 @@ public:
   void
   Shutdown()
   {
+    mCommitThread.join();
+    mCommitThreadRunning = false;
+
     while (!mDbMap.empty()) {
       ShutdownDB(mDbMap.begin()->first);
     }
@@ -402,7 +430,44 @@ public:
   uint32_t GetNumFileSystems() const;
 
 private:
+  //----------------------------------------------------------------------------
+  //! Per file system group commit queue and read-through cache of Fmd records.
+  //! The mutex serializes the readers holding the file system lock for read,
+  //! all the modifications also happen with the file system write-locked.
+  //----------------------------------------------------------------------------
+  struct FsCommitState {
+    FsCommitState(size_t cache_size): mCache(cache_size) {}
+
+    //! Fmd records not yet written to the DB - a null value marks a deletion
+    std::unordered_map<eos::common::FileId::fileid_t, std::unique_ptr<Fmd>>
+        mPending;
+    //! Recently used Fmd records
+    eos::common::LruCache<eos::common::FileId::fileid_t, Fmd> mCache;
+    uint64_t mQueuedSeq {0}; ///< Sequence number of the last queued update
+    uint64_t mDurableSeq {0}; ///< Sequence number of the last written update
+    std::mutex mMutex; ///< Mutex protecting the queue, cache and counters
+  };
+
+  //----------------------------------------------------------------------------
+  //! Handle of a queued update used to wait for it to reach the local DB
+  //----------------------------------------------------------------------------
+  struct CommitTicket {
+    std::shared_ptr<FsCommitState> mState; ///< Queue holding the update
+    uint64_t mSeq {0}; ///< Sequence number of the update, 0 if already written
+  };
+
   std::map<eos::common::FileSystem::fsid_t, eos::common::DbMap*> mDbMap;
+  //! Group commit state for each file system, protected by the mMapMutex
+  std::map<eos::common::FileSystem::fsid_t, std::shared_ptr<FsCommitState>>
+      mCommitState;
+  //! Max time an update waits in the commit queue, 0 means synchronous commits
+  std::chrono::milliseconds mCommitWindow;
+  size_t mCommitMaxBatch; ///< Number of queued updates triggering a commit
+  size_t mCacheMaxEntries; ///< Max number of cached Fmd records per fs
+  AssistedThread mCommitThread; ///< Thread flushing the commit queues
+  bool mCommitThreadRunning; ///< Mark if commit thread started, mMapMutex
+  std::mutex mCommitMutex; ///< Mutex used together with the cond. variable
+  std::condition_variable mCommitCv; ///< Notify the commit thread
   mutable eos::common::RWMutex mMapMutex;//< Mutex protecting the Fmd handler
   eos::common::LvDbDbMapInterface::Option lvdboption;
   std::map<eos::common::FileSystem::fsid_t, bool> mIsSyncing;
@@ -491,10 +556,7 @@ private:
       return false;
     }
 
-    eos::common::DbMap::Tval val;
-    bool retval = mDbMap[fsid]->get(eos::common::Slice((const char*)&fid,
-                                    sizeof(fid)), &val);
-    return retval;
+    return LocalLookupFmd(fid, fsid, nullptr);
   }
 
   //----------------------------------------------------------------------------
@@ -510,32 +572,106 @@ private:
   Fmd LocalRetrieveFmd(eos::common::FileId::fileid_t fid,
                        eos::common::FileSystem::fsid_t fsid)
   {
-    eos::common::DbMap::Tval val;
-    mDbMap[fsid]->get(eos::common::Slice((const char*)&fid, sizeof(fid)), &val);
     Fmd retval;
-    retval.ParseFromString(val.value);
+    (void) LocalLookupFmd(fid, fsid, &retval);
     return retval;
   }
 
   //----------------------------------------------------------------------------
-  //! Store Fmd structure in the local database
+  //! Look up an Fmd record in the commit queue, the cache and finally in the
+  //! local database. Records read from the database are added to the cache.
+  //!
+  //! @param fid file id
+  //! @param fsid filesystem id
+  //! @param fmd if not null, filled with the record found
+  //!
+  //! @return true if the record exists, otherwise false
+  //! @note this function must be called with the mMapMutex locked and also the
+  //! mutex corresponding to the filesystem locked
+  //----------------------------------------------------------------------------
+  bool LocalLookupFmd(eos::common::FileId::fileid_t fid,
+                      eos::common::FileSystem::fsid_t fsid, Fmd* fmd);
+
+  //----------------------------------------------------------------------------
+  //! Store Fmd structure in the local database. If group commits are enabled
+  //! the record is only queued and written later on by the commit thread.
   //!
   //! @param fid file id
   //! @param fsid filesystem id
   //! @param fmd Fmd structure to be saved
+  //! @param ticket handle to be passed to WaitCommitted once the locks are
+  //!        released
   //!
   //! @return true if successful, otherwise false
   //! @note this function must be called with the mMapMutex locked and also the
-  //! mutex corresponding to the filesystem locked
+  //! mutex corresponding to the filesystem write-locked
   //----------------------------------------------------------------------------
   bool LocalPutFmd(eos::common::FileId::fileid_t fid,
-                   eos::common::FileSystem::fsid_t fsid, const Fmd& fmd)
-  {
-    std::string sval;
-    fmd.SerializePartialToString(&sval);
-    return mDbMap[fsid]->set(eos::common::Slice((const char*)&fid, sizeof(fid)),
-                             sval, "") == 0;
-  }
+                   eos::common::FileSystem::fsid_t fsid, const Fmd& fmd,
+                   CommitTicket& ticket);
+
+  //----------------------------------------------------------------------------
+  //! Remove Fmd structure from the local database. If group commits are
+  //! enabled the deletion is only queued and applied later on.
+  //!
+  //! @param fid file id
+  //! @param fsid filesystem id
+  //! @param ticket handle to be passed to WaitCommitted once the locks are
+  //!        released
+  //!
+  //! @return true if successful, otherwise false
+  //! @note this function must be called with the mMapMutex locked and also the
+  //! mutex corresponding to the filesystem write-locked
+  //----------------------------------------------------------------------------
+  bool LocalRemoveFmd(eos::common::FileId::fileid_t fid,
+                      eos::common::FileSystem::fsid_t fsid,
+                      CommitTicket& ticket);
+
+  //----------------------------------------------------------------------------
+  //! Wait until a queued update is written to the local database. If nobody
+  //! is flushing the queue already, the caller writes the whole queue of the
+  //! file system itself so that concurrent updates share the same batch.
+  //!
+  //! @param fsid filesystem id
+  //! @param ticket handle returned when queueing the update
+  //!
+  //! @return true if the update is persisted, otherwise false
+  //! @note this function must be called without holding the mMapMutex or the
+  //! file system lock
+  //----------------------------------------------------------------------------
+  bool WaitCommitted(eos::common::FileSystem::fsid_t fsid,
+                     const CommitTicket& ticket);
+
+  //----------------------------------------------------------------------------
+  //! Write all the queued updates of a file system to the local database in a
+  //! single batch. If the batch fails, the updates are put back in the queue
+  //! and retried with the next flush.
+  //!
+  //! @param fsid filesystem id
+  //!
+  //! @return true if successful, otherwise false
+  //! @note this function must be called with the mMapMutex locked and also the
+  //! mutex corresponding to the filesystem write-locked
+  //----------------------------------------------------------------------------
+  bool FlushPending(eos::common::FileSystem::fsid_t fsid);
+
+  //----------------------------------------------------------------------------
+  //! Drop all the cached records of a file system, used after bulk updates
+  //! done directly on the local database
+  //!
+  //! @param fsid filesystem id
+  //! @note this function must be called with the mMapMutex locked and also the
+  //! mutex corresponding to the filesystem write-locked
+  //----------------------------------------------------------------------------
+  void DropCache(eos::common::FileSystem::fsid_t fsid);
+
+  //----------------------------------------------------------------------------
+  //! Loop flushing the commit queues of all file systems at least once per
+  //! commit window, this also retries the batches that failed
+  //!
+  //! @param assistant thread running the loop
+  //----------------------------------------------------------------------------
+  void CommitLoop(ThreadAssistant& assistant) noexcept;
 
   //----------------------------------------------------------------------------
   //! Execute "fs dumpmd" on the MGM node
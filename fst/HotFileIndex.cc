@@ -0,0 +1,109 @@
+//------------------------------------------------------------------------------
+// File: HotFileIndex.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2019 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "fst/HotFileIndex.hh"
+#include "common/FileId.hh"
+
+EOSFSTNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+// Register a new open handle of a file
+//------------------------------------------------------------------------------
+void
+HotFileIndex::Open(eos::common::FileSystem::fsid_t fsid,
+                   unsigned long long fid)
+{
+  FsIndex& index = mIndex[fsid];
+  unsigned int& handles = index.mHandles[fid];
+
+  if (handles) {
+    index.mOrder.erase(std::make_pair(handles, fid));
+  }
+
+  ++handles;
+  index.mOrder.insert(std::make_pair(handles, fid));
+}
+
+//------------------------------------------------------------------------------
+// Unregister an open handle of a file
+//------------------------------------------------------------------------------
+void
+HotFileIndex::Close(eos::common::FileSystem::fsid_t fsid,
+                    unsigned long long fid)
+{
+  auto it_fs = mIndex.find(fsid);
+
+  if (it_fs == mIndex.end()) {
+    return;
+  }
+
+  FsIndex& index = it_fs->second;
+  auto it = index.mHandles.find(fid);
+
+  if (it == index.mHandles.end()) {
+    return;
+  }
+
+  index.mOrder.erase(std::make_pair(it->second, fid));
+
+  if (--it->second == 0) {
+    index.mHandles.erase(it);
+
+    if (index.mHandles.empty()) {
+      mIndex.erase(it_fs);
+    }
+  } else {
+    index.mOrder.insert(std::make_pair(it->second, fid));
+  }
+}
+
+//------------------------------------------------------------------------------
+// Get the hottest files of a file system
+//------------------------------------------------------------------------------
+std::string
+HotFileIndex::GetHotFiles(eos::common::FileSystem::fsid_t fsid,
+                          size_t max_files) const
+{
+  std::string hot_files;
+  auto it_fs = mIndex.find(fsid);
+
+  if (it_fs == mIndex.end()) {
+    return hot_files;
+  }
+
+  size_t count = 0;
+
+  for (const auto& elem : it_fs->second.mOrder) {
+    if (count++ == max_files) {
+      break;
+    }
+
+    hot_files += std::to_string(elem.first);
+    hot_files += ":";
+    hot_files += eos::common::FileId::Fid2Hex(elem.second);
+    hot_files += " ";
+  }
+
+  return hot_files;
+}
+
+EOSFSTNAMESPACE_END
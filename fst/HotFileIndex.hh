@@ -0,0 +1,97 @@
+//------------------------------------------------------------------------------
+//! @file HotFileIndex.hh
+//! @brief Index of the open files ordered by number of open handles
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2019 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#pragma once
+#include "fst/Namespace.hh"
+#include "common/FileSystem.hh"
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+
+EOSFSTNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! Class HotFileIndex - keeps per file system the open files sorted by the
+//! number of open handles. It is updated on every open and close so that the
+//! list of the hottest files can be produced without walking all the open
+//! files. The class is not thread-safe, the caller is responsible for the
+//! locking.
+//------------------------------------------------------------------------------
+class HotFileIndex
+{
+public:
+  //----------------------------------------------------------------------------
+  //! Register a new open handle of a file
+  //!
+  //! @param fsid file system id
+  //! @param fid file id
+  //----------------------------------------------------------------------------
+  void Open(eos::common::FileSystem::fsid_t fsid, unsigned long long fid);
+
+  //----------------------------------------------------------------------------
+  //! Unregister an open handle of a file
+  //!
+  //! @param fsid file system id
+  //! @param fid file id
+  //----------------------------------------------------------------------------
+  void Close(eos::common::FileSystem::fsid_t fsid, unsigned long long fid);
+
+  //----------------------------------------------------------------------------
+  //! Get the hottest files of a file system
+  //!
+  //! @param fsid file system id
+  //! @param max_files max number of files to list
+  //!
+  //! @return space separated list of <num_handles>:<hex_fid> entries starting
+  //!         with the file having the most open handles
+  //----------------------------------------------------------------------------
+  std::string GetHotFiles(eos::common::FileSystem::fsid_t fsid,
+                          size_t max_files) const;
+
+private:
+  //----------------------------------------------------------------------------
+  //! Order by decreasing number of handles and then by increasing file id
+  //----------------------------------------------------------------------------
+  struct HotterFirst {
+    bool operator()(const std::pair<unsigned int, unsigned long long>& a,
+                    const std::pair<unsigned int, unsigned long long>& b) const
+    {
+      return (a.first != b.first) ? (a.first > b.first) : (a.second < b.second);
+    }
+  };
+
+  //----------------------------------------------------------------------------
+  //! Open files of a file system
+  //----------------------------------------------------------------------------
+  struct FsIndex {
+    //! Number of open handles by file id
+    std::unordered_map<unsigned long long, unsigned int> mHandles;
+    //! Pairs of number of handles and file id, hottest files first
+    std::set<std::pair<unsigned int, unsigned long long>, HotterFirst> mOrder;
+  };
+
+  std::map<eos::common::FileSystem::fsid_t, FsIndex> mIndex; ///< Per fs index
+};
+
+EOSFSTNAMESPACE_END
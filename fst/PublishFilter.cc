@@ -0,0 +1,139 @@
+//------------------------------------------------------------------------------
+// File: PublishFilter.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2019 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "fst/PublishFilter.hh"
+#include <algorithm>
+#include <cmath>
+
+EOSFSTNAMESPACE_BEGIN
+
+constexpr double PublishFilter::kAlways;
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+PublishFilter::PublishFilter(std::chrono::seconds refresh):
+  mRefresh(refresh)
+{}
+
+//------------------------------------------------------------------------------
+// Set relative change threshold for all keys starting with a given prefix
+//------------------------------------------------------------------------------
+void
+PublishFilter::SetThreshold(const std::string& prefix, double threshold)
+{
+  for (auto& elem : mThresholds) {
+    if (elem.first == prefix) {
+      elem.second = threshold;
+      return;
+    }
+  }
+
+  mThresholds.emplace_back(prefix, threshold);
+  std::stable_sort(mThresholds.begin(), mThresholds.end(),
+                   [](const std::pair<std::string, double>& a,
+  const std::pair<std::string, double>& b) {
+    return a.first.length() > b.first.length();
+  });
+}
+
+//------------------------------------------------------------------------------
+// Get threshold of a key
+//------------------------------------------------------------------------------
+double
+PublishFilter::GetThreshold(const std::string& key) const
+{
+  for (const auto& elem : mThresholds) {
+    if (key.compare(0, elem.first.length(), elem.first) == 0) {
+      return elem.second;
+    }
+  }
+
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+// Check if a numeric value needs to be broadcast
+//------------------------------------------------------------------------------
+bool
+PublishFilter::Check(const std::string& key, double value,
+                     std::chrono::steady_clock::time_point now)
+{
+  double threshold = GetThreshold(key);
+  auto it = mEntries.find(key);
+
+  if ((threshold != kAlways) && (it != mEntries.end()) &&
+      (now - it->second.mTimestamp < mRefresh)) {
+    double last = it->second.mNumber;
+
+    if ((value == last) ||
+        (std::fabs(value - last) <= threshold * std::fabs(last))) {
+      return false;
+    }
+  }
+
+  Entry& entry = mEntries[key];
+  entry.mNumber = value;
+  entry.mTimestamp = now;
+  ++mNumKeys;
+  // Values are sent as text, a dozen characters is a fair estimate
+  mNumBytes += key.length() + 12;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Check if a string value needs to be broadcast
+//------------------------------------------------------------------------------
+bool
+PublishFilter::Check(const std::string& key, const std::string& value,
+                     std::chrono::steady_clock::time_point now)
+{
+  auto it = mEntries.find(key);
+
+  if ((GetThreshold(key) != kAlways) && (it != mEntries.end()) &&
+      (now - it->second.mTimestamp < mRefresh) &&
+      (it->second.mValue == value)) {
+    return false;
+  }
+
+  Entry& entry = mEntries[key];
+  entry.mValue = value;
+  entry.mTimestamp = now;
+  ++mNumKeys;
+  mNumBytes += key.length() + value.length();
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Get number of keys approved for broadcast and reset the counters
+//------------------------------------------------------------------------------
+uint64_t
+PublishFilter::TakeCounters(uint64_t& bytes)
+{
+  uint64_t keys = mNumKeys;
+  bytes = mNumBytes;
+  mNumKeys = 0;
+  mNumBytes = 0;
+  return keys;
+}
+
+EOSFSTNAMESPACE_END
@@ -0,0 +1,132 @@
+//------------------------------------------------------------------------------
+//! @file PublishFilter.hh
+//! @brief Decide which of the published statistics need to be broadcast
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2019 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#pragma once
+#include "fst/Namespace.hh"
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+EOSFSTNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! Class PublishFilter - remembers the last broadcast value of every key of a
+//! shared hash and decides if a new value is worth broadcasting. Strings are
+//! broadcast when they change, numbers when the relative change exceeds the
+//! threshold configured for the longest matching key prefix. Every key is
+//! broadcast again once its last broadcast is older than the refresh period
+//! so that listeners which missed an update eventually converge. The class is
+//! not thread-safe.
+//------------------------------------------------------------------------------
+class PublishFilter
+{
+public:
+  //! Threshold marking keys which are broadcast on every cycle
+  static constexpr double kAlways = -1.0;
+
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //!
+  //! @param refresh max time between two broadcasts of the same key
+  //----------------------------------------------------------------------------
+  PublishFilter(std::chrono::seconds refresh);
+
+  //----------------------------------------------------------------------------
+  //! Set relative change threshold for all keys starting with a given prefix
+  //!
+  //! @param prefix key prefix
+  //! @param threshold relative change e.g. 0.05 for 5%, 0 for any change or
+  //!        kAlways to broadcast on every cycle
+  //----------------------------------------------------------------------------
+  void SetThreshold(const std::string& prefix, double threshold);
+
+  //----------------------------------------------------------------------------
+  //! Check if a numeric value needs to be broadcast and if so record it as
+  //! the last broadcast value
+  //!
+  //! @param key key name
+  //! @param value new value
+  //! @param now current time
+  //!
+  //! @return true if value must be broadcast, otherwise false
+  //----------------------------------------------------------------------------
+  bool Check(const std::string& key, double value,
+             std::chrono::steady_clock::time_point now);
+
+  //----------------------------------------------------------------------------
+  //! Check if a string value needs to be broadcast and if so record it as
+  //! the last broadcast value
+  //!
+  //! @param key key name
+  //! @param value new value
+  //! @param now current time
+  //!
+  //! @return true if value must be broadcast, otherwise false
+  //----------------------------------------------------------------------------
+  bool Check(const std::string& key, const std::string& value,
+             std::chrono::steady_clock::time_point now);
+
+  //----------------------------------------------------------------------------
+  //! Forget all broadcast values so that the next cycle broadcasts everything
+  //----------------------------------------------------------------------------
+  void Reset()
+  {
+    mEntries.clear();
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get number of keys approved for broadcast since the last call and reset
+  //! the counters
+  //!
+  //! @param bytes number of key and value bytes approved for broadcast
+  //!
+  //! @return number of keys
+  //----------------------------------------------------------------------------
+  uint64_t TakeCounters(uint64_t& bytes);
+
+private:
+  //----------------------------------------------------------------------------
+  //! Last broadcast value of a key
+  //----------------------------------------------------------------------------
+  struct Entry {
+    std::string mValue; ///< String value
+    double mNumber {0}; ///< Numeric value
+    std::chrono::steady_clock::time_point mTimestamp; ///< Last broadcast
+  };
+
+  std::chrono::seconds mRefresh; ///< Max time between two broadcasts
+  //! Thresholds by key prefix, sorted by decreasing prefix length
+  std::vector<std::pair<std::string, double>> mThresholds;
+  std::map<std::string, Entry> mEntries; ///< Last broadcast values
+  uint64_t mNumKeys {0}; ///< Keys approved since the last TakeCounters
+  uint64_t mNumBytes {0}; ///< Bytes approved since the last TakeCounters
+
+  //----------------------------------------------------------------------------
+  //! Get threshold of a key
+  //----------------------------------------------------------------------------
+  double GetThreshold(const std::string& key) const;
+};
+
+EOSFSTNAMESPACE_END
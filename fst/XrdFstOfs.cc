@@ -1217,7 +1217,8 @@ int
 XrdFstOfs::_rem(const char* path, XrdOucErrInfo& error,
                 const XrdSecEntity* client, XrdOucEnv* capOpaque,
                 const char* fstpath, unsigned long long fid,
-                unsigned long fsid, bool ignoreifnotexist)
+                unsigned long fsid, bool ignoreifnotexist,
+                bool delete_fmd)
 {
   EPNAME("rem");
   XrdOucString fstPath = "";
@@ -1314,7 +1315,7 @@ XrdFstOfs::_rem(const char* path, XrdOucErrInfo& error,
     MakeDeletionReport(fsid, fid, sbd);
   }
 
-  if (!gFmdDbMapHandler.LocalDeleteFmd(fid, fsid)) {
+  if (delete_fmd && !gFmdDbMapHandler.LocalDeleteFmd(fid, fsid)) {
     eos_notice("unable to delete fmd for fid %llu on filesystem %lu", fid, fsid);
     return gOFS.Emsg(epname, error, EIO, "delete file meta data ", fstPath.c_str());
   }
@@ -27,6 +27,7 @@
 #include "fst/Namespace.hh"
 #include "fst/Config.hh"
 #include "fst/Fmd.hh"
+#include "fst/HotFileIndex.hh"
 #include "common/Logging.hh"
 #include "mq/XrdMqMessaging.hh"
 #include "mq/XrdMqSharedObject.hh"
@@ -255,6 +256,9 @@ public:
 
   //----------------------------------------------------------------------------
   //! Remove path - low-level function
+  //!
+  //! @param delete_fmd if false the Fmd record is left to the caller e.g. to
+  //!        remove the records of a batch of deletions at once
   //----------------------------------------------------------------------------
   int _rem(const char* path,
            XrdOucErrInfo& out_error,
@@ -263,7 +267,8 @@ public:
            const char* fstPath = 0,
            unsigned long long fid = 0,
            unsigned long fsid = 0,
-           bool ignoreifnotexist = false);
+           bool ignoreifnotexist = false,
+           bool delete_fmd = true);
 
   //----------------------------------------------------------------------------
   //! Get checksum - we publish checksums at the MGM
@@ -352,6 +357,10 @@ public:
   google::sparse_hash_map<eos::common::FileSystem::fsid_t,
          google::sparse_hash_map<unsigned long long,
          unsigned int> > ROpenFid;
+  //! Open files for write/read sorted by number of handles, used to publish
+  //! the hot file lists - protected by the OpenFidMutex
+  eos::fst::HotFileIndex WHotFiles;
+  eos::fst::HotFileIndex RHotFiles;
   //! Map to forbid deleteOnClose for creates if 1+X open had a successful close
   google::sparse_hash_map<eos::common::FileSystem::fsid_t,
          google::sparse_hash_map<unsigned long long,
@@ -38,6 +38,9 @@
 #include "authz/XrdCapability.hh"
 #include "XrdOss/XrdOssApi.hh"
 #include "fst/io/FileIoPluginCommon.hh"
+#ifdef URING_FOUND
+#include "fst/io/local/IoUring.hh"
+#endif
 
 extern XrdOssSys* XrdOfsOss;
 
@@ -55,7 +58,7 @@ XrdFstOfsFile::XrdFstOfsFile(const char* user, int MonID) :
   writeDelete(false), mRainSize(0), mNsPath(""), mLocalPrefix(""),
   mRedirectManager(""), mSecString(""), mTpcKey(""), mEtag(""), mFileId(0),
   mFsId(0), mLid(0), mCid(0), mForcedMtime(1), mForcedMtime_ms(0), mFusex(false),
-  mFusexIsUnlinked(false),
+  mFusexIsUnlinked(false), mUseIoUring(false),
   closed(false), opened(false), mHasWrite(false), hasWriteError(false),
   hasReadError(false), isRW(false), mIsTpcDst(false), mIsDevNull(false),
   isCreation(false), isReplication(false), mIsInjection(false),
@@ -478,6 +481,21 @@ XrdFstOfsFile::open(const char* path, XrdSfsFileOpenMode open_mode,
     }
   }
 
+#ifdef URING_FOUND
+
+  // Select the local IO engine configured for the filesystem - the io_uring
+  // path bypasses the OSS layer so it's only used without block checksums
+  if (eos::common::LayoutId::GetBlockChecksum(mLid) ==
+      eos::common::LayoutId::kNone) {
+    eos::common::RWMutexReadLock lock(gOFS.Storage->mFsMutex);
+
+    if (gOFS.Storage->mFileSystemsMap.count(mFsId)) {
+      mUseIoUring = IoUring::IsEngineUring
+                    (gOFS.Storage->mFileSystemsMap[mFsId]->GetString("ioengine"));
+    }
+  }
+
+#endif
   XrdOucString oss_opaque = "";
   oss_opaque += "&mgm.lid=";
   oss_opaque += std::to_string(mLid).c_str();
@@ -633,8 +651,10 @@ XrdFstOfsFile::open(const char* path, XrdSfsFileOpenMode open_mode,
 
     if (isRW) {
       gOFS.WOpenFid[mFsId][mFileId]++;
+      gOFS.WHotFiles.Open(mFsId, mFileId);
     } else {
       gOFS.ROpenFid[mFsId][mFileId]++;
+      gOFS.RHotFiles.Open(mFsId, mFileId);
     }
   } else {
     // If we have local errors in open we don't disable the filesystem -
@@ -671,6 +691,8 @@ XrdFstOfsFile::AddReadTime()
                       (lrTime.tv_usec - cTime.tv_usec);
   rTime.tv_sec += (mus / 1000000);
   rTime.tv_usec += (mus % 1000000);
+  XrdSysMutexHelper vecLock(vecMutex);
+  mReadLatency.Add(mus);
 }
 
 //------------------------------------------------------------------------------
@@ -683,6 +705,8 @@ XrdFstOfsFile::AddReadVTime()
                       (lrvTime.tv_usec - cTime.tv_usec);
   rvTime.tv_sec += (mus / 1000000);
   rvTime.tv_usec += (mus % 1000000);
+  XrdSysMutexHelper vecLock(vecMutex);
+  mReadvLatency.Add(mus);
 }
 
 //------------------------------------------------------------------------------
@@ -695,6 +719,8 @@ XrdFstOfsFile::AddWriteTime()
                       lwTime.tv_usec - cTime.tv_usec;
   wTime.tv_sec += (mus / 1000000);
   wTime.tv_usec += (mus % 1000000);
+  XrdSysMutexHelper vecLock(vecMutex);
+  mWriteLatency.Add(mus);
 }
 
 //------------------------------------------------------------------------------
@@ -703,30 +729,9 @@ XrdFstOfsFile::AddWriteTime()
 void
 XrdFstOfsFile::MakeReportEnv(XrdOucString& reportString)
 {
-  // compute avg, min, max, sigma for read and written bytes
-  unsigned long long rmin, rmax, rsum;
-  unsigned long long rvmin, rvmax, rvsum; // readv bytes
-  unsigned long long rsmin, rsmax, rssum; // read single bytes
-  unsigned long rcmin, rcmax, rcsum;      // readv count
-  unsigned long long wmin, wmax, wsum;
-  double rsigma, rvsigma, rssigma, rcsigma, wsigma;
   {
     XrdSysMutexHelper vecLock(vecMutex);
-    ComputeStatistics(rvec, rmin, rmax, rsum, rsigma);
-    ComputeStatistics(wvec, wmin, wmax, wsum, wsigma);
-    ComputeStatistics(monReadvBytes, rvmin, rvmax, rvsum, rvsigma);
-    ComputeStatistics(monReadSingleBytes, rsmin, rsmax, rssum, rssigma);
-    ComputeStatistics(monReadvCount, rcmin, rcmax, rcsum, rcsigma);
     char report[16384];
-
-    if (rmin == 0xffffffff) {
-      rmin = 0;
-    }
-
-    if (wmin == 0xffffffff) {
-      wmin = 0;
-    }
-
     snprintf(report, sizeof(report) - 1,
              "log=%s&path=%s&fstpath=%s&ruid=%u&rgid=%u&td=%s&"
              "host=%s&lid=%lu&fid=%llu&fsid=%lu&"
@@ -740,7 +745,8 @@ XrdFstOfsFile::MakeReportEnv(XrdOucString& reportString)
              "wb=%llu&wb_min=%llu&wb_max=%llu&wb_sigma=%.02f&"
              "sfwdb=%llu&sbwdb=%llu&sxlfwdb=%llu&sxlbwdb=%llu&"
              "nfwds=%lu&nbwds=%lu&nxlfwds=%lu&nxlbwds=%lu&"
-             "rt=%.02f&rvt=%.02f&wt=%.02f&osize=%llu&csize=%llu&%s"
+             "rt=%.02f&rvt=%.02f&wt=%.02f&osize=%llu&csize=%llu&"
+             "rb_hist=%s&wb_hist=%s&rlat_hist=%s&rvlat_hist=%s&wlat_hist=%s&%s"
              , this->logId
              , mCapOpaque->Get("mgm.path") ? mCapOpaque->Get("mgm.path") : mNsPath.c_str()
              , mFstPath.c_str()
@@ -749,14 +755,28 @@ XrdFstOfsFile::MakeReportEnv(XrdOucString& reportString)
              , openTime.tv_sec, (unsigned long) openTime.tv_usec / 1000
              , closeTime.tv_sec, (unsigned long) closeTime.tv_usec / 1000
              , rCalls, wCalls
-             , rsum, rmin, rmax, rsigma
-             , (unsigned long long)monReadvBytes.size(), rvmin, rvmax, rvsum, rvsigma
-             , (unsigned long long)monReadSingleBytes.size(), rsmin, rsmax, rssum, rssigma
-             , rcmin, rcmax, rcsum, rcsigma
-             , wsum
-             , wmin
-             , wmax
-             , wsigma
+             , (unsigned long long) mReadStats.GetSum()
+             , (unsigned long long) mReadStats.GetMin()
+             , (unsigned long long) mReadStats.GetMax()
+             , mReadStats.GetSigma()
+             , (unsigned long long) mReadvStats.GetCount()
+             , (unsigned long long) mReadvStats.GetMin()
+             , (unsigned long long) mReadvStats.GetMax()
+             , (unsigned long long) mReadvStats.GetSum()
+             , mReadvStats.GetSigma()
+             , (unsigned long long) mReadvSingleStats.GetCount()
+             , (unsigned long long) mReadvSingleStats.GetMin()
+             , (unsigned long long) mReadvSingleStats.GetMax()
+             , (unsigned long long) mReadvSingleStats.GetSum()
+             , mReadvSingleStats.GetSigma()
+             , (unsigned long) mReadvCountStats.GetMin()
+             , (unsigned long) mReadvCountStats.GetMax()
+             , (unsigned long) mReadvCountStats.GetSum()
+             , mReadvCountStats.GetSigma()
+             , (unsigned long long) mWriteStats.GetSum()
+             , (unsigned long long) mWriteStats.GetMin()
+             , (unsigned long long) mWriteStats.GetMax()
+             , mWriteStats.GetSigma()
              , sFwdBytes
              , sBwdBytes
              , sXlFwdBytes
@@ -770,6 +790,11 @@ XrdFstOfsFile::MakeReportEnv(XrdOucString& reportString)
              , ((wTime.tv_sec * 1000.0) + (wTime.tv_usec / 1000.0))
              , (unsigned long long) openSize
              , (unsigned long long) closeSize
+             , mReadStats.GetHistogram().ToString().c_str()
+             , mWriteStats.GetHistogram().ToString().c_str()
+             , mReadLatency.ToString().c_str()
+             , mReadvLatency.ToString().c_str()
+             , mWriteLatency.ToString().c_str()
              , eos::common::SecEntity::ToEnv(mSecString.c_str(),
                  ((mTpcFlag == kTpcDstSetup) ||
                   (mTpcFlag == kTpcSrcRead)) ? "tpc" : 0).c_str());
@@ -1347,6 +1372,11 @@ XrdFstOfsFile::close()
               capOpaqueFile += eos::common::OwnCloud::FilterOcQuery(mOpenOpaque->Env(envlen));
             }
 
+            // Add e.g. the S3 multipart upload part information
+            if (mCommitOpaque.length()) {
+              capOpaqueFile += mCommitOpaque.c_str();
+            }
+
             rc = gOFS.CallManager(&error, mCapOpaque->Get("mgm.path"),
                                   mCapOpaque->Get("mgm.manager"), capOpaqueFile);
 
@@ -1472,8 +1502,10 @@ XrdFstOfsFile::close()
         }
 
         gOFS.WOpenFid[fMd->mProtoFmd.fsid()][fMd->mProtoFmd.fid()]--;
+        gOFS.WHotFiles.Close(fMd->mProtoFmd.fsid(), fMd->mProtoFmd.fid());
       } else {
         gOFS.ROpenFid[fMd->mProtoFmd.fsid()][fMd->mProtoFmd.fid()]--;
+        gOFS.RHotFiles.Close(fMd->mProtoFmd.fsid(), fMd->mProtoFmd.fid());
       }
 
       if (gOFS.WOpenFid[fMd->mProtoFmd.fsid()][fMd->mProtoFmd.fid()] <= 0) {
@@ -1847,7 +1879,7 @@ XrdFstOfsFile::readofs(XrdSfsFileOffset fileOffset, char* buffer,
   if (rc > 0) {
     if (layOut->IsEntryServer() || IsRainLayout(mLid)) {
       XrdSysMutexHelper vecLock(vecMutex);
-      rvec.push_back(rc);
+      mReadStats.Add(rc);
     }
 
     rOffset = fileOffset + rc;
@@ -1858,6 +1890,56 @@ XrdFstOfsFile::readofs(XrdSfsFileOffset fileOffset, char* buffer,
   return rc;
 }
 
+//------------------------------------------------------------------------------
+// Get a descriptor of the local file for a zero-copy read
+//------------------------------------------------------------------------------
+int
+XrdFstOfsFile::GetZeroCopyFd()
+{
+  if (isRW || (mTpcFlag == kTpcSrcRead) || gOFS.Simulate_IO_read_error ||
+      (eos::common::LayoutId::GetLayoutType(mLid) !=
+       eos::common::LayoutId::kPlain) ||
+      (eos::common::LayoutId::GetIoType(mFstPath.c_str()) !=
+       eos::common::LayoutId::kLocal)) {
+    return -1;
+  }
+
+  XrdOucErrInfo fd_error;
+
+  if (XrdOfsFile::fctl(SFS_FCTL_GETFD, 0, fd_error)) {
+    return -1;
+  }
+
+  int fd = dup(fd_error.getErrInfo());
+
+  if (fd < 0) {
+    eos_err("msg=\"failed to duplicate file descriptor\" errno=%d", errno);
+    return -1;
+  }
+
+  return fd;
+}
+
+//------------------------------------------------------------------------------
+// Account a range sent from the zero-copy descriptor
+//------------------------------------------------------------------------------
+void
+XrdFstOfsFile::AddZeroCopyRead(off_t offset, off_t length)
+{
+  // Account the range as one read of the whole length
+  gettimeofday(&cTime, &tz);
+  rCalls++;
+
+  if (length > 0) {
+    XrdSysMutexHelper vecLock(vecMutex);
+    mReadStats.Add(length);
+  }
+
+  rOffset = offset + length;
+  gettimeofday(&lrTime, &tz);
+  AddReadTime();
+}
+
 //------------------------------------------------------------------------------
 // Read method
 //------------------------------------------------------------------------------
@@ -1945,7 +2027,40 @@ XrdFstOfsFile::readvofs(XrdOucIOVec* readV, uint32_t readCount)
 {
   eos_debug("read count=%i", readCount);
   gettimeofday(&cTime, &tz);
-  XrdSfsXferSize sz = XrdOfsFile::readv(readV, readCount);
+  XrdSfsXferSize sz = SFS_ERROR;
+  bool done = false;
+#ifdef URING_FOUND
+
+  if (mUseIoUring) {
+    XrdOucErrInfo fd_error;
+    IoUring* ring = IoUring::GetThreadInstance();
+
+    if (ring && !XrdOfsFile::fctl(SFS_FCTL_GETFD, 0, fd_error)) {
+      int64_t expected = 0;
+
+      for (uint32_t i = 0; i < readCount; ++i) {
+        expected += readV[i].size;
+      }
+
+      int64_t nread = ring->ReadV(fd_error.getErrInfo(), readV, readCount);
+      done = true;
+
+      if (nread != expected) {
+        // Same as the OSS vector read, a short read is reported as ESPIPE
+        sz = gOFS.Emsg("readvofs", error, (nread < 0) ? errno : ESPIPE,
+                       "read vector - io_uring read failed fn=", FName());
+      } else {
+        sz = nread;
+      }
+    }
+  }
+
+#endif
+
+  if (!done) {
+    sz = XrdOfsFile::readv(readV, readCount);
+  }
+
   gettimeofday(&lrvTime, &tz);
   AddReadVTime();
   // Collect monitoring info
@@ -1954,11 +2069,11 @@ XrdFstOfsFile::readvofs(XrdOucIOVec* readV, uint32_t readCount)
 
     // If this is the last read of sequential reading, we can verify the checksum
     for (uint32_t i = 0; i < readCount; ++i) {
-      monReadSingleBytes.push_back(readV[i].size);
+      mReadvSingleStats.Add(readV[i].size);
     }
 
-    monReadvBytes.push_back(sz);
-    monReadvCount.push_back(readCount);
+    mReadvStats.Add(sz);
+    mReadvCountStats.Add(readCount);
   }
   return sz;
 }
@@ -2077,7 +2192,7 @@ XrdFstOfsFile::writeofs(XrdSfsFileOffset fileOffset, const char* buffer,
   if (rc > 0) {
     if (layOut->IsEntryServer() || IsRainLayout(mLid)) {
       XrdSysMutexHelper lock(vecMutex);
-      wvec.push_back(rc);
+      mWriteStats.Add(rc);
     }
 
     wOffset = fileOffset + rc;
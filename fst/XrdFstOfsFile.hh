@@ -31,6 +31,7 @@
 #include "fst/checksum/CheckSum.hh"
 #include "fst/storage/Storage.hh"
 #include "common/FileId.hh"
+#include "common/StreamingStatistics.hh"
 #include "XrdOfs/XrdOfs.hh"
 #include "XrdOfs/XrdOfsTPCInfo.hh"
 #include "XrdOuc/XrdOucString.hh"
@@ -323,6 +324,34 @@ public:
     return mIsOCchunk;
   }
 
+  //--------------------------------------------------------------------------
+  //! Get a descriptor of the local file to send a range of a plain layout
+  //! file without copying it through user space (sendfile)
+  //!
+  //! @return duplicated file descriptor to be closed by the caller or -1 if
+  //!         the file has to be read through the layout
+  //--------------------------------------------------------------------------
+  int GetZeroCopyFd();
+
+  //--------------------------------------------------------------------------
+  //! Account a range sent from the descriptor given by GetZeroCopyFd as
+  //! read, a checksum verification on read is skipped
+  //!
+  //! @param offset start of the range
+  //! @param length length of the range
+  //--------------------------------------------------------------------------
+  void AddZeroCopyRead(off_t offset, off_t length);
+
+  //--------------------------------------------------------------------------
+  //! Add opaque information to the commit sent to the MGM on close
+  //!
+  //! @param opaque "&key=value" pairs appended to the commit
+  //--------------------------------------------------------------------------
+  void AddCommitOpaque(const std::string& opaque)
+  {
+    mCommitOpaque += opaque;
+  }
+
   //--------------------------------------------------------------------------
   static int LayoutReadCB(eos::fst::CheckSum::ReadCallBack::callback_data_t* cbd);
   static int FileIoReadCB(eos::fst::CheckSum::ReadCallBack::callback_data_t* cbd);
@@ -355,6 +384,7 @@ protected:
   unsigned long long mForcedMtime_ms;
   bool mFusex; //! indicator that we are commiting from a fusex client
   bool mFusexIsUnlinked; //! indicator for an already unlinked file
+  bool mUseIoUring; //! vector reads go through io_uring (fs ioengine=uring)
   bool closed; //! indicator the file is closed
   bool opened; //! indicator that file is opened
   bool mHasWrite; //! indicator that file was written/modified
@@ -389,6 +419,7 @@ protected:
   std::string mEventRequestor;
   std::string mEventRequestorGroup;
   std::string mEventAttributes;
+  std::string mCommitOpaque; ///< Extra opaque info for the commit to the MGM
 
   enum {
     kOfsIoError = 1, //! generic IO error
@@ -429,11 +460,11 @@ private:
   struct timeval openTime; //! time when a file was opened
   struct timeval closeTime; //! time when a file was closed
   struct timezone tz; //! timezone
-  XrdSysMutex vecMutex; //! mutex protecting the rvec/wvec variables
-  std::vector<unsigned long long>
-  rvec; //! vector with all read  sizes -> to compute sigma,min,max,total
-  std::vector<unsigned long long>
-  wvec; //! vector with all write sizes -> to compute sigma,min,max,total
+  XrdSysMutex vecMutex; //! mutex protecting the I/O statistics below
+  //! read sizes -> sigma,min,max,total in constant memory
+  eos::common::StreamingStatistics mReadStats;
+  //! write sizes -> sigma,min,max,total in constant memory
+  eos::common::StreamingStatistics mWriteStats;
   unsigned long long rBytes; //! sum bytes read
   unsigned long long wBytes; //! sum bytes written
   unsigned long long sFwdBytes; //! sum bytes seeked forward
@@ -450,12 +481,15 @@ private:
   unsigned long nXlBwdSeeks; //! number of seeks backward
   unsigned long long rOffset; //! offset since last read operation on this file
   unsigned long long wOffset; //! offset since last write operation on this file
-  //! vector with all readv sizes -> to compute min,max,etc.
-  std::vector<unsigned long long> monReadvBytes;
-  //! size of each read call coming from readv requests -> to compute min,max, etc.
-  std::vector<unsigned long long> monReadSingleBytes;
-  //! number of individual read op. in each readv call -> to compute min,max, etc.
-  std::vector<unsigned long> monReadvCount;
+  //! readv sizes -> min,max,etc.
+  eos::common::StreamingStatistics mReadvStats;
+  //! size of each read call coming from readv requests -> min,max, etc.
+  eos::common::StreamingStatistics mReadvSingleStats;
+  //! number of individual read op. in each readv call -> min,max, etc.
+  eos::common::StreamingStatistics mReadvCountStats;
+  eos::common::LogHistogram mReadLatency; ///< read latency histogram in us
+  eos::common::LogHistogram mReadvLatency; ///< readv latency histogram in us
+  eos::common::LogHistogram mWriteLatency; ///< write latency histogram in us
 
   struct timeval cTime; ///< current time
   struct timeval lrTime; ///<last read time
@@ -524,46 +558,6 @@ private:
   //--------------------------------------------------------------------------
   void AddWriteTime();
 
-  //--------------------------------------------------------------------------
-  //! Compute general statistics on a set of input values
-  //!
-  //! @param vect input collection
-  //! @param min miniumum element
-  //! @param max maximum element
-  //! @param sum sum of the elements
-  //! @param avg average value
-  //! @param sigma sigma of the elements
-  //--------------------------------------------------------------------------
-  template <typename T>
-  void ComputeStatistics(const std::vector<T>& vect, T& min, T& max,
-                         T& sum, double& sigma)
-  {
-    double avg, sum2;
-    max = sum = sum2 = avg = sigma = 0;
-    min = 0xffffffff;
-    sum = std::accumulate(vect.begin(), vect.end(),
-                          static_cast<unsigned long long>(0));
-    avg = vect.size() ? (1.0 * sum / vect.size()) : 0;
-
-    for (auto it = vect.begin(); it != vect.end(); ++it) {
-      if (*it > max) {
-        max = *it;
-      }
-
-      if (*it < min) {
-        min = *it;
-      }
-
-      sum2 += std::pow((*it - avg), 2);
-    }
-
-    sigma = vect.size() ? (sqrt(sum2 / vect.size())) : 0;
-
-    if (min == 0xffffffff) {
-      min = 0;
-    }
-  }
-
   //----------------------------------------------------------------------------
   //! Create report as a string
   //----------------------------------------------------------------------------
@@ -25,122 +25,31 @@
 #define __EOSFST_ADLER_HH__
 
 #include "fst/Namespace.hh"
-#include "fst/checksum/CheckSum.hh"
+#include "fst/checksum/CombinableCheckSum.hh"
 #include "XrdOuc/XrdOucEnv.hh"
 #include "XrdOuc/XrdOucString.hh"
 #include <zlib.h>
-#include <map>
 
 EOSFSTNAMESPACE_BEGIN
 
-struct ltoff_t {
-
-  bool operator()(off_t s1, off_t s2) const
-  {
-    return (s1 < s2);
-  }
-};
-
-typedef struct {
-  off_t offset;
-  size_t length;
-  unsigned int adler;
-} Chunk;
-
-typedef std::map<off_t, Chunk, ltoff_t> MapChunks;
-typedef std::map<off_t, Chunk, ltoff_t>::iterator IterMap;
-
-class Adler : public CheckSum
+class Adler : public CombinableCheckSum
 {
-private:
-  off_t adleroffset;
-  off_t maxoffset;
-  unsigned int adler;
-  MapChunks map;
-
 public:
-  Adler() : CheckSum("adler")
-  {
-    Reset();
-  }
+  Adler() : CombinableCheckSum("adler", adler32(0L, Z_NULL, 0), Update,
+                                 Combine)
+  { }
 
   unsigned int GetAdler()
   {
-    return adler;
-  }
-
-  bool Add(const char* buffer, size_t length, off_t offset);
-  MapChunks& AddElementToMap(MapChunks& map, Chunk& chunk);
-
-  off_t
-  GetLastOffset()
-  {
-    return adleroffset;
-  }
-
-  off_t
-  GetMaxOffset()
-  {
-    return maxoffset;
-  }
-
-  int
-  GetCheckSumLen()
-  {
-    return sizeof(unsigned int);
-  }
-  void ValidateAdlerMap();
-
-  const char* GetHexChecksum();
-  const char* GetBinChecksum(int& len);
-
-  void Finalize();
-
-  void
-  Reset()
-  {
-    map.clear();
-    adleroffset = 0;
-    adler = adler32(0L, Z_NULL, 0);
-    needsRecalculation = false;
-    maxoffset = 0;
-    finalized = false;
-  }
-
-  void
-  ResetInit(off_t offsetInit, size_t lengthInit, const char* checksumInitHex)
-  {
-    Chunk currChunk;
-    maxoffset = 0;
-    adleroffset = offsetInit + lengthInit;
-
-    // Theck if this is actually a valid pointer or a filled string
-    if ( (checksumInitHex == NULL) || (!strlen(checksumInitHex))) {
-      return;
-    }
-
-    int checksumInitBin = strtol(checksumInitHex, 0, 16);
-
-    // if a file is truncated we get 0,0,<some checksum => reset to 0
-    if (lengthInit != 0) {
-      adler = checksumInitBin;
-    } else {
-      adler = adler32(0L, Z_NULL, 0);
-    }
-
-    fprintf(stderr, "adler is %x\n", adler);
-    currChunk.offset = offsetInit;
-    currChunk.length = lengthInit;
-    currChunk.adler = adler;
-    map.clear();
-    map = AddElementToMap(map, currChunk);
-    maxoffset = (offsetInit + lengthInit);
-    needsRecalculation = false;
+    return mValue;
   }
 
   virtual
   ~Adler() { };
 
+private:
+  static uint32_t Update(uint32_t value, const void* data, size_t length);
+  static uint32_t Combine(uint32_t value1, uint32_t value2, off_t len2);
 };
 
 EOSFSTNAMESPACE_END
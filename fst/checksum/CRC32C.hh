@@ -26,103 +26,44 @@
 
 /*----------------------------------------------------------------------------*/
 #include "fst/Namespace.hh"
-#include "fst/checksum/CheckSum.hh"
+#include "fst/checksum/CombinableCheckSum.hh"
 #include "common/crc32c/crc32c.h"
 /*----------------------------------------------------------------------------*/
 #include "XrdOuc/XrdOucEnv.hh"
 #include "XrdOuc/XrdOucString.hh"
 #include "XrdSys/XrdSysPthread.hh"
-/*----------------------------------------------------------------------------*/
-#include <zlib.h>
-
 /*----------------------------------------------------------------------------*/
 
 EOSFSTNAMESPACE_BEGIN
 
-class CRC32C : public CheckSum
+class CRC32C : public CombinableCheckSum
 {
-private:
-  off_t crc32coffset;
-  uint32_t crcsum;
-  bool finalized;
-
 public:
 
-  CRC32C() : CheckSum("crc32c")
-  {
-    Reset();
-  }
-
-  off_t
-  GetLastOffset()
-  {
-    return crc32coffset;
-  }
-
-  bool
-  Add(const char* buffer, size_t length, off_t offset)
-  {
-    if (offset != crc32coffset) {
-      needsRecalculation = true;
-      return false;
-    }
-
-    crcsum = checksum::crc32c(crcsum, (const Bytef*) buffer, length);
-    crc32coffset += length;
-    return true;
-  }
-
-  const char*
-  GetHexChecksum()
-  {
-    if (!finalized) {
-      Finalize();
-    }
+  CRC32C() : CombinableCheckSum("crc32c",
+                                  checksum::crc32cFinish(checksum::crc32cInit()),
+                                  Update, Combine)
+  { }
 
-    char scrc32[1024];
-    sprintf(scrc32, "%08x", crcsum);
-    Checksum = scrc32;
-    return Checksum.c_str();
-  }
-
-  const char*
-  GetBinChecksum(int& len)
-  {
-    if (!finalized) {
-      Finalize();
-    }
-
-    len = sizeof(unsigned int);
-    return (char*) &crcsum;
-  }
+  virtual
+  ~CRC32C() { };
 
-  int
-  GetCheckSumLen()
-  {
-    return sizeof(unsigned int);
-  }
+private:
 
-  void
-  Reset()
+  //----------------------------------------------------------------------------
+  //! Chunk values are kept finalized so that they can be combined directly
+  //----------------------------------------------------------------------------
+  static uint32_t
+  Update(uint32_t value, const void* data, size_t length)
   {
-    crcsum = checksum::crc32cInit();
-    crc32coffset = 0;
-    needsRecalculation = 0;
-    finalized = false;
+    return checksum::crc32cFinish(checksum::crc32c(~value, data, length));
   }
 
-  void
-  Finalize()
+  static uint32_t
+  Combine(uint32_t value1, uint32_t value2, off_t len2)
   {
-    if (!finalized) {
-      crcsum = checksum::crc32cFinish(crcsum);
-      finalized = true;
-    }
+    return checksum::crc32cCombine(value1, value2, len2);
   }
-
-  virtual
-  ~CRC32C() { };
-
 };
 
 EOSFSTNAMESPACE_END
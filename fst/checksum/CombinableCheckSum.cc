@@ -0,0 +1,206 @@
+// ----------------------------------------------------------------------
+// File: CombinableCheckSum.cc
+// Author: Andreas-Joachim Peters - CERN
+// ----------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2018 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "fst/checksum/CombinableCheckSum.hh"
+#include <iterator>
+
+EOSFSTNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+// Add a block of data at the given offset
+//------------------------------------------------------------------------------
+bool
+CombinableCheckSum::Add(const char* buffer, size_t length, off_t offset)
+{
+  if (offset != mLastOffset) {
+    // Non-sequential access, the chunk map decides at finalize time
+    needsRecalculation = true;
+  }
+
+  finalized = false;
+  mLastOffset = offset + length;
+
+  if (mLastOffset > mMaxOffset) {
+    mMaxOffset = mLastOffset;
+  }
+
+  if (!length || mDirty) {
+    return true;
+  }
+
+  off_t end = offset + length;
+  ChunkMap::iterator next = mChunks.lower_bound(offset);
+
+  // Exact overwrite of a range which was not merged yet
+  if ((next != mChunks.end()) && (next->first == offset) &&
+      (next->second.length == (off_t) length)) {
+    next->second.value = mUpdate(mInit, buffer, length);
+    return true;
+  }
+
+  if ((next != mChunks.end()) && (next->first < end)) {
+    mDirty = true;
+    mChunks.clear();
+    return true;
+  }
+
+  ChunkMap::iterator cur = mChunks.end();
+
+  if (next != mChunks.begin()) {
+    ChunkMap::iterator prev = std::prev(next);
+    off_t prev_end = prev->first + prev->second.length;
+
+    if (prev_end > offset) {
+      mDirty = true;
+      mChunks.clear();
+      return true;
+    }
+
+    if (prev_end == offset) {
+      // Streaming append - continue the running checksum of the previous chunk
+      prev->second.value = mUpdate(prev->second.value, buffer, length);
+      prev->second.length += length;
+      cur = prev;
+    }
+  }
+
+  if (cur == mChunks.end()) {
+    Chunk chunk {(off_t) length, mUpdate(mInit, buffer, length)};
+    cur = mChunks.insert(next, std::make_pair(offset, chunk));
+  }
+
+  // Merge with the following chunk if the gap is now closed
+  if ((next != mChunks.end()) && (next->first == end)) {
+    cur->second.value = mCombine(cur->second.value, next->second.value,
+                                 next->second.length);
+    cur->second.length += next->second.length;
+    mChunks.erase(next);
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Compute the final checksum if the chunks cover the file without holes
+//------------------------------------------------------------------------------
+void
+CombinableCheckSum::Finalize()
+{
+  if (finalized) {
+    return;
+  }
+
+  finalized = true;
+  needsRecalculation = true;
+  mValue = mInit;
+
+  if (mDirty) {
+    return;
+  }
+
+  if (mChunks.empty()) {
+    if (mMaxOffset == 0) {
+      needsRecalculation = false;
+    }
+
+    return;
+  }
+
+  if ((mChunks.size() == 1) && (mChunks.begin()->first == 0) &&
+      (mChunks.begin()->second.length == mMaxOffset)) {
+    mValue = mChunks.begin()->second.value;
+    needsRecalculation = false;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Reset the checksum object
+//------------------------------------------------------------------------------
+void
+CombinableCheckSum::Reset()
+{
+  mChunks.clear();
+  mValue = mInit;
+  mLastOffset = 0;
+  mMaxOffset = 0;
+  mDirty = false;
+  needsRecalculation = false;
+  finalized = false;
+}
+
+//------------------------------------------------------------------------------
+// Reset the checksum object with a known checksum for an initial range
+//------------------------------------------------------------------------------
+void
+CombinableCheckSum::ResetInit(off_t offsetInit, size_t lengthInit,
+                              const char* checksumInitHex)
+{
+  Reset();
+  mLastOffset = offsetInit + lengthInit;
+
+  // Check if this is actually a valid pointer or a filled string
+  if ((checksumInitHex == NULL) || (!strlen(checksumInitHex))) {
+    return;
+  }
+
+  // If a file is truncated we get 0,0,<some checksum> => keep the empty state
+  if (lengthInit != 0) {
+    Chunk chunk {(off_t) lengthInit,
+                 (uint32_t) strtoul(checksumInitHex, 0, 16)};
+    mChunks[offsetInit] = chunk;
+  }
+
+  mMaxOffset = offsetInit + lengthInit;
+}
+
+//------------------------------------------------------------------------------
+// Get the checksum in hex format
+//------------------------------------------------------------------------------
+const char*
+CombinableCheckSum::GetHexChecksum()
+{
+  if (!finalized) {
+    Finalize();
+  }
+
+  char shex[16];
+  snprintf(shex, sizeof(shex), "%08x", mValue);
+  Checksum = shex;
+  return Checksum.c_str();
+}
+
+//------------------------------------------------------------------------------
+// Get the checksum in binary format
+//------------------------------------------------------------------------------
+const char*
+CombinableCheckSum::GetBinChecksum(int& len)
+{
+  if (!finalized) {
+    Finalize();
+  }
+
+  len = sizeof(uint32_t);
+  return (char*) &mValue;
+}
+
+EOSFSTNAMESPACE_END
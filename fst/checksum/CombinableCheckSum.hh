@@ -0,0 +1,136 @@
+// ----------------------------------------------------------------------
+// File: CombinableCheckSum.hh
+// Author: Andreas-Joachim Peters - CERN
+// ----------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2018 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#ifndef __EOSFST_COMBINABLECHECKSUM_HH__
+#define __EOSFST_COMBINABLECHECKSUM_HH__
+
+#include "fst/Namespace.hh"
+#include "fst/checksum/CheckSum.hh"
+#include <stdint.h>
+#include <map>
+
+EOSFSTNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! Base class for 32-bit checksums which can be combined from the checksums
+//! of adjacent blocks (adler32, crc32, crc32c). Every written range keeps its
+//! own partial checksum and neighbouring ranges are merged as soon as they
+//! become contiguous, so out-of-order writes can be finalized without
+//! re-reading the file. Only overlapping writes force a re-scan.
+//------------------------------------------------------------------------------
+class CombinableCheckSum : public CheckSum
+{
+public:
+  //! Continue a checksum value over a buffer
+  typedef uint32_t (*update_t)(uint32_t value, const void* data, size_t length);
+  //! Combine the checksums of two adjacent blocks, len2 is the second's size
+  typedef uint32_t (*combine_t)(uint32_t value1, uint32_t value2, off_t len2);
+
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //!
+  //! @param name checksum name
+  //! @param init checksum value of an empty block
+  //! @param update function continuing a checksum over a buffer
+  //! @param combine function combining two adjacent block checksums
+  //----------------------------------------------------------------------------
+  CombinableCheckSum(const char* name, uint32_t init, update_t update,
+                     combine_t combine):
+    CheckSum(name), mInit(init), mUpdate(update), mCombine(combine)
+  {
+    Reset();
+  }
+
+  virtual ~CombinableCheckSum() {};
+
+  bool Add(const char* buffer, size_t length, off_t offset);
+
+  void Finalize();
+
+  void Reset();
+
+  void ResetInit(off_t offsetInit, size_t lengthInit,
+                 const char* checksumInitHex);
+
+  void
+  SetDirty()
+  {
+    mDirty = true;
+    needsRecalculation = true;
+  }
+
+  const char* GetHexChecksum();
+
+  const char* GetBinChecksum(int& len);
+
+  off_t
+  GetLastOffset()
+  {
+    return mLastOffset;
+  }
+
+  off_t
+  GetMaxOffset()
+  {
+    return mMaxOffset;
+  }
+
+  int
+  GetCheckSumLen()
+  {
+    return sizeof(uint32_t);
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get the number of disjoint ranges currently tracked
+  //----------------------------------------------------------------------------
+  size_t
+  GetNumChunks() const
+  {
+    return mChunks.size();
+  }
+
+protected:
+  uint32_t mValue; ///< final checksum value, valid after Finalize
+
+private:
+  struct Chunk {
+    off_t length;
+    uint32_t value;
+  };
+
+  //! Map from chunk start offset to chunk, chunks never overlap
+  typedef std::map<off_t, Chunk> ChunkMap;
+
+  uint32_t mInit;
+  update_t mUpdate;
+  combine_t mCombine;
+  ChunkMap mChunks;
+  off_t mLastOffset; ///< end offset of the last added block
+  off_t mMaxOffset; ///< largest end offset seen
+  bool mDirty; ///< sticky flag - the chunk map can not produce the checksum
+};
+
+EOSFSTNAMESPACE_END
+
+#endif
@@ -180,6 +180,7 @@ HttpHandler::HandleRequest(eos::common::HttpRequest* request)
   if (request->GetMethod() == "GET") {
     // call the HttpHandler::Get method
     mHttpResponse = Get(request);
+    UseZeroCopy(mHttpResponse);
   }
 
   if (request->GetMethod() == "PUT") {
@@ -351,6 +352,34 @@ HttpHandler::Get(eos::common::HttpRequest* request)
   return response;
 }
 
+/*----------------------------------------------------------------------------*/
+void
+HttpHandler::UseZeroCopy(eos::common::HttpResponse* response)
+{
+#if defined(EOS_MICRO_HTTPD) && (MHD_VERSION >= 0x00094400)
+  const char* sendfile = getenv("EOS_HTTP_SENDFILE");
+
+  if (!response || !mFile || !response->mUseFileReaderCallback ||
+      (sendfile && !strcmp(sendfile, "0")) ||
+      (mRangeRequest && (mOffsetMap.size() != 1))) {
+    return;
+  }
+
+  off_t offset = mRangeRequest ? mOffsetMap.begin()->first : 0;
+  int fd = mFile->GetZeroCopyFd();
+
+  if (fd >= 0) {
+    eos_static_debug("msg=\"zero-copy response\" offset=%llu length=%llu",
+                     (unsigned long long) offset,
+                     (unsigned long long) mRequestSize);
+    response->mResponseFd = fd;
+    response->mResponseFdOffset = offset;
+    response->mResponseLength = mRequestSize;
+  }
+
+#endif
+}
+
 /*----------------------------------------------------------------------------*/
 eos::common::HttpResponse*
 HttpHandler::Head(eos::common::HttpRequest* request)
@@ -161,6 +161,17 @@ public:
     return mPrint.c_str();
   }
 
+  /**
+   * Let a GET response be sent from the local file with sendfile instead of
+   * the read callbacks. This is done for plain layout files on a local disk
+   * if at most one range is requested, unless EOS_HTTP_SENDFILE=0. Needs
+   * libmicrohttpd 0.9.44 or newer for responses from a file offset.
+   *
+   * @param response  the response of the GET request
+   */
+  void
+  UseZeroCopy (eos::common::HttpResponse *response);
+
   /**
    * Create the map of multipart headers for each offset/length pair
    *
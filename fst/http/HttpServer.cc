@@ -150,10 +150,41 @@ HttpServer::Handler(void* cls,
 
   if (response->mUseFileReaderCallback) {
     eos_static_debug("response length=%d", response->mResponseLength);
-    mhdResponse = MHD_create_response_from_callback(response->mResponseLength,
-                  4 * 1024 * 1024, /* 4M page size */
-                  &HttpServer::FileReaderCallback,
-                  (void*) protocolHandler, 0);
+    mhdResponse = 0;
+#if MHD_VERSION >= 0x00094400
+
+    if (response->mResponseFd >= 0) {
+      // libmicrohttpd sends the file with sendfile and closes the descriptor
+      // once the response is destroyed
+      mhdResponse = MHD_create_response_from_fd_at_offset64(
+                      response->mResponseLength, response->mResponseFd,
+                      response->mResponseFdOffset);
+      eos::fst::HttpHandler* httpHandle = dynamic_cast<eos::fst::HttpHandler*>
+                                          (protocolHandler);
+
+      if (mhdResponse) {
+        response->mResponseFd = -1;
+
+        if (httpHandle && httpHandle->mFile) {
+          httpHandle->mFile->AddZeroCopyRead(response->mResponseFdOffset,
+                                             response->mResponseLength);
+        }
+      } else {
+        // The file is read through the callbacks instead
+        eos_static_warning("msg=\"failed to create zero-copy response\"");
+        close(response->mResponseFd);
+        response->mResponseFd = -1;
+      }
+    }
+
+#endif
+
+    if (!mhdResponse) {
+      mhdResponse = MHD_create_response_from_callback(response->mResponseLength,
+                    4 * 1024 * 1024, /* 4M page size */
+                    &HttpServer::FileReaderCallback,
+                    (void*) protocolHandler, 0);
+    }
   } else {
     mhdResponse = MHD_create_response_from_buffer(response->GetBodySize(),
                   (void*) response->GetBody().c_str(),
@@ -29,6 +29,7 @@
 #include "common/http/s3/S3Response.hh"
 #include "common/Logging.hh"
 /*----------------------------------------------------------------------------*/
+#include "XrdOuc/XrdOucEnv.hh"
 /*----------------------------------------------------------------------------*/
 #include <string>
 #include <map>
@@ -67,9 +68,22 @@ S3Handler::HandleRequest(eos::common::HttpRequest* request)
     mode_t create_mode = 0;
 
     if (request->GetMethod() == "PUT") {
+      // a multipart upload part is placed by the MGM at its final offset
+      XrdOucEnv partEnv(request->GetQuery().c_str());
+
+      if (partEnv.Get("eos.s3.part") && partEnv.Get("eos.s3.offset")) {
+        mPartNumber = atoi(partEnv.Get("eos.s3.part"));
+        mPartOffset = strtoll(partEnv.Get("eos.s3.offset"), 0, 10);
+      }
+
       // use the proper creation/open flags for PUT's
       open_mode |= SFS_O_CREAT;
-      open_mode |= SFS_O_TRUNC;
+
+      // parts are written in parallel into the same file, never truncate
+      if (!mPartNumber) {
+        open_mode |= SFS_O_TRUNC;
+      }
+
       open_mode |= SFS_O_RDWR;
       open_mode |= SFS_O_MKPTH;
       create_mode |= (SFS_O_MKPTH | S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
@@ -80,6 +94,13 @@ S3Handler::HandleRequest(eos::common::HttpRequest* request)
                       create_mode,
                       &mClient,
                       request->GetQuery().c_str());
+
+    if ((mRc == SFS_OK) && mPartNumber) {
+      // the file checksum can not follow parallel parts, it is combined from
+      // the part checksums when the upload is completed
+      mFile->fctl(SFS_FCTL_SPEC1, strlen("nochecksum"), "nochecksum", &mClient);
+    }
+
     mFileSize = mFile->getOpenSize();
     mFileId = mFile->getFileId();
     mLogId = mFile->logId;
@@ -107,6 +128,7 @@ S3Handler::HandleRequest(eos::common::HttpRequest* request)
   if (request->GetMethod() == "GET") {
     // call the HttpHandler::Get method
     mHttpResponse = Get(request);
+    UseZeroCopy(mHttpResponse);
   }
 
   if (request->GetMethod() == "PUT") {
@@ -236,9 +258,16 @@ S3Handler::Put(eos::common::HttpRequest* request)
     size_t* bodySize = request->GetBodySize();
 
     if (request->GetBody().c_str() && bodySize && (*bodySize)) {
-      size_t stored = mFile->write(mCurrentCallbackOffset,
+      size_t stored = mFile->write(mPartOffset + mCurrentCallbackOffset,
                                    request->GetBody().c_str(), *bodySize);
 
+      if (mPartNumber) {
+        mPartMD5.Add(request->GetBody().c_str(), *bodySize,
+                     mCurrentCallbackOffset);
+        mPartAdler.Add(request->GetBody().c_str(), *bodySize,
+                       mCurrentCallbackOffset);
+      }
+
       if (stored != *bodySize) {
         // S3 write error
         response = RestErrorResponse(500, "InternalError", "File currently "
@@ -255,6 +284,21 @@ S3Handler::Put(eos::common::HttpRequest* request)
       }
     } else {
       eos_static_info("entering close handler");
+      std::string partETag;
+
+      if (mPartNumber) {
+        // report the part to the MGM with the commit of this close
+        mPartMD5.Finalize();
+        partETag = mPartMD5.GetHexChecksum();
+        char partInfo[1024];
+        snprintf(partInfo, sizeof(partInfo) - 1,
+                 "&mgm.s3.part=%d&mgm.s3.offset=%lld&mgm.s3.size=%lld"
+                 "&mgm.s3.md5=%s&mgm.s3.adler=%s", mPartNumber,
+                 (long long) mPartOffset, (long long) mCurrentCallbackOffset,
+                 partETag.c_str(), mPartAdler.GetHexChecksum());
+        mFile->AddCommitOpaque(partInfo);
+      }
+
       mCloseCode = mFile->close();
 
       if (mCloseCode) {
@@ -263,6 +307,11 @@ S3Handler::Put(eos::common::HttpRequest* request)
         mCloseCode = 0; // we don't want to create a second response down
       } else {
         response = new eos::common::PlainHttpResponse();
+
+        if (mPartNumber) {
+          response->AddHeader("ETag", "\"" + partETag + "\"");
+        }
+
         return response;
       }
     }
@@ -33,6 +33,8 @@
 /*----------------------------------------------------------------------------*/
 #include "common/http/s3/S3Handler.hh"
 #include "fst/http/HttpHandler.hh"
+#include "fst/checksum/Adler.hh"
+#include "fst/checksum/MD5.hh"
 #include "fst/Namespace.hh"
 /*----------------------------------------------------------------------------*/
 /*----------------------------------------------------------------------------*/
@@ -47,12 +49,18 @@ class S3Store;
 class S3Handler : public eos::common::S3Handler, public eos::fst::HttpHandler
 {
 
+private:
+  int             mPartNumber;   //!< part number of a multipart upload part, 0 otherwise
+  off_t           mPartOffset;   //!< file offset of the part assigned by the MGM
+  eos::fst::MD5   mPartMD5;      //!< MD5 of the part data, used as part ETag
+  eos::fst::Adler mPartAdler;    //!< adler32 of the part data, combined by the MGM
+
 public:
 
   /**
    * Constructor
    */
-  S3Handler () {};
+  S3Handler () : mPartNumber(0), mPartOffset(0) {};
 
   /**
    * Destructor
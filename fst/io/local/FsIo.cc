@@ -24,6 +24,11 @@
 #include "fst/XrdFstOfsFile.hh"
 #include "fst/io/local/FsIo.hh"
 #include "common/XattrCompat.hh"
+#include "XrdOuc/XrdOucEnv.hh"
+
+#ifdef URING_FOUND
+#include "fst/io/local/IoUring.hh"
+#endif
 
 #ifndef __APPLE__
 #include <xfs/xfs.h>
@@ -37,7 +42,7 @@ EOSFSTNAMESPACE_BEGIN
 // Constructor
 //------------------------------------------------------------------------------
 FsIo::FsIo(std::string path) :
-  FileIo(path, "FsIo"), mFd(-1)
+  FileIo(path, "FsIo"), mFd(-1), mUseIoUring(false)
 {
 }
 
@@ -45,7 +50,7 @@ FsIo::FsIo(std::string path) :
 // Constructor
 //------------------------------------------------------------------------------
 FsIo::FsIo(std::string path, std::string iotype) :
-  FileIo(path, iotype), mFd(-1)
+  FileIo(path, iotype), mFd(-1), mUseIoUring(false)
 {
 }
 
@@ -59,6 +64,23 @@ FsIo::~FsIo()
   }
 }
 
+//------------------------------------------------------------------------------
+// Select the engine used for the vector and async IO operations
+//------------------------------------------------------------------------------
+void
+FsIo::SetIoEngine(const std::string& engine)
+{
+#ifdef URING_FOUND
+  mUseIoUring = IoUring::IsEngineUring(engine);
+#else
+
+  if (engine == "uring") {
+    eos_warning("msg=\"built without io_uring support, using pread/pwrite\"");
+  }
+
+#endif
+}
+
 //------------------------------------------------------------------------------
 // Open file
 //------------------------------------------------------------------------------
@@ -66,6 +88,15 @@ int
 FsIo::fileOpen(XrdSfsFileOpenMode flags, mode_t mode, const std::string& opaque,
 	       uint16_t timeout)
 {
+  if (!opaque.empty()) {
+    XrdOucEnv env(opaque.c_str());
+    const char* val = env.Get("eos.ioengine");
+
+    if (val) {
+      SetIoEngine(val);
+    }
+  }
+
   mFd = ::open(mFilePath.c_str(), flags, mode);
 
   if (mFd > 0) {
@@ -97,22 +128,88 @@ FsIo::fileWrite(XrdSfsFileOffset offset, const char* buffer,
 }
 
 //------------------------------------------------------------------------------
-// Read from file async - falls back on synchronous mode
+// Vector read - sync
+//------------------------------------------------------------------------------
+int64_t
+FsIo::fileReadV(XrdCl::ChunkList& chunkList, uint16_t timeout)
+{
+#ifdef URING_FOUND
+
+  if (mUseIoUring) {
+    IoUring* ring = IoUring::GetThreadInstance();
+
+    if (ring) {
+      return ring->ReadV(mFd, chunkList);
+    }
+  }
+
+#endif
+  int64_t nread = 0;
+
+  for (auto& chunk : chunkList) {
+    int64_t nbytes = ::pread(mFd, chunk.buffer, chunk.length, chunk.offset);
+
+    if (nbytes < 0) {
+      return -1;
+    }
+
+    nread += nbytes;
+  }
+
+  return nread;
+}
+
+//------------------------------------------------------------------------------
+// Vector read - async - with io_uring the chunks are submitted as one batch
+// and the call returns once all of them completed
+//------------------------------------------------------------------------------
+int64_t
+FsIo::fileReadVAsync(XrdCl::ChunkList& chunkList, uint16_t timeout)
+{
+  return fileReadV(chunkList, timeout);
+}
+
+//------------------------------------------------------------------------------
+// Read from file async - goes through the ring if enabled, otherwise falls
+// back on synchronous mode
 //------------------------------------------------------------------------------
 int64_t
 FsIo::fileReadAsync(XrdSfsFileOffset offset, char* buffer,
 		    XrdSfsXferSize length, bool readahead, uint16_t timeout)
 {
+#ifdef URING_FOUND
+
+  if (mUseIoUring) {
+    IoUring* ring = IoUring::GetThreadInstance();
+
+    if (ring) {
+      return ring->Read(mFd, offset, buffer, length);
+    }
+  }
+
+#endif
   return fileRead(offset, buffer, length, timeout);
 }
 
 //------------------------------------------------------------------------------
-// Write to file async - falls back on synchronous mode
+// Write to file async - goes through the ring if enabled, otherwise falls
+// back on synchronous mode
 //------------------------------------------------------------------------------
 int64_t
 FsIo::fileWriteAsync(XrdSfsFileOffset offset, const char* buffer,
 		     XrdSfsXferSize length, uint16_t timeout)
 {
+#ifdef URING_FOUND
+
+  if (mUseIoUring) {
+    IoUring* ring = IoUring::GetThreadInstance();
+
+    if (ring) {
+      return ring->Write(mFd, offset, buffer, length);
+    }
+  }
+
+#endif
   return fileWrite(offset, buffer, length, timeout);
 }
 
@@ -54,12 +54,21 @@ public:
   //----------------------------------------------------------------------------
   virtual ~FsIo();
 
+  //----------------------------------------------------------------------------
+  //! Select the engine used for the vector and async IO operations
+  //!
+  //! @param engine "uring" to use io_uring if available, anything else
+  //!        selects the classic pread/pwrite path
+  //----------------------------------------------------------------------------
+  void SetIoEngine(const std::string& engine);
+
   //----------------------------------------------------------------------------
   //! Open file
   //!
   //! @param flags open flags
   //! @param mode open mode
-  //! @param opaque opaque information
+  //! @param opaque opaque information, "eos.ioengine=uring" selects the
+  //!        io_uring engine for this file
   //! @param timeout timeout value
   //!
   //! @return 0 if successful, -1 otherwise and error code is set
@@ -125,11 +134,7 @@ public:
   //! @return number of bytes read of -1 if error
   //----------------------------------------------------------------------------
   virtual int64_t fileReadV(XrdCl::ChunkList& chunkList,
-                            uint16_t timeout = 0)
-  {
-    errno = EOPNOTSUPP;
-    return -1;
-  }
+                            uint16_t timeout = 0);
 
   //----------------------------------------------------------------------------
   //! Vector read - async
@@ -140,11 +145,7 @@ public:
   //! @return 0(SFS_OK) if request successfully sent, otherwise -1 (SFS_ERROR)
   //----------------------------------------------------------------------------
   virtual int64_t fileReadVAsync(XrdCl::ChunkList& chunkList,
-                                 uint16_t timeout = 0)
-  {
-    errno = EOPNOTSUPP;
-    return -1;
-  }
+                                 uint16_t timeout = 0);
 
   //----------------------------------------------------------------------------
   //! Write to file - async
@@ -387,6 +388,7 @@ public:
 
 private:
   int mFd; //< file descriptor to filesystem file
+  bool mUseIoUring; //< mark if IO is to be done through io_uring
 
   //----------------------------------------------------------------------------
   //! Disable copy constructor
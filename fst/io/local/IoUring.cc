@@ -0,0 +1,398 @@
+//------------------------------------------------------------------------------
+// File: IoUring.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2019 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "fst/io/local/IoUring.hh"
+#include "common/Logging.hh"
+#include <algorithm>
+#include <memory>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+EOSFSTNAMESPACE_BEGIN
+
+std::atomic<int> IoUring::sSupported {-1};
+
+//------------------------------------------------------------------------------
+// Get the ring of the calling thread, creating it if needed
+//------------------------------------------------------------------------------
+IoUring*
+IoUring::GetThreadInstance()
+{
+  static thread_local std::unique_ptr<IoUring> tlRing;
+  static thread_local bool tlFailed = false;
+
+  if (tlFailed || (sSupported == 0)) {
+    return nullptr;
+  }
+
+  if (tlRing) {
+    return (tlRing->mBroken ? nullptr : tlRing.get());
+  }
+
+  std::unique_ptr<IoUring> ring(new IoUring());
+  int retc = ring->Init();
+
+  if (retc) {
+    tlFailed = true;
+
+    if ((retc == -ENOSYS) || (retc == -EPERM) || (retc == -EOPNOTSUPP)) {
+      if (sSupported.exchange(0) != 0) {
+        eos_static_warning("msg=\"io_uring not supported by the kernel, using "
+                           "pread/pwrite\" errc=%d", -retc);
+      }
+    } else {
+      eos_static_err("msg=\"failed to set up io_uring\" errc=%d", -retc);
+    }
+
+    return nullptr;
+  }
+
+  // Don't overwrite the verdict of a thread that found io_uring unusable
+  int expected = -1;
+  sSupported.compare_exchange_strong(expected, 1);
+  tlRing = std::move(ring);
+  return tlRing.get();
+}
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+IoUring::IoUring():
+  mInitialized(false), mBroken(false), mFixedRegistered(false),
+  mFixedMemory(nullptr)
+{
+  memset(&mRing, 0, sizeof(mRing));
+}
+
+//------------------------------------------------------------------------------
+// Destructor
+//------------------------------------------------------------------------------
+IoUring::~IoUring()
+{
+  if (mFixedRegistered) {
+    (void) io_uring_unregister_buffers(&mRing);
+  }
+
+  if (mInitialized) {
+    io_uring_queue_exit(&mRing);
+  }
+
+  free(mFixedMemory);
+}
+
+//------------------------------------------------------------------------------
+// Set up the ring and register the fixed buffers
+//------------------------------------------------------------------------------
+int
+IoUring::Init()
+{
+  int retc = io_uring_queue_init(kQueueDepth, &mRing, 0);
+
+  if (retc < 0) {
+    return retc;
+  }
+
+  mInitialized = true;
+  // Kernels older than 5.6 have no IORING_OP_READ/WRITE and no probe
+  struct io_uring_probe* probe = io_uring_get_probe_ring(&mRing);
+  bool supported = (probe &&
+                    io_uring_opcode_supported(probe, IORING_OP_READ) &&
+                    io_uring_opcode_supported(probe, IORING_OP_WRITE) &&
+                    io_uring_opcode_supported(probe, IORING_OP_READ_FIXED));
+  free(probe);
+
+  if (!supported) {
+    return -EOPNOTSUPP;
+  }
+
+  // Failing to register the buffers (e.g. because of a low RLIMIT_MEMLOCK)
+  // is not fatal, the reads then go directly into the caller's buffer
+  if (posix_memalign((void**)&mFixedMemory, getpagesize(),
+                     kNumFixedBuffers * kFixedBufferSize) == 0) {
+    mFixedBuffers.resize(kNumFixedBuffers);
+
+    for (unsigned i = 0; i < kNumFixedBuffers; ++i) {
+      mFixedBuffers[i].iov_base = mFixedMemory + i * kFixedBufferSize;
+      mFixedBuffers[i].iov_len = kFixedBufferSize;
+    }
+
+    retc = io_uring_register_buffers(&mRing, mFixedBuffers.data(),
+                                     mFixedBuffers.size());
+
+    if (retc == 0) {
+      mFixedRegistered = true;
+    } else {
+      eos_static_info("msg=\"io_uring buffer registration failed\" errc=%d",
+                      -retc);
+    }
+  }
+
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+// Vector read
+//------------------------------------------------------------------------------
+int64_t
+IoUring::ReadV(int fd, XrdCl::ChunkList& chunks)
+{
+  std::vector<Request> reqs;
+  reqs.reserve(chunks.size());
+
+  for (auto& chunk : chunks) {
+    reqs.push_back({(off_t) chunk.offset, (size_t) chunk.length,
+                    (char*) chunk.buffer});
+  }
+
+  return Execute(fd, reqs, false);
+}
+
+//------------------------------------------------------------------------------
+// Vector read
+//------------------------------------------------------------------------------
+int64_t
+IoUring::ReadV(int fd, XrdOucIOVec* readV, int count)
+{
+  std::vector<Request> reqs;
+  reqs.reserve(count);
+
+  for (int i = 0; i < count; ++i) {
+    reqs.push_back({(off_t) readV[i].offset, (size_t) readV[i].size,
+                    readV[i].data});
+  }
+
+  return Execute(fd, reqs, false);
+}
+
+//------------------------------------------------------------------------------
+// Read
+//------------------------------------------------------------------------------
+int64_t
+IoUring::Read(int fd, off_t offset, char* buffer, size_t length)
+{
+  std::vector<Request> reqs {{offset, length, buffer}};
+  return Execute(fd, reqs, false);
+}
+
+//------------------------------------------------------------------------------
+// Write
+//------------------------------------------------------------------------------
+int64_t
+IoUring::Write(int fd, off_t offset, const char* buffer, size_t length)
+{
+  std::vector<Request> reqs {{offset, length, const_cast<char*>(buffer)}};
+  return Execute(fd, reqs, true);
+}
+
+//------------------------------------------------------------------------------
+// Submit the requests in batches and wait for their completion
+//------------------------------------------------------------------------------
+int64_t
+IoUring::Execute(int fd, std::vector<Request>& reqs, bool write)
+{
+  int64_t total = 0;
+  int errc = 0;
+  size_t idx = 0;
+  int slot[kQueueDepth];
+
+  while (idx < reqs.size()) {
+    if (mBroken) {
+      for (; idx < reqs.size(); ++idx) {
+        int64_t done = Complete(fd, reqs[idx], 0, write);
+
+        if (done < 0) {
+          errc = errno;
+        } else {
+          total += done;
+        }
+      }
+
+      break;
+    }
+
+    unsigned batch = std::min(reqs.size() - idx, (size_t) kQueueDepth);
+    unsigned num_fixed = 0;
+    unsigned num_prep = 0;
+
+    for (unsigned j = 0; j < batch; ++j) {
+      Request& req = reqs[idx + j];
+      struct io_uring_sqe* sqe = io_uring_get_sqe(&mRing);
+      slot[j] = -1;
+
+      if (sqe == nullptr) {
+        break;
+      }
+
+      if (write) {
+        io_uring_prep_write(sqe, fd, req.mBuffer, req.mLength, req.mOffset);
+      } else if (mFixedRegistered && (num_fixed < kNumFixedBuffers) &&
+                 (req.mLength <= kFixedBufferSize)) {
+        slot[j] = num_fixed++;
+        io_uring_prep_read_fixed(sqe, fd, mFixedBuffers[slot[j]].iov_base,
+                                 req.mLength, req.mOffset, slot[j]);
+      } else {
+        io_uring_prep_read(sqe, fd, req.mBuffer, req.mLength, req.mOffset);
+      }
+
+      io_uring_sqe_set_data(sqe, (void*)(uintptr_t) j);
+      ++num_prep;
+    }
+
+    int submitted = 0;
+
+    if (num_prep) {
+      do {
+        submitted = io_uring_submit_and_wait(&mRing, num_prep);
+      } while (submitted == -EINTR);
+    }
+
+    if ((num_prep < batch) || (submitted != (int) num_prep)) {
+      // Requests left in the submission queue could be picked up by a later
+      // submit once their buffers are gone - retire this ring for good
+      eos_static_err("msg=\"io_uring submit failed, disabling ring\" "
+                     "submitted=%d expected=%u", submitted, batch);
+      mBroken = true;
+      submitted = std::max(submitted, 0);
+    }
+
+    std::vector<bool> reaped(batch, false);
+
+    for (int k = 0; k < submitted; ++k) {
+      struct io_uring_cqe* cqe = nullptr;
+      int retc;
+
+      do {
+        retc = io_uring_wait_cqe(&mRing, &cqe);
+      } while (retc == -EINTR);
+
+      if (retc < 0) {
+        // Should not happen once all the requests are submitted, retire the
+        // ring and serve the rest of the batch synchronously
+        errc = -retc;
+        mBroken = true;
+        break;
+      }
+
+      unsigned j = (unsigned)(uintptr_t) io_uring_cqe_get_data(cqe);
+      int res = cqe->res;
+      io_uring_cqe_seen(&mRing, cqe);
+      Request& req = reqs[idx + j];
+      reaped[j] = true;
+
+      if (res < 0) {
+        if ((res == -EINVAL) || (res == -EOPNOTSUPP)) {
+          // The operations are probed at ring creation, this is about the
+          // request itself (e.g. the file) - serve it with pread/pwrite
+          int64_t done = Complete(fd, req, 0, write);
+
+          if (done < 0) {
+            errc = errno;
+          } else {
+            total += done;
+          }
+
+          continue;
+        }
+
+        if ((res != -EAGAIN) && (res != -EINTR)) {
+          errc = -res;
+          continue;
+        }
+
+        res = 0;
+      }
+
+      if ((slot[j] >= 0) && res) {
+        memcpy(req.mBuffer, mFixedBuffers[slot[j]].iov_base, res);
+      }
+
+      int64_t done = res;
+
+      if ((size_t) res < req.mLength) {
+        if ((done = Complete(fd, req, res, write)) < 0) {
+          errc = errno;
+          continue;
+        }
+      }
+
+      total += done;
+    }
+
+    if (mBroken) {
+      // Serve whatever did not go through the ring synchronously
+      for (unsigned j = 0; j < batch; ++j) {
+        if (!reaped[j]) {
+          int64_t done = Complete(fd, reqs[idx + j], 0, write);
+
+          if (done < 0) {
+            errc = errno;
+          } else {
+            total += done;
+          }
+        }
+      }
+    }
+
+    idx += batch;
+  }
+
+  if (errc) {
+    errno = errc;
+    return -1;
+  }
+
+  return total;
+}
+
+//------------------------------------------------------------------------------
+// Complete a (partial) request synchronously
+//------------------------------------------------------------------------------
+int64_t
+IoUring::Complete(int fd, const Request& req, size_t done, bool write)
+{
+  while (done < req.mLength) {
+    ssize_t nbytes = (write ?
+                      ::pwrite(fd, req.mBuffer + done, req.mLength - done,
+                               req.mOffset + done) :
+                      ::pread(fd, req.mBuffer + done, req.mLength - done,
+                              req.mOffset + done));
+
+    if (nbytes < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+
+      return -1;
+    }
+
+    if (nbytes == 0) {
+      break;
+    }
+
+    done += nbytes;
+  }
+
+  return done;
+}
+
+EOSFSTNAMESPACE_END
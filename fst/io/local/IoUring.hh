@@ -0,0 +1,188 @@
+//------------------------------------------------------------------------------
+//! @file IoUring.hh
+//! @brief io_uring based engine used for local file IO
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2019 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#pragma once
+#include "fst/Namespace.hh"
+#include "XrdCl/XrdClXRootDResponses.hh"
+#include "XrdOuc/XrdOucIOVec.hh"
+#include <liburing.h>
+#include <sys/uio.h>
+#include <atomic>
+#include <string>
+#include <vector>
+
+EOSFSTNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! Class IoUring - one submission/completion ring per thread used to batch
+//! local file IO. Small reads are served from a set of buffers registered
+//! with the kernel at ring creation, larger ones go directly into the caller
+//! buffer. If the running kernel does not support io_uring, GetThreadInstance
+//! returns a null pointer and callers are expected to fall back on the
+//! classic pread/pwrite path.
+//------------------------------------------------------------------------------
+class IoUring
+{
+public:
+  //! Number of submission queue entries per ring
+  static constexpr unsigned kQueueDepth = 64;
+  //! Number of registered buffers per ring
+  static constexpr unsigned kNumFixedBuffers = 32;
+  //! Size of each of the registered buffers
+  static constexpr unsigned kFixedBufferSize = 16 * 1024;
+
+  //----------------------------------------------------------------------------
+  //! Get the ring of the calling thread, creating it if needed
+  //!
+  //! @return ring object or nullptr if io_uring is not usable
+  //----------------------------------------------------------------------------
+  static IoUring* GetThreadInstance();
+
+  //----------------------------------------------------------------------------
+  //! Check if the given engine name selects io_uring
+  //!
+  //! @param engine engine name as configured e.g. "uring" or "psync"
+  //!
+  //! @return true if io_uring is requested, otherwise false
+  //----------------------------------------------------------------------------
+  static bool IsEngineUring(const std::string& engine)
+  {
+    return (engine == "uring");
+  }
+
+  //----------------------------------------------------------------------------
+  //! Destructor
+  //----------------------------------------------------------------------------
+  ~IoUring();
+
+  //----------------------------------------------------------------------------
+  //! Vector read
+  //!
+  //! @param fd file descriptor
+  //! @param chunks list of chunks to be read
+  //!
+  //! @return number of bytes read or -1 if error and errno is set
+  //----------------------------------------------------------------------------
+  int64_t ReadV(int fd, XrdCl::ChunkList& chunks);
+
+  //----------------------------------------------------------------------------
+  //! Vector read
+  //!
+  //! @param fd file descriptor
+  //! @param readV vector read structure
+  //! @param count number of entries in the vector read structure
+  //!
+  //! @return number of bytes read or -1 if error and errno is set
+  //----------------------------------------------------------------------------
+  int64_t ReadV(int fd, XrdOucIOVec* readV, int count);
+
+  //----------------------------------------------------------------------------
+  //! Read
+  //!
+  //! @param fd file descriptor
+  //! @param offset offset in file
+  //! @param buffer where the data is read
+  //! @param length read length
+  //!
+  //! @return number of bytes read or -1 if error and errno is set
+  //----------------------------------------------------------------------------
+  int64_t Read(int fd, off_t offset, char* buffer, size_t length);
+
+  //----------------------------------------------------------------------------
+  //! Write
+  //!
+  //! @param fd file descriptor
+  //! @param offset offset in file
+  //! @param buffer data to be written
+  //! @param length length
+  //!
+  //! @return number of bytes written or -1 if error and errno is set
+  //----------------------------------------------------------------------------
+  int64_t Write(int fd, off_t offset, const char* buffer, size_t length);
+
+private:
+  //----------------------------------------------------------------------------
+  //! Single IO request
+  //----------------------------------------------------------------------------
+  struct Request {
+    off_t mOffset;
+    size_t mLength;
+    char* mBuffer;
+  };
+
+  //! -1 not probed yet, 0 io_uring not supported, 1 supported
+  static std::atomic<int> sSupported;
+
+  struct io_uring mRing; ///< Submission and completion queues
+  bool mInitialized; ///< Mark if the ring was successfully set up
+  bool mBroken; ///< Mark if the ring was retired after a submission error
+  bool mFixedRegistered; ///< Mark if the fixed buffers are registered
+  char* mFixedMemory; ///< Memory backing the registered buffers
+  std::vector<struct iovec> mFixedBuffers; ///< Registered buffers
+
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //----------------------------------------------------------------------------
+  IoUring();
+
+  //----------------------------------------------------------------------------
+  //! Set up the ring, check that the kernel supports the read/write
+  //! operations and register the fixed buffers
+  //!
+  //! @return 0 if successful, otherwise negative errno
+  //----------------------------------------------------------------------------
+  int Init();
+
+  //----------------------------------------------------------------------------
+  //! Submit the given requests in batches of at most kQueueDepth entries and
+  //! wait for all of them to complete. Short transfers are completed using
+  //! the synchronous pread/pwrite calls.
+  //!
+  //! @param fd file descriptor
+  //! @param reqs requests to execute
+  //! @param write if true then do writes, otherwise reads
+  //!
+  //! @return number of bytes transferred or -1 if error and errno is set
+  //----------------------------------------------------------------------------
+  int64_t Execute(int fd, std::vector<Request>& reqs, bool write);
+
+  //----------------------------------------------------------------------------
+  //! Complete a (partial) request synchronously
+  //!
+  //! @param fd file descriptor
+  //! @param req request
+  //! @param done number of bytes already transferred
+  //! @param write if true then do a write, otherwise a read
+  //!
+  //! @return total number of bytes transferred or -1 if error
+  //----------------------------------------------------------------------------
+  static int64_t Complete(int fd, const Request& req, size_t done, bool write);
+
+  //----------------------------------------------------------------------------
+  //! Disable copy/move
+  //----------------------------------------------------------------------------
+  IoUring(const IoUring&) = delete;
+  IoUring& operator=(const IoUring&) = delete;
+};
+
+EOSFSTNAMESPACE_END
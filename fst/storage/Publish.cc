@@ -36,6 +36,43 @@ EOSFSTNAMESPACE_BEGIN
 
 constexpr std::chrono::seconds Storage::sConsistencyTimeout;
 
+//------------------------------------------------------------------------------
+// Set the change thresholds of the published statistics
+//------------------------------------------------------------------------------
+static void
+ConfigurePublishFilter(PublishFilter& filter)
+{
+  // The publish timestamp acts as heartbeat towards the MGM
+  filter.SetThreshold("stat.publishtimestamp", PublishFilter::kAlways);
+  // Rates and loads fluctuate all the time, only publish significant changes
+  filter.SetThreshold("stat.net.", 0.05);
+  filter.SetThreshold("stat.disk.readratemb", 0.05);
+  filter.SetThreshold("stat.disk.writeratemb", 0.05);
+  filter.SetThreshold("stat.disk.load", 0.05);
+  filter.SetThreshold("stat.deletion.rate", 0.05);
+  filter.SetThreshold("stat.sys.vsize", 0.01);
+  filter.SetThreshold("stat.sys.rss", 0.01);
+  filter.SetThreshold("stat.publish.", 0.1);
+  // Space usage changes by less than 0.1% are not relevant for scheduling
+  filter.SetThreshold("stat.statfs.", 0.001);
+}
+
+//------------------------------------------------------------------------------
+// Get publish filter of a file system
+//------------------------------------------------------------------------------
+PublishFilter&
+Storage::GetPublishFilter(eos::common::FileSystem::fsid_t fsid)
+{
+  auto it = mFsPublishFilters.find(fsid);
+
+  if (it == mFsPublishFilters.end()) {
+    it = mFsPublishFilters.emplace(fsid, PublishFilter(sConsistencyTimeout)).first;
+    ConfigurePublishFilter(it->second);
+  }
+
+  return it->second;
+}
+
 //------------------------------------------------------------------------------
 // Publish
 //------------------------------------------------------------------------------
@@ -98,8 +135,12 @@ Storage::Publish()
   eos::fst::Config::gConfig.getFstNodeConfigQueue("Publish");
   eos::common::Logging& g_logging = eos::common::Logging::GetInstance();
   eos::common::FileSystem::fsid_t fsid = 0;
+  ConfigurePublishFilter(mNodePublishFilter);
   std::string publish_uptime = "";
   std::string publish_sockets = "";
+  long long last_cycle_ms = 0;
+  long long last_cycle_keys = 0;
+  long long last_cycle_bytes = 0;
 
   while (true) {
     {
@@ -142,6 +183,9 @@ Storage::Publish()
     unsigned int lReportIntervalMilliSeconds = (PublishInterval * 500) +
         (unsigned int)((PublishInterval * 1000.0) * rand() / RAND_MAX);
     eos::common::LinuxStat::linux_stat_t osstat;
+    auto cycle_tp = std::chrono::steady_clock::now();
+    uint64_t cycle_keys = 0;
+    uint64_t cycle_bytes = 0;
 
     if (!eos::common::LinuxStat::GetStat(osstat)) {
       eos_err("failed to get the memory usage information");
@@ -168,65 +212,31 @@ Storage::Publish()
             continue;
           }
 
-          XrdOucString r_open_hotfiles;
-          XrdOucString w_open_hotfiles;
+          PublishFilter& filter = GetPublishFilter(fsid);
+          FileSystem* fs = mFsVect[i];
+          // Values are always stored in the local hash but only broadcast
+          // when they changed significantly since the last broadcast
+          auto set_longlong = [&](const char* key, long long value) {
+            return fs->SetLongLong(key, value,
+                                   filter.Check(key, (double) value, cycle_tp));
+          };
+          auto set_double = [&](const char* key, double value) {
+            return fs->SetDouble(key, value, filter.Check(key, value, cycle_tp));
+          };
+          auto set_string = [&](const char* key, const std::string & value) {
+            return fs->SetString(key, value.c_str(),
+                                 filter.Check(key, value, cycle_tp));
+          };
+          std::string r_open_hotfiles;
+          std::string w_open_hotfiles;
+          long long r_open = 0;
+          long long w_open = 0;
           {
-            std::map<unsigned int, std::set<unsigned long long>> Rhotfiles;
-            std::map<unsigned int, std::set<unsigned long long>> Whotfiles;
-            {
-              XrdSysMutexHelper fLock(gOFS.OpenFidMutex);
-
-              if (gOFS.ROpenFid.count(fsid)) {
-                for (auto it = gOFS.ROpenFid[fsid].begin(); it != gOFS.ROpenFid[fsid].end();
-                     ++it) {
-                  Rhotfiles[it->second].insert(it->first);
-                }
-              }
-
-              if (gOFS.WOpenFid.count(fsid)) {
-                for (auto it = gOFS.WOpenFid[fsid].begin(); it != gOFS.WOpenFid[fsid].end();
-                     ++it) {
-                  Whotfiles[it->second].insert(it->first);
-                }
-              }
-            }
-            size_t cnt = 0;
-
-            for (auto it = Rhotfiles.rbegin(); it != Rhotfiles.rend(); ++it) {
-              XrdOucString hexfid;
-
-              for (auto fit = it->second.begin(); fit != it->second.end(); ++fit) {
-                eos::common::FileId::Fid2Hex(*fit, hexfid);
-                r_open_hotfiles += (int) it->first;
-                r_open_hotfiles += ":";
-                r_open_hotfiles += hexfid.c_str();
-                r_open_hotfiles += " ";
-                ++cnt;
-
-                if (cnt == 10) {
-                  break;
-                }
-              }
-            }
-
-            cnt = 0;
-
-            for (auto it = Whotfiles.rbegin(); it != Whotfiles.rend(); ++it) {
-              XrdOucString hexfid;
-
-              for (auto fit = it->second.begin(); fit != it->second.end(); ++fit) {
-                eos::common::FileId::Fid2Hex(*fit, hexfid);
-                w_open_hotfiles += (int) it->first;
-                w_open_hotfiles += ":";
-                w_open_hotfiles += hexfid.c_str();
-                w_open_hotfiles += " ";
-                ++cnt;
-
-                if (cnt == 10) {
-                  break;
-                }
-              }
-            }
+            XrdSysMutexHelper fLock(gOFS.OpenFidMutex);
+            r_open_hotfiles = gOFS.RHotFiles.GetHotFiles(fsid, 10);
+            w_open_hotfiles = gOFS.WHotFiles.GetHotFiles(fsid, 10);
+            r_open = (long long) gOFS.ROpenFid[fsid].size();
+            w_open = (long long) gOFS.WOpenFid[fsid].size();
           }
           // Retrieve Statistics from the local db
           std::map<std::string, size_t>::const_iterator isit;
@@ -246,29 +256,43 @@ Storage::Publish()
                 //eos_static_debug("%-24s => %lu", isit->first.c_str(), isit->second);
                 std::string sname = "stat.fsck.";
                 sname += isit->first;
-                success &= mFsVect[i]->SetLongLong(sname.c_str(), isit->second);
+                success &= set_longlong(sname.c_str(), isit->second);
               }
             }
           }
 
           eos::common::Statfs* statfs = 0;
 
-          // call the update function which stores into the filesystem shared hash
+          // Store the statfs values into the filesystem shared hash
           if ((statfs = mFsVect[i]->GetStatfs())) {
-            // call the update function which stores into the filesystem shared hash
-            if (!mFsVect[i]->SetStatfs(statfs->GetStatfs())) {
+            struct statfs* sfs = statfs->GetStatfs();
+            bool sfs_ok = true;
+            sfs_ok &= set_longlong("stat.statfs.type", sfs->f_type);
+            sfs_ok &= set_longlong("stat.statfs.bsize", sfs->f_bsize);
+            sfs_ok &= set_longlong("stat.statfs.blocks", sfs->f_blocks);
+            sfs_ok &= set_longlong("stat.statfs.bfree", sfs->f_bfree);
+            sfs_ok &= set_longlong("stat.statfs.bavail", sfs->f_bavail);
+            sfs_ok &= set_longlong("stat.statfs.files", sfs->f_files);
+            sfs_ok &= set_longlong("stat.statfs.ffree", sfs->f_ffree);
+#ifdef __APPLE__
+            sfs_ok &= set_longlong("stat.statfs.namelen", MNAMELEN);
+#else
+            sfs_ok &= set_longlong("stat.statfs.namelen", sfs->f_namelen);
+#endif
+
+            if (!sfs_ok) {
               eos_static_err("cannot SetStatfs on filesystem %s",
                              mFsVect[i]->GetPath().c_str());
             }
           }
 
           // Copy out net info
-          success &= mFsVect[i]->SetDouble("stat.net.ethratemib",
-                                           netspeed / (8 * 1024 * 1024));
-          success &= mFsVect[i]->SetDouble("stat.net.inratemib",
-                                           mFstLoad.GetNetRate(lEthernetDev.c_str(), "rxbytes") / 1024.0 / 1024.0);
-          success &= mFsVect[i]->SetDouble("stat.net.outratemib",
-                                           mFstLoad.GetNetRate(lEthernetDev.c_str(), "txbytes") / 1024.0 / 1024.0);
+          success &= set_double("stat.net.ethratemib",
+                                netspeed / (8 * 1024 * 1024));
+          success &= set_double("stat.net.inratemib",
+                                mFstLoad.GetNetRate(lEthernetDev.c_str(), "rxbytes") / 1024.0 / 1024.0);
+          success &= set_double("stat.net.outratemib",
+                                mFstLoad.GetNetRate(lEthernetDev.c_str(), "txbytes") / 1024.0 / 1024.0);
           // Set current load stats, io-target specific implementation may override
           // fst load implementation
           {
@@ -290,10 +314,10 @@ Storage::Publish()
                                               "millisIO") / 1000.0;
             }
 
-            success &= mFsVect[i]->SetDouble("stat.disk.readratemb", readratemb);
-            success &= mFsVect[i]->SetDouble("stat.disk.writeratemb",
-                                             writeratemb);
-            success &= mFsVect[i]->SetDouble("stat.disk.load", diskload);
+            success &= set_double("stat.disk.readratemb", readratemb);
+            success &= set_double("stat.disk.writeratemb",
+                                  writeratemb);
+            success &= set_double("stat.disk.load", diskload);
           }
           // copy out net info
           {
@@ -304,62 +328,66 @@ Storage::Publish()
               health = mFstHealth.getDiskHealth(mFsVect[i]->GetPath());
             }
 
-            success &= mFsVect[i]->SetString("stat.health",
-                                             (health.count("summary") ? health["summary"].c_str() : "N/A"));
-            success &= mFsVect[i]->SetLongLong("stat.health.indicator",
-                                               strtoll(health["indicator"].c_str(), 0, 10));
-            success &= mFsVect[i]->SetLongLong("stat.health.drives_total",
-                                               strtoll(health["drives_total"].c_str(), 0, 10));
-            success &= mFsVect[i]->SetLongLong("stat.health.drives_failed",
-                                               strtoll(health["drives_failed"].c_str(), 0, 10));
-            success &= mFsVect[i]->SetLongLong("stat.health.redundancy_factor",
-                                               strtoll(health["redundancy_factor"].c_str(), 0, 10));
-          }
-          long long r_open = 0;
-          long long w_open = 0;
-          {
-            XrdSysMutexHelper fLock(gOFS.OpenFidMutex);
-            r_open = (long long) gOFS.ROpenFid[fsid].size();
-            w_open = (long long) gOFS.WOpenFid[fsid].size();
+            success &= set_string("stat.health", (health.count("summary") ?
+                                  health["summary"] : "N/A"));
+            success &= set_longlong("stat.health.indicator",
+                                    strtoll(health["indicator"].c_str(), 0, 10));
+            success &= set_longlong("stat.health.drives_total",
+                                    strtoll(health["drives_total"].c_str(), 0, 10));
+            success &= set_longlong("stat.health.drives_failed",
+                                    strtoll(health["drives_failed"].c_str(), 0, 10));
+            success &= set_longlong("stat.health.redundancy_factor",
+                                    strtoll(health["redundancy_factor"].c_str(), 0, 10));
           }
-          success &= mFsVect[i]->SetLongLong("stat.ropen", r_open);
-          success &= mFsVect[i]->SetLongLong("stat.wopen", w_open);
-          success &= mFsVect[i]->SetLongLong("stat.statfs.freebytes",
-                                             mFsVect[i]->GetLongLong("stat.statfs.bfree") *
-                                             mFsVect[i]->GetLongLong("stat.statfs.bsize"));
-          success &= mFsVect[i]->SetLongLong("stat.statfs.usedbytes",
-                                             (mFsVect[i]->GetLongLong("stat.statfs.blocks") -
-                                              mFsVect[i]->GetLongLong("stat.statfs.bfree")) *
-                                             mFsVect[i]->GetLongLong("stat.statfs.bsize"));
-          success &= mFsVect[i]->SetDouble("stat.statfs.filled",
-                                           100.0 * ((mFsVect[i]->GetLongLong("stat.statfs.blocks") -
-                                               mFsVect[i]->GetLongLong("stat.statfs.bfree"))) /
-                                           (1 + mFsVect[i]->GetLongLong("stat.statfs.blocks")));
-          success &= mFsVect[i]->SetLongLong("stat.statfs.capacity",
-                                             mFsVect[i]->GetLongLong("stat.statfs.blocks") *
-                                             mFsVect[i]->GetLongLong("stat.statfs.bsize"));
-          success &= mFsVect[i]->SetLongLong("stat.statfs.fused",
-                                             (mFsVect[i]->GetLongLong("stat.statfs.files") -
-                                              mFsVect[i]->GetLongLong("stat.statfs.ffree")) *
-                                             mFsVect[i]->GetLongLong("stat.statfs.bsize"));
-          success &= mFsVect[i]->SetLongLong("stat.usedfiles",
-                                             gFmdDbMapHandler.GetNumFiles(fsid));
-          success &= mFsVect[i]->SetString("stat.boot",
-                                           mFsVect[i]->GetStatusAsString(mFsVect[i]->GetStatus()));
-          success &= mFsVect[i]->SetString("stat.geotag", lNodeGeoTag.c_str());
+          success &= set_longlong("stat.ropen", r_open);
+          success &= set_longlong("stat.wopen", w_open);
+          success &= set_longlong("stat.statfs.freebytes",
+                                  mFsVect[i]->GetLongLong("stat.statfs.bfree") *
+                                  mFsVect[i]->GetLongLong("stat.statfs.bsize"));
+          success &= set_longlong("stat.statfs.usedbytes",
+                                  (mFsVect[i]->GetLongLong("stat.statfs.blocks") -
+                                   mFsVect[i]->GetLongLong("stat.statfs.bfree")) *
+                                  mFsVect[i]->GetLongLong("stat.statfs.bsize"));
+          success &= set_double("stat.statfs.filled",
+                                100.0 * ((mFsVect[i]->GetLongLong("stat.statfs.blocks") -
+                                    mFsVect[i]->GetLongLong("stat.statfs.bfree"))) /
+                                (1 + mFsVect[i]->GetLongLong("stat.statfs.blocks")));
+          success &= set_longlong("stat.statfs.capacity",
+                                  mFsVect[i]->GetLongLong("stat.statfs.blocks") *
+                                  mFsVect[i]->GetLongLong("stat.statfs.bsize"));
+          success &= set_longlong("stat.statfs.fused",
+                                  (mFsVect[i]->GetLongLong("stat.statfs.files") -
+                                   mFsVect[i]->GetLongLong("stat.statfs.ffree")) *
+                                  mFsVect[i]->GetLongLong("stat.statfs.bsize"));
+          success &= set_longlong("stat.usedfiles",
+                                  gFmdDbMapHandler.GetNumFiles(fsid));
+          success &= set_string("stat.boot",
+                                mFsVect[i]->GetStatusAsString(mFsVect[i]->GetStatus()));
+          success &= set_string("stat.geotag", lNodeGeoTag.c_str());
           struct timeval tvfs;
           gettimeofday(&tvfs, &tz);
           size_t nowms = tvfs.tv_sec * 1000 + tvfs.tv_usec / 1000;
-          success &= mFsVect[i]->SetLongLong("stat.publishtimestamp", nowms);
-          success &= mFsVect[i]->SetLongLong("stat.drainer.running",
-                                             mFsVect[i]->GetDrainQueue()->GetRunningAndQueued());
-          success &= mFsVect[i]->SetLongLong("stat.balancer.running",
-                                             mFsVect[i]->GetBalanceQueue()->GetRunningAndQueued());
-          success &= mFsVect[i]->SetLongLong("stat.disk.iops",
-                                             mFsVect[i]->getIOPS());
-          success &= mFsVect[i]->SetDouble("stat.disk.bw",
-                                           mFsVect[i]->getSeqBandwidth()); // in MB
-          success &= mFsVect[i]->SetLongLong("stat.http.port", gOFS.mHttpdPort);
+          success &= set_longlong("stat.publishtimestamp", nowms);
+          success &= set_longlong("stat.drainer.running",
+                                  mFsVect[i]->GetDrainQueue()->GetRunningAndQueued());
+          success &= set_longlong("stat.balancer.running",
+                                  mFsVect[i]->GetBalanceQueue()->GetRunningAndQueued());
+          success &= set_longlong("stat.disk.iops",
+                                  mFsVect[i]->getIOPS());
+          success &= set_double("stat.disk.bw",
+                                mFsVect[i]->getSeqBandwidth()); // in MB
+          success &= set_longlong("stat.http.port", gOFS.mHttpdPort);
+          {
+            DeletionEngine::Stats del_stats = mDeletionEngine.GetStats(fsid);
+            success &= set_longlong("stat.deletion.backlog",
+                                    del_stats.mBacklog);
+            success &= set_longlong("stat.deletion.deleted",
+                                    del_stats.mDeleted);
+            success &= set_longlong("stat.deletion.failed",
+                                    del_stats.mFailed);
+            success &= set_double("stat.deletion.rate",
+                                  del_stats.mRate);
+          }
           {
             // we have to set something which is not empty to update the value
             if (!r_open_hotfiles.length()) {
@@ -371,10 +399,8 @@ Storage::Publish()
             }
 
             // Copy out hot file list
-            success &= mFsVect[i]->SetString("stat.ropen.hotfiles",
-                                             r_open_hotfiles.c_str());
-            success &= mFsVect[i]->SetString("stat.wopen.hotfiles",
-                                             w_open_hotfiles.c_str());
+            success &= set_string("stat.ropen.hotfiles", r_open_hotfiles);
+            success &= set_string("stat.wopen.hotfiles", w_open_hotfiles);
           }
           {
             long long fbytes = mFsVect[i]->GetLongLong("stat.statfs.freebytes");
@@ -415,15 +441,26 @@ Storage::Publish()
                                     "hash");
 
           if (hash) {
-            hash->Set("stat.sys.kernel", eos::fst::Config::gConfig.KernelVersion.c_str());
-            hash->Set("stat.sys.vsize", osstat.vsize);
-            hash->Set("stat.sys.rss", osstat.rss);
-            hash->Set("stat.sys.threads", osstat.threads);
+            auto set_node_string = [&](const char* key, const std::string & value) {
+              hash->Set(key, value.c_str(),
+                        mNodePublishFilter.Check(key, value, cycle_tp));
+            };
+            auto set_node_longlong = [&](const char* key, long long value) {
+              hash->Set(key, value, mNodePublishFilter.Check(key, (double) value,
+                        cycle_tp));
+            };
+            auto set_node_double = [&](const char* key, double value) {
+              hash->Set(key, value, mNodePublishFilter.Check(key, value, cycle_tp));
+            };
+            set_node_string("stat.sys.kernel", eos::fst::Config::gConfig.KernelVersion.c_str());
+            set_node_longlong("stat.sys.vsize", osstat.vsize);
+            set_node_longlong("stat.sys.rss", osstat.rss);
+            set_node_longlong("stat.sys.threads", osstat.threads);
             {
               XrdOucString v = VERSION;
               v += "-";
               v += RELEASE;
-              hash->Set("stat.sys.eos.version", v.c_str());
+              set_node_string("stat.sys.eos.version", v.c_str());
             }
             {
               XrdOucString v = XrdVERSIONINFOVAR(XrdgetProtocol).vStr;
@@ -433,34 +470,49 @@ Storage::Publish()
                 v.erasefromstart(pos + 1);
               }
 
-              hash->Set("stat.sys.xrootd.version", v.c_str());
+              set_node_string("stat.sys.xrootd.version", v.c_str());
             }
-            hash->Set("stat.sys.keytab", eos::fst::Config::gConfig.KeyTabAdler.c_str());
-            hash->Set("stat.sys.uptime", publish_uptime.c_str());
-            hash->Set("stat.sys.sockets", publish_sockets.c_str());
-            hash->Set("stat.sys.eos.start", eos::fst::Config::gConfig.StartDate.c_str());
-            hash->Set("stat.geotag", lNodeGeoTag.c_str());
-            hash->Set("http.port", gOFS.mHttpdPort);
-            hash->Set("debug.state",
-                      eos::common::StringConversion::ToLower
-                      (g_logging.GetPriorityString
-                       (g_logging.gPriorityLevel)).c_str());
+            set_node_string("stat.sys.keytab", eos::fst::Config::gConfig.KeyTabAdler.c_str());
+            set_node_string("stat.sys.uptime", publish_uptime.c_str());
+            set_node_string("stat.sys.sockets", publish_sockets.c_str());
+            set_node_string("stat.sys.eos.start", eos::fst::Config::gConfig.StartDate.c_str());
+            set_node_string("stat.geotag", lNodeGeoTag.c_str());
+            set_node_longlong("http.port", gOFS.mHttpdPort);
+            set_node_string("debug.state",
+                            eos::common::StringConversion::ToLower
+                            (g_logging.GetPriorityString
+                             (g_logging.gPriorityLevel)).c_str());
             // copy out net info
-            hash->Set("stat.net.ethratemib", netspeed / (8 * 1024 * 1024));
-            hash->Set("stat.net.inratemib", mFstLoad.GetNetRate(lEthernetDev.c_str(),
-                      "rxbytes") / 1024.0 / 1024.0);
-            hash->Set("stat.net.outratemib", mFstLoad.GetNetRate(lEthernetDev.c_str(),
-                      "txbytes") / 1024.0 / 1024.0);
+            set_node_longlong("stat.net.ethratemib", netspeed / (8 * 1024 * 1024));
+            set_node_double("stat.net.inratemib",
+                            mFstLoad.GetNetRate(lEthernetDev.c_str(), "rxbytes") / 1024.0 / 1024.0);
+            set_node_double("stat.net.outratemib",
+                            mFstLoad.GetNetRate(lEthernetDev.c_str(), "txbytes") / 1024.0 / 1024.0);
             struct timeval tvfs;
             gettimeofday(&tvfs, &tz);
             size_t nowms = tvfs.tv_sec * 1000 + tvfs.tv_usec / 1000;
-            hash->Set("stat.publishtimestamp", nowms);
+            set_node_longlong("stat.publishtimestamp", nowms);
+            DeletionEngine::Stats del_stats = mDeletionEngine.GetStats();
+            set_node_longlong("stat.deletion.backlog", del_stats.mBacklog);
+            set_node_double("stat.deletion.rate", del_stats.mRate);
+            // Statistics of the previous publish cycle
+            set_node_longlong("stat.publish.duration", last_cycle_ms);
+            set_node_longlong("stat.publish.keys", last_cycle_keys);
+            set_node_longlong("stat.publish.bytes", last_cycle_bytes);
           }
 
           gOFS.ObjectManager.HashMutex.UnLockRead();
         }
 
         gOFS.ObjectManager.CloseMuxTransaction();
+        cycle_keys = mNodePublishFilter.TakeCounters(cycle_bytes);
+
+        for (auto& elem : mFsPublishFilters) {
+          uint64_t fs_bytes = 0;
+          cycle_keys += elem.second.TakeCounters(fs_bytes);
+          cycle_bytes += fs_bytes;
+        }
+
         // Report the consistency stats only once every 5 min
         next_consistency_stats = last_consistency_stats + sConsistencyTimeout.count();
       }
@@ -470,12 +522,20 @@ Storage::Publish()
     int lCycleDuration = (int)((tv2.tv_sec * 1000.0) - (tv1.tv_sec * 1000.0) +
                                (tv2.tv_usec / 1000.0) - (tv1.tv_usec / 1000.0));
     int lSleepTime = lReportIntervalMilliSeconds - lCycleDuration;
-    eos_static_debug("msg=\"publish interval\" %d %d", lReportIntervalMilliSeconds,
-                     lCycleDuration);
+    eos_static_debug("msg=\"publish interval\" %d %d keys=%llu bytes=%llu",
+                     lReportIntervalMilliSeconds, lCycleDuration,
+                     (unsigned long long) cycle_keys,
+                     (unsigned long long) cycle_bytes);
+    last_cycle_ms = lCycleDuration;
+    last_cycle_keys = cycle_keys;
+    last_cycle_bytes = cycle_bytes;
 
     if (lSleepTime < 0) {
-      eos_static_warning("Publisher cycle exceeded %d millisecons - took %d milliseconds",
-                         lReportIntervalMilliSeconds, lCycleDuration);
+      eos_static_warning("Publisher cycle exceeded %d millisecons - took %d "
+                         "milliseconds keys=%llu bytes=%llu",
+                         lReportIntervalMilliSeconds, lCycleDuration,
+                         (unsigned long long) cycle_keys,
+                         (unsigned long long) cycle_bytes);
     } else {
       std::this_thread::sleep_for(std::chrono::seconds(lSleepTime / 1000));
     }
@@ -35,7 +35,6 @@ Storage::Remover()
   static int deletionInterval = 300;
   std::string nodeconfigqueue =
     eos::fst::Config::gConfig.getFstNodeConfigQueue("Remover").c_str();
-  std::unique_ptr<Deletion> to_del {};
 
   if (getenv("EOS_FST_DELETE_QUERY_INTERVAL")) {
     try {
@@ -43,45 +42,15 @@ Storage::Remover()
     } catch (...) {}
   }
 
-  // Thread that unlinks stored files
+  // The files are unlinked by the deletion engine, this thread only asks the
+  // manager for more deletions once the backlog runs low
   while (true) {
-    while ((to_del = GetDeletion())) {
-      eos_static_debug("%u files to delete", GetNumDeletions());
-
-      for (unsigned int j = 0; j < to_del->fIdVector.size(); ++j) {
-        eos_static_debug("Deleting file_id=%llu on fs_id=%u", to_del->fIdVector[j],
-                         to_del->fsId);
-        XrdOucString hexstring = "";
-        eos::common::FileId::Fid2Hex(to_del->fIdVector[j], hexstring);
-        XrdOucErrInfo error;
-        XrdOucString capOpaqueString = "/?mgm.pcmd=drop";
-        XrdOucString OpaqueString = "";
-        OpaqueString += "&mgm.fsid=";
-        OpaqueString += (int) to_del->fsId;
-        OpaqueString += "&mgm.fid=";
-        OpaqueString += hexstring;
-        OpaqueString += "&mgm.localprefix=";
-        OpaqueString += to_del->localPrefix;
-        XrdOucEnv Opaque(OpaqueString.c_str());
-        capOpaqueString += OpaqueString;
-
-        if ((gOFS._rem("/DELETION", error, (const XrdSecEntity*) 0, &Opaque,
-                       0, 0, 0, true) != SFS_OK)) {
-          eos_static_warning("unable to remove fid %s fsid %lu localprefix=%s",
-                             hexstring.c_str(), to_del->fsId, to_del->localPrefix.c_str());
-        }
-
-        // Update the manager
-        int rc = gOFS.CallManager(&error, 0, 0 , capOpaqueString);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
 
-        if (rc) {
-          eos_static_err("unable to drop file id %s fsid %u at manager %s",
-                         hexstring.c_str(), to_del->fsId, to_del->managerId.c_str());
-        }
-      }
+    if (mDeletionEngine.GetBacklog() >= mDeletionEngine.GetLowWatermark()) {
+      continue;
     }
 
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
     time_t now = time(NULL);
 
     // Ask to schedule deletions regularly (default is every 5 minutes)
@@ -62,7 +62,8 @@ Storage::Create(const char* meta_dir)
 //------------------------------------------------------------------------------
 // Constructor
 //------------------------------------------------------------------------------
-Storage::Storage(const char* meta_dir)
+Storage::Storage(const char* meta_dir):
+  mNodePublishFilter(sConsistencyTimeout)
 {
   SetLogId("FstOfsStorage", "<service>");
   XrdOucString mkmetalogdir = "mkdir -p ";
@@ -129,6 +130,7 @@ Storage::Storage(const char* meta_dir)
   }
 
   mThreadSet.insert(tid);
+  mDeletionEngine.Start();
   eos_info("starting deletion thread");
 
   if ((rc = XrdSysThread::Run(&tid, Storage::StartFsRemover,
@@ -294,6 +296,8 @@ Storage::ShutdownThreads()
     eos_warning("op=shutdown threadid=%llx", (unsigned long long) *it);
     XrdSysThread::Cancel(*it);
   }
+
+  mDeletionEngine.Stop();
 }
 
 //------------------------------------------------------------------------------
@@ -825,30 +829,12 @@ Storage::CloseTransaction(unsigned int fsid, unsigned long long fid)
 }
 
 //------------------------------------------------------------------------------
-// Add deletion to the list of pending ones
+// Add deletion to the queue of the deletion engine
 //------------------------------------------------------------------------------
 void
 Storage::AddDeletion(std::unique_ptr<Deletion> del)
 {
-  XrdSysMutexHelper scope_lock(mDeletionsMutex);
-  mListDeletions.push_front(std::move(del));
-}
-
-//------------------------------------------------------------------------------
-// Get deletion object removing it from the list
-//------------------------------------------------------------------------------
-std::unique_ptr<Deletion>
-Storage::GetDeletion()
-{
-  std::unique_ptr<Deletion> del;
-  XrdSysMutexHelper scope_lock(mDeletionsMutex);
-
-  if (mListDeletions.size()) {
-    del.swap(mListDeletions.back());
-    mListDeletions.pop_back();
-  }
-
-  return del;
+  mDeletionEngine.Add(std::move(del));
 }
 
 //------------------------------------------------------------------------------
@@ -857,14 +843,7 @@ Storage::GetDeletion()
 size_t
 Storage::GetNumDeletions()
 {
-  size_t total = 0;
-  XrdSysMutexHelper scope_lock(mDeletionsMutex);
-
-  for (auto it = mListDeletions.cbegin(); it != mListDeletions.cend(); ++it) {
-    total += (*it)->fIdVector.size();
-  }
-
-  return total;
+  return mDeletionEngine.GetBacklog();
 }
 
 //------------------------------------------------------------------------------
@@ -30,6 +30,8 @@
 #include "common/RWMutex.hh"
 #include "fst/Load.hh"
 #include "fst/Health.hh"
+#include "fst/DeletionEngine.hh"
+#include "fst/PublishFilter.hh"
 #include "fst/txqueue/TransferMultiplexer.hh"
 #include <vector>
 #include <list>
@@ -83,19 +85,12 @@ public:
   void ShutdownThreads();
 
   //----------------------------------------------------------------------------
-  //! Add deletion object to the list of pending ones
+  //! Add deletion object to the queue of the deletion engine
   //!
   //! @param del deletion object
   //----------------------------------------------------------------------------
   void AddDeletion(std::unique_ptr<Deletion> del);
 
-  //----------------------------------------------------------------------------
-  //! Get deletion object removing it from the list
-  //!
-  //! @return get deletion object
-  //----------------------------------------------------------------------------
-  std::unique_ptr<Deletion> GetDeletion();
-
   //----------------------------------------------------------------------------
   //! Get number of pending deletions
   //!
@@ -178,8 +173,11 @@ private:
   XrdSysMutex mVerifyMutex; ///< Mutex protecting access to the verifications
   //! Queue of verification jobs pending
   std::queue <eos::fst::Verify*> mVerifications;
-  XrdSysMutex mDeletionsMutex; ///< Mutex protecting the list of deletions
-  std::list< std::unique_ptr<Deletion> > mListDeletions; ///< List of deletions
+  DeletionEngine mDeletionEngine; ///< Engine unlinking the deleted files
+  //! Filters of the published statistics, only used by the Publish thread.
+  //! Unchanged statistics are broadcast again every sConsistencyTimeout.
+  PublishFilter mNodePublishFilter;
+  std::map<eos::common::FileSystem::fsid_t, PublishFilter> mFsPublishFilters;
   Load mFstLoad; ///< Net/IO load monitor
   Health mFstHealth; ///< Local disk S.M.A.R.T monitor
 
@@ -226,6 +224,15 @@ private:
   void MgmSyncer();
   void Boot(FileSystem* fs);
 
+  //----------------------------------------------------------------------------
+  //! Get the filter of the statistics published for a file system
+  //!
+  //! @param fsid file system id
+  //!
+  //! @return publish filter, created if needed
+  //----------------------------------------------------------------------------
+  PublishFilter& GetPublishFilter(eos::common::FileSystem::fsid_t fsid);
+
   //----------------------------------------------------------------------------
   //! Scrub filesystem
   //----------------------------------------------------------------------------
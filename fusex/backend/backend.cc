@@ -645,6 +645,111 @@ backend::putMD(const fuse_id& id, eos::fusex::md* md, std::string authid,
   }
 }
 
+/* -------------------------------------------------------------------------- */
+int
+/* -------------------------------------------------------------------------- */
+backend::serializeMD(eos::fusex::md* md, std::string authid,
+                     std::string& mdstream)
+{
+  // temporary add the authid to be used for that request
+  md->set_authid(authid);
+  md->set_clientuuid(clientuuid);
+  bool ok = md->SerializeToString(&mdstream);
+
+  if (ok && EOS_LOGS_DEBUG) {
+    eos_static_debug("MD:\n%s", EosFuse::Instance().mds.dump_md(*md).c_str());
+  }
+
+  md->clear_authid();
+  md->clear_clientuuid();
+  md->clear_implied_authid();
+
+  if (!ok) {
+    eos_static_err("fatal serialization error");
+    return EFAULT;
+  }
+
+  return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+int
+/* -------------------------------------------------------------------------- */
+backend::putMDs(const fuse_id& id, const std::vector<std::string>& mdstreams,
+                std::vector<eos::fusex::response>& responses)
+{
+  XrdCl::URL url("root://" + hostport);
+  url.SetPath("/dummy");
+  XrdCl::URL::ParamsMap query;
+  fusexrdlogin::loginurl(url, query, id.uid, id.gid, id.pid, 0);
+  query["eos.app"] = get_appname();
+  url.SetParams(query);
+  responses.clear();
+  eos::fusex::md_batch batch;
+
+  for (const auto& mdstream : mdstreams) {
+    batch.add_md_(mdstream);
+  }
+
+  std::string batchstream;
+
+  if (!batch.SerializeToString(&batchstream)) {
+    eos_static_err("fatal serialization error");
+    return EFAULT;
+  }
+
+  XrdCl::Buffer arg;
+  XrdCl::Buffer* response = 0;
+  std::string prefix = "/?fusexb:";
+  arg.Append(prefix.c_str(), prefix.length());
+  arg.Append(batchstream.c_str(), batchstream.length());
+  eos_static_debug("query: url=%s path=%s records=%lu length=%d",
+                   url.GetURL().c_str(), prefix.c_str(), mdstreams.size(),
+                   batchstream.length());
+  XrdCl::XRootDStatus status = Query(url, XrdCl::QueryCode::OpaqueFile, arg,
+                                     response, put_timeout);
+  std::unique_ptr<XrdCl::Buffer> response_owner(response);
+
+  if (!status.IsOK()) {
+    eos_static_err("batch query resulted in error records=%lu url=%s",
+                   mdstreams.size(), url.GetURL().c_str());
+
+    if (status.code == XrdCl::errErrorResponse) {
+      return mapErrCode(status.errNo);
+    } else {
+      return EIO;
+    }
+  }
+
+  if (!response || !response->GetBuffer() || (response->GetSize() <= 6)) {
+    eos_static_err("protocol error - to short response received");
+    return EIO;
+  }
+
+  if (std::string(response->GetBuffer(), 6) != "Fusex:") {
+    eos_static_err("protocol error - fusex: prefix missing in response");
+    return EIO;
+  }
+
+  std::string sresponse;
+  std::string b64response;
+  b64response.assign(response->GetBuffer() + 6, response->GetSize() - 6);
+  eos::common::SymKey::DeBase64(b64response, sresponse);
+  eos::fusex::md_batch_response batch_resp;
+
+  if (!batch_resp.ParseFromString(sresponse) ||
+      (batch_resp.response__size() != (int) mdstreams.size())) {
+    eos_static_err("parsing error/wrong number of responses received");
+    return EIO;
+  }
+
+  for (int i = 0; i < batch_resp.response__size(); ++i) {
+    responses.push_back(batch_resp.response_(i));
+  }
+
+  return 0;
+}
+
 /* -------------------------------------------------------------------------- */
 int
 /* -------------------------------------------------------------------------- */
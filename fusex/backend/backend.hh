@@ -84,6 +84,14 @@ public:
   int putMD(const fuse_id& id, eos::fusex::md* md, std::string authid,
             XrdSysMutex* locker);
 
+  // serialize an md record for putMDs, the caller holds the md lock
+  int serializeMD(eos::fusex::md* md, std::string authid,
+                  std::string& mdstream);
+  // upload several serialized md records with one request, the server
+  // applies them in the given order and returns one response per record
+  int putMDs(const fuse_id& id, const std::vector<std::string>& mdstreams,
+             std::vector<eos::fusex::response>& responses);
+
   int getCAP(fuse_req_t req,
              uint64_t inode,
              std::vector<eos::fusex::container>& cont
@@ -4,6 +4,11 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
+#include <utime.h>
+#include <dirent.h>
+#include <atomic>
+#include <thread>
+#include <vector>
 
 #include "common/Timing.hh"
 #include "common/ShellCmd.hh"
@@ -20,6 +25,10 @@
 #define LOOP_12 10
 #define LOOP_13 10
 #define LOOP_14 100
+#define LOOP_15 1000
+#define LOOP_16 100000
+#define THREADS_16 32
+#define LOOP_17 256
 
 int main(int argc, char* argv[])
 {
@@ -561,6 +570,201 @@ int main(int argc, char* argv[])
     COMMONTIMING("rename-circular-loop", &tm);
   }
 
+  // ------------------------------------------------------------------------ //
+  testno = 15;
+
+  if ((testno >= test_start) && (testno <= test_stop)) {
+    fprintf(stderr, ">>> test %04d\n", testno);
+    // small file creation like an archive extraction, metadata updates of
+    // many files are uploaded to the MGM in batches
+    char buffer[1024];
+
+    for (size_t i = 0; i < sizeof(buffer); i++) {
+      buffer[i] = 'A' + (i % 26);
+    }
+
+    if (mkdir("small-files", S_IRWXU)) {
+      fprintf(stderr, "[test=%03d] mkdir failed\n", testno);
+      exit(testno);
+    }
+
+    COMMONTIMING("small-file-start", &tm);
+
+    for (size_t i = 0; i < LOOP_15; i++) {
+      snprintf(name, sizeof(name), "small-files/f-%lu", i);
+      int fd = creat(name, S_IRWXU);
+
+      if (fd < 0) {
+        fprintf(stderr, "[test=%03d] creat failed i=%lu\n", testno, i);
+        exit(testno);
+      }
+
+      if (write(fd, buffer, sizeof(buffer)) != sizeof(buffer)) {
+        fprintf(stderr, "[test=%03d] write failed i=%lu\n", testno, i);
+        exit(testno);
+      }
+
+      close(fd);
+      struct utimbuf times;
+      times.actime = times.modtime = 1000000000 + i;
+
+      if (utime(name, &times)) {
+        fprintf(stderr, "[test=%03d] utime failed i=%lu\n", testno, i);
+        exit(testno);
+      }
+    }
+
+    COMMONTIMING("small-file-create-loop", &tm);
+    eos::common::ShellCmd removethedir("rm -rf small-files/");
+    eos::common::cmd_status rc = removethedir.wait(60);
+
+    if (rc.exit_code) {
+      fprintf(stderr, "[test=%03d] rm -rf failed\n", testno);
+      exit(testno);
+    }
+
+    COMMONTIMING("small-file-rm-rf", &tm);
+    float create_ms = tm.GetTagTimelapse("small-file-start",
+                                         "small-file-create-loop");
+    float delete_ms = tm.GetTagTimelapse("small-file-create-loop",
+                                         "small-file-rm-rf");
+    fprintf(stderr, "[test=%03d] small files created=%d create-rate=%.02f Hz "
+            "delete-rate=%.02f Hz\n", testno, LOOP_15,
+            create_ms ? 1000.0 * LOOP_15 / create_ms : 0,
+            delete_ms ? 1000.0 * LOOP_15 / delete_ms : 0);
+  }
+
+  // ------------------------------------------------------------------------ //
+  testno = 16;
+
+  if ((testno >= test_start) && (testno <= test_stop)) {
+    fprintf(stderr, ">>> test %04d\n", testno);
+    // parallel lookup/getattr of cached inodes like a parallel build
+    const size_t nfiles = 1000;
+
+    if (mkdir("stat-files", S_IRWXU)) {
+      fprintf(stderr, "[test=%03d] mkdir failed\n", testno);
+      exit(testno);
+    }
+
+    for (size_t i = 0; i < nfiles; i++) {
+      snprintf(name, sizeof(name), "stat-files/f-%lu", i);
+      int fd = creat(name, S_IRWXU);
+
+      if (fd < 0) {
+        fprintf(stderr, "[test=%03d] creat failed i=%lu\n", testno, i);
+        exit(testno);
+      }
+
+      close(fd);
+    }
+
+    COMMONTIMING("parallel-stat-start", &tm);
+    std::atomic<size_t> failures {0};
+    std::vector<std::thread> workers;
+
+    for (size_t t = 0; t < THREADS_16; t++) {
+      workers.emplace_back([t, nfiles, &failures]() {
+        char fname[1024];
+        struct stat sbuf;
+
+        for (size_t i = 0; i < LOOP_16 / THREADS_16; i++) {
+          snprintf(fname, sizeof(fname), "stat-files/f-%lu",
+                   (i * THREADS_16 + t) % nfiles);
+
+          if (stat(fname, &sbuf)) {
+            failures++;
+          }
+
+          if (!(i % 100)) {
+            DIR* dir = opendir("stat-files");
+
+            if (!dir) {
+              failures++;
+            } else {
+              while (readdir(dir)) { }
+
+              closedir(dir);
+            }
+          }
+        }
+      });
+    }
+
+    for (auto& worker : workers) {
+      worker.join();
+    }
+
+    COMMONTIMING("parallel-stat-loop", &tm);
+
+    if (failures) {
+      fprintf(stderr, "[test=%03d] parallel stat failed n=%lu\n", testno,
+              failures.load());
+      exit(testno);
+    }
+
+    float stat_ms = tm.GetTagTimelapse("parallel-stat-start",
+                                       "parallel-stat-loop");
+    fprintf(stderr, "[test=%03d] parallel stat threads=%d stats=%d rate=%.02f Hz\n",
+            testno, THREADS_16, LOOP_16, stat_ms ? 1000.0 * LOOP_16 / stat_ms : 0);
+    eos::common::ShellCmd removethedir("rm -rf stat-files/");
+    eos::common::cmd_status rc = removethedir.wait(60);
+
+    if (rc.exit_code) {
+      fprintf(stderr, "[test=%03d] rm -rf failed\n", testno);
+      exit(testno);
+    }
+  }
+
+  // ------------------------------------------------------------------------ //
+  testno = 17;
+
+  if ((testno >= test_start) && (testno <= test_stop)) {
+    fprintf(stderr, ">>> test %04d\n", testno);
+    // large sequential read throughput with 1M requests
+    const size_t bsize = 1024 * 1024;
+    std::vector<char> block(bsize, 'e');
+    int fd = open("large-read", O_CREAT | O_TRUNC | O_RDWR, S_IRWXU);
+
+    if (fd < 0) {
+      fprintf(stderr, "[test=%03d] creat failed\n", testno);
+      exit(testno);
+    }
+
+    for (size_t i = 0; i < LOOP_17; i++) {
+      if (write(fd, block.data(), bsize) != (ssize_t) bsize) {
+        fprintf(stderr, "[test=%03d] write failed i=%lu\n", testno, i);
+        exit(testno);
+      }
+    }
+
+    close(fd);
+    fd = open("large-read", O_RDONLY);
+
+    if (fd < 0) {
+      fprintf(stderr, "[test=%03d] open failed\n", testno);
+      exit(testno);
+    }
+
+    // don't measure the kernel page cache
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    COMMONTIMING("large-read-start", &tm);
+
+    for (size_t i = 0; i < LOOP_17; i++) {
+      if (read(fd, block.data(), bsize) != (ssize_t) bsize) {
+        fprintf(stderr, "[test=%03d] read failed i=%lu\n", testno, i);
+        exit(testno);
+      }
+    }
+
+    COMMONTIMING("large-read-loop", &tm);
+    close(fd);
+    unlink("large-read");
+    float read_ms = tm.GetTagTimelapse("large-read-start", "large-read-loop");
+    fprintf(stderr, "[test=%03d] sequential read size=%d MB rate=%.02f MB/s\n",
+            testno, LOOP_17, read_ms ? 1000.0 * LOOP_17 / read_ms : 0);
+  }
+
   tm.Print();
   fprintf(stdout, "realtime = %.02f", tm.RealTime());
 }
@@ -0,0 +1,201 @@
+//------------------------------------------------------------------------------
+// File bufferpool.hh
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2019 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#ifndef __EOS_FUSE_BUFFERPOOL_HH__
+#define __EOS_FUSE_BUFFERPOOL_HH__
+
+#include <stdlib.h>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+//------------------------------------------------------------------------------
+//! Pool of page-aligned IO buffers
+//!
+//! Buffers are grouped in power-of-two size classes starting with one page.
+//! Released buffers are kept per size class up to a maximum number of cached
+//! bytes and handed out again without touching their content. Buffers larger
+//! than the biggest class are allocated and freed directly.
+//------------------------------------------------------------------------------
+class bufferpool
+{
+public:
+  static constexpr size_t kPageSize = 4096;
+  static constexpr size_t kClasses = 15; // 4k ... 64M
+
+  //----------------------------------------------------------------------------
+  //! Process wide pool, never destroyed since buffers can be released by
+  //! static objects during shutdown
+  //----------------------------------------------------------------------------
+  static bufferpool& instance()
+  {
+    static bufferpool* pool = new bufferpool();
+    return *pool;
+  }
+
+  bufferpool() : max_cached(512 * 1024 * 1024), cached_size(0), hits(0),
+    misses(0) { }
+
+  void configure(size_t _max_cached)
+  {
+    max_cached = _max_cached;
+  }
+
+  void* allocate(size_t size)
+  {
+    size_t c = size_class(size);
+
+    if (c < kClasses) {
+      std::lock_guard<std::mutex> lock(slabs[c].mutex);
+
+      if (!slabs[c].free.empty()) {
+        void* ptr = slabs[c].free.back();
+        slabs[c].free.pop_back();
+        cached_size -= class_size(c);
+        hits++;
+        return ptr;
+      }
+    }
+
+    misses++;
+    void* ptr = 0;
+
+    if (posix_memalign(&ptr, kPageSize, (c < kClasses) ? class_size(c) : size)) {
+      throw std::bad_alloc();
+    }
+
+    return ptr;
+  }
+
+  void deallocate(void* ptr, size_t size)
+  {
+    size_t c = size_class(size);
+
+    if ((c < kClasses) && ((cached_size + class_size(c)) <= max_cached)) {
+      std::lock_guard<std::mutex> lock(slabs[c].mutex);
+      slabs[c].free.push_back(ptr);
+      cached_size += class_size(c);
+      return;
+    }
+
+    free(ptr);
+  }
+
+  size_t cached() const
+  {
+    return cached_size;
+  }
+
+  size_t get_hits() const
+  {
+    return hits;
+  }
+
+  size_t get_misses() const
+  {
+    return misses;
+  }
+
+  static size_t class_size(size_t c)
+  {
+    return (kPageSize << c);
+  }
+
+  static size_t size_class(size_t size)
+  {
+    size_t c = 0;
+
+    while ((c < kClasses) && (class_size(c) < size)) {
+      c++;
+    }
+
+    return c;
+  }
+
+private:
+  struct slab {
+    std::mutex mutex;
+    std::vector<void*> free;
+  };
+
+  slab slabs[kClasses];
+  std::atomic<size_t> max_cached;
+  std::atomic<size_t> cached_size;
+  std::atomic<size_t> hits;
+  std::atomic<size_t> misses;
+};
+
+//------------------------------------------------------------------------------
+//! Allocator taking memory from the buffer pool. Elements are default
+//! initialised, so growing a char vector does not clear the memory.
+//------------------------------------------------------------------------------
+template<typename T>
+class pool_allocator
+{
+public:
+  typedef T value_type;
+
+  pool_allocator() { }
+
+  template<typename U>
+  pool_allocator(const pool_allocator<U>&) { }
+
+  T* allocate(size_t n)
+  {
+    return static_cast<T*>(bufferpool::instance().allocate(n * sizeof(T)));
+  }
+
+  void deallocate(T* ptr, size_t n)
+  {
+    bufferpool::instance().deallocate(ptr, n * sizeof(T));
+  }
+
+  template<typename U>
+  void construct(U* ptr)
+  {
+    ::new(static_cast<void*>(ptr)) U;
+  }
+
+  template<typename U, typename... Args>
+  void construct(U* ptr, Args&& ... args)
+  {
+    ::new(static_cast<void*>(ptr)) U(std::forward<Args>(args)...);
+  }
+
+  template<typename U>
+  bool operator==(const pool_allocator<U>&) const
+  {
+    return true;
+  }
+
+  template<typename U>
+  bool operator!=(const pool_allocator<U>&) const
+  {
+    return false;
+  }
+};
+
+typedef std::vector<char, pool_allocator<char>> io_buffer;
+
+#endif
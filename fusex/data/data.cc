@@ -66,6 +66,10 @@ data::init()
   XrdCl::Proxy::sWrBufferManager.configure(128,
       128 * 1024,
       cachehandler::instance().get_config().max_inflight_write_buffer_size);
+  // released IO buffers are kept in the page-aligned buffer pool
+  bufferpool::instance().configure(
+    XrdCl::Proxy::sRaBufferManager.cache_size() +
+    XrdCl::Proxy::sWrBufferManager.cache_size());
   datamap.run();
 }
 
@@ -0,0 +1,337 @@
+//------------------------------------------------------------------------------
+// File readpattern.hh
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2019 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#ifndef __EOS_FUSE_READPATTERN_HH__
+#define __EOS_FUSE_READPATTERN_HH__
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+//------------------------------------------------------------------------------
+//! Read pattern detection for the read-ahead of one open file
+//!
+//! Every read is assigned to one of a few cursors. A cursor follows a reader
+//! which continues either right after its previous read (sequential) or at a
+//! constant distance from it (strided, e.g. ROOT baskets of one branch).
+//! Several cursors advancing at the same time describe an interleaved
+//! multi-stream reader. Confident cursors provide the windows to prefetch.
+//! The class is not thread-safe, the proxy uses it with its read lock held.
+//------------------------------------------------------------------------------
+class readpattern
+{
+public:
+
+  enum pattern_t {
+    NONE = 0,
+    SEQUENTIAL = 1,
+    STRIDED = 2,
+    INTERLEAVED = 3,
+    RANDOM = 4,
+    N_PATTERNS = 5
+  };
+
+  struct window {
+    off_t offset;
+    size_t size;
+  };
+
+  static const char* name(pattern_t p)
+  {
+    switch (p) {
+    case SEQUENTIAL:
+      return "seq";
+
+    case STRIDED:
+      return "strided";
+
+    case INTERLEAVED:
+      return "interleaved";
+
+    case RANDOM:
+      return "random";
+
+    default:
+      return "none";
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  //! Read-ahead accounting per pattern, shared by all open files
+  //----------------------------------------------------------------------------
+  class stats
+  {
+  public:
+    stats()
+    {
+      for (size_t i = 0; i < N_PATTERNS; ++i) {
+        read_bytes[i] = 0;
+        hit_bytes[i] = 0;
+        prefetch_bytes[i] = 0;
+      }
+    }
+
+    void add_read(pattern_t p, uint64_t bytes)
+    {
+      read_bytes[p] += bytes;
+    }
+
+    void add_hit(pattern_t p, uint64_t bytes)
+    {
+      hit_bytes[p] += bytes;
+    }
+
+    void add_prefetch(pattern_t p, uint64_t bytes)
+    {
+      prefetch_bytes[p] += bytes;
+    }
+
+    // percentage of the bytes read which were served from read-ahead
+    float efficiency(pattern_t p) const
+    {
+      uint64_t r = read_bytes[p];
+      return r ? (100.0 * hit_bytes[p] / r) : 0.0;
+    }
+
+    // percentage of the prefetched bytes which were used
+    float volume_efficiency(pattern_t p) const
+    {
+      uint64_t f = prefetch_bytes[p];
+      return f ? (100.0 * hit_bytes[p] / f) : 0.0;
+    }
+
+    uint64_t read(pattern_t p) const
+    {
+      return read_bytes[p];
+    }
+
+  private:
+    std::atomic<uint64_t> read_bytes[N_PATTERNS];
+    std::atomic<uint64_t> hit_bytes[N_PATTERNS];
+    std::atomic<uint64_t> prefetch_bytes[N_PATTERNS];
+  };
+
+  readpattern(size_t max_cursors = 4, off_t max_stride = 64 * 1024 * 1024) :
+    mMaxCursors(max_cursors), mMaxStride(max_stride), mTick(0),
+    mLast(NONE) { }
+
+  //----------------------------------------------------------------------------
+  //! Account a read and classify it
+  //!
+  //! @return pattern of the cursor serving this read
+  //----------------------------------------------------------------------------
+  pattern_t observe(off_t offset, size_t size)
+  {
+    mTick++;
+    cursor* c = 0;
+
+    // continuation of a known cursor
+    for (auto& it : mCursors) {
+      bool contiguous = (offset == (it.offset + (off_t) it.size));
+
+      if (contiguous || (it.stride && (offset == (it.offset + it.stride)))) {
+        c = &it;
+        c->contiguous = contiguous;
+        break;
+      }
+    }
+
+    if (c) {
+      c->stride = offset - c->offset;
+      c->hits++;
+    } else {
+      // learn a stride from a cursor which is not established yet
+      for (auto& it : mCursors) {
+        if ((it.hits < kConfidentHits) && (offset > it.offset) &&
+            ((offset - it.offset) <= mMaxStride)) {
+          c = &it;
+          c->stride = offset - c->offset;
+          c->contiguous = false;
+          c->hits = 1;
+          break;
+        }
+      }
+    }
+
+    if (!c) {
+      if (mCursors.size() < mMaxCursors) {
+        mCursors.push_back(cursor());
+        c = &mCursors.back();
+      } else {
+        // replace the least recently used cursor
+        c = &(*std::min_element(mCursors.begin(), mCursors.end(),
+        [](const cursor & a, const cursor & b) {
+          return a.used < b.used;
+        }));
+        *c = cursor();
+      }
+    }
+
+    if (c->prefetched < (offset + (off_t) size)) {
+      c->prefetched = offset + size;
+    }
+
+    c->offset = offset;
+    c->size = size;
+    c->used = mTick;
+
+    if (c->hits < kConfidentHits) {
+      mLast = RANDOM;
+    } else if (active_cursors() > 1) {
+      mLast = INTERLEAVED;
+    } else {
+      mLast = c->contiguous ? SEQUENTIAL : STRIDED;
+    }
+
+    return mLast;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Windows to prefetch for all confident cursors
+  //!
+  //! @param blocks number of windows ahead of every cursor
+  //! @param seq_window window size for sequential cursors
+  //! @param budget max number of bytes to return
+  //! @param out windows not returned before
+  //----------------------------------------------------------------------------
+  void predict(size_t blocks, size_t seq_window, size_t budget,
+               std::vector<window>& out)
+  {
+    out.clear();
+
+    for (auto& c : mCursors) {
+      if (!confident(c)) {
+        continue;
+      }
+
+      size_t wsize = c.contiguous ? std::max(seq_window, c.size) : c.size;
+      off_t step = c.contiguous ? (off_t) wsize : c.stride;
+
+      // zero sized reads or windows would never advance the prediction
+      if (!wsize || (step <= 0)) {
+        continue;
+      }
+
+      // first window following the current read and the end of the horizon
+      off_t first = c.contiguous ? (c.offset + (off_t) c.size) :
+                    (c.offset + c.stride);
+      off_t horizon = first + step * (off_t) blocks;
+      off_t next = first;
+
+      if (c.contiguous) {
+        next = std::max(next, c.prefetched);
+      } else {
+        while (next < c.prefetched) {
+          next += step;
+        }
+      }
+
+      while ((next + (off_t) wsize) <= horizon) {
+
+        if (budget < wsize) {
+          return;
+        }
+
+        out.push_back(window{next, wsize});
+        budget -= wsize;
+        c.prefetched = next + wsize;
+        next += step;
+      }
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  //! Check if a prefetched range can still be read by a confident cursor
+  //----------------------------------------------------------------------------
+  bool useful(off_t offset, size_t size) const
+  {
+    for (auto& c : mCursors) {
+      if (!confident(c)) {
+        continue;
+      }
+
+      if (((offset + (off_t) size) > c.offset) && (offset < c.prefetched)) {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  pattern_t last() const
+  {
+    return mLast;
+  }
+
+  size_t active_cursors() const
+  {
+    size_t n = 0;
+
+    for (auto& c : mCursors) {
+      if (confident(c)) {
+        n++;
+      }
+    }
+
+    return n;
+  }
+
+  void reset()
+  {
+    mCursors.clear();
+    mLast = NONE;
+  }
+
+private:
+  static constexpr size_t kConfidentHits = 2;
+
+  struct cursor {
+    cursor() : offset(0), size(0), stride(0), prefetched(0), hits(0),
+      used(0), contiguous(false) { }
+
+    off_t offset; // offset of the last read
+    size_t size; // size of the last read
+    off_t stride; // distance between the last two reads
+    off_t prefetched; // end of the last prefetched window
+    size_t hits; // reads following the stride in a row
+    uint64_t used; // tick of the last read
+    bool contiguous; // last read followed the previous one without a gap
+  };
+
+  bool confident(const cursor& c) const
+  {
+    // cursors which did not advance during a full round over all cursors
+    // are considered abandoned
+    return ((c.hits >= kConfidentHits) &&
+            ((mTick - c.used) <= (2 * mMaxCursors)));
+  }
+
+  std::vector<cursor> mCursors;
+  size_t mMaxCursors;
+  off_t mMaxStride;
+  uint64_t mTick;
+  pattern_t mLast;
+};
+
+#endif
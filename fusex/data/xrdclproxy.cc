@@ -37,6 +37,7 @@ ssize_t XrdCl::Proxy::sChunkTimeout = 300;
 
 XrdCl::BufferManager XrdCl::Proxy::sWrBufferManager;
 XrdCl::BufferManager XrdCl::Proxy::sRaBufferManager;
+readpattern::stats XrdCl::Proxy::sRaPatternStats;
 
 /* -------------------------------------------------------------------------- */
 XRootDStatus
@@ -83,10 +84,16 @@ XrdCl::Proxy::Read(uint64_t offset,
   bool request_next = true;
   std::set<uint64_t> delete_chunk;
   void* pbuffer = buffer;
+  readpattern::pattern_t pattern = readpattern::NONE;
 
   if (XReadAheadStrategy != NONE) {
     ReadCondVar().Lock();
     XReadAheadBlocksIs = 0;
+    // strided and interleaved readers are served by the pattern read-ahead,
+    // the sequential window logic below would drop their chunks
+    pattern = XReadPattern.observe(offset, size);
+    bool pattern_mode = ((pattern == readpattern::STRIDED) ||
+                         (pattern == readpattern::INTERLEAVED));
 
     if (ChunkRMap().size()) {
       auto last_chunk_before_match = ChunkRMap().begin();
@@ -133,6 +140,7 @@ XrdCl::Proxy::Read(uint64_t offset,
                    match_size);
             bytesRead += match_size;
             mTotalReadAheadHitBytes += match_size;
+            sRaPatternStats.add_hit(pattern, match_size);
             buffer = (char*) buffer + match_size;
             current_offset = match_offset + match_size;
             current_size -= match_size;
@@ -170,7 +178,17 @@ XrdCl::Proxy::Read(uint64_t offset,
         }
       }
 
-      if (readahead_window_hit) {
+      if (pattern_mode) {
+        // remove chunks which are not ahead of any cursor anymore
+        for (auto it = ChunkRMap().begin(); it != ChunkRMap().end(); ++it) {
+          XrdSysCondVarHelper lLock(it->second->ReadCondVar());
+
+          if (it->second->done() &&
+              !XReadPattern.useful(it->second->offset(), it->second->size())) {
+            delete_chunk.insert(it->first);
+          }
+        }
+      } else if (readahead_window_hit) {
         // check if we can remove previous prefetched chunks, we keep one block before the current read position
         for (auto it = ChunkRMap().begin(); it != last_chunk_before_match; ++it) {
           XrdSysCondVarHelper lLock(it->second->ReadCondVar());
@@ -200,7 +218,7 @@ XrdCl::Proxy::Read(uint64_t offset,
       for (auto it = delete_chunk.begin(); it != delete_chunk.end(); ++it) {
         ChunkRMap().erase(*it);
       }
-    } else {
+    } else if (!pattern_mode) {
       if ((off_t) offset == mPosition) {
         XReadAheadReenableHits++;
 
@@ -233,7 +251,62 @@ XrdCl::Proxy::Read(uint64_t offset,
       }
     }
 
-    if (request_next) {
+    if (pattern_mode) {
+      if (!XReadPatternReader) {
+        sRaBufferManager.register_reader();
+        XReadPatternReader = true;
+      }
+
+      // chunks held by this file count against its share of the budget
+      size_t outstanding = 0;
+
+      for (auto it = ChunkRMap().begin(); it != ChunkRMap().end(); ++it) {
+        XrdSysCondVarHelper lLock(it->second->ReadCondVar());
+        outstanding += it->second->size();
+      }
+
+      size_t budget = sRaBufferManager.reader_budget();
+      budget = (budget > outstanding) ? (budget - outstanding) : 0;
+      size_t blocks = std::max((size_t) 1,
+                               XReadAheadBlocksMax / std::max((size_t) 1, XReadPattern.active_cursors()));
+      std::vector<readpattern::window> windows;
+      XReadPattern.predict(blocks, std::min(XReadAheadNomConfigured, XReadAheadMax),
+                           budget, windows);
+
+      for (auto& w : windows) {
+        if (w.offset > get_readahead_maximum_position()) {
+          break;
+        }
+
+        if (ChunkRMap().count(w.offset)) {
+          continue;
+        }
+
+        if (EOS_LOGS_DEBUG) {
+          eos_debug("----: pattern pre-fetch pattern=%s pf-offset=%lu size=%lu",
+                    readpattern::name(pattern), (unsigned long) w.offset, w.size);
+        }
+
+        ReadCondVar().UnLock();
+        XrdCl::Proxy::read_handler rahread = ReadAsyncPrepare(w.offset, w.size, false);
+
+        if (!rahread->valid()) {
+          ReadCondVar().Lock();
+          // no buffer available
+          break;
+        }
+
+        XRootDStatus rstatus = PreReadAsync(w.offset, w.size, rahread, timeout);
+        ReadCondVar().Lock();
+
+        if (rstatus.IsOK()) {
+          mTotalReadAheadBytes += w.size;
+          sRaPatternStats.add_prefetch(pattern, w.size);
+        }
+      }
+
+      ReadCondVar().UnLock();
+    } else if (request_next) {
       // dynamic window scaling
       if (readahead_window_hit) {
         if (XReadAheadStrategy == DYNAMIC) {
@@ -295,6 +368,7 @@ XrdCl::Proxy::Read(uint64_t offset,
           if (rstatus.IsOK()) {
             mReadAheadPosition += XReadAheadNom;
             mTotalReadAheadBytes += XReadAheadNom;
+            sRaPatternStats.add_prefetch(pattern, XReadAheadNom);
           }
 
           ReadCondVar().Lock();
@@ -331,6 +405,7 @@ XrdCl::Proxy::Read(uint64_t offset,
   if (status.IsOK()) {
     mPosition = offset + size;
     mTotalBytes += bytesRead;
+    sRaPatternStats.add_read(pattern, bytesRead);
   }
 
   return status;
@@ -32,6 +32,8 @@
 #include "llfusexx.hh"
 #include "common/Logging.hh"
 #include "common/Timing.hh"
+#include "data/readpattern.hh"
+#include "data/bufferpool.hh"
 #include <memory>
 #include <map>
 #include <string>
@@ -178,7 +180,7 @@ private:
 };
 
 // ---------------------------------------------------------------------- //
-typedef std::shared_ptr<std::vector<char>> shared_buffer;
+typedef std::shared_ptr<io_buffer> shared_buffer;
 // ---------------------------------------------------------------------- //
 
 // ---------------------------------------------------------------------- //
@@ -193,11 +195,11 @@ public:
   {
     max = _max;
     buffersize = _default_size;
-    queued_size = 0;
     inflight_size = 0;
     inflight_buffers = 0;
     xoff_cnt = 0;
     nobuf_cnt = 0;
+    readers = 0;
     max_inflight_size = _max_inflight_size;
   }
 
@@ -248,22 +250,13 @@ public:
       std::this_thread::sleep_for(std::chrono::milliseconds(100));
     } while (1);
 
+    // page-aligned memory from the buffer pool, the content is not cleared
+    shared_buffer buffer = std::make_shared<io_buffer>();
+    buffer->reserve(size);
+    buffer->resize(size);
     XrdSysMutexHelper lLock(this);
-    size_t cap_size = size;
     inflight_buffers++;
-    shared_buffer buffer;
-
-    if (!queue.size() || (size < buffersize)) {
-      inflight_size += cap_size;
-      buffer = std::make_shared<std::vector<char>>(cap_size, 0);
-    } else {
-      buffer = queue.front();
-      queued_size -= buffer->capacity();
-      buffer->resize(cap_size);
-      buffer->reserve(cap_size);
-      inflight_size += buffer->capacity();
-      queue.pop();
-    }
+    inflight_size += buffer->capacity();
 
     if (EOS_LOGS_DEBUG) {
       eos_static_debug("get-buffer %lx size %lu", (uint64_t)(&((*buffer)[0])),
@@ -284,23 +277,12 @@ public:
     }
 
     inflight_buffers--;
-
-    if ((queue.size() == max) || (buffer->capacity() < buffersize)) {
-      return;
-    } else {
-      queue.push(buffer);
-      buffer->resize(buffersize);
-      buffer->reserve(buffersize);
-      buffer->shrink_to_fit();
-      queued_size += buffersize;
-      return;
-    }
+    // the memory goes back to the buffer pool with the last reference
   }
 
   const size_t queued()
   {
-    XrdSysMutexHelper lLock(this);
-    return queued_size;
+    return bufferpool::instance().cached();
   }
 
   const size_t inflight()
@@ -321,16 +303,51 @@ public:
     return nobuf_cnt;
   }
 
+  // bytes of released buffers this manager used to keep for reuse
+  const size_t cache_size()
+  {
+    XrdSysMutexHelper lLock(this);
+    return max * buffersize;
+  }
+
+  // files doing pattern read-ahead share the inflight budget
+  void register_reader()
+  {
+    XrdSysMutexHelper lLock(this);
+    readers++;
+  }
+
+  void unregister_reader()
+  {
+    XrdSysMutexHelper lLock(this);
+
+    if (readers) {
+      readers--;
+    }
+  }
+
+  // bytes one registered reader may keep prefetched
+  const size_t reader_budget()
+  {
+    XrdSysMutexHelper lLock(this);
+    return std::max(buffersize, max_inflight_size / (readers ? readers : 1));
+  }
+
+  const size_t nreaders()
+  {
+    XrdSysMutexHelper lLock(this);
+    return readers;
+  }
+
 private:
-  std::queue<shared_buffer> queue;
   size_t max;
   size_t buffersize;
-  size_t queued_size;
   size_t inflight_size;
   size_t inflight_buffers;
   size_t max_inflight_size;
   size_t xoff_cnt;
   size_t nobuf_cnt;
+  size_t readers;
 };
 
 
@@ -345,6 +362,7 @@ public:
 
   static BufferManager sWrBufferManager; // write buffer manager
   static BufferManager sRaBufferManager; // async read buffer manager
+  static readpattern::stats sRaPatternStats; // read-ahead per read pattern
 
   // ---------------------------------------------------------------------- //
   XRootDStatus OpenAsync(const std::string& url,
@@ -572,6 +590,7 @@ public:
     XReadAheadStrategy = rhs;
     XReadAheadMin = min;
     XReadAheadNom = nom;
+    XReadAheadNomConfigured = nom;
     XReadAheadMax = max;
     XReadAheadBlocksMax = rablocks;
     XReadAheadBlocksNom = 1;
@@ -637,6 +656,8 @@ public:
     XReadAheadBlocksMin = 1;
     XReadAheadReenableHits = 0;
     XReadAheadBlocksIs = 0;
+    XReadAheadNomConfigured = XReadAheadNom;
+    XReadPatternReader = false;
     mPosition = 0;
     mReadAheadPosition = 0;
     mTotalBytes = 0;
@@ -708,8 +729,14 @@ public:
       Collect();
     }
 
-    eos_notice("ra-efficiency=%f ra-vol-efficiency=%f", get_readahead_efficiency(),
-               get_readahead_volume_efficiency());
+    if (XReadPatternReader) {
+      sRaBufferManager.unregister_reader();
+    }
+
+    eos_notice("ra-efficiency=%f ra-vol-efficiency=%f ra-pattern=%s",
+               get_readahead_efficiency(),
+               get_readahead_volume_efficiency(),
+               readpattern::name(XReadPattern.last()));
   }
 
   // ---------------------------------------------------------------------- //
@@ -787,7 +814,6 @@ public:
                       uint16_t timeout = 0) : mProxy(file), woffset(off), mTimeout(timeout)
     {
       mBuffer = sWrBufferManager.get_buffer(size);
-      mBuffer->resize(size);
       XrdSysCondVarHelper lLock(mProxy->WriteCondVar());
       mProxy->WriteCondVar().Signal();
     }
@@ -812,7 +838,7 @@ public:
       return mTimeout;
     }
 
-    const std::vector<char>& vbuffer()
+    const io_buffer& vbuffer()
     {
       return *mBuffer;
     }
@@ -903,7 +929,7 @@ public:
       return &((*mBuffer)[0]);
     }
 
-    std::vector<char>& vbuffer()
+    io_buffer& vbuffer()
     {
       return *mBuffer;
     }
@@ -1251,6 +1277,9 @@ private:
   size_t XReadAheadBlocksMax; // maximum number of prefetch blocks
   size_t XReadAheadBlocksIs; // current blocks in the read-ahead
   size_t XReadAheadReenableHits; // sequential read hits in a row
+  size_t XReadAheadNomConfigured; // configured nominal ra block size
+  readpattern XReadPattern; // strided/interleaved access detection
+  bool XReadPatternReader; // registered for the pattern read-ahead budget
   off_t mPosition;
   off_t mReadAheadPosition;
   off_t mTotalBytes;
@@ -541,6 +541,10 @@ EosFuse::run(int argc, char* argv[], void* userdata)
         root["options"]["md-backend.put.timeout"] = 120;
       }
 
+      if (!root["options"].isMember("md-backend.put.batch")) {
+        root["options"]["md-backend.put.batch"] = 64;
+      }
+
       if (!root["options"].isMember("data-kernelcache")) {
         root["options"]["data-kernelcache"] = 1;
       }
@@ -796,6 +800,8 @@ EosFuse::run(int argc, char* argv[], void* userdata)
       root["options"]["md-backend.timeout"].asDouble();
     config.options.md_backend_put_timeout =
       root["options"]["md-backend.put.timeout"].asDouble();
+    config.options.md_backend_put_batch =
+      root["options"]["md-backend.put.batch"].asInt();
     config.options.data_kernelcache = root["options"]["data-kernelcache"].asInt();
     config.options.mkdir_is_sync = root["options"]["mkdir-is-sync"].asInt();
     config.options.create_is_sync = root["options"]["create-is-sync"].asInt();
@@ -1528,12 +1534,13 @@ EosFuse::run(int argc, char* argv[], void* userdata)
       eos_static_warning("sss-keytabfile         := %s", config.ssskeytab.c_str());
     }
 
-    eos_static_warning("options                := backtrace=%d md-cache:%d md-enoent:%.02f md-timeout:%.02f md-put-timeout:%.02f data-cache:%d mkdir-sync:%d create-sync:%d symlink-sync:%d rename-sync:%d rmdir-sync:%d flush:%d flush-w-open:%d locking:%d no-fsync:%s ol-mode:%03o show-tree-size:%d free-md-asap:%d core-affinity:%d no-xattr:%d no-link:%d nocache-graceperiod:%d rm-rf-protect-level=%d rm-rf-bulk=%d t(lease)=%d t(size-flush)=%d",
+    eos_static_warning("options                := backtrace=%d md-cache:%d md-enoent:%.02f md-timeout:%.02f md-put-timeout:%.02f md-put-batch:%d data-cache:%d mkdir-sync:%d create-sync:%d symlink-sync:%d rename-sync:%d rmdir-sync:%d flush:%d flush-w-open:%d locking:%d no-fsync:%s ol-mode:%03o show-tree-size:%d free-md-asap:%d core-affinity:%d no-xattr:%d no-link:%d nocache-graceperiod:%d rm-rf-protect-level=%d rm-rf-bulk=%d t(lease)=%d t(size-flush)=%d",
                        config.options.enable_backtrace,
                        config.options.md_kernelcache,
                        config.options.md_kernelcache_enoent_timeout,
                        config.options.md_backend_timeout,
                        config.options.md_backend_put_timeout,
+                       config.options.md_backend_put_batch,
                        config.options.data_kernelcache,
                        config.options.mkdir_is_sync,
                        config.options.create_is_sync,
@@ -1724,6 +1731,14 @@ EosFuse::init(void* userdata, struct fuse_conn_info* conn)
                 FUSE_CAP_BIG_WRITES;
   conn->capable |= FUSE_CAP_EXPORT_SUPPORT | FUSE_CAP_POSIX_LOCKS |
                    FUSE_CAP_BIG_WRITES;
+#if ( FUSE_USE_VERSION > 28 )
+
+  // let read replies be spliced into the fuse device instead of copied
+  if (conn->capable & FUSE_CAP_SPLICE_WRITE) {
+    conn->want |= FUSE_CAP_SPLICE_WRITE;
+  }
+
+#endif
 }
 
 void
@@ -1808,6 +1823,11 @@ EosFuse::DumpStatistic(ThreadAssistant& assistant)
                "All        ra-buf-queued       := %s\n"
                "All        ra-xoff             := %lu\n"
                "All        ra-nobuff           := %lu\n"
+               "All        ra-pattern-readers  := %lu\n"
+               "All        ra-eff-seq          := %.02f %% vol:%.02f %%\n"
+               "All        ra-eff-strided      := %.02f %% vol:%.02f %%\n"
+               "All        ra-eff-interleaved  := %.02f %% vol:%.02f %%\n"
+               "All        ra-eff-random       := %.02f %% vol:%.02f %%\n"
                "All        rd-buf-inflight     := %s\n"
                "All        rd-buf-queued       := %s\n"
                "All        version             := %s\n"
@@ -1844,6 +1864,15 @@ EosFuse::DumpStatistic(ThreadAssistant& assistant)
                    XrdCl::Proxy::sRaBufferManager.queued(), "b"),
                XrdCl::Proxy::sRaBufferManager.xoff(),
                XrdCl::Proxy::sRaBufferManager.nobuf(),
+               XrdCl::Proxy::sRaBufferManager.nreaders(),
+               XrdCl::Proxy::sRaPatternStats.efficiency(readpattern::SEQUENTIAL),
+               XrdCl::Proxy::sRaPatternStats.volume_efficiency(readpattern::SEQUENTIAL),
+               XrdCl::Proxy::sRaPatternStats.efficiency(readpattern::STRIDED),
+               XrdCl::Proxy::sRaPatternStats.volume_efficiency(readpattern::STRIDED),
+               XrdCl::Proxy::sRaPatternStats.efficiency(readpattern::INTERLEAVED),
+               XrdCl::Proxy::sRaPatternStats.volume_efficiency(readpattern::INTERLEAVED),
+               XrdCl::Proxy::sRaPatternStats.efficiency(readpattern::RANDOM),
+               XrdCl::Proxy::sRaPatternStats.volume_efficiency(readpattern::RANDOM),
                eos::common::StringConversion::GetReadableSizeString(s7,
                    data::datax::sBufferManager.inflight(), "b"),
                eos::common::StringConversion::GetReadableSizeString(s8,
@@ -3936,7 +3965,14 @@ EosFuse::read(fuse_req_t req, fuse_ino_t ino, size_t size, off_t off,
     if ((res = io->ioctx()->peek_pread(req, buf, size, off)) == -1) {
       rc = errno ? errno : EIO;
     } else {
+#if ( FUSE_USE_VERSION > 28 )
+      struct fuse_bufvec bufv = FUSE_BUFVEC_INIT(res);
+      bufv.buf[0].mem = buf;
+      // the buffer is reused afterwards, so pages are not moved to the kernel
+      fuse_reply_data(req, &bufv, (enum fuse_buf_copy_flags) 0);
+#else
       fuse_reply_buf(req, buf, res);
+#endif
     }
 
     io->ioctx()->release_pread();
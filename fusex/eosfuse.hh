@@ -221,6 +221,7 @@ public:
       double md_kernelcache_enoent_timeout;
       double md_backend_timeout;
       double md_backend_put_timeout;
+      int md_backend_put_batch;
       int data_kernelcache;
       int mkdir_is_sync;
       int create_is_sync;
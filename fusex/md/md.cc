@@ -31,6 +31,7 @@
 #include "misc/longstring.hh"
 #include "common/Logging.hh"
 #include "common/StringConversion.hh"
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 #include <vector>
@@ -79,12 +80,14 @@ metad::init(backend* _mdbackend)
   std::string mdstream;
   // load the root node
   fuse_req_t req = 0;
-  XrdSysMutexHelper mLock(mdmap);
-  update(req, mdmap[1], "", true);
+  shared_md root;
+  mdmap.retrieveOrCreateTS(1, root);
+  update(req, root, "", true);
   next_ino.init(EosFuse::Instance().getKV());
   dentrymessaging = false;
   writesizeflush = false;
   appname = false;
+  mdbatch = 0;
   serverversion = "<unkown>";
 }
 
@@ -1746,8 +1749,7 @@ metad::apply(fuse_req_t req, eos::fusex::container& cont, bool listing)
     md->Locker().UnLock();
 
     if (is_new) {
-      XrdSysMutexHelper mLock(mdmap);
-      mdmap[ino] = md;
+      mdmap.insertTS(ino, md);
       stat.inodes_inc();
       stat.inodes_ever_inc();
     }
@@ -2050,19 +2052,23 @@ metad::apply(fuse_req_t req, eos::fusex::container& cont, bool listing)
 void
 metad::mdcflush(ThreadAssistant& assistant)
 {
-  uint64_t lastflushid = 0;
+  std::vector<uint64_t> lastflushids;
 
   while (!assistant.terminationRequested()) {
     {
       mdflush.Lock();
 
-      if (mdqueue.count(lastflushid)) {
-        // remove entries from the mdqueue, if their ref count is 0
-        if (!mdqueue[lastflushid]) {
-          mdqueue.erase(lastflushid);
+      for (auto lastflushid : lastflushids) {
+        if (mdqueue.count(lastflushid)) {
+          // remove entries from the mdqueue, if their ref count is 0
+          if (!mdqueue[lastflushid]) {
+            mdqueue.erase(lastflushid);
+          }
         }
       }
 
+      lastflushids.clear();
+
       stat.inodes_backlog_store(mdqueue.size());
 
       while (mdqueue.size() == 0) {
@@ -2083,18 +2089,58 @@ metad::mdcflush(ThreadAssistant& assistant)
       std::string authid = it->authid();
       fuse_id f_id = it->get_fuse_id();
       mdx::md_op op = it->op();
-      lastflushid = ino;
+      lastflushids.push_back(ino);
       eos_static_info("metacache::flush ino=%#lx flushqueue-size=%u", ino,
                       mdflushqueue.size());
       eos_static_info("metacache::flush %s", flushentry::dump(*it).c_str());
-      mdflushqueue.erase(it);
-      mdqueue[ino]--;
+      std::vector<flushentry> batch;
+      size_t max_batch = std::min(max_mdbatch(), (size_t) std::max(0,
+                                  EosFuse::Instance().Config().options.md_backend_put_batch));
+
+      if ((max_batch > 1) && ((op == metad::mdx::ADD) ||
+                              (op == metad::mdx::UPDATE) || (op == metad::mdx::RM))) {
+        // take consecutive uploads of the same caller, an inode appears only
+        // once per batch to keep the order of its changes
+        std::set<uint64_t> batch_ids;
+        batch.push_back(*it);
+        batch_ids.insert(ino);
+        mdflushqueue.erase(it);
+        mdqueue[ino]--;
+
+        while (mdflushqueue.size() && (batch.size() < max_batch)) {
+          auto next = mdflushqueue.begin();
+          fuse_id n_id = next->get_fuse_id();
+
+          if (((next->op() != metad::mdx::ADD) &&
+               (next->op() != metad::mdx::UPDATE) &&
+               (next->op() != metad::mdx::RM)) ||
+              (n_id.uid != f_id.uid) || (n_id.gid != f_id.gid) ||
+              (n_id.pid != f_id.pid) || batch_ids.count(next->id())) {
+            break;
+          }
+
+          batch.push_back(*next);
+          batch_ids.insert(next->id());
+          lastflushids.push_back(next->id());
+          mdqueue[next->id()]--;
+          mdflushqueue.erase(next);
+        }
+      } else {
+        mdflushqueue.erase(it);
+        mdqueue[ino]--;
+      }
+
       mdflush.UnLock();
 
       if (assistant.terminationRequested()) {
         return;
       }
 
+      if (batch.size() > 1) {
+        mdcflush_batch(batch);
+        continue;
+      }
+
       if (EOS_LOGS_DEBUG) {
         eos_static_debug("metacache::flush ino=%016lx authid=%s op=%d", ino,
                          authid.c_str(), (int) op);
@@ -2242,6 +2288,188 @@ metad::mdcflush(ThreadAssistant& assistant)
   }
 }
 
+/* -------------------------------------------------------------------------- */
+void
+metad::mdcflush_batch(std::vector<flushentry>& batch)
+{
+  // all entries of a batch belong to the same caller
+  fuse_id f_id = batch.front().get_fuse_id();
+  size_t i = 0;
+
+  while (i < batch.size()) {
+    // a segment ends before an entry whose remote parent inode is only known
+    // once its parent in the same segment has been created upstream
+    std::vector<std::pair<shared_md, size_t>> segment;
+    std::vector<std::string> mdstreams;
+    std::set<uint64_t> segment_ids;
+
+    for (; i < batch.size(); ++i) {
+      uint64_t ino = batch[i].id();
+      mdx::md_op op = batch[i].op();
+      shared_md md;
+
+      if (!mdmap.retrieveTS(ino, md)) {
+        eos_static_crit("metacache::flush failed to retrieve ino=%016lx", ino);
+        continue;
+      }
+
+      XrdSysMutexHelper mdLock(md->Locker());
+
+      if (!md->md_pino()) {
+        if (segment_ids.count(md->pid())) {
+          break;
+        }
+
+        shared_md pmd;
+
+        if (mdmap.retrieveTS(md->pid(), pmd)) {
+          uint64_t md_pino = pmd->md_ino();
+          eos_static_info("metacache::flush providing parent inode %016lx to %016lx",
+                          md->id(), md_pino);
+          md->set_md_pino(md_pino);
+        } else {
+          eos_static_crit("metacache::flush ino=%016lx parent remote inode not known",
+                          (unsigned long long) ino);
+        }
+      }
+
+      if (!md->id()) {
+        continue;
+      }
+
+      if (op == metad::mdx::RM) {
+        md->set_operation(md->DELETE);
+      } else {
+        md->set_operation(md->SET);
+      }
+
+      if ((op != metad::mdx::RM) && md->deleted()) {
+        // if the md was deleted in the meanwhile does not need to
+        // push it remote, since the response creates a race condition
+        continue;
+      }
+
+      if (md->id() == 1) {
+        mdLock.UnLock();
+
+        if (op == metad::mdx::RM) {
+          mdcflush_rm(md, ino);
+        }
+
+        continue;
+      }
+
+      eos::fusex::md::TYPE mdtype = md->type();
+      md->set_type(md->MD);
+      std::string mdstream;
+      int rc = mdbackend->serializeMD(&(*md), batch[i].authid(), mdstream);
+      md->set_type(mdtype);
+
+      if (rc) {
+        md->set_err(rc);
+
+        if (md->getop() != md->RM) {
+          md->setop_none();
+          md->clear_mv_authid();
+        }
+
+        md->Signal();
+        mdLock.UnLock();
+
+        if (op == metad::mdx::RM) {
+          mdcflush_rm(md, ino);
+        }
+
+        continue;
+      }
+
+      segment.emplace_back(md, i);
+      segment_ids.insert(md->id());
+      mdstreams.push_back(mdstream);
+    }
+
+    if (segment.empty()) {
+      continue;
+    }
+
+    eos_static_info("metacache::flush backend::putMDs - start records=%lu",
+                    segment.size());
+    std::vector<eos::fusex::response> responses;
+    int rc = mdbackend->putMDs(f_id, mdstreams, responses);
+
+    if (rc) {
+      eos_static_err("metacache::flush backend::putMDs failed rc=%d", rc);
+    }
+
+    for (size_t k = 0; k < segment.size(); ++k) {
+      shared_md md = segment[k].first;
+      uint64_t ino = batch[segment[k].second].id();
+      mdx::md_op op = batch[segment[k].second].op();
+      {
+        XrdSysMutexHelper mdLock(md->Locker());
+        int md_rc = rc;
+
+        if (!md_rc && (responses[k].type() == responses[k].ACK)) {
+          if (responses[k].ack_().code() == responses[k].ack_().OK) {
+            md->set_md_ino(responses[k].ack_().md_ino());
+          } else {
+            eos_static_err("failed query command for ino=%lx error='%s'", md->id(),
+                           responses[k].ack_().err_msg().c_str());
+            md_rc = responses[k].ack_().err_no() ? responses[k].ack_().err_no() : EIO;
+          }
+        }
+
+        if (md_rc) {
+          md->set_err(md_rc);
+        } else {
+          inomap.insert(md->md_ino(), md->id());
+        }
+
+        if (md->getop() != md->RM) {
+          md->setop_none();
+          md->clear_mv_authid();
+        }
+
+        md->Signal();
+      }
+
+      if (op == metad::mdx::RM) {
+        mdcflush_rm(md, ino);
+      }
+    }
+
+    eos_static_info("metacache::flush backend::putMDs - stop");
+  }
+}
+
+/* -------------------------------------------------------------------------- */
+void
+metad::mdcflush_rm(shared_md md, uint64_t ino)
+{
+  // this step is coupled to the forget function, since we cannot
+  // forget an entry if we didn't process the outstanding KV changes
+  stat.inodes_deleted_dec();
+
+  if (EOS_LOGS_DEBUG) {
+    eos_static_debug("count=%d(-%d) - ino=%#lx", md->lookup_is(), 1, ino);
+  }
+
+  bool removeentry = false;
+  {
+    XrdSysMutexHelper mLock(md->Locker());
+    removeentry = md->lookup_dec(1);
+  }
+
+  if (removeentry) {
+    if (EOS_LOGS_DEBUG) {
+      eos_static_debug("calling forget function %#lx", ino);
+    }
+
+    // forget this inode
+    forget(0, ino, 0);
+  }
+}
+
 /* -------------------------------------------------------------------------- */
 void
 metad::mdsizeflush(ThreadAssistant& assistant)
@@ -2267,28 +2495,31 @@ metad::mdstackfree(ThreadAssistant& assistant)
 
     // do this ~every 128 seconds
     if (!cnt % 256) {
-      XrdSysMutexHelper mLock(mdmap);
+      // work on a snapshot to not block the map shards during the scan, an
+      // entry is only removed if it was not replaced in the meanwhile
+      std::vector<std::pair<fuse_ino_t, shared_md>> entries;
+      mdmap.snapshotTS(entries);
+
+      for (auto it = entries.begin(); it != entries.end(); ++it) {
+        shared_md pmd;
 
-      for (auto it = mdmap.begin(); it != mdmap.end();) {
         // if the parent is gone, we can remove the child
-        if ((!mdmap.count(it->second->pid())) &&
+        if ((!mdmap.retrieveTS(it->second->pid(), pmd)) &&
             (!S_ISDIR(it->second->mode()) || it->second->deleted())) {
-          eos_static_warning("removing orphaned inode from mdmap ino=%#lx path=%s",
-                             it->first, it->second->fullpath().c_str());
-          it = mdmap.erase(it);
-          stat.inodes_dec();
+          if (mdmap.eraseTS(it->first, it->second)) {
+            eos_static_warning("removing orphaned inode from mdmap ino=%#lx path=%s",
+                               it->first, it->second->fullpath().c_str());
+            stat.inodes_dec();
+          }
         } else {
           if (it->second->deleted()) {
             if (!has_flush(it->first)) {
-              eos_static_warning("removing deleted inode from mdmap ino=%#lx path=%s",
-                                 it->first, it->second->fullpath().c_str());
-              it = mdmap.erase(it);
-              stat.inodes_dec();
-            } else {
-              it++;
+              if (mdmap.eraseTS(it->first, it->second)) {
+                eos_static_warning("removing deleted inode from mdmap ino=%#lx path=%s",
+                                   it->first, it->second->fullpath().c_str());
+                stat.inodes_dec();
+              }
             }
-          } else {
-            it++;
           }
         }
       }
@@ -2512,17 +2743,19 @@ metad::mdcommunicate(ThreadAssistant& assistant)
 
             if (rsp.type() == rsp.CONFIG) {
               if (rsp.config_().hbrate()) {
-                eos_static_notice("MGM asked us to set our heartbeat interval to %d seconds, %s dentry-messaging, %s writesizeflush, %s appname and server-version=%s",
+                eos_static_notice("MGM asked us to set our heartbeat interval to %d seconds, %s dentry-messaging, %s writesizeflush, %s appname, md-batch=%u and server-version=%s",
                                   rsp.config_().hbrate(),
                                   rsp.config_().dentrymessaging() ? "enable" : "disable",
                                   rsp.config_().writesizeflush() ?  "enable" : "disable",
                                   rsp.config_().appname() ? "accepts" : "rejects",
+                                  rsp.config_().mdbatch(),
                                   rsp.config_().serverversion().c_str());
                 interval = (int) rsp.config_().hbrate();
                 XrdSysMutexHelper cLock(EosFuse::Instance().mds.ConfigMutex);
                 EosFuse::Instance().mds.dentrymessaging = rsp.config_().dentrymessaging();
                 EosFuse::Instance().mds.writesizeflush = rsp.config_().writesizeflush();
                 EosFuse::Instance().mds.appname = rsp.config_().appname();
+                EosFuse::Instance().mds.mdbatch = rsp.config_().mdbatch();
 
                 if (rsp.config_().serverversion().length()) {
                   EosFuse::Instance().mds.serverversion = rsp.config_().serverversion();
@@ -39,6 +39,8 @@
 #include "XrdSys/XrdSysPthread.hh"
 #include <memory>
 #include <map>
+#include <unordered_map>
+#include <array>
 #include <set>
 #include <deque>
 #include <vector>
@@ -354,9 +356,12 @@ public:
     XrdSysMutex mMutex;
   };
 
-  class pmap : public std::map<fuse_ino_t, shared_md>, public XrdSysMutex
+  class pmap
   //----------------------------------------------------------------------------
   {
+    // The inode map is split into shards with their own mutex, so that
+    // concurrent lookups of different inodes don't serialize on one lock.
+    // No method holds more than one shard lock at a time.
   public:
 
     pmap() { }
@@ -365,16 +370,17 @@ public:
 
     bool retrieveOrCreateTS(fuse_ino_t ino, shared_md& ret)
     {
-      XrdSysMutexHelper mLock(this);
+      shard& s = get_shard(ino);
+      XrdSysMutexHelper mLock(s.mutex);
 
-      if (this->retrieve(ino, ret)) {
+      if (s.retrieve(ino, ret)) {
         return false;
       }
 
       ret = std::make_shared<mdx>();
 
       if (ino) {
-        (*this)[ino] = ret;
+        s.map[ino] = ret;
       }
 
       return true;
@@ -384,57 +390,80 @@ public:
 
     bool retrieveTS(fuse_ino_t ino, shared_md& ret)
     {
-      XrdSysMutexHelper mLock(this);
-      return this->retrieve(ino, ret);
+      shard& s = get_shard(ino);
+      XrdSysMutexHelper mLock(s.mutex);
+      return s.retrieve(ino, ret);
     }
 
-    bool retrieve(fuse_ino_t ino, shared_md& ret)
+    // TS stands for "thread-safe"
+
+    void insertTS(fuse_ino_t ino, shared_md& md)
     {
-      auto it = this->find(ino);
+      shard& s = get_shard(ino);
+      XrdSysMutexHelper mLock(s.mutex);
+      s.map[ino] = md;
+    }
 
-      if (it == this->end()) {
-        return false;
-      }
+    // TS stands for "thread-safe"
 
-      ret = it->second;
-      return true;
+    bool eraseTS(fuse_ino_t ino)
+    {
+      shard& s = get_shard(ino);
+      XrdSysMutexHelper mLock(s.mutex);
+      return s.map.erase(ino) ? true : false;
     }
 
-    // TS stands for "thread-safe"
+    // TS stands for "thread-safe" - erase only if ino still maps to md
 
-    void insertTS(fuse_ino_t ino, shared_md& md)
+    bool eraseTS(fuse_ino_t ino, const shared_md& md)
     {
-      XrdSysMutexHelper mLock(this);
-      (*this)[ino] = md;
+      shard& s = get_shard(ino);
+      XrdSysMutexHelper mLock(s.mutex);
+      auto it = s.map.find(ino);
+
+      if ((it == s.map.end()) || (it->second != md)) {
+        return false;
+      }
+
+      s.map.erase(it);
+      return true;
     }
 
-    // TS stands for "thread-safe"
+    // TS stands for "thread-safe" - copy of all entries taken shard by shard
 
-    bool eraseTS(fuse_ino_t ino)
+    void snapshotTS(std::vector<std::pair<fuse_ino_t, shared_md>>& entries)
     {
-      XrdSysMutexHelper mLock(this);
-      return this->erase(ino) ? true : false;
+      entries.clear();
+
+      for (auto& s : shards) {
+        XrdSysMutexHelper mLock(s.mutex);
+        entries.insert(entries.end(), s.map.begin(), s.map.end());
+      }
     }
 
     void retrieveWithParentTS(fuse_ino_t ino, shared_md& md, shared_md& pmd)
     {
       // Atomically retrieve md objects for an inode, and its parent.
+      shard& s = get_shard(ino);
+
       while (true) {
         // In this particular case, we need to first lock mdmap, and then
         // md.. The following algorithm is meant to avoid deadlocks with code
         // which locks md first, and then mdmap.
         md.reset();
         pmd.reset();
-        XrdSysMutexHelper mLock(this);
+        XrdSysMutexHelper mLock(s.mutex);
 
-        if (!retrieve(ino, md)) {
+        if (!s.retrieve(ino, md)) {
           return; // ino not there, nothing to do
         }
 
         // md has been found. Can we lock it?
         if (md->Locker().CondLock()) {
-          // Success!
-          retrieve(md->pid(), pmd);
+          // Success! The parent can live in another shard, the md lock keeps
+          // the parent id stable while we look it up.
+          mLock.UnLock();
+          retrieveTS(md->pid(), pmd);
           md->Locker().UnLock();
           return;
         }
@@ -444,6 +473,35 @@ public:
         std::this_thread::sleep_for(std::chrono::milliseconds(1));
       }
     }
+
+  private:
+    static constexpr size_t kShardBits = 6;
+    static constexpr size_t kShards = (1 << kShardBits);
+
+    struct shard {
+      XrdSysMutex mutex;
+      std::unordered_map<fuse_ino_t, shared_md> map;
+
+      bool retrieve(fuse_ino_t ino, shared_md& ret)
+      {
+        auto it = map.find(ino);
+
+        if (it == map.end()) {
+          return false;
+        }
+
+        ret = it->second;
+        return true;
+      }
+    };
+
+    shard& get_shard(fuse_ino_t ino)
+    {
+      // local inodes are allocated sequentially, spread them over all shards
+      return shards[(ino * 0x9e3779b97f4a7c15ull) >> (64 - kShardBits)];
+    }
+
+    std::array<shard, kShards> shards;
   };
 
   //----------------------------------------------------------------------------
@@ -523,7 +581,6 @@ public:
   int statvfs(fuse_req_t req, struct statvfs* svfs);
 
   void mdcflush(ThreadAssistant& assistant); // thread pushing into md cache
-
   void mdcommunicate(ThreadAssistant&
                      assistant); // thread interacting with the MGM for meta data
 
@@ -811,6 +868,12 @@ public:
     return appname;
   }
 
+  size_t max_mdbatch()
+  {
+    XrdSysMutexHelper cLock(ConfigMutex);
+    return mdbatch;
+  }
+
 private:
 
   // Lock _two_ md objects in the given order.
@@ -860,6 +923,7 @@ private:
   bool dentrymessaging;
   bool writesizeflush;
   bool appname;
+  size_t mdbatch; // max number of md records the MGM accepts in a batch
   std::string serverversion;
 
   InodeGenerator next_ino;
@@ -869,6 +933,11 @@ private:
   std::map<uint64_t, size_t> mdqueue; // inode, counter of mds to flush
   std::deque<flushentry> mdflushqueue; // linear queue with all entries to flush
 
+  // push several flush entries with one request
+  void mdcflush_batch(std::vector<flushentry>& batch);
+  // account a flushed deletion and forget the inode if unreferenced
+  void mdcflush_rm(shared_md md, uint64_t ino);
+
   size_t mdqueue_max_backlog;
 
   // ZMQ objects
@@ -0,0 +1,139 @@
+//------------------------------------------------------------------------------
+// File: read-pattern.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2019 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "fusex/data/readpattern.hh"
+#include "gtest/gtest.h"
+
+TEST(ReadPattern, Sequential)
+{
+  readpattern rp;
+  std::vector<readpattern::window> windows;
+
+  for (off_t off = 0; off < 4 * 4096; off += 4096) {
+    rp.observe(off, 4096);
+  }
+
+  ASSERT_EQ(rp.last(), readpattern::SEQUENTIAL);
+  rp.predict(2, 65536, 1024 * 1024, windows);
+  ASSERT_EQ(windows.size(), 2u);
+  ASSERT_EQ(windows[0].offset, 4 * 4096);
+  ASSERT_EQ(windows[0].size, 65536u);
+  ASSERT_EQ(windows[1].offset, 4 * 4096 + 65536);
+  // everything up to the horizon was already returned
+  rp.predict(2, 65536, 1024 * 1024, windows);
+  ASSERT_TRUE(windows.empty());
+}
+
+TEST(ReadPattern, ZeroSize)
+{
+  readpattern rp;
+  std::vector<readpattern::window> windows;
+
+  for (int i = 0; i < 4; ++i) {
+    rp.observe(4096, 0);
+  }
+
+  rp.predict(2, 0, 1024 * 1024, windows);
+  ASSERT_TRUE(windows.empty());
+}
+
+TEST(ReadPattern, Strided)
+{
+  readpattern rp;
+  std::vector<readpattern::window> windows;
+  const off_t stride = 1024 * 1024;
+
+  for (off_t i = 0; i < 4; ++i) {
+    rp.observe(i * stride, 8192);
+  }
+
+  ASSERT_EQ(rp.last(), readpattern::STRIDED);
+  rp.predict(3, 65536, 1024 * 1024, windows);
+  ASSERT_EQ(windows.size(), 3u);
+
+  for (size_t i = 0; i < windows.size(); ++i) {
+    ASSERT_EQ(windows[i].offset, (off_t)(4 + i) * stride);
+    ASSERT_EQ(windows[i].size, 8192u);
+  }
+
+  // the next read moves the horizon by one record
+  rp.observe(4 * stride, 8192);
+  rp.predict(3, 65536, 1024 * 1024, windows);
+  ASSERT_EQ(windows.size(), 1u);
+  ASSERT_EQ(windows[0].offset, 7 * stride);
+  ASSERT_TRUE(rp.useful(5 * stride, 8192));
+  ASSERT_FALSE(rp.useful(3 * stride, 8192));
+}
+
+TEST(ReadPattern, Interleaved)
+{
+  readpattern rp;
+  std::vector<readpattern::window> windows;
+  const off_t second = 512 * 1024 * 1024;
+
+  for (off_t i = 0; i < 4; ++i) {
+    rp.observe(i * 4096, 4096);
+    rp.observe(second + i * 4096, 4096);
+  }
+
+  ASSERT_EQ(rp.last(), readpattern::INTERLEAVED);
+  ASSERT_EQ(rp.active_cursors(), 2u);
+  rp.predict(1, 65536, 1024 * 1024, windows);
+  ASSERT_EQ(windows.size(), 2u);
+  ASSERT_EQ(windows[0].offset, 4 * 4096);
+  ASSERT_EQ(windows[1].offset, second + 4 * 4096);
+}
+
+TEST(ReadPattern, RandomAndBudget)
+{
+  readpattern rp;
+  std::vector<readpattern::window> windows;
+  off_t offsets[] = { 7 * 1048576, 3 * 1048576, 200 * 1048576, 1048576, 90 * 1048576 };
+
+  for (auto off : offsets) {
+    rp.observe(off, 4096);
+  }
+
+  ASSERT_EQ(rp.last(), readpattern::RANDOM);
+  rp.predict(4, 65536, 1024 * 1024, windows);
+  ASSERT_TRUE(windows.empty());
+  readpattern seq;
+
+  for (off_t off = 0; off < 4 * 4096; off += 4096) {
+    seq.observe(off, 4096);
+  }
+
+  // the budget limits the prefetched volume
+  seq.predict(16, 65536, 3 * 65536, windows);
+  ASSERT_EQ(windows.size(), 3u);
+}
+
+TEST(ReadPattern, Stats)
+{
+  readpattern::stats stats;
+  stats.add_read(readpattern::STRIDED, 1000);
+  stats.add_prefetch(readpattern::STRIDED, 2000);
+  stats.add_hit(readpattern::STRIDED, 500);
+  ASSERT_FLOAT_EQ(stats.efficiency(readpattern::STRIDED), 50.0);
+  ASSERT_FLOAT_EQ(stats.volume_efficiency(readpattern::STRIDED), 25.0);
+  ASSERT_FLOAT_EQ(stats.efficiency(readpattern::SEQUENTIAL), 0.0);
+}
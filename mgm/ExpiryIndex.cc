@@ -0,0 +1,402 @@
+// ----------------------------------------------------------------------
+// File: ExpiryIndex.cc
+// ----------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2019 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "mgm/ExpiryIndex.hh"
+#include "common/Logging.hh"
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+EOSMGMNAMESPACE_BEGIN
+
+// Journal records:
+//  + <ts> <key>   insert or update
+//  - <key>        remove
+//  * complete     index was filled by a full scan
+//  * scan <ts> <seconds> <entries>   timing of the last full scan
+//  # ...          comment
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+ExpiryIndex::ExpiryIndex(const std::string& name):
+  mName(name), mJournal(nullptr), mJournalRecords(0), mComplete(false)
+{}
+
+//------------------------------------------------------------------------------
+// Destructor
+//------------------------------------------------------------------------------
+ExpiryIndex::~ExpiryIndex()
+{
+  if (mJournal) {
+    fclose(mJournal);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Replay the journal file
+//------------------------------------------------------------------------------
+bool
+ExpiryIndex::Load(const std::string& path)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+
+  if (mJournal) {
+    fclose(mJournal);
+    mJournal = nullptr;
+  }
+
+  mPath = path;
+  mEntries.clear();
+  mOrder.clear();
+  mComplete = false;
+  mJournalRecords = 0;
+  mStats = Stats();
+  bool loaded = false;
+  FILE* fin = fopen(path.c_str(), "r");
+
+  if (fin) {
+    char* line = nullptr;
+    size_t len = 0;
+    ssize_t nread;
+
+    while ((nread = getline(&line, &len, fin)) != -1) {
+      if (nread && (line[nread - 1] == '\n')) {
+        line[nread - 1] = 0;
+      }
+
+      if (!strncmp(line, "+ ", 2)) {
+        char* key = nullptr;
+        time_t ts = strtoll(line + 2, &key, 10);
+
+        if (key && (*key == ' ')) {
+          InsertLocked(key + 1, ts);
+        }
+      } else if (!strncmp(line, "- ", 2)) {
+        RemoveLocked(line + 2);
+      } else if (!strcmp(line, "* complete")) {
+        mComplete = true;
+      } else if (!strncmp(line, "* scan ", 7)) {
+        long long ts = 0;
+        double seconds = 0;
+        unsigned long long entries = 0;
+
+        if (sscanf(line + 7, "%lld %lf %llu", &ts, &seconds, &entries) == 3) {
+          mStats.scan_ts = ts;
+          mStats.scan_time = seconds;
+          mStats.scan_entries = entries;
+        }
+      }
+
+      mJournalRecords++;
+    }
+
+    free(line);
+    fclose(fin);
+    loaded = true;
+  }
+
+  eos_static_info("msg=\"loaded expiry index\" index=%s path=\"%s\" "
+                  "entries=%llu complete=%d", mName.c_str(), path.c_str(),
+                  (unsigned long long) mEntries.size(), mComplete);
+  // start with a compact journal
+  CompactLocked();
+  return loaded;
+}
+
+//------------------------------------------------------------------------------
+// Add or update an entry
+//------------------------------------------------------------------------------
+void
+ExpiryIndex::Insert(const std::string& key, time_t ts)
+{
+  if (key.empty() || (key.find('\n') != std::string::npos)) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mMutex);
+  InsertLocked(key, ts);
+  Journal("+ %lld %s\n", (long long) ts, key.c_str());
+}
+
+//------------------------------------------------------------------------------
+// Remove an entry
+//------------------------------------------------------------------------------
+bool
+ExpiryIndex::Remove(const std::string& key)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+
+  if (!RemoveLocked(key)) {
+    return false;
+  }
+
+  Journal("- %s\n", key.c_str());
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Get the oldest entry
+//------------------------------------------------------------------------------
+bool
+ExpiryIndex::Front(std::string& key, time_t& ts) const
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+
+  if (mOrder.empty()) {
+    return false;
+  }
+
+  ts = mOrder.begin()->first;
+  key = mOrder.begin()->second;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Get the oldest entries before a deadline
+//------------------------------------------------------------------------------
+std::vector<std::pair<time_t, std::string>>
+    ExpiryIndex::Due(time_t deadline, size_t max) const
+{
+  std::vector<std::pair<time_t, std::string>> due;
+  std::lock_guard<std::mutex> lock(mMutex);
+
+  for (auto it = mOrder.begin(); (it != mOrder.end()) && (it->first < deadline) &&
+       (due.size() < max); ++it) {
+    due.push_back(*it);
+  }
+
+  return due;
+}
+
+//------------------------------------------------------------------------------
+// Remove all entries
+//------------------------------------------------------------------------------
+void
+ExpiryIndex::Clear()
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  mEntries.clear();
+  mOrder.clear();
+  mComplete = false;
+  CompactLocked();
+}
+
+//------------------------------------------------------------------------------
+// Mark the index as complete
+//------------------------------------------------------------------------------
+void
+ExpiryIndex::SetComplete()
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  mComplete = true;
+  CompactLocked();
+}
+
+//------------------------------------------------------------------------------
+// Check if the index is complete
+//------------------------------------------------------------------------------
+bool
+ExpiryIndex::IsComplete() const
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  return mComplete;
+}
+
+//------------------------------------------------------------------------------
+// Rewrite the journal
+//------------------------------------------------------------------------------
+void
+ExpiryIndex::Compact()
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  CompactLocked();
+}
+
+//------------------------------------------------------------------------------
+// Get number of entries
+//------------------------------------------------------------------------------
+size_t
+ExpiryIndex::Size() const
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  return mEntries.size();
+}
+
+//------------------------------------------------------------------------------
+// Record the timing of a full scan
+//------------------------------------------------------------------------------
+void
+ExpiryIndex::RecordScan(double seconds, unsigned long long entries)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  mStats.scan_ts = time(NULL);
+  mStats.scan_time = seconds;
+  mStats.scan_entries = entries;
+  // the owner schedules its next scan from the persisted time
+  Journal("* scan %lld %.03f %llu\n", (long long) mStats.scan_ts, seconds,
+          entries);
+}
+
+//------------------------------------------------------------------------------
+// Record the timing of an index cycle
+//------------------------------------------------------------------------------
+void
+ExpiryIndex::RecordCycle(double seconds, unsigned long long entries,
+                         unsigned long long expired)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  mStats.cycle_ts = time(NULL);
+  mStats.cycle_time = seconds;
+  mStats.cycle_entries = entries;
+  mStats.cycle_expired = expired;
+}
+
+//------------------------------------------------------------------------------
+// Get the timing statistics
+//------------------------------------------------------------------------------
+ExpiryIndex::Stats
+ExpiryIndex::GetStats() const
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  return mStats;
+}
+
+//------------------------------------------------------------------------------
+// Add or update an entry, the caller has to hold mMutex
+//------------------------------------------------------------------------------
+void
+ExpiryIndex::InsertLocked(const std::string& key, time_t ts)
+{
+  auto it = mEntries.find(key);
+
+  if (it != mEntries.end()) {
+    mOrder.erase(std::make_pair(it->second, key));
+    it->second = ts;
+  } else {
+    mEntries[key] = ts;
+  }
+
+  mOrder.insert(std::make_pair(ts, key));
+}
+
+//------------------------------------------------------------------------------
+// Remove an entry, the caller has to hold mMutex
+//------------------------------------------------------------------------------
+bool
+ExpiryIndex::RemoveLocked(const std::string& key)
+{
+  auto it = mEntries.find(key);
+
+  if (it == mEntries.end()) {
+    return false;
+  }
+
+  mOrder.erase(std::make_pair(it->second, key));
+  mEntries.erase(it);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Append a record to the journal, the caller has to hold mMutex
+//------------------------------------------------------------------------------
+void
+ExpiryIndex::Journal(const char* fmt, ...)
+{
+  if (!mJournal) {
+    return;
+  }
+
+  va_list args;
+  va_start(args, fmt);
+
+  if ((vfprintf(mJournal, fmt, args) < 0) || fflush(mJournal)) {
+    eos_static_err("msg=\"failed to write expiry index journal\" index=%s "
+                   "path=\"%s\" errno=%d", mName.c_str(), mPath.c_str(), errno);
+  }
+
+  va_end(args);
+
+  // rewrite the journal once most of its records are obsolete
+  if ((++mJournalRecords > 1024) &&
+      (mJournalRecords > (4 * mEntries.size()))) {
+    CompactLocked();
+  }
+}
+
+//------------------------------------------------------------------------------
+// Rewrite the journal, the caller has to hold mMutex
+//------------------------------------------------------------------------------
+void
+ExpiryIndex::CompactLocked()
+{
+  if (mPath.empty()) {
+    return;
+  }
+
+  if (mJournal) {
+    fclose(mJournal);
+    mJournal = nullptr;
+  }
+
+  std::string tmp_path = mPath + ".tmp";
+  FILE* fout = fopen(tmp_path.c_str(), "w");
+  bool ok = (fout != nullptr);
+
+  if (ok) {
+    ok = (fprintf(fout, "# eos expiry index %s\n", mName.c_str()) > 0);
+
+    for (auto it = mOrder.begin(); ok && (it != mOrder.end()); ++it) {
+      ok = (fprintf(fout, "+ %lld %s\n", (long long) it->first,
+                    it->second.c_str()) > 0);
+    }
+
+    if (ok && mComplete) {
+      ok = (fprintf(fout, "* complete\n") > 0);
+    }
+
+    if (ok && mStats.scan_ts) {
+      ok = (fprintf(fout, "* scan %lld %.03f %llu\n", (long long) mStats.scan_ts,
+                    mStats.scan_time, mStats.scan_entries) > 0);
+    }
+
+    ok = (fflush(fout) == 0) && (fsync(fileno(fout)) == 0) && ok;
+    ok = (fclose(fout) == 0) && ok;
+    ok = ok && (rename(tmp_path.c_str(), mPath.c_str()) == 0);
+  }
+
+  if (!ok) {
+    eos_static_err("msg=\"failed to compact expiry index journal\" index=%s "
+                   "path=\"%s\" errno=%d", mName.c_str(), mPath.c_str(), errno);
+  }
+
+  mJournalRecords = mOrder.size() + 1;
+  mJournal = fopen(mPath.c_str(), "a");
+
+  if (!mJournal) {
+    eos_static_err("msg=\"failed to open expiry index journal\" index=%s "
+                   "path=\"%s\" errno=%d", mName.c_str(), mPath.c_str(), errno);
+  }
+}
+
+EOSMGMNAMESPACE_END
@@ -0,0 +1,203 @@
+// ----------------------------------------------------------------------
+// File: ExpiryIndex.hh
+// ----------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2019 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#ifndef __EOSMGM_EXPIRYINDEX__HH__
+#define __EOSMGM_EXPIRYINDEX__HH__
+
+#include "mgm/Namespace.hh"
+#include <stdio.h>
+#include <time.h>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*----------------------------------------------------------------------------*/
+/**
+ * @file ExpiryIndex.hh
+ *
+ * @brief Persistent time ordered index of namespace entries used by the
+ * LRU and Recycle engines to find the entries to expire without scanning
+ *
+ */
+/*----------------------------------------------------------------------------*/
+EOSMGMNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! Time ordered set of keys (paths or file ids) with a timestamp each.
+//!
+//! Every modification is appended to a journal file which is replayed by
+//! Load. The journal is rewritten by Compact once it contains many obsolete
+//! records. An index is complete once the owner has filled it with a full
+//! scan and called SetComplete - the flag is persisted, so an index which was
+//! never completed (e.g. crash during the bootstrap scan) is recognized and
+//! rebuilt after a restart. The time of the last full scan is persisted as
+//! well, so that owners rescanning periodically don't rescan on every start.
+//------------------------------------------------------------------------------
+class ExpiryIndex
+{
+public:
+  //----------------------------------------------------------------------------
+  //! Timing of the last full scan and of the last index driven cycle
+  //----------------------------------------------------------------------------
+  struct Stats {
+    time_t scan_ts = 0; ///< time of the last full scan
+    double scan_time = 0; ///< duration of the last full scan in seconds
+    unsigned long long scan_entries = 0; ///< entries found by the scan
+    time_t cycle_ts = 0; ///< time of the last index cycle
+    double cycle_time = 0; ///< duration of the last index cycle in seconds
+    unsigned long long cycle_entries = 0; ///< entries looked at by the cycle
+    unsigned long long cycle_expired = 0; ///< entries expired by the cycle
+  };
+
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //!
+  //! @param name name used in log messages
+  //----------------------------------------------------------------------------
+  ExpiryIndex(const std::string& name);
+
+  //----------------------------------------------------------------------------
+  //! Destructor
+  //----------------------------------------------------------------------------
+  ~ExpiryIndex();
+
+  //----------------------------------------------------------------------------
+  //! Replay the journal file and keep it open for appending
+  //!
+  //! @param path journal file
+  //!
+  //! @return true if the journal was readable, otherwise false
+  //----------------------------------------------------------------------------
+  bool Load(const std::string& path);
+
+  //----------------------------------------------------------------------------
+  //! Add or update an entry
+  //!
+  //! @param key unique key of the entry
+  //! @param ts timestamp of the entry
+  //----------------------------------------------------------------------------
+  void Insert(const std::string& key, time_t ts);
+
+  //----------------------------------------------------------------------------
+  //! Remove an entry
+  //!
+  //! @return true if the entry existed
+  //----------------------------------------------------------------------------
+  bool Remove(const std::string& key);
+
+  //----------------------------------------------------------------------------
+  //! Get the oldest entry
+  //!
+  //! @return false if the index is empty
+  //----------------------------------------------------------------------------
+  bool Front(std::string& key, time_t& ts) const;
+
+  //----------------------------------------------------------------------------
+  //! Get the oldest entries with a timestamp before a deadline
+  //!
+  //! @param deadline entries with ts < deadline are returned
+  //! @param max maximum number of entries to return
+  //!
+  //! @return list of timestamps and keys in time order
+  //----------------------------------------------------------------------------
+  std::vector<std::pair<time_t, std::string>>
+      Due(time_t deadline, size_t max) const;
+
+  //----------------------------------------------------------------------------
+  //! Remove all entries and mark the index as incomplete
+  //----------------------------------------------------------------------------
+  void Clear();
+
+  //----------------------------------------------------------------------------
+  //! Mark the index as complete after a full scan and compact the journal
+  //----------------------------------------------------------------------------
+  void SetComplete();
+
+  //----------------------------------------------------------------------------
+  //! Check if the index contains all entries
+  //----------------------------------------------------------------------------
+  bool IsComplete() const;
+
+  //----------------------------------------------------------------------------
+  //! Rewrite the journal with the current entries
+  //----------------------------------------------------------------------------
+  void Compact();
+
+  //----------------------------------------------------------------------------
+  //! Get number of entries
+  //----------------------------------------------------------------------------
+  size_t Size() const;
+
+  //----------------------------------------------------------------------------
+  //! Record the timing of a full scan, the time of the scan is persisted
+  //----------------------------------------------------------------------------
+  void RecordScan(double seconds, unsigned long long entries);
+
+  //----------------------------------------------------------------------------
+  //! Record the timing of an index cycle
+  //----------------------------------------------------------------------------
+  void RecordCycle(double seconds, unsigned long long entries,
+                   unsigned long long expired);
+
+  //----------------------------------------------------------------------------
+  //! Get the timing statistics
+  //----------------------------------------------------------------------------
+  Stats GetStats() const;
+
+private:
+  //----------------------------------------------------------------------------
+  //! Add or update an entry, the caller has to hold mMutex
+  //----------------------------------------------------------------------------
+  void InsertLocked(const std::string& key, time_t ts);
+
+  //----------------------------------------------------------------------------
+  //! Remove an entry, the caller has to hold mMutex
+  //----------------------------------------------------------------------------
+  bool RemoveLocked(const std::string& key);
+
+  //----------------------------------------------------------------------------
+  //! Append a record to the journal, the caller has to hold mMutex
+  //----------------------------------------------------------------------------
+  void Journal(const char* fmt, ...);
+
+  //----------------------------------------------------------------------------
+  //! Rewrite the journal, the caller has to hold mMutex
+  //----------------------------------------------------------------------------
+  void CompactLocked();
+
+  std::string mName; ///< name used in log messages
+  std::string mPath; ///< journal file, empty if not persistent
+  FILE* mJournal; ///< journal opened for appending
+  size_t mJournalRecords; ///< records written since the last compaction
+  bool mComplete; ///< index contains all entries
+  mutable std::mutex mMutex; ///< protects all members
+  std::map<std::string, time_t> mEntries; ///< timestamp by key
+  std::set<std::pair<time_t, std::string>> mOrder; ///< entries by time
+  Stats mStats; ///< timing statistics
+};
+
+EOSMGMNAMESPACE_END
+
+#endif
@@ -29,6 +29,7 @@
 #include "mgm/Policy.hh"
 #include "mgm/Quota.hh"
 #include "mgm/Recycle.hh"
+#include "mgm/LRU.hh"
 #include "namespace/interface/IView.hh"
 #include "namespace/interface/ContainerIterators.hh"
 #include "namespace/Prefetcher.hh"
@@ -264,6 +265,7 @@ FuseServer::Clients::Dispatch(const std::string identity,
     cfg.set_dentrymessaging(true);
     cfg.set_writesizeflush(true);
     cfg.set_appname(true);
+    cfg.set_mdbatch(sMaxMDBatch);
     cfg.set_serverversion(std::string(VERSION) + std::string("::") + std::string(
                             RELEASE));
     BroadcastConfig(identity, cfg);
@@ -2727,6 +2729,56 @@ FuseServer::ValidatePERM(const eos::fusex::md& md, const std::string& mode,
   }
 }
 
+/*----------------------------------------------------------------------------*/
+int
+FuseServer::HandleMDBatch(const std::string& id,
+                          const eos::fusex::md_batch& batch,
+                          eos::common::Mapping::VirtualIdentity& vid,
+                          std::string* response)
+{
+  if (batch.md_().size() > (int) sMaxMDBatch) {
+    eos_err("batch of %d md records exceeds the limit of %u",
+            batch.md_().size(), sMaxMDBatch);
+    return E2BIG;
+  }
+
+  eos::fusex::md_batch_response batch_resp;
+
+  // records are applied in the order given by the client, this preserves the
+  // ordering of changes to the same inode and parent/child dependencies
+  for (int i = 0; i < batch.md_().size(); ++i) {
+    eos::fusex::md md;
+    eos::fusex::response* resp = batch_resp.add_response_();
+    int rc = EINVAL;
+    std::string resultstream;
+
+    if (md.ParseFromString(batch.md_(i)) &&
+        ((md.operation() == md.SET) || (md.operation() == md.DELETE))) {
+      rc = HandleMD(id, md, vid, &resultstream, 0);
+    }
+
+    if (!rc && !resultstream.empty() && resp->ParseFromString(resultstream)) {
+      continue;
+    }
+
+    if (!rc) {
+      rc = EIO;
+    }
+
+    resp->Clear();
+    resp->set_type(resp->ACK);
+    resp->mutable_ack_()->set_code(resp->ack_().PERMANENT_FAILURE);
+    resp->mutable_ack_()->set_transactionid(md.reqid());
+    resp->mutable_ack_()->set_err_no(rc);
+    resp->mutable_ack_()->set_err_msg(strerror(rc));
+  }
+
+  gOFS->MgmStats.Add("Eosxd::ext::BATCHED", vid.uid, vid.gid,
+                     batch.md_().size());
+  batch_resp.SerializeToString(response);
+  return 0;
+}
+
 /*----------------------------------------------------------------------------*/
 void
 FuseServer::prefetchMD(const eos::fusex::md& md)
@@ -3163,6 +3215,12 @@ FuseServer::HandleMD(const std::string& id,
         mtime.tv_nsec = md.mtime_ns();
         cmd->setCTime(ctime);
         cmd->setMTime(mtime);
+        // LRU policy before the update, new directories inherit the policy
+        std::map<std::string, std::string> lru_before;
+
+        if (op != CREATE) {
+          lru_before = LRU::PolicyAttributes(cmd->getAttributes());
+        }
 
         for (auto it = md.attr().begin(); it != md.attr().end(); ++it) {
           if ((it->first.substr(0, 3) != "sys") ||
@@ -3205,8 +3263,16 @@ FuseServer::HandleMD(const std::string& id,
         }
 
         gOFS->eosDirectoryService->updateStore(cmd.get());
+        bool lru_policy = (LRU::PolicyAttributes(cmd->getAttributes()) !=
+                           lru_before);
+        unsigned long long lru_cid = cmd->getId();
         // release the namespace lock before seralization/broadcasting
         lock.Release();
+
+        if (lru_policy) {
+          gOFS->LRUd.PolicyChanged(lru_cid, op != CREATE);
+        }
+
         eos::fusex::response resp;
         resp.set_type(resp.ACK);
         resp.mutable_ack_()->set_code(resp.ack_().OK);
@@ -3404,6 +3470,9 @@ FuseServer::HandleMD(const std::string& id,
           pcmd->addFile(gmd.get());
           gOFS->eosFileService->updateStore(gmd.get());
           gOFS->eosView->updateContainerStore(pcmd.get());
+          eos::IContainerMD::XAttrMap lru_attrs = pcmd->getAttributes();
+          unsigned long long lru_fid = gmd->getId();
+          unsigned long long lru_cid = pcmd->getId();
           eos::fusex::response resp;
           resp.set_type(resp.ACK);
           resp.mutable_ack_()->set_code(resp.ack_().OK);
@@ -3411,6 +3480,12 @@ FuseServer::HandleMD(const std::string& id,
           resp.mutable_ack_()->set_md_ino(eos::common::FileId::FidToInode(gmd->getId()));
           // release the namespace lock before serialization/broadcasting
           lock.Release();
+
+          if (LRU::HasPolicy(lru_attrs)) {
+            gOFS->LRUd.FileCreated(lru_fid, lru_cid, md.name(), md.ctime(),
+                                   lru_attrs);
+          }
+
           resp.SerializeToString(response);
           struct timespec pt_mtime;
           pt_mtime.tv_sec = md.mtime();
@@ -3542,8 +3617,22 @@ FuseServer::HandleMD(const std::string& id,
         fmd = gOFS->eosFileService->getFileMD(eos::common::FileId::InodeToFid(md_ino),
                                               &clock);
         eos_info("ino=%llx clock=%llx", md_ino, clock);
+        // new, renamed or moved files might fall under an expire policy
+        eos::IContainerMD::XAttrMap lru_attrs;
+
+        if (op != UPDATE) {
+          lru_attrs = pcmd->getAttributes();
+        }
+
+        unsigned long long lru_fid = fmd->getId();
+        unsigned long long lru_cid = pcmd->getId();
         // release the namespace lock before serialization/broadcasting
         lock.Release();
+
+        if (LRU::HasPolicy(lru_attrs)) {
+          gOFS->LRUd.FileCreated(lru_fid, lru_cid, md.name(), md.ctime(),
+                                 lru_attrs);
+        }
         eos::fusex::response resp;
         resp.set_type(resp.ACK);
         resp.mutable_ack_()->set_code(resp.ack_().OK);
@@ -3679,9 +3768,24 @@ FuseServer::HandleMD(const std::string& id,
 
         gOFS->eosDirectoryService->updateStore(pcmd.get());
 
+        eos::IContainerMD::XAttrMap lru_attrs;
+
+        if (op == CREATE) {
+          lru_attrs = pcmd->getAttributes();
+        }
+
+        unsigned long long lru_fid = fmd->getId();
+
+        unsigned long long lru_cid = pcmd->getId();
+
         // release the namespace lock before serialization/broadcasting
         lock.Release();
 
+        if (LRU::HasPolicy(lru_attrs)) {
+          gOFS->LRUd.FileCreated(lru_fid, lru_cid, md.name(), md.ctime(),
+                                 lru_attrs);
+        }
+
         eos::fusex::response resp;
 
         resp.set_type(resp.ACK);
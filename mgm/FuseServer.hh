@@ -611,6 +611,24 @@ public:
                std::string* response = 0,
                uint64_t* clock = 0);
 
+  //----------------------------------------------------------------------------
+  //! Apply a batch of md records in the given order
+  //!
+  //! @param identity client identity
+  //! @param batch md records, only SET and DELETE operations are accepted
+  //! @param vid virtual identity of the client
+  //! @param response serialized md_batch_response with one response per record
+  //!
+  //! @return 0 if successful, otherwise errno concerning the whole batch
+  //----------------------------------------------------------------------------
+  int HandleMDBatch(const std::string& identity,
+                    const eos::fusex::md_batch& batch,
+                    eos::common::Mapping::VirtualIdentity& vid,
+                    std::string* response);
+
+  //! Max number of md records accepted in a batch
+  static constexpr uint32_t sMaxMDBatch = 256;
+
   void prefetchMD(const eos::fusex::md& md);
 
 
@@ -440,7 +440,9 @@ Iostat::Receive(ThreadAssistant& assistant) noexcept
       delete newmessage;
     }
 
-    assistant.wait_for(std::chrono::seconds(1));
+    if (!mClient.IsPushActive()) {
+      assistant.wait_for(std::chrono::seconds(1));
+    }
   }
 }
 
@@ -26,6 +26,8 @@
 #include "common/LayoutId.hh"
 #include "common/Mapping.hh"
 #include "common/RWMutex.hh"
+#include "common/Path.hh"
+#include "common/Timing.hh"
 #include "mgm/Quota.hh"
 #include "mgm/LRU.hh"
 #include "mgm/Stat.hh"
@@ -34,9 +36,14 @@
 #include "namespace/interface/IView.hh"
 #include "namespace/interface/ContainerIterators.hh"
 #include "namespace/Prefetcher.hh"
+#include <algorithm>
+#include <limits>
+#include <tuple>
 
 //! Attribute name defining any LRU policy
 const char* LRU::gLRUPolicyPrefix = "sys.lru.*";
+//! Delay before retrying the expiration of a file which failed
+time_t LRU::gLRURetryTime = 3600;
 
 /*----------------------------------------------------------------------------*/
 
@@ -87,6 +94,19 @@ LRU::LRUr(ThreadAssistant& assistant) noexcept
     return;
   }
 
+  if (gOFS->MgmMetaLogDir.length()) {
+    mExpiryIndex.Load(gOFS->MgmMetaLogDir + "/lru.index");
+    mPolicyDirs.Load(gOFS->MgmMetaLogDir + "/lru-dirs.index");
+
+    // the next full scan is due 'lru.rescan' after the persisted one and
+    // bounds what a restarted master may have missed
+    if (mExpiryIndex.IsComplete() && mPolicyDirs.IsComplete()) {
+      mLastScan = mExpiryIndex.GetStats().scan_ts;
+    }
+  }
+
+  bool was_master = false;
+  bool startup = true;
   assistant.wait_for(std::chrono::seconds(10));
   eos_static_info("msg=\"async LRU thread started\"");
 
@@ -94,6 +114,7 @@ LRU::LRUr(ThreadAssistant& assistant) noexcept
     // every now and then we wake up
     bool IsEnabledLRU;
     time_t lLRUInterval;
+    time_t lLRURescan = 86400;
     time_t lStartTime = time(NULL);
     time_t lStopTime;
     {
@@ -109,94 +130,164 @@ LRU::LRUr(ThreadAssistant& assistant) noexcept
       if (FsView::gFsView.mSpaceView.count("default")) {
         lLRUInterval =
           atoi(FsView::gFsView.mSpaceView["default"]->GetConfigMember("lru.interval").c_str());
+        std::string rescan =
+          FsView::gFsView.mSpaceView["default"]->GetConfigMember("lru.rescan");
+
+        if (rescan.length()) {
+          lLRURescan = strtoll(rescan.c_str(), 0, 10);
+        }
       } else {
         lLRUInterval = 0;
       }
     }
 
+    // Files created while we were a slave are not in the indices
+    if (gOFS->mMaster->IsMaster() != was_master) {
+      was_master = !was_master;
+
+      if (was_master && !startup) {
+        eos_static_info("%s", "msg=\"became master - rebuilding the LRU "
+                        "indices\"");
+        mExpiryIndex.Clear();
+        mPolicyDirs.Clear();
+      }
+    }
+
+    startup = false;
+
     // Only a master needs to run LRU
     if (gOFS->mMaster->IsMaster() && IsEnabledLRU) {
-      // Do a slow find
-      unsigned long long ndirs =
-        (unsigned long long) gOFS->eosDirectoryService->getNumContainers();
-      time_t ms = 1;
+      bool full_scan = (!mExpiryIndex.IsComplete() || !mPolicyDirs.IsComplete() ||
+                        ((lLRURescan > 0) && ((lStartTime - mLastScan) >= lLRURescan)));
 
-      if (ndirs > 10000000) {
-        ms = 0;
-      }
+      if (full_scan) {
+        // Do a slow find
+        unsigned long long ndirs =
+          (unsigned long long) gOFS->eosDirectoryService->getNumContainers();
+        time_t ms = 1;
 
-      if (mMs) {
-        // we have a forced setting
-        ms = GetMs();
-      }
+        if (ndirs > 10000000) {
+          ms = 0;
+        }
 
-      eos_static_info("msg=\"start LRU scan\" ndir=%llu ms=%u", ndirs, ms);
-      std::map<std::string, std::set<std::string> > lrudirs;
-      XrdOucString stdErr;
-      // Find all directories defining an LRU policy
-      gOFS->MgmStats.Add("LRUFind", 0, 0, 1);
-      EXEC_TIMING_BEGIN("LRUFind");
-
-      if (!gOFS->_find("/", mError, stdErr, mRootVid, lrudirs, gLRUPolicyPrefix,
-                       "*", true, ms, false)
-         ) {
-        eos_static_info("msg=\"finished LRU find\" LRU-dirs=%llu",
-                        lrudirs.size());
+        if (mMs) {
+          // we have a forced setting
+          ms = GetMs();
+        }
 
-        // scan backwards ... in this way we get rid of empty directories in one go ...
-        for (auto it = lrudirs.rbegin(); it != lrudirs.rend(); it++) {
-          // Get the attributes
-          eos_static_info("lru-dir=\"%s\"", it->first.c_str());
-          eos::IContainerMD::XAttrMap map;
+        eos_static_info("msg=\"start LRU scan\" ndir=%llu ms=%u", ndirs, ms);
+        std::map<std::string, std::set<std::string> > lrudirs;
+        XrdOucString stdErr;
+        eos::common::Timing scan_timing("LRUScan");
+        COMMONTIMING("start", &scan_timing);
+        // Find all directories defining an LRU policy
+        gOFS->MgmStats.Add("LRUFind", 0, 0, 1);
+        EXEC_TIMING_BEGIN("LRUFind");
+
+        if (!gOFS->_find("/", mError, stdErr, mRootVid, lrudirs, gLRUPolicyPrefix,
+                         "*", true, ms, false)
+           ) {
+          eos_static_info("msg=\"finished LRU find\" LRU-dirs=%llu",
+                          lrudirs.size());
+          // the scan adds all policy directories and files to expire
+          mPolicyDirs.Clear();
+          mExpiryIndex.Clear();
+          {
+            std::lock_guard<std::mutex> lock(mConvertMutex);
+            mConvertDue.clear();
+          }
 
-          if (!gOFS->_attr_ls(it->first.c_str(), mError, mRootVid,
-                              (const char*) 0, map)) {
-            // -------------------------------------------------------------------
-            // sort out the individual LRU policies
-            // -------------------------------------------------------------------
-            if (map.count("sys.lru.expire.empty") && !it->second.size()) {
-              // -----------------------------------------------------------------
-              // remove empty directories older than <age>
-              // -----------------------------------------------------------------
-              AgeExpireEmpty(it->first.c_str(), map["sys.lru.expire.empty"]);
-            }
+          // scan backwards ... in this way we get rid of empty directories in one go ...
+          for (auto it = lrudirs.rbegin(); it != lrudirs.rend(); it++) {
+            // Get the attributes
+            eos_static_info("lru-dir=\"%s\"", it->first.c_str());
+            eos::IContainerMD::XAttrMap map;
 
-            if (map.count("sys.lru.expire.match")) {
-              // -----------------------------------------------------------------
-              // files with a given match will be removed after expiration time
-              // -----------------------------------------------------------------
-              AgeExpire(it->first.c_str(), map["sys.lru.expire.match"]);
+            if (!gOFS->_attr_ls(it->first.c_str(), mError, mRootVid,
+                                (const char*) 0, map)) {
+              ApplyPolicies(it->first.c_str(), map, !it->second.size(), true);
             }
+          }
 
-            if (map.count("sys.lru.lowwatermark") &&
-                map.count("sys.lru.highwatermark")) {
-              // -----------------------------------------------------------------
-              // if the space in this directory reaches highwatermark, files are
-              // cleaned up according to the LRU policy
-              // -----------------------------------------------------------------
-              CacheExpire(it->first.c_str(),
-                          map["sys.lru.lowwatermark"],
-                          map["sys.lru.highwatermark"]
-                         );
-            }
+          if (assistant.terminationRequested()) {
+            return;
+          }
 
-            if (map.count("sys.lru.convert.match")) {
-              // -----------------------------------------------------------------
-              // files with a given match/age will be automatically converted
-              // -----------------------------------------------------------------
-              ConvertMatch(it->first.c_str(), map);
-            }
+          COMMONTIMING("stop", &scan_timing);
+          mPolicyDirs.SetComplete();
+          mExpiryIndex.SetComplete();
+          mExpiryIndex.RecordScan(scan_timing.RealTime() / 1000.0, lrudirs.size());
+          mLastScan = lStartTime;
+        }
+
+        EXEC_TIMING_END("LRUFind");
+        eos_static_info("msg=\"finished LRU application\" LRU-dirs=%llu",
+                        lrudirs.size());
+      } else {
+        // Apply the directory policies without scanning the namespace
+        eos::common::Timing cycle_timing("LRUCycle");
+        COMMONTIMING("start", &cycle_timing);
+        std::vector<std::tuple<std::string, time_t, unsigned long long>> dirs;
+
+        for (const auto& entry : mPolicyDirs.Due(std::numeric_limits<time_t>::max(),
+             std::numeric_limits<size_t>::max())) {
+          try {
+            unsigned long long cid = strtoull(entry.second.c_str(), 0, 10);
+            eos::Prefetcher::prefetchContainerMDWithParentsAndWait(gOFS->eosView, cid);
+            RWMutexReadLock lock(gOFS->eosViewRWMutex);
+            auto cmd = gOFS->eosDirectoryService->getContainerMD(cid);
+            dirs.emplace_back(gOFS->eosView->getUri(cmd.get()), entry.first, cid);
+          } catch (eos::MDException& e) {
+            mPolicyDirs.Remove(entry.second);
           }
         }
 
-        if (assistant.terminationRequested()) {
-          return;
+        // deepest directories first as for the scan
+        std::sort(dirs.rbegin(), dirs.rend());
+        unsigned long long looked_at = dirs.size();
+
+        for (const auto& dir : dirs) {
+          const std::string& path = std::get<0>(dir);
+          unsigned long long cid = std::get<2>(dir);
+          eos::IContainerMD::XAttrMap map;
+
+          if (gOFS->_attr_ls(path.c_str(), mError, mRootVid, (const char*) 0,
+                             map)) {
+            continue;
+          }
+
+          if (!HasPolicy(map)) {
+            // policy was removed
+            mPolicyDirs.Remove(std::to_string(cid));
+            continue;
+          }
+
+          bool empty = false;
+
+          try {
+            RWMutexReadLock lock(gOFS->eosViewRWMutex);
+            auto cmd = gOFS->eosDirectoryService->getContainerMD(cid);
+            empty = ((cmd->getNumFiles() + cmd->getNumContainers()) == 0);
+          } catch (eos::MDException& e) {
+            continue;
+          }
+
+          eos_static_info("lru-dir=\"%s\"", path.c_str());
+          ApplyPolicies(path.c_str(), map, empty, std::get<1>(dir) != 0, cid);
+
+          if (assistant.terminationRequested()) {
+            return;
+          }
         }
-      }
 
-      EXEC_TIMING_END("LRUFind");
-      eos_static_info("msg=\"finished LRU application\" LRU-dirs=%llu",
-                      lrudirs.size());
+        unsigned long long expired = ExpireDue(looked_at);
+        COMMONTIMING("stop", &cycle_timing);
+        mExpiryIndex.RecordCycle(cycle_timing.RealTime() / 1000.0, looked_at,
+                                 expired);
+        eos_static_info("msg=\"finished LRU index cycle\" LRU-dirs=%llu "
+                        "entries=%llu expired=%llu time=%.03f", dirs.size(),
+                        looked_at, expired, cycle_timing.RealTime() / 1000.0);
+      }
     }
 
     lStopTime = time(NULL);
@@ -235,6 +326,295 @@ LRU::LRUr(ThreadAssistant& assistant) noexcept
   }
 }
 
+//------------------------------------------------------------------------------
+// Apply the policies of one directory
+//------------------------------------------------------------------------------
+void
+LRU::ApplyPolicies(const char* dir, eos::IContainerMD::XAttrMap& map,
+                   bool empty, bool match_scan, unsigned long long cid)
+{
+  // ---------------------------------------------------------------------------
+  // sort out the individual LRU policies
+  // ---------------------------------------------------------------------------
+  if (map.count("sys.lru.expire.empty") && empty) {
+    // -------------------------------------------------------------------------
+    // remove empty directories older than <age>
+    // -------------------------------------------------------------------------
+    AgeExpireEmpty(dir, map["sys.lru.expire.empty"]);
+  }
+
+  if (map.count("sys.lru.expire.match") && match_scan) {
+    // -------------------------------------------------------------------------
+    // files with a given match will be removed after expiration time, the
+    // others are added to the expiry index
+    // -------------------------------------------------------------------------
+    AgeExpire(dir, map["sys.lru.expire.match"]);
+  }
+
+  if (match_scan) {
+    // the existing files are now known to the expiry index
+    try {
+      eos::Prefetcher::prefetchContainerMDAndWait(gOFS->eosView, dir);
+      RWMutexReadLock lock(gOFS->eosViewRWMutex);
+      cid = gOFS->eosView->getContainer(dir)->getId();
+      mPolicyDirs.Insert(std::to_string(cid), 0);
+    } catch (eos::MDException& e) {}
+  }
+
+  if (map.count("sys.lru.lowwatermark") &&
+      map.count("sys.lru.highwatermark")) {
+    // -------------------------------------------------------------------------
+    // if the space in this directory reaches highwatermark, files are
+    // cleaned up according to the LRU policy
+    // -------------------------------------------------------------------------
+    CacheExpire(dir, map["sys.lru.lowwatermark"], map["sys.lru.highwatermark"]);
+  }
+
+  if (map.count("sys.lru.convert.match")) {
+    // -------------------------------------------------------------------------
+    // files with a given match/age will be automatically converted, the index
+    // cycle lists the directory only once the next file is due
+    // -------------------------------------------------------------------------
+    if (match_scan || !cid || ConvertDue(cid, time(NULL))) {
+      time_t due = ConvertMatch(dir, map);
+
+      if (cid) {
+        SetConvertDue(cid, due, false);
+      }
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Check if a directory has to be listed for conversions
+//------------------------------------------------------------------------------
+bool
+LRU::ConvertDue(unsigned long long cid, time_t now)
+{
+  std::lock_guard<std::mutex> lock(mConvertMutex);
+  auto it = mConvertDue.find(cid);
+  return ((it == mConvertDue.end()) || (it->second && (it->second <= now)));
+}
+
+//------------------------------------------------------------------------------
+// Record when the next file of a directory is due for conversion
+//------------------------------------------------------------------------------
+void
+LRU::SetConvertDue(unsigned long long cid, time_t due, bool lower)
+{
+  std::lock_guard<std::mutex> lock(mConvertMutex);
+  auto it = mConvertDue.find(cid);
+
+  if (!lower) {
+    mConvertDue[cid] = due;
+  } else if ((it != mConvertDue.end()) && (!it->second || (due < it->second))) {
+    it->second = due;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Expire the files of the expiry index which are due
+//------------------------------------------------------------------------------
+unsigned long long
+LRU::ExpireDue(unsigned long long& looked_at)
+{
+  unsigned long long expired = 0;
+  time_t now = time(NULL);
+  std::vector<std::pair<time_t, std::string>> due;
+
+  // entries leave the due range in any case: removed or moved to a later time
+  while (!(due = mExpiryIndex.Due(now, 1000)).empty()) {
+    for (const auto& entry : due) {
+      unsigned long long fid = strtoull(entry.second.c_str(), 0, 10);
+      std::string path;
+      std::string name;
+      eos::IFileMD::ctime_t ctime {0, 0};
+      looked_at++;
+
+      try {
+        eos::Prefetcher::prefetchFileMDWithParentsAndWait(gOFS->eosView, fid);
+        RWMutexReadLock lock(gOFS->eosViewRWMutex);
+        auto fmd = gOFS->eosFileService->getFileMD(fid);
+        path = gOFS->eosView->getUri(fmd.get());
+        name = fmd->getName();
+        fmd->getCTime(ctime);
+      } catch (eos::MDException& e) {
+        path.clear();
+      }
+
+      time_t age = -1;
+
+      if (path.length()) {
+        // the policy of the current parent directory applies
+        eos::common::Path cPath(path.c_str());
+        eos::IContainerMD::XAttrMap map;
+
+        if (!gOFS->_attr_ls(cPath.GetParentPath(), mError, mRootVid,
+                            (const char*) 0, map) &&
+            map.count("sys.lru.expire.match")) {
+          age = GetMatchAge(map["sys.lru.expire.match"], name);
+        }
+      }
+
+      if (age < 0) {
+        // deleted, moved away or policy removed
+        mExpiryIndex.Remove(entry.second);
+        continue;
+      }
+
+      if ((ctime.tv_sec + age) < now) {
+        eos_static_notice("msg=\"delete expired file\" path=\"%s\" "
+                          "ctime=%u policy-age=%u age=%u",
+                          path.c_str(), ctime.tv_sec, age,
+                          now - ctime.tv_sec);
+
+        if (gOFS->_rem(path.c_str(), mError, mRootVid, "")) {
+          eos_static_err("msg=\"failed to expire file\" path=\"%s\"", path.c_str());
+          // keep the entry and retry it later
+          mExpiryIndex.Insert(entry.second, now + gLRURetryTime);
+        } else {
+          expired++;
+          mExpiryIndex.Remove(entry.second);
+        }
+      } else {
+        // policy age was changed
+        mExpiryIndex.Insert(entry.second, ctime.tv_sec + age);
+      }
+    }
+  }
+
+  return expired;
+}
+
+//------------------------------------------------------------------------------
+// Get the shortest age matching a file name in an expire match policy
+//------------------------------------------------------------------------------
+time_t
+LRU::GetMatchAge(const std::string& policy, const std::string& name)
+{
+  std::map<std::string, std::string> lMatchMap;
+
+  if (!StringConversion::GetKeyValueMap(policy.c_str(), lMatchMap, ":")) {
+    return -1;
+  }
+
+  XrdOucString fname = name.c_str();
+  time_t min_age = -1;
+
+  for (auto it = lMatchMap.begin(); it != lMatchMap.end(); it++) {
+    if (fname.matches(it->first.c_str())) {
+      XrdOucString sage = it->second.c_str();
+      errno = 0;
+      time_t age = StringConversion::GetSizeFromString(sage);
+
+      if (!errno && ((min_age < 0) || (age < min_age))) {
+        min_age = age;
+      }
+    }
+  }
+
+  return min_age;
+}
+
+//------------------------------------------------------------------------------
+// Notification of a file creation
+//------------------------------------------------------------------------------
+void
+LRU::FileCreated(unsigned long long fid, unsigned long long cid,
+                 const std::string& name, time_t ctime,
+                 const eos::IContainerMD::XAttrMap& attrmap)
+{
+  auto it = attrmap.find("sys.lru.expire.match");
+
+  if (it != attrmap.end()) {
+    time_t age = GetMatchAge(it->second, name);
+
+    if (age >= 0) {
+      mExpiryIndex.Insert(std::to_string(fid), ctime + age);
+    }
+  }
+
+  it = attrmap.find("sys.lru.convert.match");
+
+  if (it != attrmap.end()) {
+    // same <match>:<age> format as the expire match policy
+    time_t age = GetMatchAge(it->second, name);
+
+    if (age >= 0) {
+      SetConvertDue(cid, ctime + age, true);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Notification of a directory policy change
+//------------------------------------------------------------------------------
+void
+LRU::PolicyChanged(unsigned long long cid, bool scan)
+{
+  mPolicyDirs.Insert(std::to_string(cid), scan ? time(NULL) : 0);
+}
+
+//------------------------------------------------------------------------------
+// Check if an attribute map contains an LRU policy
+//------------------------------------------------------------------------------
+bool
+LRU::HasPolicy(const eos::IContainerMD::XAttrMap& attrmap)
+{
+  for (const auto& elem : attrmap) {
+    if (elem.first.compare(0, 8, "sys.lru.") == 0) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+//------------------------------------------------------------------------------
+// Get the LRU policy attributes of an attribute map
+//------------------------------------------------------------------------------
+std::map<std::string, std::string>
+LRU::PolicyAttributes(const eos::IContainerMD::XAttrMap& attrmap)
+{
+  std::map<std::string, std::string> policy;
+
+  for (const auto& elem : attrmap) {
+    if (elem.first.compare(0, 8, "sys.lru.") == 0) {
+      policy.insert(elem);
+    }
+  }
+
+  return policy;
+}
+
+//------------------------------------------------------------------------------
+// Print the expiry index statistics
+//------------------------------------------------------------------------------
+void
+LRU::PrintIndexStats(std::string& out, const char* fmtstr)
+{
+  ExpiryIndex::Stats stats = mExpiryIndex.GetStats();
+  char line[1024];
+  auto add = [&](const char* key, const std::string & value) {
+    snprintf(line, sizeof(line) - 1, fmtstr, key, value.c_str());
+    out += line;
+  };
+  char value[64];
+  add("lru.index.complete", (mExpiryIndex.IsComplete() &&
+                             mPolicyDirs.IsComplete()) ? "true" : "false");
+  add("lru.index.dirs", std::to_string(mPolicyDirs.Size()));
+  add("lru.index.files", std::to_string(mExpiryIndex.Size()));
+  snprintf(value, sizeof(value), "%.03f", stats.scan_time);
+  add("lru.scan.time", value);
+  add("lru.scan.dirs", std::to_string(stats.scan_entries));
+  add("lru.scan.timestamp", std::to_string(stats.scan_ts));
+  snprintf(value, sizeof(value), "%.03f", stats.cycle_time);
+  add("lru.cycle.time", value);
+  add("lru.cycle.entries", std::to_string(stats.cycle_entries));
+  add("lru.cycle.expired", std::to_string(stats.cycle_expired));
+  add("lru.cycle.timestamp", std::to_string(stats.cycle_ts));
+}
+
 /*----------------------------------------------------------------------------*/
 void
 LRU::AgeExpireEmpty(const char* dir, std::string& policy)
@@ -333,27 +713,35 @@ LRU::AgeExpire(const char* dir,
         fullpath += fmd->getName();
         eos_static_debug("%s", fullpath.c_str());
 
-        // Loop over the match map
+        // Loop over the match map, the shortest matching age applies
+        time_t age = -1;
+
         for (auto mit = lMatchAgeMap.begin(); mit != lMatchAgeMap.end(); mit++) {
           XrdOucString fname = fmd->getName().c_str();
           eos_static_debug("%s %d", mit->first.c_str(),
                            fname.matches(mit->first.c_str()));
 
-          if (fname.matches(mit->first.c_str())) {
-            // Full match check the age policy
-            eos::IFileMD::ctime_t ctime;
-            fmd->getCTime(ctime);
-            time_t age = mit->second;
+          if (fname.matches(mit->first.c_str()) &&
+              ((age < 0) || (mit->second < age))) {
+            age = mit->second;
+          }
+        }
 
-            if ((ctime.tv_sec + age) < now) {
-              // This entry can be deleted
-              eos_static_notice("msg=\"delete expired file\" path=\"%s\" "
-                                "ctime=%u policy-age=%u age=%u",
-                                fullpath.c_str(), ctime.tv_sec, age,
-                                now - ctime.tv_sec);
-              lDeleteList.push_back(fullpath);
-              break;
-            }
+        if (age >= 0) {
+          // Full match check the age policy
+          eos::IFileMD::ctime_t ctime;
+          fmd->getCTime(ctime);
+
+          if ((ctime.tv_sec + age) < now) {
+            // This entry can be deleted
+            eos_static_notice("msg=\"delete expired file\" path=\"%s\" "
+                              "ctime=%u policy-age=%u age=%u",
+                              fullpath.c_str(), ctime.tv_sec, age,
+                              now - ctime.tv_sec);
+            lDeleteList.push_back(fullpath);
+          } else {
+            // Expire it when it is due without listing the directory
+            mExpiryIndex.Insert(std::to_string(fmd->getId()), ctime.tv_sec + age);
           }
         }
       }
@@ -526,7 +914,7 @@ LRU::CacheExpire(const char* dir,
 }
 
 /*----------------------------------------------------------------------------*/
-void
+time_t
 LRU::ConvertMatch(const char* dir,
                   eos::IContainerMD::XAttrMap& map)
 /*----------------------------------------------------------------------------*/
@@ -534,8 +922,11 @@ LRU::ConvertMatch(const char* dir,
  * @brief convert all files matching
  * @param dir directory to process
  * @param map storing all the 'sys.conversion.<match>' policies
+ * @return time the next file is due for conversion, 0 if none
  */
 {
+  time_t next_due = 0;
+
   eos_static_info("msg=\"applying match policy\" dir=\"%s\" match=\"%s\"",
                   dir,
                   map["sys.lru.convert.match"].c_str());
@@ -549,7 +940,7 @@ LRU::ConvertMatch(const char* dir,
      ) {
     eos_static_err("msg=\"LRU match attribute is illegal\" val=\"%s\"",
                    map["sys.lru.convert.match"].c_str());
-    return;
+    return next_due;
   }
 
   for (auto it = lMatchMap.begin(); it != lMatchMap.end(); it++) {
@@ -606,7 +997,12 @@ LRU::ConvertMatch(const char* dir,
             fmd->getCTime(ctime);
             time_t age = mit->second;
 
-            if ((ctime.tv_sec + age) < now) {
+            if ((ctime.tv_sec + age) >= now) {
+              // not yet due, the directory is listed again once it is
+              if (!next_due || ((ctime.tv_sec + age) < next_due)) {
+                next_due = ctime.tv_sec + age;
+              }
+            } else {
               std::string conv_attr = "sys.conversion.";
               conv_attr += mit->first;
               // Check if this file has already the proper layout
@@ -700,6 +1096,8 @@ LRU::ConvertMatch(const char* dir,
                      conversiontagfile);
     }
   }
+
+  return next_due;
 }
 
 
@@ -25,11 +25,14 @@
 #define __EOSMGM_LRU__HH__
 
 #include "mgm/Namespace.hh"
+#include "mgm/ExpiryIndex.hh"
 #include "common/Mapping.hh"
 #include "common/AssistedThread.hh"
 #include "namespace/interface/IContainerMD.hh"
 #include "XrdOuc/XrdOucErrInfo.hh"
 #include <sys/types.h>
+#include <map>
+#include <mutex>
 
 EOSMGMNAMESPACE_BEGIN
 
@@ -38,6 +41,12 @@ EOSMGMNAMESPACE_BEGIN
  *
  * @brief  This class implements an LRU engine to apply policies based on atime
  *
+ * Directories with a policy and files matching a 'sys.lru.expire.match'
+ * policy are kept in persistent expiry indices which are updated on file
+ * creation and policy changes. A full namespace scan is only done to build
+ * the indices and then in the interval configured by 'lru.rescan' in the
+ * default space (default 1 day) to pick up entries moved into policy
+ * directories by renames.
  */
 
 class LRU
@@ -47,12 +56,22 @@ private:
   time_t mMs; //< forced sleep time used for find / scans
   eos::common::Mapping::VirtualIdentity mRootVid;//< we operate with the root vid
   XrdOucErrInfo mError; //< XRootD error object
+  //! Files with an expire policy by due time, key is the file id
+  ExpiryIndex mExpiryIndex;
+  //! Directories with a policy, key is the container id, timestamp is 0 or
+  //! the time of a policy change not yet applied to the existing files
+  ExpiryIndex mPolicyDirs;
+  time_t mLastScan; //< time of the last full scan, restored from the index
+  std::mutex mConvertMutex; //< protects mConvertDue
+  //! Next time a directory with a conversion policy has files to convert, 0
+  //! if none, key is the container id. Directories not in the map are listed.
+  std::map<unsigned long long, time_t> mConvertDue;
 
 public:
 
   /* Default Constructor - use it to run the LRU thread by calling Start
    */
-  LRU()
+  LRU(): mExpiryIndex("lru"), mPolicyDirs("lru-dirs"), mLastScan(0)
   {
     mMs = 0;
     eos::common::Mapping::Root(mRootVid);
@@ -102,19 +121,100 @@ public:
    */
   void AgeExpireEmpty(const char* dir, std::string& policy);
 
-  /* expire by age
+  /* expire by age, files to expire later are added to the expiry index
    */
   void AgeExpire(const char* dir, std::string& policy);
 
+  /**
+   * @brief apply the policies of one directory
+   * @param dir directory path
+   * @param map attributes of the directory
+   * @param empty true if the directory has no children
+   * @param match_scan list the directory for the expire and convert match
+   *        policies, otherwise it is only listed once conversions are due
+   * @param cid container id of the directory, 0 if not known
+   */
+  void ApplyPolicies(const char* dir, eos::IContainerMD::XAttrMap& map,
+                     bool empty, bool match_scan, unsigned long long cid = 0);
+
+  /**
+   * @brief expire the files of the expiry index which are due
+   * @return number of expired files
+   */
+  unsigned long long ExpireDue(unsigned long long& looked_at);
+
+  /**
+   * @brief get the age of a file name in an expire match policy
+   * @param policy value of sys.lru.expire.match
+   * @param name file name
+   * @return age in seconds or -1 if the name does not match
+   */
+  static time_t GetMatchAge(const std::string& policy, const std::string& name);
+
+  /**
+   * @brief notification of a file creation
+   * @param fid file id
+   * @param cid container id of the parent directory
+   * @param name file name
+   * @param ctime creation time
+   * @param attrmap attributes of the parent directory
+   */
+  void FileCreated(unsigned long long fid, unsigned long long cid,
+                   const std::string& name, time_t ctime,
+                   const eos::IContainerMD::XAttrMap& attrmap);
+
+  /**
+   * @brief notification of a directory which got or inherited an LRU policy
+   * @param cid container id
+   * @param scan the existing files have to be checked for expiration
+   */
+  void PolicyChanged(unsigned long long cid, bool scan);
+
+  /**
+   * @brief check if an attribute map contains an LRU policy
+   */
+  static bool HasPolicy(const eos::IContainerMD::XAttrMap& attrmap);
+
+  /**
+   * @brief get the LRU policy attributes of an attribute map
+   */
+  static std::map<std::string, std::string>
+  PolicyAttributes(const eos::IContainerMD::XAttrMap& attrmap);
+
+  /**
+   * @brief print the expiry index statistics
+   * @param out output string
+   * @param fmtstr format for a key and a value
+   */
+  void PrintIndexStats(std::string& out, const char* fmtstr);
+
   /* expire by volume
    */
   void CacheExpire(const char* dir, std::string& low, std::string& high);
 
-  /* convert by match
+  /* convert by match, returns the time the next file of the directory is
+   * due for conversion or 0 if there is none
+   */
+  time_t ConvertMatch(const char* dir,  eos::IContainerMD::XAttrMap& map);
+
+  /**
+   * @brief check if a directory has to be listed for conversions
+   * @param cid container id
+   * @param now current time
+   */
+  bool ConvertDue(unsigned long long cid, time_t now);
+
+  /**
+   * @brief record when the next file of a directory is due for conversion
+   * @param cid container id
+   * @param due time the next file is due, 0 if none
+   * @param lower only make an existing due time earlier, directories not
+   *        in the map are listed anyway
    */
-  void ConvertMatch(const char* dir,  eos::IContainerMD::XAttrMap& map);
+  void SetConvertDue(unsigned long long cid, time_t due, bool lower);
 
   static const char* gLRUPolicyPrefix;
+  static time_t gLRURetryTime; //< delay before retrying a failed expiration
 
   struct lru_entry {
     // compare operator to use struct in a map
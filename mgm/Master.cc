@@ -66,6 +66,8 @@ Master::Master()
   fCompactingRatio = 0;
   fCompactFiles = false;
   fCompactDirectories = false;
+  fCompactIncremental = false;
+  fCompactingCommitPauseUs = 0;
   fDevNull = 0;
   fDevNullLogger = nullptr;
   fDevNullErr = nullptr;
@@ -691,6 +693,7 @@ Master::Compacting()
       int rc = 0;
       bool CompactFiles = fCompactFiles;
       bool CompactDirectories = fCompactDirectories;
+      bool CompactIncremental = fCompactIncremental;
 
       if (CompactFiles) {
         // Clean-up any old .oc file
@@ -710,48 +713,129 @@ Master::Compacting()
       }
 
       bool compacted = false;
+      {
+        XrdSysMutexHelper cLock(fCompactingMutex);
+        fFileCompactingProgress = eos::CompactingProgress();
+        fDirCompactingProgress = eos::CompactingProgress();
+        fCompactingCommitPauseUs = 0;
+      }
+
+      void* compData = nullptr;
+      void* compDirData = nullptr;
 
       try {
-        void* compData = nullptr;
-        void* compDirData = nullptr;
-        {
-          MasterLog(eos_info("msg=\"compact prepare\""));
-          // Require NS read lock
-          eos::common::RWMutexReadLock lock(gOFS->eosViewRWMutex);
+        if (CompactIncremental) {
+          {
+            MasterLog(eos_info("msg=\"compact prepare incremental\""));
+            // Require NS read lock
+            eos::common::RWMutexReadLock lock(gOFS->eosViewRWMutex);
+
+            if (CompactFiles) {
+              compData = eos_chlog_filesvc->compactIncrementalPrepare(ocfile);
+            }
 
-          if (CompactFiles) {
-            compData = eos_chlog_filesvc->compactPrepare(ocfile);
+            if (CompactDirectories) {
+              compDirData = eos_chlog_dirsvc->compactIncrementalPrepare(ocdir);
+            }
           }
-
-          if (CompactDirectories) {
-            compDirData = eos_chlog_dirsvc->compactPrepare(ocdir);
+          {
+            MasterLog(eos_info("msg=\"compacting segments\""));
+            // The segments take the namespace lock themselves - both logs
+            // have to be small at the same time to keep the commit short. A
+            // log which does not get small while catching up with the
+            // appended records reports done after a bounded number of
+            // segments and its tail is compacted by the commit.
+            bool filesDone = false;
+            bool dirsDone = false;
+
+            while (!filesDone || !dirsDone) {
+              filesDone = !CompactFiles ||
+                          eos_chlog_filesvc->compactSegment(compData, &fNsLock);
+              dirsDone = !CompactDirectories ||
+                         eos_chlog_dirsvc->compactSegment(compDirData, &fNsLock);
+              XrdSysMutexHelper cLock(fCompactingMutex);
+              fFileCompactingProgress =
+                eos_chlog_filesvc->getCompactingProgress(compData);
+              fDirCompactingProgress =
+                eos_chlog_dirsvc->getCompactingProgress(compDirData);
+            }
           }
-        }
-        {
-          MasterLog(eos_info("msg=\"compacting\""));
+          {
+            // Requires namespace write lock
+            MasterLog(eos_info("msg=\"compact commit incremental\""));
+            eos::common::RWMutexWriteLock lock(gOFS->eosViewRWMutex);
+            auto start = std::chrono::steady_clock::now();
+
+            if (CompactFiles) {
+              eos_chlog_filesvc->compactIncrementalCommit(compData);
+              compData = nullptr;
+            }
+
+            if (CompactDirectories) {
+              eos_chlog_dirsvc->compactIncrementalCommit(compDirData);
+              compDirData = nullptr;
+            }
+
+            uint64_t pause = std::chrono::duration_cast<std::chrono::microseconds>
+                             (std::chrono::steady_clock::now() - start).count();
+            XrdSysMutexHelper cLock(fCompactingMutex);
+            fCompactingCommitPauseUs = pause;
+
+            if (CompactFiles) {
+              fFileCompactingProgress.processed = fFileCompactingProgress.total;
+            }
 
-          // Does not require namespace lock
-          if (CompactFiles) {
-            eos_chlog_filesvc->compact(compData);
+            if (CompactDirectories) {
+              fDirCompactingProgress.processed = fDirCompactingProgress.total;
+            }
           }
+          MasterLog(eos_info("msg=\"compact commit incremental done\" "
+                             "file-segments=%llu dir-segments=%llu "
+                             "commit-pause-us=%llu",
+                             (unsigned long long) fFileCompactingProgress.segments,
+                             (unsigned long long) fDirCompactingProgress.segments,
+                             (unsigned long long) fCompactingCommitPauseUs));
+        } else {
+          {
+            MasterLog(eos_info("msg=\"compact prepare\""));
+            // Require NS read lock
+            eos::common::RWMutexReadLock lock(gOFS->eosViewRWMutex);
 
-          if (CompactDirectories) {
-            eos_chlog_dirsvc->compact(compDirData);
+            if (CompactFiles) {
+              compData = eos_chlog_filesvc->compactPrepare(ocfile);
+            }
+
+            if (CompactDirectories) {
+              compDirData = eos_chlog_dirsvc->compactPrepare(ocdir);
+            }
           }
-        }
-        {
-          // Requires namespace write lock
-          MasterLog(eos_info("msg=\"compact commit\""));
-          eos::common::RWMutexWriteLock lock(gOFS->eosViewRWMutex);
+          {
+            MasterLog(eos_info("msg=\"compacting\""));
 
-          if (CompactFiles) {
-            eos_chlog_filesvc->compactCommit(compData);
+            // Does not require namespace lock
+            if (CompactFiles) {
+              eos_chlog_filesvc->compact(compData);
+            }
+
+            if (CompactDirectories) {
+              eos_chlog_dirsvc->compact(compDirData);
+            }
           }
+          {
+            // Requires namespace write lock
+            MasterLog(eos_info("msg=\"compact commit\""));
+            eos::common::RWMutexWriteLock lock(gOFS->eosViewRWMutex);
 
-          if (CompactDirectories) {
-            eos_chlog_dirsvc->compactCommit(compDirData);
+            if (CompactFiles) {
+              eos_chlog_filesvc->compactCommit(compData);
+            }
+
+            if (CompactDirectories) {
+              eos_chlog_dirsvc->compactCommit(compDirData);
+            }
           }
         }
+
         {
           XrdSysMutexHelper cLock(fCompactingMutex);
           reschedule = (fCompactingInterval != 0);
@@ -830,6 +914,19 @@ Master::Compacting()
         errno = e.getErrno();
         MasterLog(eos_crit("online-compacting returned ec=%d %s", e.getErrno(),
                            e.getMessage().str().c_str()));
+
+        if (CompactIncremental && (compData || compDirData)) {
+          // Point the namespace back to the original logs
+          eos::common::RWMutexWriteLock lock(gOFS->eosViewRWMutex);
+
+          if (compData) {
+            eos_chlog_filesvc->compactIncrementalAbort(compData);
+          }
+
+          if (compDirData) {
+            eos_chlog_dirsvc->compactIncrementalAbort(compDirData);
+          }
+        }
       }
 
       std::this_thread::sleep_for(std::chrono::seconds(1));
@@ -936,6 +1033,33 @@ Master::PrintOutCompacting(XrdOucString& out)
   out += " ratio-dir=";
   out += cfratio;
   out += ":1";
+
+  if (fCompactIncremental) {
+    // Progress of the running or the last incremental compacting
+    XrdSysMutexHelper cLock(fCompactingMutex);
+    uint64_t processed = fFileCompactingProgress.processed +
+                         fDirCompactingProgress.processed;
+    uint64_t total = fFileCompactingProgress.total +
+                     fDirCompactingProgress.total;
+    uint64_t maxPauseUs = std::max(fFileCompactingProgress.maxPauseUs,
+                                   fDirCompactingProgress.maxPauseUs);
+    uint64_t lastPauseUs = std::max(fFileCompactingProgress.lastPauseUs,
+                                    fDirCompactingProgress.lastPauseUs);
+    char cprogress[512];
+    snprintf(cprogress, sizeof(cprogress) - 1,
+             " mode=incremental progress=%.01f%% segments=%llu copied=%llu "
+             "pause-last=%.03fms pause-max=%.03fms pause-commit=%.03fms",
+             total ? (100.0 * processed / total) : 0.0,
+             (unsigned long long)(fFileCompactingProgress.segments +
+                                  fDirCompactingProgress.segments),
+             (unsigned long long)(fFileCompactingProgress.copied +
+                                  fDirCompactingProgress.copied),
+             lastPauseUs / 1000.0, maxPauseUs / 1000.0,
+             fCompactingCommitPauseUs / 1000.0);
+    out += cprogress;
+  } else {
+    out += " mode=full";
+  }
 }
 
 //------------------------------------------------------------------------------
@@ -1905,11 +2029,10 @@ Master::BootNamespace()
       dynamic_cast<eos::IChLogFileMDSvc*>(gOFS->eosFileService);
 
     if (eos_chlog_filesvc && eos_chlog_dirsvc) {
-      if (!IsMaster()) {
-        // slave needs access to the namespace lock
-        eos_chlog_filesvc->setSlaveLock(&fNsLock);
-        eos_chlog_dirsvc->setSlaveLock(&fNsLock);
-      }
+      // The slave follower and the checkpoint thread of a master need access
+      // to the namespace lock
+      eos_chlog_filesvc->setSlaveLock(&fNsLock);
+      eos_chlog_dirsvc->setSlaveLock(&fNsLock);
 
       eos_chlog_filesvc->clearWarningMessages();
       eos_chlog_dirsvc->clearWarningMessages();
@@ -28,6 +28,7 @@
 #include "mgm/Namespace.hh"
 #include "mgm/IMaster.hh"
 #include "namespace/utils/Locking.hh"
+#include "namespace/interface/Misc.hh"
 #include "XrdOuc/XrdOucString.hh"
 #include <atomic>
 
@@ -167,6 +168,17 @@ public:
     fCompactDirectories = d;
   }
 
+  //----------------------------------------------------------------------------
+  //! Configure incremental online compacting, the changelog files are then
+  //! compacted in segments holding the namespace lock only for short periods
+  //!
+  //! @param incremental enable incremental compacting
+  //----------------------------------------------------------------------------
+  void SetCompactingIncremental(bool incremental)
+  {
+    fCompactIncremental = incremental;
+  }
+
   //----------------------------------------------------------------------------
   //! Start slave follower thread
   //!
@@ -256,6 +268,13 @@ private:
   bool fRemoteMasterOk; ///< flag indicating if the remote master is up
   bool fCompactFiles; ///< compact the files changelog file if true
   bool fCompactDirectories; ///< compact the directories changelog file if true
+  bool fCompactIncremental; ///< compact the changelog files in segments
+  //! progress of an incremental compacting of the file changelog
+  eos::CompactingProgress fFileCompactingProgress;
+  //! progress of an incremental compacting of the directory changelog
+  eos::CompactingProgress fDirCompactingProgress;
+  //! write lock hold time of the last incremental compacting commit
+  uint64_t fCompactingCommitPauseUs;
   pthread_t fThread; ///< heartbeat thread id
   pthread_t fCompactingThread; ///< online compacting thread id
   //! compacting ratio for file changelog e.g. 4:1 => 4 times smaller after compaction
@@ -314,6 +333,15 @@ private:
       }
     }
 
+    //------------------------------------------------------------------------
+    // Take a read lock, give up after the timeout
+    //------------------------------------------------------------------------
+    virtual bool
+    timedReadLock(uint64_t timeout_ns)
+    {
+      return pLock ? pLock->TimedRdLock(timeout_ns) : true;
+    }
+
     //------------------------------------------------------------------------
     // Take a write lock
     //------------------------------------------------------------------------
@@ -73,7 +73,7 @@ Messaging::Listen(ThreadAssistant& assistant) noexcept
 
     if (new_msg) {
       Process(new_msg.get());
-    } else {
+    } else if (!XrdMqMessaging::gMessageClient.IsPushActive()) {
       assistant.wait_for(std::chrono::seconds(1));
     }
   }
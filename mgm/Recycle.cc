@@ -26,13 +26,22 @@
 #include "common/Mapping.hh"
 #include "common/RWMutex.hh"
 #include "common/Path.hh"
+#include "common/Timing.hh"
 #include "mgm/Recycle.hh"
 #include "mgm/XrdMgmOfs.hh"
 #include "mgm/Quota.hh"
+#include "mgm/Master.hh"
 #include "mgm/XrdMgmOfsDirectory.hh"
 #include "namespace/interface/IView.hh"
 #include "namespace/Prefetcher.hh"
 #include "XrdOuc/XrdOucErrInfo.hh"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
 
 // MgmOfsConfigure prepends the proc directory path e.g. the bin is
 // /eos/<instance/proc/recycle/
@@ -43,9 +52,18 @@ std::string Recycle::gRecyclingKeepRatio = "sys.recycle.keepratio";
 std::string Recycle::gRecyclingVersionKey = "sys.recycle.version.key";
 std::string Recycle::gRecyclingPostFix = ".d";
 int Recycle::gRecyclingPollTime = 30;
+int Recycle::gRecyclingRescanTime = 86400;
+int Recycle::gRecyclingRetryTime = 3600;
+eos::mgm::ExpiryIndex Recycle::gRecyclingIndex("recycle");
+unsigned int Recycle::gRecyclingPurgeThreads = 4;
+unsigned int Recycle::gRecyclingPurgeMaxThreads = 16;
+size_t Recycle::gRecyclingPurgeBatch = 1000;
+Recycle::PurgeProgress Recycle::gPurgeProgress;
 
 EOSMGMNAMESPACE_BEGIN
 
+static void PrintRunningPurges(std::ostringstream& out);
+
 
 //------------------------------------------------------------------------------
 // Run asynchronous recyling thread
@@ -81,7 +99,6 @@ Recycle::Recycler(ThreadAssistant& assistant) noexcept
   XrdOucErrInfo lError;
   time_t lKeepTime = 0;
   double lSpaceKeepRatio = 0;
-  std::multimap<time_t, std::string> lDeletionMap;
   time_t snoozetime = 10;
   unsigned long long lLowInodesWatermark = 0;
   unsigned long long lLowSpaceWatermark = 0;
@@ -93,6 +110,14 @@ Recycle::Recycler(ThreadAssistant& assistant) noexcept
     return;
   }
 
+  // The index of the recycle bin entries is filled by ToGarbage. Another MGM
+  // may have been master since the journal was written, so the bin is scanned
+  // once this MGM is master, including right after the start.
+  if (gOFS->MgmMetaLogDir.length()) {
+    gRecyclingIndex.Load(gOFS->MgmMetaLogDir + "/recycle.index");
+  }
+
+  bool was_master = false;
   assistant.wait_for(std::chrono::seconds(10));
 
   while (!assistant.terminationRequested()) {
@@ -115,6 +140,26 @@ Recycle::Recycler(ThreadAssistant& assistant) noexcept
 
     // This will be reconfigured to an appropriate value later
     snoozetime = gRecyclingPollTime;
+
+    // Entries recycled while we were a slave are not in the index
+    if (gOFS->mMaster->IsMaster() != was_master) {
+      was_master = !was_master;
+
+      if (was_master) {
+        eos_static_info("%s", "msg=\"became master - rebuilding the recycle "
+                        "bin index\"");
+        gRecyclingIndex.Clear();
+      }
+    }
+
+    // Rescan now and then to pick up entries the index missed
+    if (gRecyclingIndex.IsComplete() &&
+        ((time(NULL) - gRecyclingIndex.GetStats().scan_ts) >=
+         gRecyclingRescanTime)) {
+      eos_static_info("%s", "msg=\"rescanning the recycle bin\"");
+      gRecyclingIndex.Clear();
+    }
+
     // Read our current policy setting
     eos::IContainerMD::XAttrMap attrmap;
 
@@ -163,15 +208,18 @@ Recycle::Recycler(ThreadAssistant& assistant) noexcept
 
       if (attrmap.count(Recycle::gRecyclingTimeAttribute)) {
         lKeepTime = strtoull(attrmap[Recycle::gRecyclingTimeAttribute].c_str(), 0, 10);
-        eos_static_info("keep-time=%llu deletion-map=%llu", lKeepTime,
-                        lDeletionMap.size());
+        eos_static_info("keep-time=%llu index-entries=%llu", lKeepTime,
+                        gRecyclingIndex.Size());
 
         if (lKeepTime > 0) {
-          if (!lDeletionMap.size()) {
+          if (!gRecyclingIndex.IsComplete()) {
             //...................................................................
-            //  the deletion map is filled if there is nothing inside with files/
-            //  directories found previously in the garbage bin
+            //  the index is filled with a full scan of the garbage bin if it
+            //  could not be restored from its journal
             //...................................................................
+            eos::common::Timing scan_timing("RecycleScan");
+            COMMONTIMING("start", &scan_timing);
+            gRecyclingIndex.Clear();
             // the old reyccle bin gid/uid/<contracted>
             {
               std::string subdirs;
@@ -247,8 +295,8 @@ Recycle::Recycler(ThreadAssistant& assistant) noexcept
                                            "recycle-path=%s l2-path=%s l3-path=%s",
                                            Recycle::gRecyclingPrefix.c_str(), l2.c_str(), l3.c_str());
                           } else {
-                            // Add to the garbage fifo deletion multimap
-                            lDeletionMap.insert(std::pair<time_t, std::string > (buf.st_ctime, l4));
+                            // Add to the garbage index
+                            gRecyclingIndex.Insert(l4, buf.st_ctime);
                           }
                         }
 
@@ -305,23 +353,39 @@ Recycle::Recycler(ThreadAssistant& assistant) noexcept
                                      "recycle-path=%s path=%s",
                                      Recycle::gRecyclingPrefix.c_str(), fullpath.c_str());
                     } else {
-                      // Add to the garbage fifo deletion multimap
-                      lDeletionMap.insert(std::pair<time_t, std::string > (buf.st_ctime,
-                                          fullpath.c_str()));
-                      eos_static_debug("new-bin: adding to deletionmap : %s", fullpath.c_str());
+                      // Add to the garbage index
+                      gRecyclingIndex.Insert(fullpath, buf.st_ctime);
+                      eos_static_debug("new-bin: adding to index : %s", fullpath.c_str());
                     }
                   }
                 }
               }
             }
-          } else {
+
+            COMMONTIMING("stop", &scan_timing);
+            gRecyclingIndex.SetComplete();
+            gRecyclingIndex.RecordScan(scan_timing.RealTime() / 1000.0,
+                                       gRecyclingIndex.Size());
+            eos_static_info("msg=\"recycle bin scan finished\" entries=%llu "
+                            "time=%.03f", gRecyclingIndex.Size(),
+                            scan_timing.RealTime() / 1000.0);
+          }
+
+          {
             snoozetime = 0; // this will be redefined by the oldest entry time
-            auto it = lDeletionMap.begin();
+            eos::common::Timing cycle_timing("RecycleCycle");
+            COMMONTIMING("start", &cycle_timing);
+            unsigned long long n_entries = 0;
+            unsigned long long n_expired = 0;
+            std::string key;
+            time_t ctime;
             time_t now = time(NULL);
 
-            while (it != lDeletionMap.end()) {
+            while (gRecyclingIndex.Front(key, ctime)) {
+              n_entries++;
+
               // take the first element and see if it is exceeding the keep time
-              if ((it->first + lKeepTime) < now) {
+              if ((ctime + lKeepTime) < now) {
                 // This entry can be removed
                 // If there is a keep-ratio policy defined we abort deletion once
                 // we are enough under the thresholds
@@ -346,9 +410,21 @@ Recycle::Recycler(ThreadAssistant& assistant) noexcept
                   }
                 }
 
-                XrdOucString delpath = it->second.c_str();
+                struct stat buf;
+
+                if (gOFS->_stat(key.c_str(), &buf, lError, rootvid, "", 0, false)) {
+                  // already purged or restored
+                  eos_static_debug("msg=\"dropping vanished entry from recycle "
+                                   "bin index\" path=%s", key.c_str());
+                  gRecyclingIndex.Remove(key);
+                  continue;
+                }
+
+                XrdOucString delpath = key.c_str();
+                bool failed = false;
+                n_expired++;
 
-                if ((it->second.length()) &&
+                if ((key.length()) &&
                     (delpath.endswith(Recycle::gRecyclingPostFix.c_str()))) {
                   //.............................................................
                   // do a directory deletion - first find all subtree children
@@ -358,9 +434,10 @@ Recycle::Recycler(ThreadAssistant& assistant) noexcept
                   std::set<std::string>::const_iterator fileit;
                   XrdOucString err_msg;
 
-                  if (gOFS->_find(it->second.c_str(), lError, err_msg, rootvid, found)) {
+                  if (gOFS->_find(key.c_str(), lError, err_msg, rootvid, found)) {
                     eos_static_err("msg=\"unable to do a find in subtree\" path=%s stderr=\"%s\"",
-                                   it->second.c_str(), err_msg.c_str());
+                                   key.c_str(), err_msg.c_str());
+                    failed = true;
                   } else {
                     //...........................................................
                     // standard way to delete files recursively
@@ -382,6 +459,7 @@ Recycle::Recycler(ThreadAssistant& assistant) noexcept
 
                         if (gOFS->_rem(fspath.c_str(), lError, rootvid, (const char*) 0)) {
                           eos_static_err("msg=\"unable to remove file\" path=%s", fspath.c_str());
+                          failed = true;
                         } else {
                           eos_static_info("msg=\"permanently deleted file from recycle bin\" path=%s keep-time=%llu",
                                           fspath.c_str(), lKeepTime);
@@ -404,34 +482,38 @@ Recycle::Recycler(ThreadAssistant& assistant) noexcept
 
                       if (gOFS->_remdir(rfoundit->first.c_str(), lError, rootvid, (const char*) 0)) {
                         eos_static_err("msg=\"unable to remove directory\" path=%s", fspath.c_str());
+                        failed = true;
                       } else {
                         eos_static_info("msg=\"permanently deleted directory from recycle bin\" path=%s keep-time=%llu",
                                         fspath.c_str(), lKeepTime);
                       }
                     }
                   }
-
-                  lDeletionMap.erase(it);
-                  it = lDeletionMap.begin();
                 } else {
                   //...........................................................
                   // do a single file deletion
                   //...........................................................
-                  if (gOFS->_rem(it->second.c_str(), lError, rootvid, (const char*) 0)) {
-                    eos_static_err("msg=\"unable to remove file\" path=%s", it->second.c_str());
+                  if (gOFS->_rem(key.c_str(), lError, rootvid, (const char*) 0)) {
+                    eos_static_err("msg=\"unable to remove file\" path=%s", key.c_str());
+                    failed = true;
                   }
+                }
 
-                  lDeletionMap.erase(it);
-                  it = lDeletionMap.begin();
+                if (failed) {
+                  // keep the entry and retry it later, it is due again in
+                  // gRecyclingRetryTime seconds
+                  gRecyclingIndex.Insert(key, now + gRecyclingRetryTime - lKeepTime);
+                } else {
+                  gRecyclingIndex.Remove(key);
                 }
               } else {
                 // This entry has still to be kept
                 eos_static_info("oldest entry: %lld sec to deletion",
-                                it->first + lKeepTime - now);
+                                ctime + lKeepTime - now);
 
                 if (!snoozetime) {
                   // define the sleep period from the oldest entry
-                  snoozetime = it->first + lKeepTime - now;
+                  snoozetime = ctime + lKeepTime - now;
 
                   if (snoozetime < gRecyclingPollTime) {
                     // avoid to activate this thread too many times, 5 minutes
@@ -455,6 +537,10 @@ Recycle::Recycler(ThreadAssistant& assistant) noexcept
             if (!snoozetime) {
               snoozetime = gRecyclingPollTime;
             }
+
+            COMMONTIMING("stop", &cycle_timing);
+            gRecyclingIndex.RecordCycle(cycle_timing.RealTime() / 1000.0, n_entries,
+                                        n_expired);
           }
         } else {
           eos_static_warning("msg=\"parsed '%s' attribute as keep-time of %llu seconds - ignoring!\" recycle-path=%s",
@@ -526,6 +612,7 @@ Recycle::ToGarbage(const char* epname, XrdOucErrInfo& error)
     return gOFS->Emsg(epname, error, EIO, "rename file/directory", srecyclepath);
   }
 
+  gRecyclingIndex.Insert(srecyclepath, time(NULL));
   // store the recycle path in the error object
   error.setErrInfo(0, srecyclepath);
   return SFS_OK;
@@ -765,7 +852,19 @@ Recycle::Print(std::string& std_out, std::string& std_err,
                  attrmap[Recycle::gRecyclingTimeAttribute].c_str() : "not configured",
                  attrmap.count(Recycle::gRecyclingKeepRatio) ?
                  attrmap[Recycle::gRecyclingKeepRatio].c_str() : "not configured");
-        oss_out << sline << std::endl
+        oss_out << sline << std::endl;
+        ExpiryIndex::Stats stats = gRecyclingIndex.GetStats();
+        snprintf(sline, sizeof(sline) - 1, "# index %llu entries (%s) last-scan "
+                 "%.03f s for %llu entries last-cycle %.03f s for %llu entries "
+                 "%llu expired", (unsigned long long) gRecyclingIndex.Size(),
+                 gRecyclingIndex.IsComplete() ? "complete" : "building",
+                 stats.scan_time, stats.scan_entries, stats.cycle_time,
+                 stats.cycle_entries, stats.cycle_expired);
+        oss_out << sline << std::endl;
+
+        PrintRunningPurges(oss_out);
+
+        oss_out
                 << "# _________________________________________________________"
                 << "___________________________________________________________"
                 << "_______" << std::endl;
@@ -781,6 +880,22 @@ Recycle::Print(std::string& std_out, std::string& std_err,
                  attrmap[Recycle::gRecyclingTimeAttribute].c_str() : "-1",
                  attrmap.count(Recycle::gRecyclingKeepRatio) ?
                  attrmap[Recycle::gRecyclingKeepRatio].c_str() : "-1");
+        oss_out << sline;
+        ExpiryIndex::Stats stats = gRecyclingIndex.GetStats();
+        snprintf(sline, sizeof(sline) - 1, " index-entries=%llu index-complete=%d "
+                 "scan-time=%.03f scan-entries=%llu cycle-time=%.03f "
+                 "cycle-entries=%llu cycle-expired=%llu",
+                 (unsigned long long) gRecyclingIndex.Size(),
+                 gRecyclingIndex.IsComplete(), stats.scan_time, stats.scan_entries,
+                 stats.cycle_time, stats.cycle_entries, stats.cycle_expired);
+        oss_out << sline;
+        snprintf(sline, sizeof(sline) - 1, " purge-running=%d purge-dirs=%llu "
+                 "purge-bulk=%llu purge-files=%llu purge-failed=%llu",
+                 (int) gPurgeProgress.running,
+                 (unsigned long long) gPurgeProgress.dirs,
+                 (unsigned long long) gPurgeProgress.bulk,
+                 (unsigned long long) gPurgeProgress.files,
+                 (unsigned long long) gPurgeProgress.failed);
         oss_out << sline << std::endl;
       }
     }
@@ -1179,6 +1294,7 @@ Recycle::Restore(std::string& std_out, std::string& std_err,
     std_out += "success: restored path=";
     std_out += oPath.GetPath();
     std_out += "\n";
+    gRecyclingIndex.Remove(cPath.GetPath());
   }
 
   if (restore_versions == false) {
@@ -1205,82 +1321,378 @@ Recycle::Restore(std::string& std_out, std::string& std_err,
   return retc;
 }
 
-/*----------------------------------------------------------------------------*/
-int
-Recycle::PurgeOld(std::string& std_out, std::string& std_err,
-                  eos::common::Mapping::VirtualIdentity_t& vid)
+//------------------------------------------------------------------------------
+//! Deletes recycle bin entries with a pool of parallel workers and an optional
+//! limit of deletions per second. The queue of entries is bounded, the walk
+//! of the bin waits for the workers once it is full.
+//------------------------------------------------------------------------------
+class RecyclePurger
 {
-  eos::common::Mapping::VirtualIdentity rootvid;
-  eos::common::Mapping::Root(rootvid);
-  XrdMgmOfsDirectory dirl;
-  char sdir[4096];
-  snprintf(sdir, sizeof(sdir) - 1, "%s/%u/%u/", Recycle::gRecyclingPrefix.c_str(),
-           (unsigned int) vid.gid, (unsigned int) vid.uid);
-  int retc = dirl.open(sdir, vid, "");
+public:
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //!
+  //! @param list_vid identity used to list the bin, by default root
+  //----------------------------------------------------------------------------
+  RecyclePurger(const std::string& dir, unsigned int rate, unsigned int nthreads,
+                std::string& std_err,
+                const eos::common::Mapping::VirtualIdentity* list_vid = nullptr):
+    mDir(dir), mRate(rate),
+    mThreads(std::min(nthreads ? nthreads : Recycle::gRecyclingPurgeThreads,
+                      Recycle::gRecyclingPurgeMaxThreads)),
+    mStdErr(std_err), mDirs(0), mFiles(0), mBulk(0), mFailed(0),
+    mStart(time(NULL)), mLastReport(mStart),
+    mNext(std::chrono::steady_clock::now()), mBusy(0), mStop(false)
+  {
+    eos::common::Mapping::Root(mRootVid);
+    mListVid = (list_vid ? *list_vid : mRootVid);
+    Recycle::gPurgeProgress.running++;
+    std::lock_guard<std::mutex> lock(sPurgesMutex);
+    sPurges.insert(this);
+  }
 
-  if (retc) {
-    std_out = "success: nothing has been purged in the old recycle bin!\n";
-    return 0;
+  ~RecyclePurger()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mQueueMutex);
+      mStop = true;
+    }
+    mQueueCv.notify_all();
+
+    for (auto& worker : mWorkers) {
+      worker.join();
+    }
+
+    Recycle::gPurgeProgress.running--;
+    std::lock_guard<std::mutex> lock(sPurgesMutex);
+    sPurges.erase(this);
   }
 
-  const char* dname;
-  int nfiles_deleted = 0;
-  int nbulk_deleted = 0;
+  //----------------------------------------------------------------------------
+  //! Queue the entries of a bin directory for deletion
+  //!
+  //! @param dir directory ending with '/'
+  //! @param depth levels of sub-directories (uid, date, index) to descend
+  //!
+  //! @return 0 if the directory could be listed, otherwise the error code
+  //----------------------------------------------------------------------------
+  int Walk(const std::string& dir, int depth)
+  {
+    XrdMgmOfsDirectory dirl;
+    int retc = dirl.open(dir.c_str(), mListVid, "");
+
+    if (retc) {
+      return retc;
+    }
+
+    mDirs++;
+    Recycle::gPurgeProgress.dirs++;
+    std::vector<std::string> subdirs;
+    const char* dname;
 
-  while ((dname = dirl.nextEntry())) {
-    std::string sdname = dname;
+    while ((dname = dirl.nextEntry())) {
+      std::string name = dname;
 
-    if ((sdname == ".") || (sdname == "..")) {
-      continue;
+      if ((name == ".") || (name == "..")) {
+        continue;
+      }
+
+      if (name[0] == '#') {
+        Add(dir + name);
+      } else if (depth > 0) {
+        subdirs.push_back(dir + name + "/");
+      }
     }
 
-    std::string pathname = sdir;
-    pathname += dname;
-    struct stat buf;
-    XrdOucErrInfo lError;
+    dirl.close();
 
-    if (!gOFS->_stat(pathname.c_str(), &buf, lError, vid, "")) {
-      // execute a proc command
-      ProcCommand Cmd;
-      XrdOucString info;
+    for (const auto& subdir : subdirs) {
+      Walk(subdir, depth - 1);
+    }
 
-      if (S_ISDIR(buf.st_mode)) {
-        // we need recursive deletion
-        info = "mgm.cmd=rm&mgm.option=r&mgm.path=";
-      } else {
-        info = "mgm.cmd=rm&mgm.path=";
+    return 0;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Queue an entry for deletion, waits while the queue is full
+  //----------------------------------------------------------------------------
+  void Add(const std::string& path)
+  {
+    std::unique_lock<std::mutex> lock(mQueueMutex);
+
+    // the workers are started with the first entry and serve all batches
+    if (mWorkers.empty()) {
+      for (unsigned int i = 0; i < mThreads; ++i) {
+        mWorkers.emplace_back(&RecyclePurger::Work, this);
       }
+    }
 
-      info += pathname.c_str();
-      int result = Cmd.open("/proc/user", info.c_str(), rootvid, &lError);
-      Cmd.AddOutput(std_out, std_err);
+    mDoneCv.wait(lock, [this] {
+      return mQueue.size() < Recycle::gRecyclingPurgeBatch;
+    });
+    mQueue.push_back(path);
+    mQueueCv.notify_one();
+  }
 
-      if (*std_out.rbegin() != '\n') {
-        std_out += "\n";
+  //----------------------------------------------------------------------------
+  //! Wait until all the queued entries are deleted
+  //----------------------------------------------------------------------------
+  void Flush()
+  {
+    std::unique_lock<std::mutex> lock(mQueueMutex);
+    mDoneCv.wait(lock, [this] {
+      return mQueue.empty() && !mBusy;
+    });
+  }
+
+  unsigned long long GetFiles() const
+  {
+    return mFiles;
+  }
+
+  unsigned long long GetBulk() const
+  {
+    return mBulk;
+  }
+
+  unsigned long long GetFailed() const
+  {
+    return mFailed;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Print the progress of the running purges
+  //----------------------------------------------------------------------------
+  static void PrintRunning(std::ostringstream& out)
+  {
+    std::lock_guard<std::mutex> lock(sPurgesMutex);
+    char sline[4096];
+
+    for (auto purger : sPurges) {
+      snprintf(sline, sizeof(sline) - 1, "# purge of %s running for %lld s: "
+               "listed %llu directories purged %llu bulk deletions and "
+               "%llu files %llu failed", purger->mDir.c_str(),
+               (long long)(time(NULL) - purger->mStart),
+               (unsigned long long) purger->mDirs,
+               (unsigned long long) purger->mBulk,
+               (unsigned long long) purger->mFiles,
+               (unsigned long long) purger->mFailed);
+      out << sline << std::endl;
+    }
+  }
+
+private:
+  //----------------------------------------------------------------------------
+  //! Worker loop deleting the queued entries
+  //----------------------------------------------------------------------------
+  void Work()
+  {
+    std::unique_lock<std::mutex> lock(mQueueMutex);
+
+    while (true) {
+      mQueueCv.wait(lock, [this] {
+        return mStop || !mQueue.empty();
+      });
+
+      if (mQueue.empty()) {
+        return;
       }
 
-      if (*std_err.rbegin() != '\n') {
-        std_err += "\n";
+      std::string path = std::move(mQueue.front());
+      mQueue.pop_front();
+      mBusy++;
+      lock.unlock();
+      Delete(path);
+      Report();
+      lock.lock();
+      mBusy--;
+      mDoneCv.notify_all();
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  //! Log the progress every 10 seconds
+  //----------------------------------------------------------------------------
+  void Report()
+  {
+    time_t now = time(NULL);
+    time_t last = mLastReport;
+
+    if (((now - last) >= 10) && mLastReport.compare_exchange_strong(last, now)) {
+      eos_static_info("msg=\"recycle purge progress\" dir=\"%s\" bulk=%llu "
+                      "files=%llu failed=%llu rate=%.02f", mDir.c_str(),
+                      (unsigned long long) mBulk, (unsigned long long) mFiles,
+                      (unsigned long long) mFailed,
+                      1.0 * (mBulk + mFiles) / (now - mStart));
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  //! Wait for the next deletion slot of the rate limit
+  //----------------------------------------------------------------------------
+  void Throttle()
+  {
+    if (!mRate) {
+      return;
+    }
+
+    std::chrono::steady_clock::time_point slot;
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      auto now = std::chrono::steady_clock::now();
+
+      // unused slots are not accumulated
+      if (mNext < now) {
+        mNext = now;
       }
 
+      slot = mNext;
+      mNext += std::chrono::microseconds(1000000 / mRate);
+    }
+    std::this_thread::sleep_until(slot);
+  }
+
+  //----------------------------------------------------------------------------
+  //! Delete a file or a bulk deletion directory
+  //----------------------------------------------------------------------------
+  void Delete(const std::string& path)
+  {
+    eos::common::Mapping::VirtualIdentity rootvid = mRootVid;
+    eos::common::Mapping::VirtualIdentity listvid = mListVid;
+    XrdOucErrInfo lError;
+    struct stat buf;
+    Throttle();
+
+    if (gOFS->_stat(path.c_str(), &buf, lError, listvid, "")) {
+      // restored or purged in the meanwhile
+      return;
+    }
+
+    int retc = 0;
+    std::string std_out, std_err;
+
+    if (S_ISDIR(buf.st_mode)) {
+      // we need recursive deletion
+      ProcCommand Cmd;
+      XrdOucString info = "mgm.cmd=rm&mgm.option=r&mgm.path=";
+      info += path.c_str();
+      retc = Cmd.open("/proc/user", info.c_str(), rootvid, &lError);
+      Cmd.AddOutput(std_out, std_err);
       Cmd.close();
+    } else {
+      retc = gOFS->_rem(path.c_str(), lError, rootvid, (const char*) 0);
+      std_err = lError.getErrText();
+    }
 
-      if (!result) {
-        if (S_ISDIR(buf.st_mode)) {
-          nbulk_deleted++;
-        } else {
-          nfiles_deleted++;
+    if (retc) {
+      mFailed++;
+      Recycle::gPurgeProgress.failed++;
+      std::lock_guard<std::mutex> lock(mMutex);
+
+      // the first errors are enough to understand what is going on
+      if (mFailed <= 100) {
+        mStdErr += "error: failed to purge ";
+        mStdErr += path;
+        mStdErr += " - ";
+        mStdErr += std_err;
+
+        if (*mStdErr.rbegin() != '\n') {
+          mStdErr += "\n";
         }
       }
+
+      return;
+    }
+
+    Recycle::gRecyclingIndex.Remove(path);
+
+    if (S_ISDIR(buf.st_mode)) {
+      mBulk++;
+      Recycle::gPurgeProgress.bulk++;
+    } else {
+      mFiles++;
+      Recycle::gPurgeProgress.files++;
     }
   }
 
-  dirl.close();
+  static std::mutex sPurgesMutex; ///< protects sPurges
+  static std::set<RecyclePurger*> sPurges; ///< running purges
+  eos::common::Mapping::VirtualIdentity mRootVid; ///< identity of the deletions
+  eos::common::Mapping::VirtualIdentity mListVid; ///< identity of the listing
+  std::string mDir; ///< directory being purged
+  unsigned int mRate; ///< max. deletions per second, 0 for no limit
+  unsigned int mThreads; ///< number of parallel workers
+  std::string& mStdErr; ///< error output
+  std::atomic<unsigned long long> mDirs; ///< directories listed
+  std::atomic<unsigned long long> mFiles; ///< files deleted
+  std::atomic<unsigned long long> mBulk; ///< bulk deletions deleted
+  std::atomic<unsigned long long> mFailed; ///< failed deletions
+  time_t mStart; ///< start of the purge
+  std::atomic<time_t> mLastReport; ///< time of the last progress message
+  std::mutex mMutex; ///< protects mNext and mStdErr
+  std::chrono::steady_clock::time_point mNext; ///< next deletion slot
+  std::mutex mQueueMutex; ///< protects mQueue, mBusy and mStop
+  std::condition_variable mQueueCv; ///< signals queued entries to the workers
+  std::condition_variable mDoneCv; ///< signals deleted entries to the walk
+  std::deque<std::string> mQueue; ///< entries queued for deletion
+  size_t mBusy; ///< entries being deleted
+  bool mStop; ///< workers have to exit once the queue is empty
+  std::vector<std::thread> mWorkers; ///< worker pool of this purge
+};
+
+std::mutex RecyclePurger::sPurgesMutex;
+std::set<RecyclePurger*> RecyclePurger::sPurges;
+
+//------------------------------------------------------------------------------
+// Print the progress of the running purges
+//------------------------------------------------------------------------------
+static void
+PrintRunningPurges(std::ostringstream& out)
+{
+  RecyclePurger::PrintRunning(out);
+}
+
+//------------------------------------------------------------------------------
+// Append the result of a purge to the output
+//------------------------------------------------------------------------------
+static void
+PurgeSummary(std::string& std_out, const RecyclePurger& purger,
+             const char* bin)
+{
   std_out += "success: purged ";
-  std_out += (int) nbulk_deleted;
+  std_out += std::to_string(purger.GetBulk());
   std_out += " bulk deletions and ";
-  std_out += (int) nfiles_deleted;
-  std_out += " individual files from the old recycle bin!\n";
+  std_out += std::to_string(purger.GetFiles());
+  std_out += " individual files from the ";
+  std_out += bin;
+  std_out += "!";
+
+  if (purger.GetFailed()) {
+    std_out += " ";
+    std_out += std::to_string(purger.GetFailed());
+    std_out += " deletions failed!";
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+int
+Recycle::PurgeOld(std::string& std_out, std::string& std_err,
+                  eos::common::Mapping::VirtualIdentity_t& vid)
+{
+  char sdir[4096];
+  snprintf(sdir, sizeof(sdir) - 1, "%s/%u/%u/", Recycle::gRecyclingPrefix.c_str(),
+           (unsigned int) vid.gid, (unsigned int) vid.uid);
+  // only the deletions are done as root, the bin is listed as the caller
+  RecyclePurger purger(sdir, 0, 0, std_err, &vid);
+
+  if (purger.Walk(sdir, 0)) {
+    std_out = "success: nothing has been purged in the old recycle bin!\n";
+    return 0;
+  }
+
+  purger.Flush();
+  PurgeSummary(std_out, purger, "old recycle bin");
+  std_out += "\n";
   return 0;
 }
 
@@ -1289,16 +1701,11 @@ int
 Recycle::Purge(std::string& std_out, std::string& std_err,
                eos::common::Mapping::VirtualIdentity_t& vid,
                std::string date,
-               bool global)
+               bool global,
+               unsigned int rate,
+               unsigned int nthreads)
 {
-  eos::common::Mapping::VirtualIdentity rootvid;
-  eos::common::Mapping::Root(rootvid);
-  XrdMgmOfsDirectory dirl;
   char sdir[4096];
-  XrdOucErrInfo lError;
-  int nfiles_deleted = 0;
-  int nbulk_deleted = 0;
-  std::string rpath;
 
   if (vid.uid && !vid.sudoer &&
       !(eos::common::Mapping::HasUid(3, vid.uid_list)) &&
@@ -1308,6 +1715,9 @@ Recycle::Purge(std::string& std_out, std::string& std_err,
     return EPERM;
   }
 
+  // levels of directories above the entries: uid:<uid>/<year>/<month>/<day>/<index>
+  int depth = 4;
+
   if (!global || (global && vid.uid)) {
     snprintf(sdir, sizeof(sdir) - 1, "%s/uid:%u/%s",
              Recycle::gRecyclingPrefix.c_str(),
@@ -1315,92 +1725,45 @@ Recycle::Purge(std::string& std_out, std::string& std_err,
              date.c_str());
   } else {
     snprintf(sdir, sizeof(sdir) - 1, "%s/", Recycle::gRecyclingPrefix.c_str());
+    depth++;
   }
 
-  std::map<std::string, std::set < std::string>> findmap;
-  int depth = 5 + (int) global;
   eos::common::Path dPath(std::string("/") + date);
+  depth -= std::min(depth, (int) dPath.GetSubPathSize());
+  std::string dir = sdir;
 
-  if (dPath.GetSubPathSize()) {
-    if (depth > (int) dPath.GetSubPathSize()) {
-      depth -= dPath.GetSubPathSize();
-    }
+  if (*dir.rbegin() != '/') {
+    dir += "/";
   }
 
-  XrdOucString err_msg;
-  int retc = gOFS->_find(sdir, lError, err_msg, rootvid, findmap,
-                         0, 0, false, 0, true, depth);
-
-  if (retc && errno != ENOENT) {
-    std_err = err_msg.c_str();
-    eos_static_err("msg=\"find command failed\" dir=\"%s\"", sdir);
+  if (nthreads > gRecyclingPurgeMaxThreads) {
+    std_err += "warning: limiting the purge to ";
+    std_err += std::to_string(gRecyclingPurgeMaxThreads);
+    std_err += " threads\n";
+    nthreads = gRecyclingPurgeMaxThreads;
   }
 
-  for (auto dirit = findmap.begin(); dirit != findmap.end(); ++dirit) {
-    eos_static_debug("dir=%s", dirit->first.c_str());
-    XrdOucString dirname = dirit->first.c_str();
-
-    if (dirname.endswith(".d/")) {
-      dirname.erase(dirname.length() - 1);
-      eos::common::Path cpath(dirname.c_str());
-      dirname = cpath.GetParentPath();
-      dirit->second.insert(cpath.GetName());
-    }
-
-    for (auto fileit = dirit->second.begin(); fileit != dirit->second.end();
-         ++fileit) {
-      XrdOucString fname = fileit->c_str();
-      std::string pathname = dirname.c_str();
-      pathname += *fileit;
-      struct stat buf;
-      XrdOucErrInfo lError;
-
-      if ((fname != "/") && !fname.beginswith("#")) {
-        continue;
-      }
-
-      if (!gOFS->_stat(pathname.c_str(), &buf, lError, rootvid, "")) {
-        // execute a proc command
-        ProcCommand Cmd;
-        XrdOucString info;
-
-        if (S_ISDIR(buf.st_mode)) {
-          // we need recursive deletion
-          info = "mgm.cmd=rm&mgm.option=r&mgm.path=";
-        } else {
-          info = "mgm.cmd=rm&mgm.path=";
-        }
-
-        info += pathname.c_str();
-        int result = Cmd.open("/proc/user", info.c_str(), rootvid, &lError);
-        Cmd.AddOutput(std_out, std_err);
-
-        if (*std_out.rbegin() != '\n') {
-          std_out += "\n";
-        }
-
-        if (*std_err.rbegin() != '\n') {
-          std_err += "\n";
-        }
+  eos_static_info("msg=\"start recycle bin purge\" dir=\"%s\" rate=%u "
+                  "threads=%u", dir.c_str(), rate, nthreads);
+  eos::common::Timing tm("RecyclePurge");
+  COMMONTIMING("start", &tm);
+  RecyclePurger purger(dir, rate, nthreads, std_err);
+  int retc = purger.Walk(dir, depth);
 
-        Cmd.close();
-
-        if (!result) {
-          if (S_ISDIR(buf.st_mode)) {
-            nbulk_deleted++;
-          } else {
-            nfiles_deleted++;
-          }
-        }
-      }
-    }
+  if (retc && (errno != ENOENT)) {
+    std_err += "error: unable to list ";
+    std_err += dir;
+    std_err += "\n";
+    eos_static_err("msg=\"unable to list recycle bin\" dir=\"%s\"", dir.c_str());
   }
 
-  std_out += "success: purged ";
-  std_out += (int) nbulk_deleted;
-  std_out += " bulk deletions and ";
-  std_out += (int) nfiles_deleted;
-  std_out += " individual files from the recycle bin!";
+  purger.Flush();
+  COMMONTIMING("stop", &tm);
+  eos_static_info("msg=\"finished recycle bin purge\" dir=\"%s\" bulk=%llu "
+                  "files=%llu failed=%llu time=%.03f", dir.c_str(),
+                  purger.GetBulk(), purger.GetFiles(), purger.GetFailed(),
+                  tm.RealTime() / 1000.0);
+  PurgeSummary(std_out, purger, "recycle bin");
   return 0;
 }
 
@@ -25,9 +25,11 @@
 #define __EOSMGM_RECYCLE__HH__
 
 #include "mgm/Namespace.hh"
+#include "mgm/ExpiryIndex.hh"
 #include "common/AssistedThread.hh"
 #include "XrdOuc/XrdOucString.hh"
 #include <sys/types.h>
+#include <atomic>
 
 class XrdOucErrInfo;
 
@@ -185,16 +187,40 @@ public:
 
   /**
    * purge all files in the recycle bin with new uid:<uid>/<date> structure
+   *
+   * The bin is walked one directory at a time and the entries are deleted by
+   * a pool of parallel workers through a bounded queue.
+   *
    * @param std_out where to print
    * @param std_err where to print
    * @param vid of the client
    * @PARAM date can be empty, <year> or <year>/<month> or <year>/<month>/<day>
+   * @param global purge the bins of all users
+   * @param rate max. number of deletions per second, 0 for no limit
+   * @param nthreads number of parallel workers, 0 for the default, at most
+   *        gRecyclingPurgeMaxThreads
    * @return 0 if done, otherwise errno
    */
   static int Purge(std::string& std_out, std::string& std_err,
                    eos::common::Mapping::VirtualIdentity_t& vid,
                    std::string date = "",
-                   bool global = false);
+                   bool global = false,
+                   unsigned int rate = 0,
+                   unsigned int nthreads = 0);
+
+  /**
+   * totals of the purge operations since the MGM start, the progress of each
+   * running purge is printed by 'recycle ls'
+   */
+  struct PurgeProgress {
+    std::atomic<int> running; //< number of running purges
+    std::atomic<unsigned long long> dirs; //< bin directories listed
+    std::atomic<unsigned long long> files; //< individual files purged
+    std::atomic<unsigned long long> bulk; //< bulk deletions purged
+    std::atomic<unsigned long long> failed; //< failed deletions
+
+    PurgeProgress() : running(0), dirs(0), files(0), bulk(0), failed(0) { }
+  };
 
   /**
    * configure the recycle bin
@@ -231,6 +257,16 @@ public:
   static std::string
   gRecyclingVersionKey; //<  attribute key storing the recycling key of the version directory belonging to a given file
   static int gRecyclingPollTime; //< poll interval inside the garbage bin
+  static int gRecyclingRescanTime; //< interval of the full scans of the bin
+  static int gRecyclingRetryTime; //< delay before retrying a failed purge
+  static unsigned int
+  gRecyclingPurgeThreads; //< default number of parallel workers of a purge
+  static unsigned int
+  gRecyclingPurgeMaxThreads; //< max. number of parallel workers of a purge
+  static size_t gRecyclingPurgeBatch; //< max. number of entries queued by a purge
+  static PurgeProgress gPurgeProgress; //< progress of the purge operations
+  static ExpiryIndex
+  gRecyclingIndex; //< recycle bin entries ordered by the time they were recycled
 };
 
 EOSMGMNAMESPACE_END
@@ -111,7 +111,7 @@ VstMessaging::Listen(ThreadAssistant& assistant) noexcept
     if (newmessage) {
       Process(newmessage);
       delete newmessage;
-    } else {
+    } else if (!mMessageClient.IsPushActive()) {
       assistant.wait_for(std::chrono::seconds(1));
     }
 
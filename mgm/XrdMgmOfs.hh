@@ -1781,6 +1781,19 @@ private:
             eos::common::Mapping::VirtualIdentity& vid,
             const XrdSecEntity* client);
 
+  //----------------------------------------------------------------------------
+  //! Fuse extension handling a batch of md records in one request.
+  //! Will redirect to the RW master.
+  //----------------------------------------------------------------------------
+  int FusexBatch(const char* path,
+                 const char* ininfo,
+                 std::string protobuf,
+                 XrdOucEnv& env,
+                 XrdOucErrInfo& error,
+                 eos::common::LogId& ThreadLogId,
+                 eos::common::Mapping::VirtualIdentity& vid,
+                 const XrdSecEntity* client);
+
   //----------------------------------------------------------------------------
   //! Return metadata in env representation
   //----------------------------------------------------------------------------
@@ -202,6 +202,11 @@ XrdMgmOfs::_attr_set(const char* path, XrdOucErrInfo& error,
 
       gOFS->FuseXCastContainer(d_id);
       gOFS->FuseXCastRefresh(d_id, d_pid);
+
+      if (Key.beginswith("sys.lru.")) {
+        gOFS->LRUd.PolicyChanged(d_id.getUnderlyingUInt64(), true);
+      }
+
       errno = 0;
     }
   } catch (eos::MDException& e) {
@@ -518,6 +523,10 @@ XrdMgmOfs::_attr_rem(const char* path, XrdOucErrInfo& error,
           lock.Release();
           gOFS->FuseXCastContainer(d_id);
           gOFS->FuseXCastRefresh(d_id, d_pid);
+
+          if (Key.beginswith("sys.lru.")) {
+            gOFS->LRUd.PolicyChanged(d_id.getUnderlyingUInt64(), true);
+          }
         } else {
           errno = ENODATA;
         }
@@ -151,6 +151,7 @@ XrdMgmOfs::FSctl(const int cmd,
   }
 
   bool fusexset = false;
+  bool fusexbatch = false;
 
   // check if this is a protocol buffer injection
   if ((cmd == SFS_FSCTL_PLUGIN) && (args.Arg2Len > 5)) {
@@ -159,6 +160,10 @@ XrdMgmOfs::FSctl(const int cmd,
 
     if (key == "fusex:") {
       fusexset = true;
+    } else if ((key == "fusexb") && (args.Arg2Len > 6) && (args.Arg2[6] == ':')) {
+      // batch of md records
+      fusexset = true;
+      fusexbatch = true;
     }
   }
 
@@ -258,6 +263,13 @@ XrdMgmOfs::FSctl(const int cmd,
     }
 
     std::string protobuf;
+
+    if (fusexbatch) {
+      protobuf.assign(args.Arg2 + 7, args.Arg2Len - 7);
+      return XrdMgmOfs::FusexBatch(path, ininfo, protobuf, env, error,
+                                   ThreadLogId, vid, client);
+    }
+
     protobuf.assign(args.Arg2 + 6, args.Arg2Len - 6);
     return XrdMgmOfs::Fusex(path, ininfo, protobuf, env, error, ThreadLogId,
                             vid, client);
@@ -359,10 +359,15 @@ XrdMgmOfs::_mkdir(const char* path,
           eos::ContainerIdentifier nd_id = newdir->getIdentifier();
           eos::ContainerIdentifier d_id = dir->getIdentifier();
           eos::ContainerIdentifier d_pid = dir->getParentIdentifier();
+          bool lru_policy = eos::mgm::LRU::HasPolicy(xattrs);
           lock.Release();
           gOFS->FuseXCastContainer(nd_id);
           gOFS->FuseXCastContainer(d_id);
           gOFS->FuseXCastRefresh(d_id, d_pid);
+
+          if (lru_policy) {
+            gOFS->LRUd.PolicyChanged(nd_id.getUnderlyingUInt64(), false);
+          }
         } catch (eos::MDException& e) {
           errno = e.getErrno();
           eos_debug("msg=\"exception\" ec=%d emsg=\"%s\"\n",
@@ -425,10 +430,15 @@ XrdMgmOfs::_mkdir(const char* path,
     eos::ContainerIdentifier nd_id = newdir->getIdentifier();
     eos::ContainerIdentifier d_id = dir->getIdentifier();
     eos::ContainerIdentifier d_pid = dir->getParentIdentifier();
+    bool lru_policy = eos::mgm::LRU::HasPolicy(newdir->getAttributes());
     lock.Release();
     gOFS->FuseXCastContainer(nd_id);
     gOFS->FuseXCastContainer(d_id);
     gOFS->FuseXCastRefresh(d_id, d_pid);
+
+    if (lru_policy) {
+      gOFS->LRUd.PolicyChanged(nd_id.getUnderlyingUInt64(), false);
+    }
   } catch (eos::MDException& e) {
     errno = e.getErrno();
     eos_debug("msg=\"exception\" ec=%d emsg=\"%s\"",
@@ -103,6 +103,14 @@ XrdMgmOfs::_touch(const char* path,
       } catch (const eos::MDException& eq) {
         // no quota node
       }
+
+      eos::IContainerMD::XAttrMap attrmap = cmd->getAttributes();
+
+      if (eos::mgm::LRU::HasPolicy(attrmap)) {
+        // register the file for expiration
+        gOFS->LRUd.FileCreated(fmd->getId(), cid, fmd->getName(), time(NULL),
+                               attrmap);
+      }
     }
 
     gOFS->eosView->updateContainerStore(cmd.get());
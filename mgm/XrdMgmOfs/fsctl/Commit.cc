@@ -29,6 +29,7 @@
 #include "mgm/XrdMgmOfs.hh"
 #include "mgm/Macros.hh"
 #include "mgm/TapeAwareGc.hh"
+#include "mgm/http/s3/S3Store.hh"
 #include "mgm/XrdMgmOfs/fsctl/CommitHelper.hh"
 
 #include <XrdOuc/XrdOucEnv.hh>
@@ -175,6 +176,25 @@ XrdMgmOfs::Commit(const char* path,
                     "commit filesize change - file is already removed [EIDRM]", "");
       }
 
+      // The part write is over, the completion of its upload does not have
+      // to wait for it anymore
+      if (cgi["s3part"].length()) {
+        eos::mgm::S3Store::PartCommitted(fid, atoi(cgi["s3part"].c_str()));
+      }
+
+      // A part arriving after the multipart upload was completed or aborted
+      // must not touch the size or the ETag of the object. This is no
+      // deletion errno, the replica carries the data of the completed object.
+      if (cgi["s3part"].length() && !fmd->hasAttribute("sys.s3.upload")) {
+        eos_thread_err("msg=\"rejecting part commit, no multipart upload in "
+                       "progress\" fid=%llu part=%s", fmd->getId(),
+                       cgi["s3part"].c_str());
+        gOFS->MgmStats.Add("CommitFailedS3Part", 0, 0, 1);
+        return Emsg(epname, error, EINVAL,
+                    "commit s3 part - no multipart upload in progress [EINVAL]",
+                    cgi["path"].c_str());
+      }
+
       // Check if commit comes from a replication procedure
       // and if the size/checksum is ok
       if (option["replication"]) {
@@ -193,8 +213,12 @@ XrdMgmOfs::Commit(const char* path,
                       "- suppressing recovery replica", "");
         }
 
-        if (eos::common::LayoutId::GetLayoutType(lid) ==
-            eos::common::LayoutId::kReplica) {
+        // The replicas of a multipart upload in progress grow out of order,
+        // they are checked against the parts when the upload is completed.
+        // Multipart uploads are refused in buckets with a RAIN layout.
+        if ((eos::common::LayoutId::GetLayoutType(lid) ==
+             eos::common::LayoutId::kReplica) &&
+            !fmd->hasAttribute("sys.s3.upload")) {
           // We check filesize and the checksum only for replica layouts
           eos_thread_debug("fmd_size=%llu, size=%lli", fmd->getSize(), size);
 
@@ -239,6 +263,9 @@ XrdMgmOfs::Commit(const char* path,
       // Set checksum if concerned
       CommitHelper::handle_checksum(vid, ThreadLogId, fmd, option, checksumbuffer);
 
+      // Record the part of an S3 multipart upload
+      CommitHelper::handle_s3part(vid, ThreadLogId, fmd, cgi, option);
+
       fmdname = fmd->getName();
       paths["atomic"].Init(fmdname.c_str());
       paths["atomic"].DecodeAtomicPath(option["versioning"]);
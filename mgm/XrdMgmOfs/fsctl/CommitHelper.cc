@@ -172,6 +172,14 @@ CommitHelper::grab_cgi(XrdOucEnv& env, CommitHelper::cgi_t& cgi)
   if (env.Get("mgm.checksum")) {
     cgi["checksum"] = env.Get("mgm.checksum");
   }
+
+  if (env.Get("mgm.s3.part")) {
+    cgi["s3part"] = env.Get("mgm.s3.part");
+    cgi["s3offset"] = env.Get("mgm.s3.offset") ? env.Get("mgm.s3.offset") : "";
+    cgi["s3size"] = env.Get("mgm.s3.size") ? env.Get("mgm.s3.size") : "";
+    cgi["s3md5"] = env.Get("mgm.s3.md5") ? env.Get("mgm.s3.md5") : "";
+    cgi["s3adler"] = env.Get("mgm.s3.adler") ? env.Get("mgm.s3.adler") : "";
+  }
 }
 
 //------------------------------------------------------------------------------
@@ -563,6 +571,30 @@ CommitHelper::handle_checksum(eos::common::Mapping::VirtualIdentity_t& vid,
   }
 }
 
+//------------------------------------------------------------------------------
+// record a part of an S3 multipart upload
+//------------------------------------------------------------------------------
+
+void
+CommitHelper::handle_s3part(eos::common::Mapping::VirtualIdentity_t& vid,
+                            eos::common::LogId& ThreadLogId,
+                            std::shared_ptr<eos::IFileMD>fmd,
+                            CommitHelper::cgi_t& cgi,
+                            CommitHelper::option_t& option)
+{
+  if (!option["commitsize"] || !cgi["s3part"].length() ||
+      !fmd->hasAttribute("sys.s3.upload")) {
+    return;
+  }
+
+  // the part list is verified and combined by CompleteMultipartUpload
+  std::string part = cgi["s3offset"] + " " + cgi["s3size"] + " " +
+                     cgi["s3md5"] + " " + cgi["s3adler"];
+  eos_thread_info("msg=\"s3 part committed\" fid=%llu part=%s info=\"%s\"",
+                  fmd->getId(), cgi["s3part"].c_str(), part.c_str());
+  fmd->setAttribute("sys.s3.part." + cgi["s3part"], part);
+}
+
 //------------------------------------------------------------------------------
 // commit new file meta data
 //------------------------------------------------------------------------------
@@ -585,6 +617,11 @@ CommitHelper::commit_fmd(eos::common::Mapping::VirtualIdentity_t& vid,
       fmd->removeAttribute(tmpEtag);
     }
 
+    // the ETag of an S3 multipart upload does not describe rewritten contents
+    if (fmd->hasAttribute("sys.s3.etag") && option["commitsize"]) {
+      fmd->removeAttribute("sys.s3.etag");
+    }
+
     gOFS->eosView->updateFileStore(fmd.get());
     cmd = gOFS->eosDirectoryService->getContainerMD(cid);
 
@@ -118,6 +118,12 @@ public:
                               CommitHelper::option_t& option,
                               eos::Buffer& checksumbuffer);
 
+  static void handle_s3part(eos::common::Mapping::VirtualIdentity_t& vid,
+                            eos::common::LogId& ThreadLogId,
+                            std::shared_ptr<eos::IFileMD>fmd,
+                            CommitHelper::cgi_t& cgi,
+                            CommitHelper::option_t& option);
+
   static bool commit_fmd(eos::common::Mapping::VirtualIdentity_t& vid,
                          eos::common::LogId& ThreadLogId,
                          unsigned long cid,
@@ -22,6 +22,7 @@
  ************************************************************************/
 
 #include "common/Logging.hh"
+#include "common/StringConversion.hh"
 #include "namespace/interface/IView.hh"
 #include "namespace/interface/IQuota.hh"
 #include "namespace/interface/IFileMD.hh"
@@ -54,101 +55,118 @@ XrdMgmOfs::Drop(const char* path,
   EXEC_TIMING_BEGIN("Drop");
   int envlen;
   eos_thread_info("drop request for %s", env.Env(envlen));
-  char* afid = env.Get("mgm.fid");
+  char* single_fid = env.Get("mgm.fid");
+  // Deletions done by the FSTs are reported as comma separated lists
+  char* fid_list = env.Get("mgm.fids");
   char* afsid = env.Get("mgm.fsid");
+  std::vector<std::string> fids;
 
-  if (afid && afsid) {
-    unsigned long fsid = strtoul(afsid, 0, 10);
-    std::shared_ptr<eos::IContainerMD> container;
-    std::shared_ptr<eos::IFileMD> fmd;
-    eos::IQuotaNode* ns_quota = nullptr;
-    eos::common::RWMutexWriteLock wlock(gOFS->eosViewRWMutex);
-
-    try {
-      fmd = eosFileService->getFileMD(eos::common::FileId::Hex2Fid(afid));
-    } catch (...) {
-      eos_thread_warning("no meta record exists anymore for fid=%s", afid);
+  if (afsid) {
+    if (fid_list) {
+      eos::common::StringConversion::Tokenize(fid_list, fids, ",");
+    } else if (single_fid) {
+      fids.push_back(single_fid);
     }
+  }
 
-    if (fmd) {
-      try {
-        container =
-          gOFS->eosDirectoryService->getContainerMD(fmd->getContainerId());
-      } catch (eos::MDException& e) {}
+  if (!fids.empty()) {
+    unsigned long fsid = strtoul(afsid, 0, 10);
 
-      if (container) {
-        try {
-          ns_quota = gOFS->eosView->getQuotaNode(container.get());
-        } catch (eos::MDException& e) {
-          ns_quota = nullptr;
-        }
-      }
+    for (const auto& sfid : fids) {
+      const char* afid = sfid.c_str();
+      std::shared_ptr<eos::IContainerMD> container;
+      std::shared_ptr<eos::IFileMD> fmd;
+      eos::IQuotaNode* ns_quota = nullptr;
+      eos::common::RWMutexWriteLock wlock(gOFS->eosViewRWMutex);
 
       try {
-        std::vector<unsigned int> drop_fsid;
-        bool updatestore = false;
-        // If mgm.dropall flag is set then it means we got a deleteOnClose
-        // at the gateway node and we need to delete all replicas
-        char* drop_all = env.Get("mgm.dropall");
-
-        if (drop_all) {
-          for (unsigned int i = 0; i < fmd->getNumLocation(); i++) {
-            drop_fsid.push_back(fmd->getLocation(i));
-          }
-        } else {
-          drop_fsid.push_back(fsid);
-        }
-
-        // Drop the selected replicas
-        for (const auto& id : drop_fsid) {
-          eos_thread_debug("removing location %u of fid=%s", id, afid);
-          updatestore = false;
-
-          if (fmd->hasLocation(id)) {
-            fmd->unlinkLocation(id);
-            updatestore = true;
-          }
+        fmd = eosFileService->getFileMD(eos::common::FileId::Hex2Fid(afid));
+      } catch (...) {
+        eos_thread_warning("no meta record exists anymore for fid=%s", afid);
+      }
 
-          if (fmd->hasUnlinkedLocation(id)) {
-            fmd->removeLocation(id);
-            updatestore = true;
+      if (fmd) {
+        try {
+          container =
+            gOFS->eosDirectoryService->getContainerMD(fmd->getContainerId());
+        } catch (eos::MDException& e) {}
+
+        if (container) {
+          try {
+            ns_quota = gOFS->eosView->getQuotaNode(container.get());
+          } catch (eos::MDException& e) {
+            ns_quota = nullptr;
           }
+        }
 
-          if (updatestore) {
-            gOFS->eosView->updateFileStore(fmd.get());
-            // After update we might have to get the new address
-            fmd = eosFileService->getFileMD(eos::common::FileId::Hex2Fid(afid));
+        try {
+          std::vector<unsigned int> drop_fsid;
+          bool updatestore = false;
+          // If mgm.dropall flag is set then it means we got a deleteOnClose
+          // at the gateway node and we need to delete all replicas
+          char* drop_all = env.Get("mgm.dropall");
+
+          if (drop_all) {
+            for (unsigned int i = 0; i < fmd->getNumLocation(); i++) {
+              drop_fsid.push_back(fmd->getLocation(i));
+            }
+          } else {
+            drop_fsid.push_back(fsid);
           }
-        }
 
-        // Delete the record only if all replicas are dropped
-        if ((!fmd->getNumUnlinkedLocation()) && (!fmd->getNumLocation())
-            && (drop_all || updatestore)) {
-          // However we should only remove the file from the namespace, if
-          // there was indeed a replica to be dropped, otherwise we get
-          // unlinked files if the secondary replica fails to write but
-          // the machine can call the MGM
-          if (ns_quota) {
-            // If we were still attached to a container, we can now detach
-            // and count the file as removed
-            ns_quota->removeFile(fmd.get());
+          // Drop the selected replicas
+          for (const auto& id : drop_fsid) {
+            eos_thread_debug("removing location %u of fid=%s", id, afid);
+            updatestore = false;
+
+            if (fmd->hasLocation(id)) {
+              fmd->unlinkLocation(id);
+              updatestore = true;
+            }
+
+            if (fmd->hasUnlinkedLocation(id)) {
+              fmd->removeLocation(id);
+              updatestore = true;
+            }
+
+            if (updatestore) {
+              gOFS->eosView->updateFileStore(fmd.get());
+              // After update we might have to get the new address
+              fmd = eosFileService->getFileMD(eos::common::FileId::Hex2Fid(afid));
+            }
           }
 
-          gOFS->eosView->removeFile(fmd.get());
-
-          if (container) {
-            container->setMTimeNow();
-            gOFS->eosView->updateContainerStore(container.get());
-            container->notifyMTimeChange(gOFS->eosDirectoryService);
-            eos::ContainerIdentifier container_id = container->getIdentifier();
-            eos::ContainerIdentifier container_pid = container->getParentIdentifier();
-            wlock.Release();
-            gOFS->FuseXCastContainer(container_id);
-            gOFS->FuseXCastRefresh(container_id, container_pid);
+          // Delete the record only if all replicas are dropped
+          if ((!fmd->getNumUnlinkedLocation()) && (!fmd->getNumLocation())
+              && (drop_all || updatestore)) {
+            // However we should only remove the file from the namespace, if
+            // there was indeed a replica to be dropped, otherwise we get
+            // unlinked files if the secondary replica fails to write but
+            // the machine can call the MGM
+            if (ns_quota) {
+              // If we were still attached to a container, we can now detach
+              // and count the file as removed
+              ns_quota->removeFile(fmd.get());
+            }
+
+            gOFS->eosView->removeFile(fmd.get());
+
+            if (container) {
+              container->setMTimeNow();
+              gOFS->eosView->updateContainerStore(container.get());
+              container->notifyMTimeChange(gOFS->eosDirectoryService);
+              eos::ContainerIdentifier container_id =
+                container->getIdentifier();
+              eos::ContainerIdentifier container_pid =
+                container->getParentIdentifier();
+              wlock.Release();
+              gOFS->FuseXCastContainer(container_id);
+              gOFS->FuseXCastRefresh(container_id, container_pid);
+            }
           }
+        } catch (...) {
+          eos_thread_warning("no meta record exists anymore for fid=%s", afid);
         }
-      } catch (...) {
-        eos_thread_warning("no meta record exists anymore for fid=%s", afid);
       }
     }
   } else {
@@ -158,7 +176,7 @@ XrdMgmOfs::Drop(const char* path,
                 "missing meta information");
   }
 
-  gOFS->MgmStats.Add("Drop", vid.uid, vid.gid, 1);
+  gOFS->MgmStats.Add("Drop", vid.uid, vid.gid, fids.size());
   const char* ok = "OK";
   error.setErrInfo(strlen(ok) + 1, ok);
   EXEC_TIMING_END("Drop");
@@ -85,3 +85,54 @@ XrdMgmOfs::Fusex(const char* path,
   EXEC_TIMING_END("Eosxd::ext::0-HANDLE");
   return SFS_DATA;
 }
+
+//----------------------------------------------------------------------------
+// Fuse extension handling a batch of md records in one request.
+// Will redirect to the RW master.
+//----------------------------------------------------------------------------
+int
+XrdMgmOfs::FusexBatch(const char* path,
+                      const char* ininfo,
+                      std::string protobuf,
+                      XrdOucEnv& env,
+                      XrdOucErrInfo& error,
+                      eos::common::LogId& ThreadLogId,
+                      eos::common::Mapping::VirtualIdentity& vid,
+                      const XrdSecEntity* client)
+{
+  static const char* epname = "FusexBatch";
+
+  ACCESSMODE_W;
+  MAYSTALL;
+  MAYREDIRECT;
+
+  EXEC_TIMING_BEGIN("Eosxd::ext::0-HANDLE-BATCH");
+
+  gOFS->MgmStats.Add("Eosxd::ext::0-HANDLE-BATCH", vid.uid, vid.gid, 1);
+
+  eos_static_debug("protobuf-len=%d", protobuf.length());
+
+  eos::fusex::md_batch batch;
+  if (!batch.ParseFromString(protobuf)) {
+    return Emsg(epname, error, EINVAL, "parse protocol buffer [EINVAL]", "");
+  }
+
+  std::string resultstream;
+  std::string id = std::string("Fusex::sync:") + vid.tident.c_str();
+
+  int rc = gOFS->zMQ->gFuseServer.HandleMDBatch(id, batch, vid, &resultstream);
+
+  if (rc) {
+    return Emsg(epname, error, rc, "handle request", "");
+  }
+
+  std::string b64response;
+  eos::common::SymKey::Base64(resultstream, b64response);
+
+  XrdOucString response = "Fusex:";
+  response += b64response.c_str();
+
+  error.setErrInfo(response.length(), response.c_str());
+  EXEC_TIMING_END("Eosxd::ext::0-HANDLE-BATCH");
+  return SFS_DATA;
+}
@@ -1965,6 +1965,7 @@ XrdMgmOfs::InitStats()
   MgmStats.Add("CommitFailedFid", 0, 0, 0);
   MgmStats.Add("CommitFailedNamespace", 0, 0, 0);
   MgmStats.Add("CommitFailedParameters", 0, 0, 0);
+  MgmStats.Add("CommitFailedS3Part", 0, 0, 0);
   MgmStats.Add("CommitFailedUnlinked", 0, 0, 0);
   MgmStats.Add("ConversionDone", 0, 0, 0);
   MgmStats.Add("ConversionFailed", 0, 0, 0);
@@ -1975,6 +1976,8 @@ XrdMgmOfs::InitStats()
   MgmStats.Add("Exists", 0, 0, 0);
   MgmStats.Add("Exists", 0, 0, 0);
   MgmStats.Add("Eosxd::ext::0-HANDLE", 0, 0, 0);
+  MgmStats.Add("Eosxd::ext::0-HANDLE-BATCH", 0, 0, 0);
+  MgmStats.Add("Eosxd::ext::BATCHED", 0, 0, 0);
   MgmStats.Add("Eosxd::ext::0-STREAM", 0, 0, 0);
   MgmStats.Add("Eosxd::ext::GET", 0, 0, 0);
   MgmStats.Add("Eosxd::ext::SET", 0, 0, 0);
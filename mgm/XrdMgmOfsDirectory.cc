@@ -62,7 +62,7 @@
 // Constructor
 //------------------------------------------------------------------------------
 XrdMgmOfsDirectory::XrdMgmOfsDirectory(char* user, int MonID):
-  XrdSfsDirectory(user, MonID)
+  XrdSfsDirectory(user, MonID), mListingBatch(0)
 {
   dirName = "";
   dh.reset();
@@ -71,6 +71,11 @@ XrdMgmOfsDirectory::XrdMgmOfsDirectory(char* user, int MonID):
   eos::common::LogId();
 }
 
+//------------------------------------------------------------------------------
+// Destructor
+//------------------------------------------------------------------------------
+XrdMgmOfsDirectory::~XrdMgmOfsDirectory() {}
+
 /*----------------------------------------------------------------------------*/
 int
 XrdMgmOfsDirectory::open(const char* inpath,
@@ -206,14 +211,19 @@ XrdMgmOfsDirectory::_open(const char* dir_path,
       gOFS->MgmStats.Add("OpenDir-Entry", vid.uid, vid.gid,
                          dh->getNumContainers() + dh->getNumFiles());
 
-      // Collect all file names
-      for (auto it = eos::FileMapIterator(dh); it.valid(); it.next()) {
-        dh_list.insert(it.key());
-      }
+      if (mListingBatch) {
+        // The entries are read by nextEntry
+        mCursor.reset(new eos::ContainerListingCursor(dh));
+      } else {
+        // Collect all file names
+        for (auto it = eos::FileMapIterator(dh); it.valid(); it.next()) {
+          dh_list.insert(it.key());
+        }
 
-      // Collect all subcontainers
-      for (auto it = eos::ContainerMapIterator(dh); it.valid(); it.next()) {
-        dh_list.insert(it.key());
+        // Collect all subcontainers
+        for (auto it = eos::ContainerMapIterator(dh); it.valid(); it.next()) {
+          dh_list.insert(it.key());
+        }
       }
 
       dh_list.insert(".");
@@ -274,6 +284,24 @@ XrdMgmOfsDirectory::nextEntry()
  */
 /*----------------------------------------------------------------------------*/
 {
+  if ((dh_it == dh_list.end()) && mCursor) {
+    // read the next batch of a batched listing
+    std::vector<std::string> names;
+    bool more;
+    {
+      eos::common::RWMutexReadLock lock(gOFS->eosViewRWMutex);
+      more = mCursor->next(names, mListingBatch);
+    }
+
+    if (!more) {
+      mCursor.reset();
+    }
+
+    dh_list.clear();
+    dh_list.insert(names.begin(), names.end());
+    dh_it = dh_list.begin();
+  }
+
   if (dh_it == dh_list.end()) {
     // no more entry
     return (const char*) 0;
@@ -297,6 +325,7 @@ XrdMgmOfsDirectory::close()
 {
   //  static const char *epname = "closedir";
   dh_list.clear();
+  mCursor.reset();
   return SFS_OK;
 }
 
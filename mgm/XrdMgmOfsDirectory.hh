@@ -42,6 +42,7 @@
 #include "XrdSfs/XrdSfsInterface.hh"
 /*----------------------------------------------------------------------------*/
 #include <dirent.h>
+#include <memory>
 #include <string>
 #include <set>
 /*----------------------------------------------------------------------------*/
@@ -50,6 +51,7 @@
 namespace eos
 {
 class IContainerMD;
+class ContainerListingCursor;
 };
 
 /*----------------------------------------------------------------------------*/
@@ -85,6 +87,17 @@ public:
   // ---------------------------------------------------------------------------
   const char *nextEntry ();
 
+  // ---------------------------------------------------------------------------
+  //! Read the entries in batches of the given size while they are returned
+  //! instead of collecting all of them at open, has to be called before open.
+  //! An entry returned by nextEntry is then only valid until the next call.
+  // ---------------------------------------------------------------------------
+  void
+  SetListingBatch (size_t batch)
+  {
+    mListingBatch = batch;
+  }
+
   //----------------------------------------------------------------------------
   //! Create an error message
   //!
@@ -128,7 +141,7 @@ public:
   // ---------------------------------------------------------------------------
   //! Destructor
   // ---------------------------------------------------------------------------
-  ~XrdMgmOfsDirectory () {};
+  ~XrdMgmOfsDirectory ();
 
 private:
 
@@ -145,6 +158,8 @@ private:
   std::shared_ptr<eos::IContainerMD> dh;
   std::set<std::string> dh_list;
   std::set<std::string>::const_iterator dh_it;
+  size_t mListingBatch; ///< batch size of a batched listing, 0 if disabled
+  std::unique_ptr<eos::ContainerListingCursor> mCursor; ///< batched listing
 };
 
 
@@ -44,6 +44,7 @@
 #include "mgm/Macros.hh"
 #include "mgm/ZMQ.hh"
 #include "mgm/Master.hh"
+#include "mgm/LRU.hh"
 #include "namespace/Prefetcher.hh"
 #include "namespace/Resolver.hh"
 #include "authz/XrdCapability.hh"
@@ -894,6 +895,14 @@ XrdMgmOfsFile::open(const char* inpath,
         }
 
         isCreation = true;
+
+        if (eos::mgm::LRU::HasPolicy(attrmap)) {
+          // register the file for expiration
+          eos::common::Path cPath(path);
+          gOFS->LRUd.FileCreated(fileId, cid, cPath.GetName(), time(NULL),
+                                 attrmap);
+        }
+
         // -------------------------------------------------------------------------
       }
     } else {
@@ -163,9 +163,23 @@ HttpServer::Handler(void* cls,
   eos_static_debug("\n\n%s", response->ToString().c_str());
   // Create the response
   struct MHD_Response* mhdResponse;
-  mhdResponse = MHD_create_response_from_buffer(response->GetBodySize(), (void*)
-                response->GetBody().c_str(),
-                MHD_RESPMEM_MUST_COPY);
+  bool streamed = response->mUseFileReaderCallback;
+
+  if (streamed) {
+    // The body is produced while it is sent, the protocol handler is deleted
+    // by the free callback once the response is done
+    mhdResponse = MHD_create_response_from_callback(
+                    (response->mResponseLength < 0) ? MHD_SIZE_UNKNOWN :
+                    response->mResponseLength,
+                    64 * 1024, /* 64k page size */
+                    &HttpServer::BodyReaderCallback,
+                    (void*) protocolHandler,
+                    &HttpServer::BodyFreeCallback);
+  } else {
+    mhdResponse = MHD_create_response_from_buffer(response->GetBodySize(), (void*)
+                  response->GetBody().c_str(),
+                  MHD_RESPMEM_MUST_COPY);
+  }
 
   if (mhdResponse) {
     // Add all the response header tags
@@ -180,7 +194,11 @@ HttpServer::Handler(void* cls,
                                  mhdResponse);
     eos_static_debug("msg=\"MHD_queue_response\" retc=%d", ret);
     MHD_destroy_response(mhdResponse);
-    delete protocolHandler;
+
+    if (!streamed) {
+      delete protocolHandler;
+    }
+
     *ptr = 0;
     return ret;
   } else {
@@ -191,6 +209,40 @@ HttpServer::Handler(void* cls,
   }
 }
 
+/*----------------------------------------------------------------------------*/
+ssize_t
+HttpServer::BodyReaderCallback(void* cls, uint64_t pos, char* buf, size_t max)
+{
+  eos::common::ProtocolHandler* handler =
+    static_cast<eos::common::ProtocolHandler*>(cls);
+  eos::common::HttpResponse* response = handler->GetResponse();
+
+  if (!response) {
+    return MHD_CONTENT_READER_END_WITH_ERROR;
+  }
+
+  ssize_t nread = response->ReadBody(pos, buf, max);
+
+  if (nread == -1) {
+    return MHD_CONTENT_READER_END_OF_STREAM;
+  }
+
+  if (nread < 0) {
+    eos_static_err("msg=\"failed to produce the response body\" pos=%llu",
+                   (unsigned long long) pos);
+    return MHD_CONTENT_READER_END_WITH_ERROR;
+  }
+
+  return nread;
+}
+
+/*----------------------------------------------------------------------------*/
+void
+HttpServer::BodyFreeCallback(void* cls)
+{
+  delete static_cast<eos::common::ProtocolHandler*>(cls);
+}
+
 #endif
 
 /*----------------------------------------------------------------------------*/
@@ -80,6 +80,28 @@ public:
                   void**                             con_cls,
                   enum MHD_RequestTerminationCode    toe);
 
+  /**
+   * Produce the next part of a streamed response body
+   *
+   * @param cls  the protocol handler owning the response
+   * @param pos  the position of the part in the body
+   * @param buf  the buffer to fill
+   * @param max  the size of the buffer
+   *
+   * @return the number of bytes written to buf or one of the
+   *         MHD_CONTENT_READER_END_* codes
+   */
+  static ssize_t
+  BodyReaderCallback(void* cls, uint64_t pos, char* buf, size_t max);
+
+  /**
+   * Delete the protocol handler of a streamed response once it is done
+   *
+   * @param cls  the protocol handler owning the response
+   */
+  static void
+  BodyFreeCallback(void* cls);
+
 
 
 #endif
@@ -130,6 +130,10 @@ S3Handler::HandleRequest(eos::common::HttpRequest* request)
       response = Head(request);
       break;
 
+    case POST:
+      response = Post(request);
+      break;
+
     case PUT:
       response = Put(request);
       break;
@@ -249,13 +253,41 @@ S3Handler::Head(eos::common::HttpRequest* request)
   return response;
 }
 
+/*----------------------------------------------------------------------------*/
+eos::common::HttpResponse*
+S3Handler::Post(eos::common::HttpRequest* request)
+{
+  eos::common::HttpResponse* response = 0;
+
+  if (mSubResourceMap.count("uploads")) {
+    response = mS3Store->CreateMultipartUpload(request, GetId(), GetBucket(),
+               GetPath());
+  } else if (mSubResourceMap.count("uploadId")) {
+    response = mS3Store->CompleteMultipartUpload(request, GetId(), GetBucket(),
+               GetPath(), mSubResourceMap["uploadId"]);
+  } else {
+    response = new eos::common::PlainHttpResponse();
+    response->SetResponseCode(eos::common::HttpResponse::NOT_IMPLEMENTED);
+  }
+
+  return response;
+}
+
 /*----------------------------------------------------------------------------*/
 eos::common::HttpResponse*
 S3Handler::Put(eos::common::HttpRequest* request)
 {
   eos::common::HttpResponse* response = 0;
-  response = mS3Store->PutObject(request, GetId(), GetBucket(), GetPath(),
-                                 GetQuery());
+
+  if (mSubResourceMap.count("partNumber") && mSubResourceMap.count("uploadId")) {
+    response = mS3Store->UploadPart(request, GetId(), GetBucket(), GetPath(),
+                                    mSubResourceMap["uploadId"],
+                                    mSubResourceMap["partNumber"]);
+  } else {
+    response = mS3Store->PutObject(request, GetId(), GetBucket(), GetPath(),
+                                   GetQuery());
+  }
+
   return response;
 }
 
@@ -264,7 +296,14 @@ eos::common::HttpResponse*
 S3Handler::Delete(eos::common::HttpRequest* request)
 {
   eos::common::HttpResponse* response = 0;
-  response = mS3Store->DeleteObject(request, GetId(), GetBucket(), GetPath());
+
+  if (mSubResourceMap.count("uploadId")) {
+    response = mS3Store->AbortMultipartUpload(request, GetId(), GetBucket(),
+               GetPath(), mSubResourceMap["uploadId"]);
+  } else {
+    response = mS3Store->DeleteObject(request, GetId(), GetBucket(), GetPath());
+  }
+
   return response;
 }
 
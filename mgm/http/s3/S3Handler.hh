@@ -115,6 +115,16 @@ public:
   eos::common::HttpResponse*
   Head (eos::common::HttpRequest *request);
 
+  /**
+   * Handle an S3 POST request (multipart upload creation and completion).
+   *
+   * @param request  the client request object
+   *
+   * @return an HTTP response object
+   */
+  eos::common::HttpResponse*
+  Post (eos::common::HttpRequest *request);
+
   /**
    * Handle an S3 PUT request.
    *
@@ -33,6 +33,9 @@
 #include "common/LayoutId.hh"
 #include "common/FileId.hh"
 #include "common/Timing.hh"
+#include "common/Path.hh"
+#include <openssl/md5.h>
+#include <zlib.h>
 
 EOSMGMNAMESPACE_BEGIN
 
@@ -330,6 +333,11 @@ S3Store::ListBucket(const std::string& bucket, const std::string& query)
         continue;
       }
 
+      // multipart uploads in progress are not objects yet
+      if (sname.find(EOS_COMMON_PATH_S3_UPLOAD_FILE_PREFIX) == 0) {
+        continue;
+      }
+
       // don't return more than max-keys
       if (cnt++ > max_keys) {
         truncated = true;
@@ -371,7 +379,11 @@ S3Store::ListBucket(const std::string& bucket, const std::string& query)
           entry += "</LastModified>";
           entry += "<ETag>\"";
 
-          eos::appendChecksumOnStringAsHex(fmd.get(), entry);
+          if (fmd->hasAttribute("sys.s3.etag")) {
+            entry += fmd->getAttribute("sys.s3.etag");
+          } else {
+            eos::appendChecksumOnStringAsHex(fmd.get(), entry);
+          }
 
           entry += "\"</ETag>";
           entry += "<Size>";
@@ -995,4 +1007,915 @@ S3Store::DeleteObject(eos::common::HttpRequest* request,
   return response;
 }
 
+/*----------------------------------------------------------------------------*/
+std::string
+S3Store::UploadPath(const std::string& objectpath, const std::string& uploadid)
+{
+  // upload ids are generated uuids, anything else must not end up in a path
+  if (uploadid.empty() ||
+      (uploadid.find_first_not_of("0123456789abcdef-") != std::string::npos)) {
+    return "";
+  }
+
+  size_t spos = objectpath.rfind('/');
+
+  if ((spos == std::string::npos) || (spos + 1 == objectpath.length())) {
+    return "";
+  }
+
+  std::string uploadpath = objectpath.substr(0, spos + 1);
+  uploadpath += EOS_COMMON_PATH_S3_UPLOAD_FILE_PREFIX;
+  uploadpath += uploadid;
+  uploadpath += ".";
+  uploadpath += objectpath.substr(spos + 1);
+  return uploadpath;
+}
+
+/*----------------------------------------------------------------------------*/
+bool
+S3Store::ParsePartList(const std::string& xml,
+                       std::vector<std::pair<int, std::string>>& parts)
+{
+  auto xmlValue = [](const std::string & xml, const std::string & tag) {
+    size_t start = xml.find("<" + tag + ">");
+    size_t stop = xml.find("</" + tag + ">");
+
+    if ((start == std::string::npos) || (stop == std::string::npos) ||
+        (stop < start)) {
+      return std::string("");
+    }
+
+    start += tag.length() + 2;
+    return xml.substr(start, stop - start);
+  };
+  parts.clear();
+  size_t pos = 0;
+
+  while ((pos = xml.find("<Part>", pos)) != std::string::npos) {
+    size_t end = xml.find("</Part>", pos);
+
+    if (end == std::string::npos) {
+      parts.clear();
+      return false;
+    }
+
+    std::string xmlpart = xml.substr(pos, end - pos);
+    std::string number = xmlValue(xmlpart, "PartNumber");
+    XrdOucString unquoted = xmlValue(xmlpart, "ETag").c_str();
+    unquoted.replace("&quot;", "");
+    unquoted.replace("\"", "");
+
+    if (number.empty() ||
+        (number.find_first_not_of("0123456789") != std::string::npos) ||
+        (number.length() > 5) || !unquoted.length()) {
+      parts.clear();
+      return false;
+    }
+
+    parts.push_back(std::make_pair(atoi(number.c_str()),
+                                   std::string(unquoted.c_str())));
+    pos = end;
+  }
+
+  return !parts.empty();
+}
+
+/*----------------------------------------------------------------------------*/
+bool
+S3Store::ParsePartInfo(const std::string& value, PartInfo& part)
+{
+  // <offset> <size> <md5> <adler32>
+  std::vector<std::string> info;
+  eos::common::StringConversion::Tokenize(value, info, " ");
+
+  if ((info.size() != 4) || (info[2].length() != 2 * MD5_DIGEST_LENGTH) ||
+      (info[2].find_first_not_of("0123456789abcdef") != std::string::npos)) {
+    return false;
+  }
+
+  char* end = 0;
+  part.offset = strtoull(info[0].c_str(), &end, 10);
+
+  if (*end) {
+    return false;
+  }
+
+  part.size = strtoull(info[1].c_str(), &end, 10);
+
+  if (*end) {
+    return false;
+  }
+
+  part.md5 = info[2];
+  part.adler = strtoul(info[3].c_str(), &end, 16);
+  return (*end == 0);
+}
+
+/*----------------------------------------------------------------------------*/
+bool
+S3Store::CheckPartLayout(size_t index, size_t count,
+                         unsigned long long partsize, const PartInfo& part)
+{
+  if (part.offset != (unsigned long long) index * partsize) {
+    return false;
+  }
+
+  return ((part.size <= partsize) &&
+          ((index + 1 == count) || (part.size == partsize)));
+}
+
+/*----------------------------------------------------------------------------*/
+uint32_t
+S3Store::CombineAdler32(const std::vector<PartInfo>& parts)
+{
+  uLong adler = adler32(0L, Z_NULL, 0);
+
+  for (auto it = parts.begin(); it != parts.end(); ++it) {
+    adler = adler32_combine(adler, it->adler, it->size);
+  }
+
+  return adler;
+}
+
+/*----------------------------------------------------------------------------*/
+std::string
+S3Store::MultipartETag(const std::vector<PartInfo>& parts)
+{
+  std::string md5s;
+
+  for (auto it = parts.begin(); it != parts.end(); ++it) {
+    for (size_t c = 0; c + 1 < it->md5.length(); c += 2) {
+      md5s += (char) strtol(it->md5.substr(c, 2).c_str(), 0, 16);
+    }
+  }
+
+  unsigned char digest[MD5_DIGEST_LENGTH];
+  MD5((const unsigned char*) md5s.c_str(), md5s.length(), digest);
+  std::string etag;
+
+  for (int i = 0; i < MD5_DIGEST_LENGTH; ++i) {
+    char hex[3];
+    snprintf(hex, sizeof(hex), "%02x", digest[i]);
+    etag += hex;
+  }
+
+  etag += "-";
+  etag += std::to_string(parts.size());
+  return etag;
+}
+
+/*----------------------------------------------------------------------------*/
+std::mutex S3Store::sPartsMutex;
+std::map<unsigned long long, std::map<int, time_t>> S3Store::sPartsInFlight;
+
+/*----------------------------------------------------------------------------*/
+void
+S3Store::PartOpened(unsigned long long fid, int part, time_t now)
+{
+  std::lock_guard<std::mutex> lock(sPartsMutex);
+  sPartsInFlight[fid][part] = now;
+}
+
+/*----------------------------------------------------------------------------*/
+void
+S3Store::PartCommitted(unsigned long long fid, int part)
+{
+  std::lock_guard<std::mutex> lock(sPartsMutex);
+  auto it = sPartsInFlight.find(fid);
+
+  if (it != sPartsInFlight.end()) {
+    it->second.erase(part);
+
+    if (it->second.empty()) {
+      sPartsInFlight.erase(it);
+    }
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+bool
+S3Store::PartsInFlight(unsigned long long fid, time_t now)
+{
+  std::lock_guard<std::mutex> lock(sPartsMutex);
+  auto it = sPartsInFlight.find(fid);
+
+  if (it == sPartsInFlight.end()) {
+    return false;
+  }
+
+  for (auto part = it->second.begin(); part != it->second.end(); ++part) {
+    if (now < part->second + sPartWriteTimeout) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/*----------------------------------------------------------------------------*/
+void
+S3Store::ForgetParts(unsigned long long fid)
+{
+  std::lock_guard<std::mutex> lock(sPartsMutex);
+  sPartsInFlight.erase(fid);
+}
+
+/*----------------------------------------------------------------------------*/
+eos::common::HttpResponse*
+S3Store::CreateMultipartUpload(eos::common::HttpRequest* request,
+                               const std::string& id,
+                               const std::string& bucket,
+                               const std::string& path)
+{
+  using namespace eos::common;
+  XrdOucErrInfo error;
+  Mapping::VirtualIdentity vid;
+  Mapping::Nobody(vid);
+  HttpResponse* response = 0;
+  int errc = 0;
+  std::string username = id;
+  uid_t uid = Mapping::UserNameToUid(username, errc);
+
+  if (errc) {
+    // error mapping the s3 id to unix id
+    return S3Handler::RestErrorResponse(eos::common::HttpResponse::BAD_REQUEST,
+                                        "InvalidArgument",
+                                        "Unable to map bucket id to virtual id",
+                                        id.c_str(), "");
+  }
+
+  // set the bucket id as vid
+  vid.uid = uid;
+  vid.uid_list.push_back(uid);
+  // build the full path for the request
+  std::string objectpath = mS3ContainerPath[bucket];
+
+  if (objectpath[objectpath.length() - 1] == '/') {
+    objectpath.erase(objectpath.length() - 1);
+  }
+
+  objectpath += path;
+  uuid_t uuid;
+  char suuid[40];
+  uuid_generate_time(uuid);
+  uuid_unparse_lower(uuid, suuid);
+  std::string uploadid = suuid;
+  std::string uploadpath = UploadPath(objectpath, uploadid);
+
+  if (uploadpath.empty()) {
+    return S3Handler::RestErrorResponse(eos::common::HttpResponse::BAD_REQUEST,
+                                        "InvalidArgument",
+                                        "Invalid object name",
+                                        path, "");
+  }
+
+  XrdSfsFile* file = gOFS->newFile((char*) id.c_str());
+
+  if (!file) {
+    return response;
+  }
+
+  XrdSecEntity client("unix");
+  client.name = strdup(id.c_str());
+  client.host = strdup(request->GetHeaders()["host"].c_str());
+  client.tident = strdup("http");
+  snprintf(client.prot, sizeof(client.prot) - 1, "https");
+  // adler32 checksums of the parts can be combined at completion, a zero
+  // booking size attaches the scheduled locations already now, so every part
+  // is sent to the same file systems
+  std::string query =
+    "&eos.checksum.noforce=1&eos.layout.checksum=adler&eos.bookingsize=0";
+  int rc = file->open(uploadpath.c_str(), SFS_O_TRUNC, SFS_O_MKPTH, &client,
+                      query.c_str());
+  int ec = file->error.getErrInfo();
+  delete file;
+
+  if (rc != SFS_REDIRECT) {
+    if ((rc == SFS_ERROR) && (ec == EPERM)) {
+      return S3Handler::RestErrorResponse(eos::common::HttpResponse::FORBIDDEN,
+                                          "AccessDenied",
+                                          "Access Denied",
+                                          path, "");
+    }
+
+    return S3Handler::RestErrorResponse(
+             eos::common::HttpResponse::INTERNAL_SERVER_ERROR,
+             "Internal Error",
+             "File creation currently "
+             "unavailable", path, "");
+  }
+
+  bool rain = false;
+  {
+    // tag the upload file, only tagged files accept part commits
+    eos::common::RWMutexWriteLock lock(gOFS->eosViewRWMutex);
+
+    try {
+      std::shared_ptr<eos::IFileMD> fmd = gOFS->eosView->getFile(uploadpath);
+      unsigned long layout = LayoutId::GetLayoutType(fmd->getLayoutId());
+      // parts are written in parallel into one file, a RAIN file has its
+      // parity computed by a single writer and can not be updated once it
+      // has a size
+      rain = ((layout == LayoutId::kRaidDP) || (layout == LayoutId::kRaid6) ||
+              (layout == LayoutId::kArchive));
+
+      if (!rain) {
+        fmd->setAttribute("sys.s3.upload", uploadid);
+        gOFS->eosView->updateFileStore(fmd.get());
+      }
+    } catch (eos::MDException& e) {
+      eos_static_err("msg=\"unable to tag upload file\" path=%s emsg=\"%s\"",
+                     uploadpath.c_str(), e.getMessage().str().c_str());
+      return S3Handler::RestErrorResponse(
+               eos::common::HttpResponse::INTERNAL_SERVER_ERROR,
+               "Internal Error",
+               "File creation currently "
+               "unavailable", path, "");
+    }
+  }
+
+  if (rain) {
+    if (gOFS->_rem(uploadpath.c_str(), error, vid, (const char*) 0, false,
+                   false, true)) {
+      eos_static_err("msg=\"unable to remove upload file\" path=%s",
+                     uploadpath.c_str());
+    }
+
+    return S3Handler::RestErrorResponse(
+             eos::common::HttpResponse::NOT_IMPLEMENTED,
+             "NotImplemented",
+             "Multipart uploads are not supported in buckets with a RAIN "
+             "layout", path, "");
+  }
+
+  std::string result = XML_V1_UTF8;
+  result += "<InitiateMultipartUploadResult "
+            "xmlns=\"http://s3.amazonaws.com/doc/2006-03-01/\">";
+  result += "<Bucket>";
+  result += bucket;
+  result += "</Bucket>";
+  result += "<Key>";
+  result += path.substr(1);
+  result += "</Key>";
+  result += "<UploadId>";
+  result += uploadid;
+  result += "</UploadId>";
+  result += "</InitiateMultipartUploadResult>";
+  response = new PlainHttpResponse();
+  response->AddHeader("Content-Type", "application/xml");
+  response->AddHeader("Connection", "close");
+  response->AddHeader("Server", gOFS->HostName);
+  response->SetBody(result);
+  return response;
+}
+
+/*----------------------------------------------------------------------------*/
+eos::common::HttpResponse*
+S3Store::UploadPart(eos::common::HttpRequest* request,
+                    const std::string& id,
+                    const std::string& bucket,
+                    const std::string& path,
+                    const std::string& uploadid,
+                    const std::string& partnumber)
+{
+  using namespace eos::common;
+  XrdOucErrInfo error;
+  Mapping::VirtualIdentity vid;
+  Mapping::Nobody(vid);
+  HttpResponse* response = 0;
+  int errc = 0;
+  std::string username = id;
+  uid_t uid = Mapping::UserNameToUid(username, errc);
+
+  if (errc) {
+    // error mapping the s3 id to unix id
+    return S3Handler::RestErrorResponse(eos::common::HttpResponse::BAD_REQUEST,
+                                        "InvalidArgument",
+                                        "Unable to map bucket id to virtual id",
+                                        id.c_str(), "");
+  }
+
+  // set the bucket id as vid
+  vid.uid = uid;
+  vid.uid_list.push_back(uid);
+  // build the full path for the request
+  std::string objectpath = mS3ContainerPath[bucket];
+
+  if (objectpath[objectpath.length() - 1] == '/') {
+    objectpath.erase(objectpath.length() - 1);
+  }
+
+  objectpath += path;
+  std::string uploadpath = UploadPath(objectpath, uploadid);
+  int part = atoi(partnumber.c_str());
+
+  if ((part < 1) || (part > 10000)) {
+    return S3Handler::RestErrorResponse(eos::common::HttpResponse::BAD_REQUEST,
+                                        "InvalidArgument",
+                                        "Part number must be an integer "
+                                        "between 1 and 10000", partnumber, "");
+  }
+
+  if (!request->GetHeaders().count("content-length")) {
+    return S3Handler::RestErrorResponse(eos::common::HttpResponse::BAD_REQUEST,
+                                        "MissingContentLength",
+                                        "You must provide the Content-Length "
+                                        "HTTP header", path, "");
+  }
+
+  unsigned long long length = strtoull(
+                                request->GetHeaders()["content-length"].c_str(), 0, 10);
+  unsigned long long partsize = 0;
+  unsigned long long fid = 0;
+  // all parts but the last have the size of the first part, so every part
+  // knows its final offset without waiting for the others
+  auto getUploadFile = [&]() -> std::shared_ptr<eos::IFileMD> {
+    std::shared_ptr<eos::IFileMD> fmd;
+
+    try {
+      if (uploadpath.length()) {
+        fmd = gOFS->eosView->getFile(uploadpath);
+      }
+    } catch (eos::MDException& e) {
+      fmd.reset();
+    }
+
+    if (fmd && fmd->hasAttribute("sys.s3.upload") &&
+        (fmd->getAttribute("sys.s3.upload") == uploadid)) {
+      return fmd;
+    }
+
+    return std::shared_ptr<eos::IFileMD>();
+  };
+  auto sizeError = [&]() -> HttpResponse* {
+    if ((length > partsize) || ((part == 1) && (length != partsize))) {
+      return S3Handler::RestErrorResponse(eos::common::HttpResponse::BAD_REQUEST,
+                                          "EntityTooLarge",
+                                          "All parts but the last one must "
+                                          "have the size of the first part",
+                                          partnumber, "");
+    }
+
+    return 0;
+  };
+  {
+    eos::common::RWMutexReadLock lock(gOFS->eosViewRWMutex);
+    std::shared_ptr<eos::IFileMD> fmd = getUploadFile();
+
+    if (!fmd) {
+      return S3Handler::RestErrorResponse(eos::common::HttpResponse::NOT_FOUND,
+                                          "NoSuchUpload",
+                                          "The specified upload does not exist",
+                                          uploadid, "");
+    }
+
+    if (fmd->hasAttribute("sys.s3.upload.partsize")) {
+      partsize = strtoull(fmd->getAttribute("sys.s3.upload.partsize").c_str(),
+                          0, 10);
+
+      if ((response = sizeError())) {
+        return response;
+      }
+
+      // registered under the namespace lock, a completion either sees this
+      // part or has already removed the upload tag
+      fid = fmd->getId();
+      PartOpened(fid, part, time(NULL));
+    } else if (part != 1) {
+      // clients retry a slow down, by then the first part has been seen
+      return S3Handler::RestErrorResponse(
+               eos::common::HttpResponse::SERVICE_UNAVAILABLE,
+               "SlowDown",
+               "The part size is not known before the first part is uploaded",
+               partnumber, "");
+    }
+  }
+
+  if (!fid) {
+    // only the first part stores the part size
+    eos::common::RWMutexWriteLock lock(gOFS->eosViewRWMutex);
+    std::shared_ptr<eos::IFileMD> fmd = getUploadFile();
+
+    if (!fmd) {
+      return S3Handler::RestErrorResponse(eos::common::HttpResponse::NOT_FOUND,
+                                          "NoSuchUpload",
+                                          "The specified upload does not exist",
+                                          uploadid, "");
+    }
+
+    if (fmd->hasAttribute("sys.s3.upload.partsize")) {
+      partsize = strtoull(fmd->getAttribute("sys.s3.upload.partsize").c_str(),
+                          0, 10);
+    } else {
+      std::string spartsize;
+      partsize = length;
+      fmd->setAttribute("sys.s3.upload.partsize",
+                        StringConversion::GetSizeString(spartsize, partsize));
+
+      try {
+        gOFS->eosView->updateFileStore(fmd.get());
+      } catch (eos::MDException& e) {
+        return S3Handler::RestErrorResponse(
+                 eos::common::HttpResponse::INTERNAL_SERVER_ERROR,
+                 "Internal Error",
+                 "Unable to store the part size", path, "");
+      }
+    }
+
+    if ((response = sizeError())) {
+      return response;
+    }
+
+    fid = fmd->getId();
+    PartOpened(fid, part, time(NULL));
+  }
+
+  XrdSfsFile* file = gOFS->newFile((char*) id.c_str());
+
+  if (file) {
+    XrdSecEntity client("unix");
+    client.name = strdup(id.c_str());
+    client.host = strdup(request->GetHeaders()["host"].c_str());
+    client.tident = strdup("http");
+    snprintf(client.prot, sizeof(client.prot) - 1, "https");
+    int rc = file->open(uploadpath.c_str(), SFS_O_RDWR, 0, &client, "");
+
+    if (rc == SFS_REDIRECT) {
+      // tell the FST where the part goes, it reports the part with its commit
+      std::string hostcgi = file->error.getErrText();
+      std::string sconv;
+      hostcgi += (hostcgi.find('?') == std::string::npos) ? "?" : "&";
+      hostcgi += "eos.s3.part=";
+      hostcgi += StringConversion::GetSizeString(sconv,
+                 (unsigned long long) part);
+      hostcgi += "&eos.s3.offset=";
+      hostcgi += StringConversion::GetSizeString(sconv,
+                 (unsigned long long)(part - 1) * partsize);
+      // the embedded server on FSTs is hardcoded to run on port 8001
+      response = HttpServer::HttpRedirect(uploadpath, hostcgi, 8001, false);
+      response->AddHeader("x-amz-website-redirect-location",
+                          response->GetHeaders()["Location"]);
+      std::string body = XML_V1_UTF8;
+      body += "<Error>"
+              "<Code>TemporaryRedirect</Code>"
+              "<Message>Please re-send this request to the specified temporary "
+              "endpoint. Continue to use the original request endpoint for "
+              "future requests.</Message>"
+              "<Endpoint>";
+      body += response->GetHeaders()["Location"];
+      body += "</Endpoint>"
+              "</Error>";
+      response->SetBody(body);
+    } else if (rc == SFS_ERROR) {
+      PartCommitted(fid, part);
+
+      if (file->error.getErrInfo() == EPERM) {
+        response = S3Handler::RestErrorResponse(eos::common::HttpResponse::FORBIDDEN,
+                                                "AccessDenied",
+                                                "Access Denied",
+                                                path, "");
+      } else {
+        response = S3Handler::RestErrorResponse(
+                     eos::common::HttpResponse::INTERNAL_SERVER_ERROR,
+                     "Internal Error",
+                     "File currently unwritable", path, "");
+      }
+    } else {
+      PartCommitted(fid, part);
+      response = S3Handler::RestErrorResponse(
+                   eos::common::HttpResponse::INTERNAL_SERVER_ERROR,
+                   "Internal Error",
+                   "File not accessible in this way",
+                   path, "");
+    }
+
+    // clean up the object
+    delete file;
+  } else {
+    PartCommitted(fid, part);
+  }
+
+  return response;
+}
+
+/*----------------------------------------------------------------------------*/
+eos::common::HttpResponse*
+S3Store::CompleteMultipartUpload(eos::common::HttpRequest* request,
+                                 const std::string& id,
+                                 const std::string& bucket,
+                                 const std::string& path,
+                                 const std::string& uploadid)
+{
+  using namespace eos::common;
+  XrdOucErrInfo error;
+  Mapping::VirtualIdentity vid;
+  Mapping::Nobody(vid);
+  HttpResponse* response = 0;
+  int errc = 0;
+  std::string username = id;
+  uid_t uid = Mapping::UserNameToUid(username, errc);
+
+  if (errc) {
+    // error mapping the s3 id to unix id
+    return S3Handler::RestErrorResponse(eos::common::HttpResponse::BAD_REQUEST,
+                                        "InvalidArgument",
+                                        "Unable to map bucket id to virtual id",
+                                        id.c_str(), "");
+  }
+
+  // set the bucket id as vid
+  vid.uid = uid;
+  vid.uid_list.push_back(uid);
+  // build the full path for the request
+  std::string objectpath = mS3ContainerPath[bucket];
+
+  if (objectpath[objectpath.length() - 1] == '/') {
+    objectpath.erase(objectpath.length() - 1);
+  }
+
+  objectpath += path;
+  std::string uploadpath = UploadPath(objectpath, uploadid);
+  std::vector<std::pair<int, std::string>> parts;
+
+  if (!ParsePartList(request->GetBody(), parts)) {
+    return S3Handler::RestErrorResponse(eos::common::HttpResponse::BAD_REQUEST,
+                                        "MalformedXML",
+                                        "The part list is missing or malformed",
+                                        path, "");
+  }
+
+  std::string etag;
+  eos::IFileMD::LocationVector locations;
+  {
+    // completion only touches meta data, the parts are already in place
+    eos::common::RWMutexWriteLock lock(gOFS->eosViewRWMutex);
+    std::shared_ptr<eos::IFileMD> fmd;
+
+    try {
+      if (uploadpath.length()) {
+        fmd = gOFS->eosView->getFile(uploadpath);
+      }
+    } catch (eos::MDException& e) {
+      fmd.reset();
+    }
+
+    if (!fmd || !fmd->hasAttribute("sys.s3.upload") ||
+        (fmd->getAttribute("sys.s3.upload") != uploadid)) {
+      return S3Handler::RestErrorResponse(eos::common::HttpResponse::NOT_FOUND,
+                                          "NoSuchUpload",
+                                          "The specified upload does not exist",
+                                          uploadid, "");
+    }
+
+    // a part still being written would change the data of the object after
+    // its checksums are fixed, parts register under the namespace lock so
+    // none can start once the upload tag is removed below
+    if (PartsInFlight(fmd->getId(), time(NULL))) {
+      return S3Handler::RestErrorResponse(
+               eos::common::HttpResponse::SERVICE_UNAVAILABLE,
+               "SlowDown",
+               "Parts of the upload are still being written",
+               uploadid, "");
+    }
+
+    unsigned long long partsize = 0;
+
+    if (fmd->hasAttribute("sys.s3.upload.partsize")) {
+      partsize = strtoull(fmd->getAttribute("sys.s3.upload.partsize").c_str(),
+                          0, 10);
+    }
+
+    // parts are placed by number, so the list has to start with the first
+    // part and must not have gaps
+    std::vector<PartInfo> infos;
+    unsigned long long size = 0;
+
+    for (size_t i = 0; i < parts.size(); ++i) {
+      std::string key = "sys.s3.part." + std::to_string(parts[i].first);
+
+      if ((parts[i].first != (int)(i + 1)) || !fmd->hasAttribute(key)) {
+        return S3Handler::RestErrorResponse(eos::common::HttpResponse::BAD_REQUEST,
+                                            "InvalidPart",
+                                            "Parts have to be listed from the "
+                                            "first one without gaps and have "
+                                            "to be uploaded", path, "");
+      }
+
+      PartInfo info;
+
+      if (!ParsePartInfo(fmd->getAttribute(key), info) ||
+          (info.md5 != parts[i].second) ||
+          (info.offset != (unsigned long long) i * partsize)) {
+        return S3Handler::RestErrorResponse(eos::common::HttpResponse::BAD_REQUEST,
+                                            "InvalidPart",
+                                            "The ETag of a part does not match",
+                                            std::to_string(parts[i].first), "");
+      }
+
+      if (!CheckPartLayout(i, parts.size(), partsize, info)) {
+        return S3Handler::RestErrorResponse(eos::common::HttpResponse::BAD_REQUEST,
+                                            "InvalidPart",
+                                            "All parts but the last one must "
+                                            "have the size of the first part",
+                                            std::to_string(parts[i].first), "");
+      }
+
+      size += info.size;
+      infos.push_back(info);
+    }
+
+    // data of unlisted parts behind the last listed one would remain in the file
+    eos::IFileMD::XAttrMap attrs = fmd->getAttributes();
+
+    for (auto it = attrs.begin(); it != attrs.end(); ++it) {
+      if ((it->first.find("sys.s3.part.") == 0) &&
+          (atoi(it->first.c_str() + strlen("sys.s3.part.")) > (int) parts.size())) {
+        return S3Handler::RestErrorResponse(eos::common::HttpResponse::BAD_REQUEST,
+                                            "InvalidPart",
+                                            "Parts behind the last listed part "
+                                            "have been uploaded", path, "");
+      }
+    }
+
+    // the S3 ETag of a multipart upload is the MD5 of the part MD5s
+    etag = MultipartETag(infos);
+
+    if (LayoutId::GetChecksum(fmd->getLayoutId()) == LayoutId::kAdler) {
+      uint32_t adler = CombineAdler32(infos);
+      char bin[4] = {(char)(adler >> 24), (char)(adler >> 16),
+                     (char)(adler >> 8), (char) adler
+                    };
+      eos::Buffer checksum;
+      checksum.putData(bin, sizeof(bin));
+      fmd->setChecksum(checksum);
+    }
+
+    for (auto it = attrs.begin(); it != attrs.end(); ++it) {
+      if (it->first.find("sys.s3.") == 0) {
+        fmd->removeAttribute(it->first);
+      }
+    }
+
+    fmd->setAttribute("sys.s3.etag", etag);
+    fmd->setSize(size);
+    fmd->setMTimeNow();
+    locations = fmd->getLocations();
+    ForgetParts(fmd->getId());
+
+    try {
+      gOFS->eosView->updateFileStore(fmd.get());
+    } catch (eos::MDException& e) {
+      return S3Handler::RestErrorResponse(
+               eos::common::HttpResponse::INTERNAL_SERVER_ERROR,
+               "Internal Error",
+               "Unable to complete the upload", path, "");
+    }
+  }
+
+  // the object becomes visible with the final rename
+  if (gOFS->_rename(uploadpath.c_str(), objectpath.c_str(), error, vid, 0, 0,
+                    true, false, true)) {
+    eos_static_err("msg=\"unable to rename upload file\" src=%s dst=%s",
+                   uploadpath.c_str(), objectpath.c_str());
+
+    if (error.getErrInfo() == EPERM) {
+      return S3Handler::RestErrorResponse(eos::common::HttpResponse::FORBIDDEN,
+                                          "AccessDenied",
+                                          "Access Denied",
+                                          path, "");
+    }
+
+    return S3Handler::RestErrorResponse(
+             eos::common::HttpResponse::INTERNAL_SERVER_ERROR,
+             "Internal Error",
+             "Unable to complete the upload", path, "");
+  }
+
+  // the parts are committed without a checksum, let the FSTs compute the
+  // checksum of the whole file and commit it like a verification would
+  Mapping::VirtualIdentity rootvid;
+  Mapping::Root(rootvid);
+
+  for (auto it = locations.begin(); it != locations.end(); ++it) {
+    if (gOFS->_verifystripe(objectpath.c_str(), error, rootvid, *it,
+                            "&mgm.verify.compute.checksum=1"
+                            "&mgm.verify.commit.checksum=1")) {
+      eos_static_err("msg=\"unable to verify the checksum of the object\" "
+                     "path=%s fsid=%u errc=%d", objectpath.c_str(), *it,
+                     error.getErrInfo());
+    }
+  }
+
+  std::string result = XML_V1_UTF8;
+  result += "<CompleteMultipartUploadResult "
+            "xmlns=\"http://s3.amazonaws.com/doc/2006-03-01/\">";
+  result += "<Location>";
+  result += "http://";
+  result += request->GetHeaders()["host"];
+  result += "/";
+  result += bucket;
+  result += path;
+  result += "</Location>";
+  result += "<Bucket>";
+  result += bucket;
+  result += "</Bucket>";
+  result += "<Key>";
+  result += path.substr(1);
+  result += "</Key>";
+  result += "<ETag>\"";
+  result += etag;
+  result += "\"</ETag>";
+  result += "</CompleteMultipartUploadResult>";
+  response = new PlainHttpResponse();
+  response->AddHeader("Content-Type", "application/xml");
+  response->AddHeader("Connection", "close");
+  response->AddHeader("Server", gOFS->HostName);
+  response->SetBody(result);
+  return response;
+}
+
+/*----------------------------------------------------------------------------*/
+eos::common::HttpResponse*
+S3Store::AbortMultipartUpload(eos::common::HttpRequest* request,
+                              const std::string& id,
+                              const std::string& bucket,
+                              const std::string& path,
+                              const std::string& uploadid)
+{
+  using namespace eos::common;
+  XrdOucErrInfo error;
+  Mapping::VirtualIdentity vid;
+  Mapping::Nobody(vid);
+  HttpResponse* response = 0;
+  int errc = 0;
+  std::string username = id;
+  uid_t uid = Mapping::UserNameToUid(username, errc);
+
+  if (errc) {
+    // error mapping the s3 id to unix id
+    return S3Handler::RestErrorResponse(eos::common::HttpResponse::BAD_REQUEST,
+                                        "InvalidArgument",
+                                        "Unable to map bucket id to virtual id",
+                                        id.c_str(), "");
+  }
+
+  // set the bucket id as vid
+  vid.uid = uid;
+  vid.uid_list.push_back(uid);
+  // build the full path for the request
+  std::string objectpath = mS3ContainerPath[bucket];
+
+  if (objectpath[objectpath.length() - 1] == '/') {
+    objectpath.erase(objectpath.length() - 1);
+  }
+
+  objectpath += path;
+  std::string uploadpath = UploadPath(objectpath, uploadid);
+  bool exists = false;
+  unsigned long long fid = 0;
+
+  if (uploadpath.length()) {
+    eos::common::RWMutexReadLock lock(gOFS->eosViewRWMutex);
+
+    try {
+      std::shared_ptr<eos::IFileMD> fmd = gOFS->eosView->getFile(uploadpath);
+      exists = fmd->hasAttribute("sys.s3.upload") &&
+               (fmd->getAttribute("sys.s3.upload") == uploadid);
+      fid = fmd->getId();
+    } catch (eos::MDException& e) {
+      exists = false;
+    }
+  }
+
+  if (!exists) {
+    return S3Handler::RestErrorResponse(eos::common::HttpResponse::NOT_FOUND,
+                                        "NoSuchUpload",
+                                        "The specified upload does not exist",
+                                        uploadid, "");
+  }
+
+  // the parts of an aborted upload are not kept in the recycle bin
+  if (gOFS->_rem(uploadpath.c_str(), error, vid, (const char*) 0, false, false,
+                 true)) {
+    if (error.getErrInfo() == EPERM) {
+      return S3Handler::RestErrorResponse(eos::common::HttpResponse::FORBIDDEN,
+                                          "AccessDenied",
+                                          "Access Denied",
+                                          path, "");
+    }
+
+    return S3Handler::RestErrorResponse(eos::common::HttpResponse::BAD_REQUEST,
+                                        "InvalidArgument",
+                                        "Unable to abort the upload",
+                                        uploadid, "");
+  }
+
+  ForgetParts(fid);
+  response = new eos::common::PlainHttpResponse();
+  response->AddHeader("Connection", "close");
+  response->AddHeader("Server", gOFS->HostName);
+  response->SetResponseCode(response->NO_CONTENT);
+  return response;
+}
+
 EOSMGMNAMESPACE_END
@@ -38,8 +38,11 @@
 /*----------------------------------------------------------------------------*/
 /*----------------------------------------------------------------------------*/
 #include <map>
+#include <mutex>
 #include <set>
 #include <string>
+#include <vector>
+#include <stdint.h>
 /*----------------------------------------------------------------------------*/
 
 EOSMGMNAMESPACE_BEGIN
@@ -184,6 +187,208 @@ public:
                 const std::string        &bucket,
                 const std::string        &path);
 
+  /**
+   * Start a multipart upload by creating a hidden upload file next to the
+   * object, all parts are written directly into this file
+   *
+   * @param request  the client request object
+   * @param id       the S3 id of the client
+   * @param bucket   the name of the bucket
+   * @param path     the request path
+   *
+   * @return S3 HTTP response object
+   */
+  eos::common::HttpResponse*
+  CreateMultipartUpload (eos::common::HttpRequest *request,
+                         const std::string        &id,
+                         const std::string        &bucket,
+                         const std::string        &path);
+
+  /**
+   * Upload a part of a multipart upload (redirection). The size of the first
+   * part fixes the part size, every part is placed at its final offset.
+   *
+   * @param request     the client request object
+   * @param id          the S3 id of the client
+   * @param bucket      the name of the bucket
+   * @param path        the request path
+   * @param uploadid    the id of the multipart upload
+   * @param partnumber  the number of the part
+   *
+   * @return S3 HTTP response object
+   */
+  eos::common::HttpResponse*
+  UploadPart (eos::common::HttpRequest *request,
+              const std::string        &id,
+              const std::string        &bucket,
+              const std::string        &path,
+              const std::string        &uploadid,
+              const std::string        &partnumber);
+
+  /**
+   * Complete a multipart upload - verifies the listed parts, combines their
+   * checksums and renames the upload file to the object name
+   *
+   * @param request   the client request object
+   * @param id        the S3 id of the client
+   * @param bucket    the name of the bucket
+   * @param path      the request path
+   * @param uploadid  the id of the multipart upload
+   *
+   * @return S3 HTTP response object
+   */
+  eos::common::HttpResponse*
+  CompleteMultipartUpload (eos::common::HttpRequest *request,
+                           const std::string        &id,
+                           const std::string        &bucket,
+                           const std::string        &path,
+                           const std::string        &uploadid);
+
+  /**
+   * Abort a multipart upload and remove the upload file
+   *
+   * @param request   the client request object
+   * @param id        the S3 id of the client
+   * @param bucket    the name of the bucket
+   * @param path      the request path
+   * @param uploadid  the id of the multipart upload
+   *
+   * @return S3 HTTP response object
+   */
+  eos::common::HttpResponse*
+  AbortMultipartUpload (eos::common::HttpRequest *request,
+                        const std::string        &id,
+                        const std::string        &bucket,
+                        const std::string        &path,
+                        const std::string        &uploadid);
+
+  /**
+   * Part of a multipart upload as recorded by the part commit in the
+   * sys.s3.part.<n> attribute "<offset> <size> <md5> <adler32>"
+   */
+  struct PartInfo
+  {
+    unsigned long long offset;
+    unsigned long long size;
+    std::string md5;
+    uint32_t adler;
+  };
+
+  /**
+   * Parse the part list of a complete multipart upload request
+   * <Part><PartNumber>n</PartNumber><ETag>e</ETag></Part>, the ETags are
+   * returned without quotes
+   *
+   * @param xml    the request body
+   * @param parts  the part numbers and ETags in the listed order
+   *
+   * @return false if the list is empty or malformed
+   */
+  static bool
+  ParsePartList (const std::string &xml,
+                 std::vector<std::pair<int, std::string>> &parts);
+
+  /**
+   * Parse the value of a sys.s3.part.<n> attribute
+   *
+   * @param value  the attribute value
+   * @param part   the parsed part
+   *
+   * @return false if the value is malformed
+   */
+  static bool
+  ParsePartInfo (const std::string &value, PartInfo &part);
+
+  /**
+   * Check that a part sits at its final offset - all parts but the last one
+   * have the size of the first part
+   *
+   * @param index     the position of the part in the list
+   * @param count     the number of parts in the list
+   * @param partsize  the part size fixed by the first part
+   * @param part      the part to check
+   *
+   * @return true if offset and size are valid
+   */
+  static bool
+  CheckPartLayout (size_t index, size_t count, unsigned long long partsize,
+                   const PartInfo &part);
+
+  /**
+   * @param parts  the parts in file order
+   *
+   * @return the adler32 checksum of the whole file
+   */
+  static uint32_t
+  CombineAdler32 (const std::vector<PartInfo> &parts);
+
+  /**
+   * @param parts  the parts in file order
+   *
+   * @return the S3 ETag of a multipart upload - the MD5 of the part MD5s
+   *         followed by "-<number of parts>"
+   */
+  static std::string
+  MultipartETag (const std::vector<PartInfo> &parts);
+
+  /**
+   * Register a part write redirected to an FST. The caller has to hold the
+   * namespace lock under which the upload was found.
+   *
+   * @param fid   the file id of the upload file
+   * @param part  the number of the part
+   * @param now   the current time
+   */
+  static void
+  PartOpened (unsigned long long fid, int part, time_t now);
+
+  /**
+   * Unregister a part write, called by the part commit under the namespace
+   * write lock
+   *
+   * @param fid   the file id of the upload file
+   * @param part  the number of the part
+   */
+  static void
+  PartCommitted (unsigned long long fid, int part);
+
+  /**
+   * Check for part writes which might still modify the upload file - a write
+   * which did not commit within sPartWriteTimeout is considered abandoned
+   *
+   * @param fid  the file id of the upload file
+   * @param now  the current time
+   *
+   * @return true if a part is still being written
+   */
+  static bool
+  PartsInFlight (unsigned long long fid, time_t now);
+
+  /**
+   * Forget all part writes of an upload which was completed or aborted
+   *
+   * @param fid  the file id of the upload file
+   */
+  static void
+  ForgetParts (unsigned long long fid);
+
+  static const time_t sPartWriteTimeout = 3600; //< seconds until a part write is considered abandoned
+
+private:
+
+  static std::mutex                                        sPartsMutex;    //< mutex protecting sPartsInFlight
+  static std::map<unsigned long long, std::map<int, time_t>> sPartsInFlight; //< map pointing from upload file id to the parts being written and their redirection time
+
+  /**
+   * @param objectpath  the namespace path of the object
+   * @param uploadid    the id of the multipart upload
+   *
+   * @return the path of the upload file or an empty string if the upload id
+   *         is malformed
+   */
+  static std::string
+  UploadPath (const std::string &objectpath, const std::string &uploadid);
+
 };
 
 /*----------------------------------------------------------------------------*/
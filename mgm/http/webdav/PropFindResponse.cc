@@ -33,6 +33,8 @@
 #include "common/Path.hh"
 #include "common/http/OwnCloud.hh"
 #include "XrdOuc/XrdOucErrInfo.hh"
+#include <algorithm>
+#include <vector>
 
 EOSMGMNAMESPACE_BEGIN
 
@@ -91,6 +93,12 @@ PropFindResponse::EncodeURI(const char* uri)
 }
 
 
+/*----------------------------------------------------------------------------*/
+PropFindResponse::~PropFindResponse()
+{
+  delete mDirectory;
+}
+
 /*----------------------------------------------------------------------------*/
 eos::common::HttpResponse*
 PropFindResponse::BuildResponse(eos::common::HttpRequest* request)
@@ -124,19 +132,6 @@ PropFindResponse::BuildResponse(eos::common::HttpRequest* request)
     }
   }
 
-  // Build the response
-  // xml declaration
-  xml_node<>* decl = mXMLResponseDocument.allocate_node(node_declaration);
-  decl->append_attribute(AllocateAttribute("version", "1.0"));
-  decl->append_attribute(AllocateAttribute("encoding", "utf-8"));
-  mXMLResponseDocument.append_node(decl);
-  // <multistatus/> node
-  xml_node<>* multistatusNode = AllocateNode("d:multistatus");
-  multistatusNode->append_attribute(AllocateAttribute("xmlns:d", "DAV:"));
-  multistatusNode->append_attribute(
-    AllocateAttribute(eos::common::OwnCloud::OwnCloudNs(),
-                      eos::common::OwnCloud::OwnCloudNsUrl()));
-  mXMLResponseDocument.append_node(multistatusNode);
   // Is the requested resource a file or directory?
   XrdOucErrInfo error;
   struct stat statInfo;
@@ -157,6 +152,24 @@ PropFindResponse::BuildResponse(eos::common::HttpRequest* request)
   //  }
   eos_static_debug("depth=%s, isdir=%d", depth.c_str(),
                    S_ISDIR(statInfo.st_mode));
+
+  if ((depth == "1") && S_ISDIR(statInfo.st_mode)) {
+    return BuildDirectoryResponse(request);
+  }
+
+  // Build the response
+  // xml declaration
+  xml_node<>* decl = mXMLResponseDocument.allocate_node(node_declaration);
+  decl->append_attribute(AllocateAttribute("version", "1.0"));
+  decl->append_attribute(AllocateAttribute("encoding", "utf-8"));
+  mXMLResponseDocument.append_node(decl);
+  // <multistatus/> node
+  xml_node<>* multistatusNode = AllocateNode("d:multistatus");
+  multistatusNode->append_attribute(AllocateAttribute("xmlns:d", "DAV:"));
+  multistatusNode->append_attribute(
+    AllocateAttribute(eos::common::OwnCloud::OwnCloudNs(),
+                      eos::common::OwnCloud::OwnCloudNsUrl()));
+  mXMLResponseDocument.append_node(multistatusNode);
   xml_node<>* responseNode = 0;
 
   if (depth == "0" || !S_ISDIR(statInfo.st_mode)) {
@@ -168,54 +181,6 @@ PropFindResponse::BuildResponse(eos::common::HttpRequest* request)
     } else {
       return this;
     }
-  } else if (depth == "1") {
-    // Stat the resource and all child resources
-    XrdMgmOfsDirectory directory;
-    int listrc = directory.open(request->GetUrl().c_str(), *mVirtualIdentity,
-                                (const char*) 0);
-    responseNode = BuildResponseNode(request->GetUrl().c_str(),
-                                     request->GetUrl(true).c_str());
-
-    if (responseNode) {
-      multistatusNode->append_node(responseNode);
-    }
-
-    if (!listrc) {
-      const char* val;
-
-      while ((val = directory.nextEntry())) {
-        XrdOucString entryname = val;
-
-        // don't display . .., atomic(+version) uploads and version directories
-        if (entryname.beginswith(EOS_COMMON_PATH_VERSION_FILE_PREFIX) ||
-            entryname.beginswith(EOS_COMMON_PATH_ATOMIC_FILE_PREFIX) ||
-            entryname.beginswith(EOS_WEBDAV_HIDE_IN_PROPFIND_PREFIX) ||
-            (entryname == ".") ||
-            (entryname == "..")) {
-          // skip over . .. and hidden files
-          continue;
-        }
-
-        // one response node for each file...
-        eos::common::Path path((request->GetUrl() + std::string("/") + std::string(
-                                  val)).c_str());
-        eos::common::Path refpath((request->GetUrl(true) + std::string("/") +
-                                   std::string(val)).c_str());
-        responseNode = BuildResponseNode(path.GetPath(), refpath.GetPath());
-
-        if (responseNode) {
-          multistatusNode->append_node(responseNode);
-        } else {
-          // We might have a failed stat in the BuildResponseNode if there are
-          // symlinks present
-          SetResponseCode(HttpResponse::OK);
-        }
-      }
-    } else {
-      eos_static_warning("msg=\"error opening directory - might be stalled/banned\"");
-      SetResponseCode(ResponseCodes::FORBIDDEN);
-      return this;
-    }
   } else if (depth == "1,noroot") {
     // Stat all child resources but not the requested resource
     SetResponseCode(HttpResponse::NOT_IMPLEMENTED);
@@ -237,6 +202,132 @@ PropFindResponse::BuildResponse(eos::common::HttpRequest* request)
   return this;
 }
 
+/*----------------------------------------------------------------------------*/
+eos::common::HttpResponse*
+PropFindResponse::BuildDirectoryResponse(eos::common::HttpRequest* request)
+{
+  // Stat the resource and all child resources, the entry names are read
+  // from the namespace one batch at a time as well
+  mDirectory = new XrdMgmOfsDirectory();
+  mDirectory->SetListingBatch(cStreamBatchSize);
+
+  if (mDirectory->open(request->GetUrl().c_str(), *mVirtualIdentity,
+                       (const char*) 0)) {
+    eos_static_warning("msg=\"error opening directory - might be stalled/banned\"");
+    SetResponseCode(ResponseCodes::FORBIDDEN);
+    return this;
+  }
+
+  mDirectoryUrl = request->GetUrl();
+  mDirectoryHrefUrl = request->GetUrl(true);
+  // The <multistatus/> node is written by hand since it is never complete
+  // in memory
+  mStreamBuffer = "<?xml version=\"1.0\" encoding=\"utf-8\"?>"
+                  "<d:multistatus xmlns:d=\"DAV:\" ";
+  mStreamBuffer += eos::common::OwnCloud::OwnCloudNs();
+  mStreamBuffer += "=\"";
+  mStreamBuffer += eos::common::OwnCloud::OwnCloudNsUrl();
+  mStreamBuffer += "\">";
+  rapidxml::xml_node<>* responseNode = BuildResponseNode(mDirectoryUrl,
+                                       mDirectoryHrefUrl);
+
+  if (responseNode) {
+    rapidxml::print(std::back_inserter(mStreamBuffer), *responseNode,
+                    rapidxml::print_no_indenting);
+  }
+
+  mXMLResponseDocument.clear();
+  mStreamEnd = !StreamNextBatch();
+  SetResponseCode(HttpResponse::MULTI_STATUS);
+  AddHeader("Content-Type", "application/xml; charset=utf-8");
+
+  if (mStreamEnd) {
+    // Small listing, send it in one go
+    mStreamBuffer += "</d:multistatus>";
+    AddHeader("Content-Length", std::to_string((long long) mStreamBuffer.size()));
+    SetBody(mStreamBuffer);
+    mStreamBuffer.clear();
+    return this;
+  }
+
+  // Large listing, the rest is produced while the response is sent
+  eos_static_info("msg=\"streaming directory listing\" url=\"%s\"",
+                  mDirectoryUrl.c_str());
+  mUseFileReaderCallback = true;
+  mResponseLength = -1;
+  return this;
+}
+
+/*----------------------------------------------------------------------------*/
+bool
+PropFindResponse::StreamNextBatch()
+{
+  std::vector<std::string> names;
+  const char* val = 0;
+
+  while ((names.size() < cStreamBatchSize) && (val = mDirectory->nextEntry())) {
+    XrdOucString entryname = val;
+
+    // don't display . .., atomic(+version) uploads and version directories
+    if (entryname.beginswith(EOS_COMMON_PATH_VERSION_FILE_PREFIX) ||
+        entryname.beginswith(EOS_COMMON_PATH_ATOMIC_FILE_PREFIX) ||
+        entryname.beginswith(EOS_WEBDAV_HIDE_IN_PROPFIND_PREFIX) ||
+        (entryname == ".") ||
+        (entryname == "..")) {
+      // skip over . .. and hidden files
+      continue;
+    }
+
+    names.push_back(val);
+  }
+
+  for (auto& name : names) {
+    // one response node for each file...
+    eos::common::Path path((mDirectoryUrl + std::string("/") + name).c_str());
+    eos::common::Path refpath((mDirectoryHrefUrl + std::string("/") +
+                               name).c_str());
+    rapidxml::xml_node<>* responseNode = BuildResponseNode(path.GetPath(),
+                                         refpath.GetPath());
+
+    // We might have a failed stat in the BuildResponseNode if there are
+    // symlinks present, such entries are left out
+    if (responseNode) {
+      rapidxml::print(std::back_inserter(mStreamBuffer), *responseNode,
+                      rapidxml::print_no_indenting);
+    }
+
+    // Release the nodes of the entry, the memory pool keeps its first block
+    mXMLResponseDocument.clear();
+  }
+
+  return (val != 0);
+}
+
+/*----------------------------------------------------------------------------*/
+ssize_t
+PropFindResponse::ReadBody(uint64_t pos, char* buf, size_t max)
+{
+  while (!mStreamEnd && ((mStreamBuffer.size() - mStreamOffset) < max)) {
+    mStreamBuffer.erase(0, mStreamOffset);
+    mStreamOffset = 0;
+
+    if (!StreamNextBatch()) {
+      mStreamBuffer += "</d:multistatus>";
+      mStreamEnd = true;
+    }
+  }
+
+  size_t len = std::min(max, mStreamBuffer.size() - mStreamOffset);
+
+  if (!len) {
+    return -1;
+  }
+
+  memcpy(buf, mStreamBuffer.data() + mStreamOffset, len);
+  mStreamOffset += len;
+  return len;
+}
+
 /*----------------------------------------------------------------------------*/
 void
 PropFindResponse::ParseRequestPropertyTypes(rapidxml::xml_node<>* node)
@@ -44,6 +44,8 @@
 #include "XrdOuc/XrdOucErrInfo.hh"
 /*----------------------------------------------------------------------------*/
 
+class XrdMgmOfsDirectory;
+
 EOSMGMNAMESPACE_BEGIN;
 
 
@@ -81,10 +83,23 @@ public:
     ALLPROP_MARKER = 0xf000
   };
 
+  /**
+   * Number of directory entries stat'ed and serialised at a time by a
+   * Depth:1 PROPFIND
+   */
+  static const size_t cStreamBatchSize = 256;
+
 protected:
   int mRequestPropertyTypes; //!< properties that were requested
   eos::common::Mapping::VirtualIdentity *mVirtualIdentity; //!< virtual identity for this client
 
+  XrdMgmOfsDirectory *mDirectory; //!< directory listed by a streamed response
+  std::string mDirectoryUrl;      //!< URL of the listed directory
+  std::string mDirectoryHrefUrl;  //!< href URL of the listed directory
+  std::string mStreamBuffer;      //!< serialised part not sent yet
+  size_t mStreamOffset;           //!< position of the unsent data in the buffer
+  bool mStreamEnd;                //!< the complete listing is in the buffer
+
 public:
 
   /**
@@ -95,7 +110,7 @@ public:
   PropFindResponse (eos::common::HttpRequest *request,
                     eos::common::Mapping::VirtualIdentity *vid) :
     WebDAVResponse (request), mRequestPropertyTypes (NONE),
-    mVirtualIdentity (vid)
+    mVirtualIdentity (vid), mDirectory (0), mStreamOffset (0), mStreamEnd (false)
   {
     static bool initialized = false;
     if (!initialized)
@@ -115,9 +130,7 @@ public:
   /**
    * Destructor
    */
-  virtual ~PropFindResponse ()
-  {
-  };
+  virtual ~PropFindResponse ();
 
 
   /**
@@ -130,6 +143,41 @@ public:
   HttpResponse*
   BuildResponse (eos::common::HttpRequest *request);
 
+  /**
+   * Build the response to a Depth:1 PROPFIND on a directory. The child
+   * resources are read from the namespace, stat'ed and serialised in batches
+   * while the response is sent, so the memory needed does not depend on the
+   * directory size. A
+   * listing fitting into the first batch is returned as a plain body.
+   *
+   * @param request  the client request object
+   *
+   * @return the response object
+   */
+  HttpResponse*
+  BuildDirectoryResponse (eos::common::HttpRequest *request);
+
+  /**
+   * Produce the next part of a streamed directory listing
+   *
+   * @param pos  the position of the part in the body
+   * @param buf  the buffer to fill
+   * @param max  the size of the buffer
+   *
+   * @return the number of bytes written to buf, -1 at the end of the body
+   */
+  ssize_t
+  ReadBody (uint64_t pos, char *buf, size_t max);
+
+  /**
+   * Append the response nodes of the next batch of directory entries to the
+   * stream buffer
+   *
+   * @return false if the directory has no more entries
+   */
+  bool
+  StreamNextBatch ();
+
   /**
    * Check the request XML to find out which properties were requested and
    * will therefore need to be returned.
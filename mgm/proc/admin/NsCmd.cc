@@ -546,6 +546,13 @@ NsCmd::CompactSubcmd(const eos::console::NsProto_CompactProto& compact,
     return;
   }
 
+  if (compact.status()) {
+    XrdOucString status;
+    master->PrintOutCompacting(status);
+    reply.set_std_out(std::string(status.c_str()) + "\n");
+    return;
+  }
+
   if (mVid.uid == 0) {
     if (compact.on()) {
       master->ScheduleOnlineCompacting((time(NULL) + compact.delay()),
@@ -565,9 +572,10 @@ NsCmd::CompactSubcmd(const eos::console::NsProto_CompactProto& compact,
         master->SetCompactingType(true, true, true);
       }
 
+      master->SetCompactingIncremental(compact.incremental());
       std::ostringstream oss;
-      oss << "success: configured online compacting to run in "
-          << compact.delay()
+      oss << "success: configured " << (compact.incremental() ? "incremental " : "")
+          << "online compacting to run in " << compact.delay()
           << " seconds from now (might be delayed up to 60 seconds)";
 
       if (compact.interval()) {
@@ -25,6 +25,7 @@
 #include "mgm/proc/ProcInterface.hh"
 #include "mgm/XrdMgmOfs.hh"
 #include "mgm/Egroup.hh"
+#include "mgm/LRU.hh"
 #include "namespace/interface/IChLogFileMDSvc.hh"
 #include "namespace/interface/IChLogContainerMDSvc.hh"
 #include "namespace/interface/IFsView.hh"
@@ -95,6 +96,13 @@ ProcCommand::Space()
 
         stdOut += line;
       }
+
+      if (space == "default") {
+        // the LRU engine is configured in the default space
+        std::string lru_stats;
+        gOFS->LRUd.PrintIndexStats(lru_stats, fmtstr);
+        stdOut += lru_stats.c_str();
+      }
     } else {
       stdErr = "error: cannot find space - no space with name=";
       stdErr += space.c_str();
@@ -484,6 +492,7 @@ ProcCommand::Space()
                 (key == "converter") ||
                 (key == "lru") ||
                 (key == "lru.interval") ||
+                (key == "lru.rescan") ||
                 (key == "wfe") ||
                 (key == "wfe.interval") ||
                 (key == "wfe.ntx") ||
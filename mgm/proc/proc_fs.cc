@@ -351,7 +351,7 @@ proc_fs_config(std::string& identifier, std::string& key, std::string& value,
             (key == "scanrate") || (key == "graceperiod") ||
             (key == "drainperiod") || (key == "proxygroup") ||
             (key == "filestickyproxydepth") || (key == "forcegeotag") ||
-            (key == "s3credentials")))) {
+            (key == "s3credentials") || (key == "ioengine")))) {
         // Check permissions
         size_t dpos = 0;
         std::string nodename = fs->GetString("host");
@@ -446,6 +446,15 @@ proc_fs_config(std::string& identifier, std::string& key, std::string& value,
             }
           }
 
+          fs->SetString(key.c_str(), value.c_str());
+          FsView::gFsView.StoreFsConfig(fs);
+        } else if (key == "ioengine") {
+          if ((value != "psync") && (value != "uring")) {
+            stdErr += "error: ioengine must be one of psync|uring";
+            retc = EINVAL;
+            return retc;
+          }
+
           fs->SetString(key.c_str(), value.c_str());
           FsView::gFsView.StoreFsConfig(fs);
         } else {
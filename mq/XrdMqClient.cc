@@ -63,6 +63,15 @@ XrdMqClient::XrdMqClient(const char* clientid, const char* brokerurl,
   kMessageBuffer = "";
   kRecvBuffer = nullptr;
   kRecvBufferAlloc = 0;
+  kPushActive = false;
+  // Max time the broker may hold a receive request waiting for new messages,
+  // push mode is opt-in, by default the client polls the broker
+  kPushWait = (getenv("EOS_MQ_PUSH_WAIT_MS") ?
+               atoi(getenv("EOS_MQ_PUSH_WAIT_MS")) : 0);
+
+  if (kPushWait < 0) {
+    kPushWait = 0;
+  }
   // Install sigbus signal handler
   struct sigaction act;
   memset(&act, 0, sizeof(act));
@@ -159,14 +168,14 @@ XrdMqClient::Subscribe(const char* queue)
   for (int i = 0; i < kBrokerN; i++) {
     XrdCl::OpenFlags::Flags flags_xrdcl = XrdCl::OpenFlags::Read;
     XrdCl::File* file = GetBrokerXrdClientReceiver(i);
-    XrdOucString* url = kBrokerUrls.Find(GetBrokerId(i).c_str());
+    std::string url = GetReceiverUrl(i);
 
-    if (!file || !file->Open(url->c_str(), flags_xrdcl).IsOK()) {
+    if (!file || !file->Open(url, flags_xrdcl).IsOK()) {
       // Open failed
-      eos_err("msg=\"failed to subscribe to url: %s\"", url->c_str());
+      eos_err("msg=\"failed to subscribe to url: %s\"", url.c_str());
       continue;
     } else {
-      eos_info("msg=\"successfully subscribed to url: %s\"", url->c_str());
+      eos_info("msg=\"successfully subscribed to url: %s\"", url.c_str());
     }
   }
 
@@ -435,7 +444,11 @@ XrdMqClient::RecvMessage(ThreadAssistant* assistant)
       }
     }
 
+    // Brokers not supporting push mode always return a zero modification time
+    kPushActive = (kPushWait && stinfo->GetModTime());
+
     if (stinfo->GetSize() == 0) {
+      delete stinfo;
       return 0;
     }
 
@@ -517,6 +530,25 @@ XrdMqClient::GetBrokerXrdClientReceiver(int i)
   return kBrokerXrdClientReceiver.Find(GetBrokerId(i).c_str());
 }
 
+//------------------------------------------------------------------------------
+// GetReceiverUrl
+//------------------------------------------------------------------------------
+std::string
+XrdMqClient::GetReceiverUrl(int i)
+{
+  XrdOucString rhostport;
+  XrdCl::URL url(GetBrokerUrl(i, rhostport)->c_str());
+
+  if (kPushWait && url.GetUserName().empty()) {
+    // The broker holds our stat requests in push mode and the server handles
+    // the requests of one connection in sequence. Use a dedicated connection
+    // for receiving so that sending messages is never delayed by a held stat.
+    url.SetUserName("mqpush");
+  }
+
+  return url.GetURL();
+}
+
 //------------------------------------------------------------------------------
 // ReNewBrokerXrdClientReceiver
 //------------------------------------------------------------------------------
@@ -535,10 +567,9 @@ XrdMqClient::ReNewBrokerXrdClientReceiver(int i, ThreadAssistant* assistant)
 
   while (true) {
     auto file = new XrdCl::File();
-    XrdOucString rhostport;
     uint16_t timeout = (getenv("EOS_FST_OP_TIMEOUT") ?
                         atoi(getenv("EOS_FST_OP_TIMEOUT")) : 0);
-    std::string url {GetBrokerUrl(i, rhostport)->c_str()};
+    std::string url = GetReceiverUrl(i);
     XrdCl::XRootDStatus status = file->Open(url, XrdCl::OpenFlags::Read,
                                             XrdCl::Access::None, timeout);
 
@@ -595,6 +626,14 @@ XrdMqClient::AddBroker(const char* brokerurl,
   newBrokerUrl += XMQCADVISORYFLUSHBACKLOG;
   newBrokerUrl += "=";
   newBrokerUrl += advisoryflushbacklog;
+
+  if (kPushWait) {
+    newBrokerUrl += "&";
+    newBrokerUrl += XMQCPUSHWAIT;
+    newBrokerUrl += "=";
+    newBrokerUrl += kPushWait;
+  }
+
   printf("==> new Broker %s\n", newBrokerUrl.c_str());
 
   for (int i = 0; i < kBrokerN; i++) {
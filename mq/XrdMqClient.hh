@@ -152,6 +152,15 @@ public:
     return kInitOK;
   }
 
+  //----------------------------------------------------------------------------
+  //! Check if the broker holds our receive requests until messages arrive. In
+  //! this case callers of RecvMessage don't need to sleep between calls.
+  //----------------------------------------------------------------------------
+  bool IsPushActive() const
+  {
+    return kPushActive;
+  }
+
   void ReNewBrokerXrdClientReceiver(int i, ThreadAssistant* assistant = nullptr);
 
   void CheckBrokerXrdClientReceiver(int i);
@@ -209,6 +218,15 @@ public:
   static DiscardResponseHandler gDiscardResponseHandler;
 
 private:
+  //----------------------------------------------------------------------------
+  //! Get URL used by the receiver of a broker
+  //!
+  //! @param i broker index
+  //!
+  //! @return receiver URL
+  //----------------------------------------------------------------------------
+  std::string GetReceiverUrl(int i);
+
   static XrdSysMutex Mutex;
   XrdOucHash <XrdOucString> kBrokerUrls;
   XrdOucHash <XrdCl::File> kBrokerXrdClientReceiver;
@@ -222,6 +240,8 @@ private:
   int kRecvBufferAlloc;
   size_t kInternalBufferPosition;
   bool kInitOK;
+  int kPushWait; ///< Time in ms the broker may hold a receive, 0 to poll
+  bool kPushActive; ///< Broker confirmed holding receive requests
 };
 
 
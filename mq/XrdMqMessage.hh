@@ -39,6 +39,7 @@
 #define XMQCADVISORYSTATUS       "xmqclient.advisory.status"
 #define XMQCADVISORYQUERY        "xmqclient.advisory.query"
 #define XMQCADVISORYFLUSHBACKLOG "xmqclient.advisory.flushbacklog"
+#define XMQCPUSHWAIT             "xmqclient.pushwait"
 #define XMQCIPHER EVP_des_cbc
 
 //------------------------------------------------------------------------------
@@ -86,7 +86,9 @@ XrdMqMessaging::Listen(ThreadAssistant& assistant) noexcept
       }
     }
 
-    if (new_msg == nullptr) {
+    // In push mode the broker already held the request until timeout
+    if ((new_msg == nullptr) &&
+        !XrdMqMessaging::gMessageClient.IsPushActive()) {
       assistant.wait_for(std::chrono::seconds(1));
     }
   }
@@ -34,8 +34,10 @@
 #include "mq/XrdMqOfs.hh"
 #include "mq/XrdMqMessage.hh"
 #include "mq/XrdMqOfsTrace.hh"
+#include "mq/XrdMqSharedObject.hh"
 #include "common/PasswordHandler.hh"
 #include "namespace/ns_quarkdb/BackendClient.hh"
+#include <algorithm>
 #include <pwd.h>
 #include <grp.h>
 #include <signal.h>
@@ -110,11 +112,25 @@ XrdMqOfsFile::open(const char* queuename, XrdSfsFileOpenMode openMode,
     advisoryflushbacklog = atoi(val);
   }
 
+  if ((val = queueenv.Get(XMQCPUSHWAIT))) {
+    // Client wants its stat requests to wait for new messages
+    long push_wait = atol(val);
+
+    if (push_wait > MQOFSMAXPUSHWAITMS) {
+      push_wait = MQOFSMAXPUSHWAITMS;
+    }
+
+    if (push_wait > 0) {
+      mMsgOut->mPushWait = std::chrono::milliseconds(push_wait);
+    }
+  }
+
   mMsgOut->AdvisoryStatus = advisorystatus;
   mMsgOut->AdvisoryQuery  = advisoryquery;
   mMsgOut->AdvisoryFlushBackLog = advisoryflushbacklog;
   mMsgOut->BrokenByFlush = false;
   gMqFS->mQueueOut.insert(std::make_pair(mQueueName, mMsgOut));
+  gMqFS->mQueueIndex.Add(mQueueName, mMsgOut, advisorystatus, advisoryquery);
   eos_info_lite("connected queue: %s", mQueueName.c_str());
   mIsOpen = true;
   return SFS_OK;
@@ -142,6 +158,21 @@ XrdMqOfsFile::stat(struct stat* buf)
   gMqFS->Statistics();
 
   if (mMsgOut) {
+    bool held = false;
+
+    if (mMsgOut->mPushWait.count()) {
+      // Push mode - hold the request until there is something to deliver
+      // instead of letting the client poll an empty queue. Every held request
+      // parks a worker thread so only a few of them are held at a time, the
+      // others get an immediate answer and make the client poll.
+      if (++gMqFS->mNumHeldStats <= gMqFS->mMaxHeldStats) {
+        held = true;
+        mMsgOut->WaitForMessages(mMsgOut->mPushWait);
+      }
+
+      --gMqFS->mNumHeldStats;
+    }
+
     mMsgOut->DeletionSem.Wait();
     // this should be the case always ...
     ZTRACE(stat, "Waiting for message");
@@ -174,7 +205,8 @@ XrdMqOfsFile::stat(struct stat* buf)
     buf->st_gid    = 0;
     buf->st_size   = mMsgOut->RetrieveMessages();
     buf->st_atime  = 0;
-    buf->st_mtime  = 0;
+    // Tell the client that this broker honoured the push wait
+    buf->st_mtime  = (held ? 1 : 0);
     buf->st_ctime  = 0;
     buf->st_blocks = 1024;
     buf->st_ino    = 0;
@@ -244,6 +276,7 @@ XrdMqOfsFile::close()
       // Take away all pending messages
       mMsgOut->RetrieveMessages();
       gMqFS->mQueueOut.erase(mQueueName);
+      gMqFS->mQueueIndex.Remove(mQueueName);
       delete mMsgOut;
     }
 
@@ -309,7 +342,10 @@ XrdSfsFileSystem* XrdSfsGetFileSystem(XrdSfsFileSystem* native_fs,
 XrdMqOfs::XrdMqOfs(XrdSysError* ep):
   myPort(1097), mDeliveredMessages(0ull), mFanOutMessages(0ull),
   mMaxQueueBacklog(MQOFSMAXQUEUEBACKLOG),
-  mRejectQueueBacklog(MQOFSREJECTQUEUEBACKLOG), mQdbCluster(), mQdbPassword(),
+  mRejectQueueBacklog(MQOFSREJECTQUEUEBACKLOG),
+  mMaxQueueBytes(MQOFSMAXQUEUEBYTES),
+  mCoalesceQueueBytes(MQOFSCOALESCEQUEUEBYTES),
+  mMaxHeldStats(MQOFSMAXHELDSTATS), mQdbCluster(), mQdbPassword(),
   mQdbContactDetails(), mQcl(nullptr), mMasterId(), mMgmId()
 {
   ConfigFN  = 0;
@@ -429,6 +465,28 @@ int XrdMqOfs::Configure(XrdSysError& Eroute)
           }
         }
 
+        if (!strcmp("maxqueuebytes", var)) {
+          if ((val = Config.GetWord())) {
+            uint64_t tmp_val {0};
+            (void) sscanf(val, "%lu", &tmp_val);
+            mMaxQueueBytes = tmp_val;
+          }
+        }
+
+        if (!strcmp("maxheldstats", var)) {
+          if ((val = Config.GetWord())) {
+            mMaxHeldStats = std::max(0, atoi(val));
+          }
+        }
+
+        if (!strcmp("coalescequeuebytes", var)) {
+          if ((val = Config.GetWord())) {
+            uint64_t tmp_val {0};
+            (void) sscanf(val, "%lu", &tmp_val);
+            mCoalesceQueueBytes = tmp_val;
+          }
+        }
+
         if (!strcmp("trace", var)) {
           if ((val = Config.GetWord())) {
             auto& g_logging = eos::common::Logging::GetInstance();
@@ -717,6 +775,21 @@ XrdMqOfs::Statistics()
       rc = write(fd, line, strlen(line));
       sprintf(line, "mq.backloghits            %lld\n", QueueBacklogHits);
       rc = write(fd, line, strlen(line));
+      sprintf(line, "mq.queuedbytes            %llu\n",
+              (unsigned long long) mQueuedBytes);
+      rc = write(fd, line, strlen(line));
+      sprintf(line, "mq.coalesced              %llu\n",
+              (unsigned long long) mCoalescedMessages);
+      rc = write(fd, line, strlen(line));
+      sprintf(line, "mq.budgetdropped          %llu\n",
+              (unsigned long long) mBudgetDroppedMessages);
+      rc = write(fd, line, strlen(line));
+      sprintf(line, "mq.matchcachehits         %llu\n",
+              (unsigned long long) mQueueIndex.GetCacheHits());
+      rc = write(fd, line, strlen(line));
+      sprintf(line, "mq.matchcachemisses       %llu\n",
+              (unsigned long long) mQueueIndex.GetCacheMisses());
+      rc = write(fd, line, strlen(line));
       sprintf(line, "mq.in_rate                %f\n",
               (1000.0 * (ReceivedMessages - LastReceivedMessages) / (tdiff)));
       rc = write(fd, line, strlen(line));
@@ -762,6 +835,12 @@ XrdMqOfs::Statistics()
     ZTRACE(getstats, "#Queues                       : " << mQueueOut.size());
     ZTRACE(getstats, "Deferred  Messages (backlog)  : " << BacklogDeferred);
     ZTRACE(getstats, "Backlog   Messages Hits       : " << QueueBacklogHits);
+    ZTRACE(getstats, "Queued    Bytes               : " << mQueuedBytes);
+    ZTRACE(getstats, "Coalesced Messages            : " << mCoalescedMessages);
+    ZTRACE(getstats, "Budget    Dropped Messages    : " <<
+           mBudgetDroppedMessages);
+    ZTRACE(getstats, "Match     Cache Hits/Misses   : " <<
+           mQueueIndex.GetCacheHits() << "/" << mQueueIndex.GetCacheMisses());
     char rates[4096];
     sprintf(rates,
             "Rates: IN: %.02f OUT: %.02f FAN: %.02f ADV: %.02f: UNDEV: %.02f DISCMON: %.02f NOMSG: %.02f"
@@ -1243,6 +1322,102 @@ XrdMqOfs::FSctl(const int cmd, XrdSfsFSctl& args, XrdOucErrInfo& error,
 //------------------------------------------------------------------------------
 // Helper Classes & Functions
 //------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// Compute the priority class and coalescing key of a message. Only shared
+// hash updates of a single sender are coalesced, two updates supersede each
+// other if they set exactly the same keys of the same hash.
+//------------------------------------------------------------------------------
+static void
+ClassifyMessage(XrdSmartOucEnv* message, int type, const XrdOucString& sender)
+{
+  if (message->mClassified) {
+    return;
+  }
+
+  message->mClassified = true;
+
+  if ((type == XrdMqMessageHeader::kStatusMessage) ||
+      (type == XrdMqMessageHeader::kQueryMessage)) {
+    message->mPriority = XrdSmartOucEnv::Priority::kHigh;
+    return;
+  }
+
+  if (message->mSize > MQOFSBULKMESSAGESIZE) {
+    message->mPriority = XrdSmartOucEnv::Priority::kBulk;
+  }
+
+  const char* sealed_body = message->Get(XMQBODY);
+
+  if (!sealed_body) {
+    return;
+  }
+
+  XrdOucString body = sealed_body;
+  XrdMqMessage::UnSeal(body);
+  std::string key = sender.c_str();
+
+  if (XrdMqSharedHashCodec::IsEncoded(body.c_str())) {
+    XrdMqSharedHashCodec::Message msg;
+    std::string error;
+
+    if (!XrdMqSharedHashCodec::Decode(body.c_str(), msg, error)) {
+      return;
+    }
+
+    if (msg.mCmd == XrdMqSharedHashCodec::Command::kBroadCastReply) {
+      message->mPriority = XrdSmartOucEnv::Priority::kBulk;
+      return;
+    }
+
+    if (msg.mCmd != XrdMqSharedHashCodec::Command::kUpdate) {
+      return;
+    }
+
+    key += "\n" + msg.mSubject + "\n" + msg.mType;
+
+    for (const auto& entry : msg.mEntries) {
+      key += "\n" + entry.first;
+    }
+  } else if (body.beginswith(XRDMQSHAREDHASH_BCREPLY)) {
+    message->mPriority = XrdSmartOucEnv::Priority::kBulk;
+    return;
+  } else if (body.beginswith(XRDMQSHAREDHASH_UPDATE)) {
+    XrdOucEnv env(body.c_str());
+    const char* subject = env.Get(XRDMQSHAREDHASH_SUBJECT);
+    const char* type = env.Get(XRDMQSHAREDHASH_TYPE);
+    const char* pairs = env.Get(XRDMQSHAREDHASH_PAIRS);
+
+    if (!subject || !type || !pairs) {
+      return;
+    }
+
+    // "|<key1>~<value1>%<changeid1>|<key2>~<value2>%<changeid2> ..."
+    std::vector<std::string> keys;
+
+    for (const char* ptr = strchr(pairs, '|'); ptr; ptr = strchr(ptr, '|')) {
+      const char* end = strchr(++ptr, '~');
+
+      if (!end) {
+        return;
+      }
+
+      keys.emplace_back(ptr, end - ptr);
+    }
+
+    std::sort(keys.begin(), keys.end());
+    key += std::string("\n") + subject + "\n" + type;
+
+    for (const auto& elem : keys) {
+      key += "\n" + elem;
+    }
+  } else {
+    return;
+  }
+
+  message->mCoalesceKey = key;
+}
+
 bool
 XrdMqOfs::Deliver(XrdMqOfsMatches& Matches)
 {
@@ -1254,59 +1429,38 @@ XrdMqOfs::Deliver(XrdMqOfsMatches& Matches)
   std::vector<XrdMqMessageOut*> matched_out_queues;
   Matches.message->procmutex.Lock();
 
-  // If we have a status message we have to do a complete loop
+  // Status and query messages go to the queues subscribed to advisories
   if (((Matches.messagetype) == XrdMqMessageHeader::kStatusMessage) ||
       ((Matches.messagetype) == XrdMqMessageHeader::kQueryMessage)) {
-    for (auto it = mQueueOut.begin(); it != mQueueOut.end(); ++it) {
-      XrdMqMessageOut* msg_out = it->second;
+    const XrdMqSubscriptionIndex::QueueList& advisory_queues =
+      ((Matches.messagetype == XrdMqMessageHeader::kStatusMessage) ?
+       mQueueIndex.GetAdvisoryStatusQueues() :
+       mQueueIndex.GetAdvisoryQueryQueues());
 
+    for (const auto& elem : advisory_queues) {
       // If this is be a loop back message we continue
-      if (sendername == it->first) {
+      if (sendername == elem.first) {
         // avoid feedback to the same queue
         continue;
       }
 
-      // If this queue does not take advisory status messages we continue
-      if ((Matches.messagetype == XrdMqMessageHeader::kStatusMessage) &&
-          (!msg_out->AdvisoryStatus)) {
-        continue;
-      }
-
-      // if this queue does not take advisory query messages we continue
-      if ((Matches.messagetype == XrdMqMessageHeader::kQueryMessage)  &&
-          (!msg_out->AdvisoryQuery)) {
-        continue;
-      } else {
-        ZTRACE(fsctl, "Adding Advisory Message to Queuename: " <<
-               msg_out->QueueName.c_str());
-        matched_out_queues.push_back(msg_out);
-      }
+      ZTRACE(fsctl, "Adding Advisory Message to Queuename: " <<
+             elem.second->QueueName.c_str());
+      matched_out_queues.push_back(elem.second);
     }
   } else {
-    // If we have a wildcard match we have to do a complete loop
+    // If we have a wildcard match the index resolves the matching queues
     if ((Matches.queuename.find("*") != STR_NPOS)) {
-      for (auto it = mQueueOut.begin(); it != mQueueOut.end(); ++it) {
-        XrdMqMessageOut* msg_out = it->second;
-
-        // fprintf(stderr,"current queue name: %s <=> sender :%s\n",
-        //        it->first.c_str(), sendername.c_str());
+      for (const auto& elem : mQueueIndex.Match(Matches.queuename.c_str())) {
         // If this would be a loop back message we continue
-        if (sendername == it->first) {
+        if (sendername == elem.first) {
           // avoid feedback to the same queue
           continue;
         }
 
-        XrdOucString Key = it->first.c_str();
-        XrdOucString nowildcard = Matches.queuename;
-        nowildcard.replace("*", "");
-        int nmatch = Key.matches(Matches.queuename.c_str(), '*');
-
-        if (nmatch == nowildcard.length()) {
-          // this is a match
-          ZTRACE(fsctl, "Adding Wildcard matched Message to Queuename: "
-                 << msg_out->QueueName.c_str());
-          matched_out_queues.push_back(msg_out);
-        }
+        ZTRACE(fsctl, "Adding Wildcard matched Message to Queuename: "
+               << elem.second->QueueName.c_str());
+        matched_out_queues.push_back(elem.second);
       }
     } else {
       // We have just to find one named queue
@@ -1384,24 +1538,57 @@ XrdMqOfs::Deliver(XrdMqOfsMatches& Matches)
           TRACES("error: queue " << msg_out->QueueName
                  << " exceeds max. accepted backlog of " << mRejectQueueBacklog
                  << " message!");
-      } else {
-        if (!msg_out->BrokenByFlush) {
-          // We deliver only to not broken clients, they have to reconnect to
-          // get out of this situation
-          Matches.matches++;
-
-          if (Matches.matches == 1) {
-            // add to the message hash
-            std::string messageid = Matches.message->Get(XMQHEADER);
-            XrdSysMutexHelper scope_lock(gMqFS->mMsgsMutex);
-            gMqFS->Messages.insert(std::pair<std::string, XrdSmartOucEnv*> (messageid,
-                                   Matches.message));
+      } else if (!msg_out->BrokenByFlush) {
+        // We deliver only to not broken clients, they have to reconnect to
+        // get out of this situation
+        bool coalesce = (mCoalesceQueueBytes &&
+                         (msg_out->mQueuedBytes >= mCoalesceQueueBytes));
+
+        if (coalesce || (mMaxQueueBytes && (msg_out->mQueuedBytes +
+                                            Matches.message->mSize > mMaxQueueBytes / 2))) {
+          // Only receivers with a large backlog need to look into the message
+          ClassifyMessage(Matches.message, Matches.messagetype, Matches.sendername);
+        }
+
+        if (!msg_out->HasBudget(Matches.message, mMaxQueueBytes)) {
+          // Only set the reject flag if the queue has not set the advisory
+          // flush back log flag
+          if (!msg_out->AdvisoryFlushBackLog) {
+            Matches.backlogrejected = true;
+          } else {
+            msg_out->BrokenByFlush = true;
+            TRACES("warning: queue " << msg_out->QueueName
+                   << " is broken by byte budget flush of " << mMaxQueueBytes
+                   << " bytes!");
           }
 
-          ZTRACE(fsctl, "Adding Message to Queuename: " << msg_out->QueueName.c_str());
-          msg_out->mMsgQueue.push_back(Matches.message);
-          Matches.message->AddRefs(1);
+          Matches.backlogqueues += msg_out->QueueName;
+          Matches.backlogqueues += ":";
+          ++mBudgetDroppedMessages;
+          ZTRACE(fsctl, "Dropping Message over byte budget of Queuename: "
+                 << msg_out->QueueName.c_str());
+          continue;
+        }
+
+        // The superseded message is only dropped once the new one is accepted
+        if (coalesce && !Matches.message->mCoalesceKey.empty() &&
+            msg_out->CoalesceMessage(Matches.message)) {
+          ++mCoalescedMessages;
+        }
+
+        Matches.matches++;
+
+        if (Matches.matches == 1) {
+          // add to the message hash
+          std::string messageid = Matches.message->Get(XMQHEADER);
+          XrdSysMutexHelper scope_lock(gMqFS->mMsgsMutex);
+          gMqFS->Messages.insert(std::pair<std::string, XrdSmartOucEnv*> (messageid,
+                                 Matches.message));
         }
+
+        ZTRACE(fsctl, "Adding Message to Queuename: " << msg_out->QueueName.c_str());
+        msg_out->PushMessage(Matches.message, coalesce);
+        Matches.message->AddRefs(1);
       }
     }
 
@@ -1409,6 +1596,11 @@ XrdMqOfs::Deliver(XrdMqOfsMatches& Matches)
     for (auto msg_out : matched_out_queues) {
       msg_out->UnLock();
     }
+
+    // Wake up clients waiting in push mode
+    for (auto msg_out : matched_out_queues) {
+      msg_out->NotifyMessages();
+    }
   }
 
   Matches.message->procmutex.UnLock();
@@ -1433,6 +1625,24 @@ XrdMqMessageOut::RetrieveMessages()
   while (mMsgQueue.size()) {
     message = mMsgQueue.front();
     mMsgQueue.pop_front();
+    ++mNumPopped;
+
+    if (!message) {
+      // Superseded by a later update
+      continue;
+    }
+
+    mQueuedBytes -= message->mSize;
+    gMqFS->mQueuedBytes -= message->mSize;
+
+    if (!message->mCoalesceKey.empty()) {
+      auto it = mCoalesce.find(message->mCoalesceKey);
+
+      if ((it != mCoalesce.end()) && (it->second.first == message)) {
+        mCoalesce.erase(it);
+      }
+    }
+
     message->procmutex.Lock();
     // fprintf(stderr,"%llu %s Message %llu nref: %d\n", (unsigned long long)
     // &mMsgQueue, QueueName.c_str(), (unsigned long long) message, message->Refs());
@@ -1460,3 +1670,129 @@ XrdMqMessageOut::RetrieveMessages()
 
   return mMsgBuffer.length();
 }
+
+//------------------------------------------------------------------------------
+// Check if a message fits in the byte budget of this queue
+//------------------------------------------------------------------------------
+bool
+XrdMqMessageOut::HasBudget(const XrdSmartOucEnv* message,
+                           uint64_t max_bytes) const
+{
+  if (!max_bytes) {
+    return true;
+  }
+
+  switch (message->mPriority) {
+  case XrdSmartOucEnv::Priority::kHigh:
+    // Heartbeats are tiny and must reach the receiver to keep it alive
+    return true;
+
+  case XrdSmartOucEnv::Priority::kBulk:
+    return (mQueuedBytes + message->mSize <= max_bytes / 2);
+
+  default:
+    return (mQueuedBytes + message->mSize <= max_bytes);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Append message to the queue
+//------------------------------------------------------------------------------
+void
+XrdMqMessageOut::PushMessage(XrdSmartOucEnv* message, bool track)
+{
+  mMsgQueue.push_back(message);
+  mQueuedBytes += message->mSize;
+  gMqFS->mQueuedBytes += message->mSize;
+
+  if (track && !message->mCoalesceKey.empty()) {
+    mCoalesce[message->mCoalesceKey] = std::make_pair(message, mNumPushed);
+  }
+
+  ++mNumPushed;
+}
+
+//------------------------------------------------------------------------------
+// Drop a queued message superseded by the given one
+//------------------------------------------------------------------------------
+bool
+XrdMqMessageOut::CoalesceMessage(XrdSmartOucEnv* message)
+{
+  auto it = mCoalesce.find(message->mCoalesceKey);
+
+  if (it == mCoalesce.end()) {
+    return false;
+  }
+
+  XrdSmartOucEnv* old_message = it->second.first;
+  uint64_t index = it->second.second - mNumPopped;
+  mCoalesce.erase(it);
+
+  if ((index >= mMsgQueue.size()) || (mMsgQueue[index] != old_message)) {
+    return false;
+  }
+
+  // Leave a hole in the queue, it is skipped when retrieving the messages
+  mMsgQueue[index] = nullptr;
+  mQueuedBytes -= old_message->mSize;
+  gMqFS->mQueuedBytes -= old_message->mSize;
+  old_message->procmutex.Lock();
+  old_message->DecRefs();
+
+  if (old_message->Refs() <= 0) {
+    std::string msg_id = old_message->Get(XMQHEADER);
+    {
+      XrdSysMutexHelper scope_lock(gMqFS->mMsgsMutex);
+      gMqFS->Messages.erase(msg_id.c_str());
+    }
+    old_message->procmutex.UnLock();
+    delete old_message;
+  } else {
+    old_message->procmutex.UnLock();
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Check if there are messages pending for this queue
+//------------------------------------------------------------------------------
+bool
+XrdMqMessageOut::HasMessages() const
+{
+  XrdSysMutexHelper scope_lock(mMutex);
+  return (!mMsgQueue.empty() || !mMsgBuffer.empty());
+}
+
+//------------------------------------------------------------------------------
+// Wait until messages are pending for this queue or the timeout expires
+//------------------------------------------------------------------------------
+bool
+XrdMqMessageOut::WaitForMessages(std::chrono::milliseconds timeout)
+{
+  using namespace std::chrono;
+  auto deadline = steady_clock::now() + timeout;
+  XrdSysCondVarHelper cond_lock(mMsgCond);
+
+  while (!HasMessages()) {
+    auto remaining = duration_cast<milliseconds>(deadline - steady_clock::now());
+
+    if (remaining.count() <= 0) {
+      return false;
+    }
+
+    mMsgCond.WaitMS(remaining.count());
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Wake up a client waiting for messages on this queue
+//------------------------------------------------------------------------------
+void
+XrdMqMessageOut::NotifyMessages()
+{
+  XrdSysCondVarHelper cond_lock(mMsgCond);
+  mMsgCond.Signal();
+}
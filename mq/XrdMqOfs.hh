@@ -32,6 +32,7 @@
 #include "XrdSys/XrdSysPthread.hh"
 #include "XrdSys/XrdSysSemWait.hh"
 #include "common/Logging.hh"
+#include "mq/XrdMqSubscriptionIndex.hh"
 #include "namespace/ns_quarkdb/QdbContactDetails.hh"
 #include <sys/types.h>
 #include <unistd.h>
@@ -43,12 +44,24 @@
 #include <string>
 #include <vector>
 #include <deque>
+#include <unordered_map>
 #include <atomic>
+#include <chrono>
 
 // if we have too many messages pending we don't take new ones for the moment
 #define MQOFSMAXMESSAGEBACKLOG 100000
 #define MQOFSMAXQUEUEBACKLOG 50000
 #define MQOFSREJECTQUEUEBACKLOG 100000
+// max bytes queued for a single receiver, bulk messages get half of it
+#define MQOFSMAXQUEUEBYTES (128 * 1024 * 1024)
+// queued bytes above which superseded shared hash updates are coalesced
+#define MQOFSCOALESCEQUEUEBYTES (4 * 1024 * 1024)
+// messages larger than this are treated as bulk messages
+#define MQOFSBULKMESSAGESIZE (64 * 1024)
+// max time a stat request waits for new messages in push mode
+#define MQOFSMAXPUSHWAITMS 1000
+// max number of stat requests held at the same time in push mode
+#define MQOFSMAXHELDSTATS 16
 
 #define MAYREDIRECT {                                         \
     int port=0;                                               \
@@ -74,9 +87,23 @@ class QClient;
 class XrdSmartOucEnv : public XrdOucEnv
 {
 public:
+  //----------------------------------------------------------------------------
+  //! Priority classes deciding which messages are dropped first when a
+  //! receiver runs out of its queue budget
+  //----------------------------------------------------------------------------
+  enum class Priority {
+    kHigh, ///< Advisory status and query messages i.e. heartbeats
+    kNormal, ///< Updates and point to point messages
+    kBulk ///< Broadcast replies and large messages
+  };
+
   XrdSmartOucEnv(const char* vardata = 0, int vardlen = 0) :
     XrdOucEnv(vardata, vardlen), nref(0)
-  {}
+  {
+    int len = 0;
+    Env(len);
+    mSize = len;
+  }
 
   virtual ~XrdSmartOucEnv() {}
 
@@ -96,6 +123,13 @@ public:
   }
 
   XrdSysMutex procmutex;
+  size_t mSize {0}; ///< Size of the message in bytes
+  //! Priority and coalescing key have been computed, they are only needed
+  //! for receivers with a large backlog
+  bool mClassified {false};
+  Priority mPriority {Priority::kNormal}; ///< Message priority class
+  //! Messages with the same non-empty key supersede each other
+  std::string mCoalesceKey;
 
 private:
   std::atomic<int> nref;
@@ -181,6 +215,56 @@ public:
   //----------------------------------------------------------------------------
   size_t RetrieveMessages();
 
+  //----------------------------------------------------------------------------
+  //! Check if there are messages pending for this queue
+  //----------------------------------------------------------------------------
+  bool HasMessages() const;
+
+  //----------------------------------------------------------------------------
+  //! Wait until messages are pending for this queue or the timeout expires
+  //!
+  //! @param timeout max time to wait
+  //!
+  //! @return true if messages are pending, otherwise false
+  //----------------------------------------------------------------------------
+  bool WaitForMessages(std::chrono::milliseconds timeout);
+
+  //----------------------------------------------------------------------------
+  //! Wake up a client waiting for messages on this queue. Must be called
+  //! without holding the queue lock.
+  //----------------------------------------------------------------------------
+  void NotifyMessages();
+
+  //----------------------------------------------------------------------------
+  //! Check if a message fits in the byte budget of this queue. Must be called
+  //! with the queue lock held.
+  //!
+  //! @param message classified message
+  //! @param max_bytes byte budget of the queue, 0 means unlimited
+  //!
+  //! @return true if the message can be queued, otherwise false
+  //----------------------------------------------------------------------------
+  bool HasBudget(const XrdSmartOucEnv* message, uint64_t max_bytes) const;
+
+  //----------------------------------------------------------------------------
+  //! Append message to the queue. Must be called with the queue lock held.
+  //!
+  //! @param message message to append
+  //! @param track track the message so that a later update with the same
+  //!        coalescing key can replace it
+  //----------------------------------------------------------------------------
+  void PushMessage(XrdSmartOucEnv* message, bool track);
+
+  //----------------------------------------------------------------------------
+  //! Drop a queued message superseded by the given one. Must be called with
+  //! the queue lock held.
+  //!
+  //! @param message classified message about to be queued
+  //!
+  //! @return true if a message was dropped, otherwise false
+  //----------------------------------------------------------------------------
+  bool CoalesceMessage(XrdSmartOucEnv* message);
+
   bool AdvisoryStatus;
   bool AdvisoryQuery;
   bool AdvisoryFlushBackLog;
@@ -188,10 +272,20 @@ public:
   XrdOucString QueueName;
   std::string mMsgBuffer;
   XrdSysSemWait DeletionSem;
+  //! Queued messages, entries of coalesced messages are null
   std::deque<XrdSmartOucEnv*> mMsgQueue;
+  uint64_t mQueuedBytes {0}; ///< Bytes of the messages in mMsgQueue
+  //! Max time a stat waits for new messages, 0 means polling client
+  std::chrono::milliseconds mPushWait {0};
 
 private:
   mutable XrdSysMutex mMutex; ///< Mutex protecting access to the msg queue
+  uint64_t mNumPushed {0}; ///< Number of messages ever appended to the queue
+  uint64_t mNumPopped {0}; ///< Number of messages ever removed from the queue
+  //! Tracked messages by coalescing key with their sequence number
+  std::unordered_map<std::string, std::pair<XrdSmartOucEnv*, uint64_t>>
+      mCoalesce;
+  XrdSysCondVar mMsgCond; ///< Signalled when new messages are queued
 };
 
 //------------------------------------------------------------------------------
@@ -399,6 +493,14 @@ public:
   long long    MaxMessageBacklog;
   uint64_t     mMaxQueueBacklog;
   uint64_t     mRejectQueueBacklog;
+  uint64_t     mMaxQueueBytes; ///< Byte budget of every queue, 0 unlimited
+  uint64_t     mCoalesceQueueBytes; ///< Queued bytes enabling coalescing
+  std::atomic<uint64_t> mQueuedBytes {0}; ///< Bytes queued over all queues
+  std::atomic<uint64_t> mCoalescedMessages {0}; ///< Superseded and dropped
+  std::atomic<uint64_t> mBudgetDroppedMessages {0}; ///< Over queue budget
+  //! Max number of stat requests holding a worker thread in push mode
+  int          mMaxHeldStats;
+  std::atomic<int> mNumHeldStats {0}; ///< Stat requests currently held
   void         Statistics();
   XrdOucString StatisticsFile;
   char*         ConfigFN;
@@ -408,7 +510,9 @@ private:
   static std::string sLeaseKey;
   //! Hash of all output's connected
   std::map<std::string, XrdMqMessageOut*> mQueueOut;
-  XrdSysMutex mQueueOutMutex;  ///< Mutex protecting the output hash
+  //! Index of the outputs used to resolve broadcast and wildcard receivers
+  XrdMqSubscriptionIndex mQueueIndex;
+  XrdSysMutex mQueueOutMutex;  ///< Mutex protecting the output hash and index
   std::string mQdbCluster; ///< Quarkdb cluster info host1:port1 host2:port2 ..
   std::string mQdbPassword; ///< Quarkdb cluster password
   eos::QdbContactDetails mQdbContactDetails; ///< QuarkDB contact details
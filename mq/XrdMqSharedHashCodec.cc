@@ -0,0 +1,257 @@
+// ----------------------------------------------------------------------
+// File: XrdMqSharedHashCodec.cc
+// ----------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2019 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "mq/XrdMqSharedHashCodec.hh"
+#include <algorithm>
+#include <cstring>
+
+constexpr int XrdMqSharedHashCodec::kVersion;
+
+//! Prefix of every encoded message
+static const char sMagic[] = "mqsb";
+static const size_t sMagicLen = sizeof(sMagic) - 1;
+
+//------------------------------------------------------------------------------
+// Constructor - start a new message
+//------------------------------------------------------------------------------
+XrdMqSharedHashCodec::XrdMqSharedHashCodec(Command cmd,
+    const std::string& subject,
+    const std::string& type)
+{
+  mOut = sMagic;
+  mOut += std::to_string(kVersion);
+  mOut += static_cast<char>(cmd);
+  EncodeString(mOut, subject);
+  EncodeString(mOut, type);
+}
+
+//------------------------------------------------------------------------------
+// Append an updated key to an update or broadcast reply message
+//------------------------------------------------------------------------------
+void
+XrdMqSharedHashCodec::AddPair(const std::string& key, const std::string& value)
+{
+  EncodeKey(key);
+  EncodeString(mOut, value);
+}
+
+//------------------------------------------------------------------------------
+// Append a deleted key to a deletion message
+//------------------------------------------------------------------------------
+void
+XrdMqSharedHashCodec::AddKey(const std::string& key)
+{
+  EncodeKey(key);
+}
+
+//------------------------------------------------------------------------------
+// Check if a message body uses this encoding
+//------------------------------------------------------------------------------
+bool
+XrdMqSharedHashCodec::IsEncoded(const char* body)
+{
+  return (body && (strncmp(body, sMagic, sMagicLen) == 0));
+}
+
+//------------------------------------------------------------------------------
+// Decode message
+//------------------------------------------------------------------------------
+bool
+XrdMqSharedHashCodec::Decode(const std::string& body, Message& msg,
+                             std::string& error)
+{
+  msg.mEntries.clear();
+
+  if ((body.length() < sMagicLen + 2) ||
+      body.compare(0, sMagicLen, sMagic)) {
+    error = "not a compact shared hash message";
+    return false;
+  }
+
+  size_t pos = sMagicLen;
+  int version = body[pos++] - '0';
+
+  if ((version < 1) || (version > kVersion)) {
+    error = "unsupported shared hash encoding version ";
+    error += body[sMagicLen];
+    return false;
+  }
+
+  char cmd = body[pos++];
+
+  if ((cmd != static_cast<char>(Command::kUpdate)) &&
+      (cmd != static_cast<char>(Command::kMuxUpdate)) &&
+      (cmd != static_cast<char>(Command::kBroadCastReply)) &&
+      (cmd != static_cast<char>(Command::kDelete))) {
+    error = "unknown shared hash command ";
+    error += cmd;
+    return false;
+  }
+
+  msg.mCmd = static_cast<Command>(cmd);
+
+  if (!DecodeString(body, pos, msg.mSubject) ||
+      !DecodeString(body, pos, msg.mType)) {
+    error = "parsing error in shared hash header";
+    return false;
+  }
+
+  std::string key;
+  std::string suffix;
+  std::string value;
+
+  while (pos < body.length()) {
+    size_t shared = 0;
+
+    if (!DecodeNumber(body, pos, ',', shared) || (shared > key.length()) ||
+        !DecodeString(body, pos, suffix)) {
+      error = "parsing error in shared hash key";
+      return false;
+    }
+
+    key.resize(shared);
+    key += suffix;
+
+    if ((msg.mCmd != Command::kDelete) && !DecodeString(body, pos, value)) {
+      error = "parsing error in shared hash value";
+      return false;
+    }
+
+    msg.mEntries.emplace_back(key, value);
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Append front coded key
+//------------------------------------------------------------------------------
+void
+XrdMqSharedHashCodec::EncodeKey(const std::string& key)
+{
+  size_t shared = 0;
+  size_t max_shared = std::min(key.length(), mLastKey.length());
+
+  while ((shared < max_shared) && (key[shared] == mLastKey[shared])) {
+    ++shared;
+  }
+
+  mOut += std::to_string(shared);
+  mOut += ',';
+  EncodeString(mOut, key.substr(shared));
+  mLastKey = key;
+  ++mNumRecords;
+}
+
+//------------------------------------------------------------------------------
+// Append length prefixed string with '#' escaped
+//------------------------------------------------------------------------------
+void
+XrdMqSharedHashCodec::EncodeString(std::string& out, const std::string& data)
+{
+  if (data.find('#') == std::string::npos) {
+    out += std::to_string(data.length());
+    out += ':';
+    out += data;
+    return;
+  }
+
+  // The "#and#" seal of the message body must not appear in the data
+  std::string escaped;
+  escaped.reserve(data.length() + 8);
+
+  for (auto c : data) {
+    if (c == '#') {
+      escaped += "#23";
+    } else {
+      escaped += c;
+    }
+  }
+
+  out += std::to_string(escaped.length());
+  out += ':';
+  out += escaped;
+}
+
+//------------------------------------------------------------------------------
+// Decode a decimal number terminated by the given character starting at pos
+// and move pos after the terminator
+//------------------------------------------------------------------------------
+bool
+XrdMqSharedHashCodec::DecodeNumber(const std::string& body, size_t& pos,
+                                   char term, size_t& number)
+{
+  size_t start = pos;
+  number = 0;
+
+  while ((pos < body.length()) && (body[pos] >= '0') && (body[pos] <= '9')) {
+    number = number * 10 + (body[pos] - '0');
+    ++pos;
+  }
+
+  // Messages are limited to a few MB, longer numbers are corrupted
+  if ((pos == start) || (pos - start > 9) || (pos >= body.length()) ||
+      (body[pos] != term)) {
+    return false;
+  }
+
+  ++pos;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Decode length prefixed string starting at pos and move pos after it
+//------------------------------------------------------------------------------
+bool
+XrdMqSharedHashCodec::DecodeString(const std::string& body, size_t& pos,
+                                   std::string& data)
+{
+  size_t len = 0;
+
+  if (!DecodeNumber(body, pos, ':', len) || (body.length() - pos < len)) {
+    return false;
+  }
+
+  size_t end = pos + len;
+  size_t hash = body.find('#', pos);
+
+  if ((hash == std::string::npos) || (hash >= end)) {
+    data.assign(body, pos, len);
+    pos = end;
+    return true;
+  }
+
+  data.clear();
+
+  while (pos < end) {
+    if (body[pos] != '#') {
+      data += body[pos++];
+    } else if ((end - pos >= 3) && (body.compare(pos, 3, "#23") == 0)) {
+      data += '#';
+      pos += 3;
+    } else {
+      return false;
+    }
+  }
+
+  return true;
+}
@@ -0,0 +1,168 @@
+// ----------------------------------------------------------------------
+// File: XrdMqSharedHashCodec.hh
+// ----------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2019 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#ifndef __XRDMQ_SHAREDHASHCODEC_HH__
+#define __XRDMQ_SHAREDHASHCODEC_HH__
+
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------
+//! Class XrdMqSharedHashCodec - compact, versioned encoding of shared hash
+//! updates, multiplexed updates, broadcast replies and deletions.
+//!
+//! Strings are written as "<decimal length>:<bytes>" so that the decoder never
+//! has to scan for delimiters and keys or values may contain any character.
+//! Keys are sent in sorted order and front coded i.e. only the suffix which
+//! differs from the previous key is sent. Change ids are local to the sender
+//! and are not transmitted. The message travels inside the body of an
+//! XrdMqMessage hence it has to stay free of '\0' and lengths are written in
+//! decimal. The message body seals '&' as "#and#", therefore every '#' of a
+//! string is escaped as "#23" and the length counts the escaped bytes.
+//!
+//! message := "mqsb" <version> <command> string(subject) string(type) record*
+//! record  := <decimal shared prefix> ',' string(suffix) [string(value)]
+//!
+//! Multiplexed updates follow the env encoding convention: the subject is the
+//! '%' separated list of subjects and every key carries the index of its
+//! subject as "#<index>#" prefix.
+//------------------------------------------------------------------------------
+class XrdMqSharedHashCodec
+{
+public:
+  //! Latest version of the encoding, 0 stands for the env encoding
+  static constexpr int kVersion = 1;
+
+  //----------------------------------------------------------------------------
+  //! Message commands
+  //----------------------------------------------------------------------------
+  enum class Command : char {
+    kUpdate = 'u', ///< Update of some keys
+    kMuxUpdate = 'm', ///< Update of some keys of several subjects
+    kBroadCastReply = 'b', ///< Full content of the hash
+    kDelete = 'd' ///< Deletion of some keys, records carry no value
+  };
+
+  //----------------------------------------------------------------------------
+  //! Decoded message
+  //----------------------------------------------------------------------------
+  struct Message {
+    Command mCmd {Command::kUpdate}; ///< Message command
+    std::string mSubject; ///< Hash subject
+    std::string mType; ///< Hash type
+    //! Updated keys and values or deleted keys with empty values
+    std::vector<std::pair<std::string, std::string>> mEntries;
+  };
+
+  //----------------------------------------------------------------------------
+  //! Constructor - start a new message
+  //!
+  //! @param cmd message command
+  //! @param subject hash subject
+  //! @param type hash type
+  //----------------------------------------------------------------------------
+  XrdMqSharedHashCodec(Command cmd, const std::string& subject,
+                       const std::string& type);
+
+  //----------------------------------------------------------------------------
+  //! Append an updated key to an update or broadcast reply message. Keys
+  //! should be added in sorted order for best compression.
+  //!
+  //! @param key entry key
+  //! @param value entry value
+  //----------------------------------------------------------------------------
+  void AddPair(const std::string& key, const std::string& value);
+
+  //----------------------------------------------------------------------------
+  //! Append a deleted key to a deletion message
+  //!
+  //! @param key deleted key
+  //----------------------------------------------------------------------------
+  void AddKey(const std::string& key);
+
+  //----------------------------------------------------------------------------
+  //! Get encoded message
+  //----------------------------------------------------------------------------
+  const std::string& GetMessage() const
+  {
+    return mOut;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get number of records in the message
+  //----------------------------------------------------------------------------
+  size_t GetNumRecords() const
+  {
+    return mNumRecords;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Check if a message body uses this encoding
+  //!
+  //! @param body message body
+  //!
+  //! @return true if body has the compact encoding, otherwise false
+  //----------------------------------------------------------------------------
+  static bool IsEncoded(const char* body);
+
+  //----------------------------------------------------------------------------
+  //! Decode message
+  //!
+  //! @param body message body
+  //! @param msg decoded message
+  //! @param error error message if decoding failed
+  //!
+  //! @return true if successful, otherwise false
+  //----------------------------------------------------------------------------
+  static bool Decode(const std::string& body, Message& msg, std::string& error);
+
+private:
+  std::string mOut; ///< Encoded message
+  std::string mLastKey; ///< Last key added used for front coding
+  size_t mNumRecords {0}; ///< Number of records added
+
+  //----------------------------------------------------------------------------
+  //! Append front coded key
+  //----------------------------------------------------------------------------
+  void EncodeKey(const std::string& key);
+
+  //----------------------------------------------------------------------------
+  //! Append length prefixed string with '#' escaped
+  //----------------------------------------------------------------------------
+  static void EncodeString(std::string& out, const std::string& data);
+
+  //----------------------------------------------------------------------------
+  //! Decode a decimal number terminated by the given character starting at
+  //! pos and move pos after the terminator
+  //----------------------------------------------------------------------------
+  static bool DecodeNumber(const std::string& body, size_t& pos, char term,
+                           size_t& number);
+
+  //----------------------------------------------------------------------------
+  //! Decode length prefixed string starting at pos, undo the '#' escaping
+  //! and move pos after it
+  //----------------------------------------------------------------------------
+  static bool DecodeString(const std::string& body, size_t& pos,
+                           std::string& data);
+};
+
+#endif
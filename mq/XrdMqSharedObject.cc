@@ -30,6 +30,7 @@
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <algorithm>
+#include <fnmatch.h>
 #include <curl/curl.h>
 
 using eos::common::RWMutexReadLock;
@@ -399,8 +400,38 @@ bool
 XrdMqSharedHash::CloseTransaction()
 {
   bool retval = true;
+  int encoding = 0;
 
-  if (mSOM->mBroadcast && mTransactions.size()) {
+  if (mSOM->mBroadcast && (mTransactions.size() || mDeletions.size())) {
+    encoding = mSOM->GetEncoding(mBroadcastQueue);
+  }
+
+  if (mSOM->mBroadcast && mTransactions.size() && encoding) {
+    std::string txmessage;
+    EncodeTransactions(txmessage, XrdMqSharedHashCodec::Command::kUpdate, false);
+
+    if (txmessage.length() > (2 * 1000 * 1000)) {
+      // Same size limit as for the env encoding, send item by item
+      std::set<std::string> transactions;
+      transactions.swap(mTransactions);
+
+      for (auto it = transactions.begin(); it != transactions.end(); ++it) {
+        mTransactions.insert(*it);
+        EncodeTransactions(txmessage, XrdMqSharedHashCodec::Command::kUpdate);
+        XrdMqMessage message("XrdMqSharedHashMessage");
+        message.SetBody(txmessage.c_str());
+        message.MarkAsMonitor();
+        retval &= XrdMqMessaging::gMessageClient.SendMessage(message,
+                  mBroadcastQueue.c_str(), false, false, true);
+      }
+    } else {
+      XrdMqMessage message("XrdMqSharedHashMessage");
+      message.SetBody(txmessage.c_str());
+      message.MarkAsMonitor();
+      retval &= XrdMqMessaging::gMessageClient.SendMessage(message,
+                mBroadcastQueue.c_str(), false, false, true);
+    }
+  } else if (mSOM->mBroadcast && mTransactions.size()) {
     XrdOucString txmessage = "";
     MakeUpdateEnvHeader(txmessage);
     AddTransactionsToEnvString(txmessage, false);
@@ -442,7 +473,15 @@ XrdMqSharedHash::CloseTransaction()
     }
   }
 
-  if (mSOM->mBroadcast && mDeletions.size()) {
+  if (mSOM->mBroadcast && mDeletions.size() && encoding) {
+    std::string txmessage;
+    EncodeDeletions(txmessage);
+    XrdMqMessage message("XrdMqSharedHashMessage");
+    message.SetBody(txmessage.c_str());
+    message.MarkAsMonitor();
+    retval &= XrdMqMessaging::gMessageClient.SendMessage(message,
+              mBroadcastQueue.c_str(), false, false, true);
+  } else if (mSOM->mBroadcast && mDeletions.size()) {
     XrdOucString txmessage = "";
     MakeDeletionEnvHeader(txmessage);
     AddDeletionsToEnvString(txmessage);
@@ -534,6 +573,7 @@ bool
 XrdMqSharedHash::BroadCastEnvString(const char* receiver)
 {
   XrdOucString txmessage = "";
+  int encoding = mSOM->GetEncoding(receiver);
   {
     XrdSysMutexHelper lock(*mTransactMutex);
     mTransactions.clear();
@@ -545,9 +585,18 @@ XrdMqSharedHash::BroadCastEnvString(const char* receiver)
         mTransactions.insert(it->first);
       }
     }
-    MakeBroadCastEnvHeader(txmessage);
-    // This will also clear the mTransactions set
-    AddTransactionsToEnvString(txmessage);
+
+    if (encoding) {
+      std::string encoded;
+      // This will also clear the mTransactions set
+      EncodeTransactions(encoded, XrdMqSharedHashCodec::Command::kBroadCastReply);
+      txmessage = encoded.c_str();
+    } else {
+      MakeBroadCastEnvHeader(txmessage);
+      // This will also clear the mTransactions set
+      AddTransactionsToEnvString(txmessage);
+    }
+
     mIsTransaction = false;
   }
 
@@ -620,6 +669,52 @@ XrdMqSharedHash::AddDeletionsToEnvString(XrdOucString& out)
   mDeletions.clear();
 }
 
+//-------------------------------------------------------------------------------
+// Encode transactions as compact message - this must be called with the
+// mTransactMutex locked.
+//-------------------------------------------------------------------------------
+void
+XrdMqSharedHash::EncodeTransactions(std::string& out,
+                                    XrdMqSharedHashCodec::Command cmd,
+                                    bool clear_after)
+{
+  XrdMqSharedHashCodec codec(cmd, mSubject, mType);
+  {
+    RWMutexReadLock rd_lock(*mStoreMutex);
+
+    for (auto it = mTransactions.begin(); it != mTransactions.end(); ++it) {
+      auto it_store = mStore.find(*it);
+
+      if (it_store != mStore.end()) {
+        codec.AddPair(*it, it_store->second.GetValue());
+      }
+    }
+  }
+  out = codec.GetMessage();
+
+  if (clear_after) {
+    mTransactions.clear();
+  }
+}
+
+//-------------------------------------------------------------------------------
+// Encode deletions as compact message - this must be called with the
+// mTransactMutex locked.
+//-------------------------------------------------------------------------------
+void
+XrdMqSharedHash::EncodeDeletions(std::string& out)
+{
+  XrdMqSharedHashCodec codec(XrdMqSharedHashCodec::Command::kDelete, mSubject,
+                             mType);
+
+  for (auto it = mDeletions.begin(); it != mDeletions.end(); ++it) {
+    codec.AddKey(*it);
+  }
+
+  out = codec.GetMessage();
+  mDeletions.clear();
+}
+
 //-------------------------------------------------------------------------------
 // Build and send broadcast request
 //-------------------------------------------------------------------------------
@@ -641,6 +736,11 @@ XrdMqSharedHash::BroadcastRequest(const char* req_target)
   out += XRDMQSHAREDHASH_TYPE;
   out += "=";
   out += mType.c_str();
+  // Announce the shared hash encoding we understand
+  out += "&";
+  out += XRDMQSHAREDHASH_ENCODING;
+  out += "=";
+  out += XrdMqSharedHashCodec::kVersion;
   message.SetBody(out.c_str());
   message.MarkAsMonitor();
   return XrdMqMessaging::gMessageClient.SendMessage(message, req_target, false,
@@ -2430,6 +2530,9 @@ XrdMqSharedObjectManager::XrdMqSharedObjectManager():
   AutoReplyQueue = "";
   AutoReplyQueueDerive = false;
   IsMuxTransaction = false;
+  // Compact encoding is used with peers supporting it unless disabled
+  mCompactEncoding = !(getenv("EOS_MQ_SHARED_HASH_COMPACT") &&
+                       !atoi(getenv("EOS_MQ_SHARED_HASH_COMPACT")));
   {
     XrdSysMutexHelper mLock(MuxTransactionsMutex);
     MuxTransactions.clear();
@@ -2774,6 +2877,18 @@ XrdMqSharedObjectManager::ParseEnvMessage(XrdMqMessage* message,
     return false;
   }
 
+  if (XrdMqSharedHashCodec::IsEncoded(message->GetBody())) {
+    XrdMqSharedHashCodec::Message msg;
+    std::string decode_error;
+
+    if (!XrdMqSharedHashCodec::Decode(message->GetBody(), msg, decode_error)) {
+      error = decode_error.c_str();
+      return false;
+    }
+
+    return ApplyEncodedMessage(msg, error);
+  }
+
   XrdOucEnv env(message->GetBody());
   int envlen;
   env.Env(envlen);
@@ -2866,6 +2981,12 @@ XrdMqSharedObjectManager::ParseEnvMessage(XrdMqMessage* message,
       sh = GetObject(subjectlist[0].c_str(), type.c_str());
     }
 
+    if ((ftag == XRDMQSHAREDHASH_BCREQUEST) && (reply != "")) {
+      // Remember the encoding understood by the requester
+      const char* encoding = env.Get(XRDMQSHAREDHASH_ENCODING);
+      SetPeerEncoding(reply, (encoding ? atoi(encoding) : 0));
+    }
+
     if ((ftag == XRDMQSHAREDHASH_BCREQUEST) ||
         (ftag == XRDMQSHAREDHASH_DELETE) ||
         (ftag == XRDMQSHAREDHASH_REMOVE)) {
@@ -2911,38 +3032,8 @@ XrdMqSharedObjectManager::ParseEnvMessage(XrdMqMessage* message,
       if (!sh) {
         HashMutex.UnLockRead();
 
-        if (AutoReplyQueueDerive) {
-          AutoReplyQueue = subject.c_str();
-          int pos = 0;
-
-          for (int i = 0; i < 4; i++) {
-            pos = subject.find("/", pos);
-
-            if (i < 3) {
-              if (pos == STR_NPOS) {
-                AutoReplyQueue = "";
-                error = "cannot derive the reply queue from ";
-                error += subject.c_str();
-                return false;
-              } else {
-                pos++;
-              }
-            } else {
-              AutoReplyQueue.erase(pos);
-            }
-          }
-        }
-
-        // create the list of subjects
-        for (size_t i = 0; i < subjectlist.size(); i++) {
-          if (!CreateSharedObject(subjectlist[i].c_str(), AutoReplyQueue.c_str(),
-                                  type.c_str())) {
-            error = "cannot create shared object for ";
-            error += subject.c_str();
-            error += " and type ";
-            error += type.c_str();
-            return false;
-          }
+        if (!CreateMessageSubjects(subject, subjectlist, type, error)) {
+          return false;
         }
 
         {
@@ -3143,6 +3234,246 @@ XrdMqSharedObjectManager::ParseEnvMessage(XrdMqMessage* message,
   return false;
 }
 
+//------------------------------------------------------------------------------
+// Create the subjects of a received message which are not known yet
+//------------------------------------------------------------------------------
+bool
+XrdMqSharedObjectManager::CreateMessageSubjects(const std::string& subject,
+    const std::vector<std::string>& subjectlist, const std::string& type,
+    XrdOucString& error)
+{
+  if (AutoReplyQueueDerive) {
+    AutoReplyQueue = subject.c_str();
+    int pos = 0;
+
+    for (int i = 0; i < 4; i++) {
+      pos = subject.find("/", pos);
+
+      if (i < 3) {
+        if (pos == STR_NPOS) {
+          AutoReplyQueue = "";
+          error = "cannot derive the reply queue from ";
+          error += subject.c_str();
+          return false;
+        } else {
+          pos++;
+        }
+      } else {
+        AutoReplyQueue.erase(pos);
+      }
+    }
+  }
+
+  // create the list of subjects
+  for (size_t i = 0; i < subjectlist.size(); i++) {
+    if (!CreateSharedObject(subjectlist[i].c_str(), AutoReplyQueue.c_str(),
+                            type.c_str())) {
+      error = "cannot create shared object for ";
+      error += subject.c_str();
+      error += " and type ";
+      error += type.c_str();
+      return false;
+    }
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Apply a message in compact encoding
+//------------------------------------------------------------------------------
+bool
+XrdMqSharedObjectManager::ApplyEncodedMessage(
+  const XrdMqSharedHashCodec::Message& msg, XrdOucString& error)
+{
+  using Command = XrdMqSharedHashCodec::Command;
+
+  if (msg.mCmd == Command::kMuxUpdate) {
+    return ApplyEncodedMuxMessage(msg, error);
+  }
+
+  XrdMqSharedHash* sh = nullptr;
+  {
+    RWMutexReadLock lock(HashMutex);
+    sh = GetObject(msg.mSubject.c_str(), msg.mType.c_str());
+  }
+
+  if (!sh) {
+    if (msg.mCmd == Command::kDelete) {
+      error = "delete: don't know this subject ";
+      error += msg.mSubject.c_str();
+      return false;
+    }
+
+    // Automatically create the subject, if it does not exist
+    if (!CreateMessageSubjects(msg.mSubject, {msg.mSubject}, msg.mType, error)) {
+      return false;
+    }
+  }
+
+  RWMutexReadLock lock(HashMutex);
+  // From here on we have a read lock on 'sh'
+  sh = GetObject(msg.mSubject.c_str(), msg.mType.c_str());
+
+  if (!sh) {
+    error = "update: subject ";
+    error += msg.mSubject.c_str();
+    error += " does not exist (FATAL!)";
+    return false;
+  }
+
+  if (msg.mCmd == Command::kDelete) {
+    for (const auto& entry : msg.mEntries) {
+      sh->Delete(entry.first, false);
+    }
+
+    return true;
+  }
+
+  if (msg.mCmd == Command::kBroadCastReply) {
+    // We don't have to broad cast this clear => it is a broad cast reply
+    sh->Clear(false);
+  }
+
+  for (const auto& entry : msg.mEntries) {
+    if (sDebug) {
+      fprintf(stderr,
+              "XrdMqSharedObjectManager::ApplyEncodedMessage=>Setting [%s] %s=> %s\n",
+              msg.mSubject.c_str(), entry.first.c_str(), entry.second.c_str());
+    }
+
+    // Set entry without broadcast
+    sh->Set(entry.first.c_str(), entry.second.c_str(), false);
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Apply a multiplexed update in compact encoding
+//------------------------------------------------------------------------------
+bool
+XrdMqSharedObjectManager::ApplyEncodedMuxMessage(
+  const XrdMqSharedHashCodec::Message& msg, XrdOucString& error)
+{
+  std::vector<std::string> subjectlist;
+  eos::common::StringConversion::Tokenize(msg.mSubject, subjectlist, "%");
+
+  if (subjectlist.empty()) {
+    error = "update: no subject in multiplexed message";
+    return false;
+  }
+
+  bool missing = false;
+  {
+    RWMutexReadLock lock(HashMutex);
+
+    for (const auto& subject : subjectlist) {
+      if (!GetObject(subject.c_str(), msg.mType.c_str())) {
+        missing = true;
+        break;
+      }
+    }
+  }
+
+  // Automatically create the subjects, if they don't exist
+  if (missing && !CreateMessageSubjects(msg.mSubject, subjectlist, msg.mType,
+                                        error)) {
+    return false;
+  }
+
+  RWMutexReadLock lock(HashMutex);
+
+  for (const auto& entry : msg.mEntries) {
+    // Every key carries the #<subject-index># prefix
+    size_t pos = entry.first.find('#', 1);
+    size_t index = subjectlist.size();
+
+    if ((entry.first[0] == '#') && (pos != std::string::npos) && (pos > 1)) {
+      try {
+        index = std::stoul(entry.first.substr(1, pos - 1));
+      } catch (...) {}
+    }
+
+    if (index >= subjectlist.size()) {
+      error = "update: parsing error in multiplexed key ";
+      error += entry.first.c_str();
+      return false;
+    }
+
+    XrdMqSharedHash* sh = GetObject(subjectlist[index].c_str(),
+                                    msg.mType.c_str());
+
+    if (!sh) {
+      error = "update: subject ";
+      error += subjectlist[index].c_str();
+      error += " does not exist (FATAL!)";
+      return false;
+    }
+
+    // Set entry without broadcast
+    sh->Set(entry.first.c_str() + pos + 1, entry.second.c_str(), false);
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Record the shared hash encoding understood by a peer
+//------------------------------------------------------------------------------
+void
+XrdMqSharedObjectManager::SetPeerEncoding(const std::string& peer, int version)
+{
+  if (version > XrdMqSharedHashCodec::kVersion) {
+    version = XrdMqSharedHashCodec::kVersion;
+  }
+
+  XrdSysMutexHelper scope_lock(mEncodingMutex);
+  auto it = mPeerEncodings.find(peer);
+
+  if ((it == mPeerEncodings.end()) || (it->second != version)) {
+    mPeerEncodings[peer] = version;
+    mTargetEncodings.clear();
+  }
+}
+
+//------------------------------------------------------------------------------
+// Get the shared hash encoding to use for messages sent to a target
+//------------------------------------------------------------------------------
+int
+XrdMqSharedObjectManager::GetEncoding(const std::string& target)
+{
+  if (!mCompactEncoding) {
+    return 0;
+  }
+
+  XrdSysMutexHelper scope_lock(mEncodingMutex);
+  auto it = mTargetEncodings.find(target);
+
+  if (it != mTargetEncodings.end()) {
+    return it->second;
+  }
+
+  // Unknown targets and targets matching a peer which did not announce the
+  // compact encoding get the env encoding
+  int version = -1;
+
+  for (const auto& peer : mPeerEncodings) {
+    if (fnmatch(target.c_str(), peer.first.c_str(), 0) == 0) {
+      if ((version == -1) || (peer.second < version)) {
+        version = peer.second;
+      }
+    }
+  }
+
+  if (version == -1) {
+    version = 0;
+  }
+
+  mTargetEncodings[target] = version;
+  return version;
+}
+
 //------------------------------------------------------------------------------
 //
 //------------------------------------------------------------------------------
@@ -3171,11 +3502,20 @@ XrdMqSharedObjectManager::CloseMuxTransaction()
   XrdSysMutexHelper mLock(MuxTransactionsMutex);
 
   if (MuxTransactions.size()) {
-    XrdOucString txmessage = "";
-    MakeMuxUpdateEnvHeader(txmessage);
-    AddMuxTransactionEnvString(txmessage);
     XrdMqMessage message("XrdMqSharedHashMessage");
-    message.SetBody(txmessage.c_str());
+
+    // Same encoding negotiation as for the single hash transactions
+    if (GetEncoding(MuxTransactionBroadCastQueue)) {
+      std::string txmessage;
+      EncodeMuxTransactions(txmessage);
+      message.SetBody(txmessage.c_str());
+    } else {
+      XrdOucString txmessage = "";
+      MakeMuxUpdateEnvHeader(txmessage);
+      AddMuxTransactionEnvString(txmessage);
+      message.SetBody(txmessage.c_str());
+    }
+
     message.MarkAsMonitor();
     XrdMqMessaging::gMessageClient.SendMessage(message,
         MuxTransactionBroadCastQueue.c_str(), false, false, true);
@@ -3262,6 +3602,47 @@ XrdMqSharedObjectManager::AddMuxTransactionEnvString(XrdOucString& out)
   }
 }
 
+//------------------------------------------------------------------------------
+// Encode the multiplexed transactions as compact message
+//------------------------------------------------------------------------------
+void
+XrdMqSharedObjectManager::EncodeMuxTransactions(std::string& out)
+{
+  std::string subjects;
+
+  for (auto it = MuxTransactions.begin(); it != MuxTransactions.end(); ++it) {
+    if (!subjects.empty()) {
+      subjects += "%";
+    }
+
+    subjects += it->first;
+  }
+
+  XrdMqSharedHashCodec codec(XrdMqSharedHashCodec::Command::kMuxUpdate,
+                             subjects, MuxTransactionType);
+  size_t index = 0;
+
+  for (auto it_subj = MuxTransactions.begin(); it_subj != MuxTransactions.end();
+       ++it_subj, ++index) {
+    XrdMqSharedHash* hash = GetObject(it_subj->first.c_str(),
+                                      MuxTransactionType.c_str());
+
+    if (hash) {
+      std::string prefix = "#" + std::to_string(index) + "#";
+      RWMutexReadLock lock(*(hash->mStoreMutex));
+
+      for (auto it = it_subj->second.begin(); it != it_subj->second.end(); ++it) {
+        auto it_store = hash->mStore.find(*it);
+
+        if (it_store != hash->mStore.end()) {
+          codec.AddPair(prefix + *it, it_store->second.GetValue());
+        }
+      }
+    }
+  }
+
+  out = codec.GetMessage();
+}
 
 //-------------------------------------------------------------------------------
 //
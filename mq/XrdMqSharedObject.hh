@@ -25,6 +25,7 @@
 #define __XRDMQ_SHAREDHASH_HH__
 
 #include "mq/XrdMqClient.hh"
+#include "mq/XrdMqSharedHashCodec.hh"
 #include "XrdSys/XrdSysPthread.hh"
 #include "XrdSys/XrdSysSemWait.hh"
 #include "mgm/TableFormatter/TableCell.hh"
@@ -51,6 +52,7 @@
 #define XRDMQSHAREDHASH_KEYS      "mqsh.keys"
 #define XRDMQSHAREDHASH_REPLY     "mqsh.reply"
 #define XRDMQSHAREDHASH_TYPE      "mqsh.type"
+#define XRDMQSHAREDHASH_ENCODING  "mqsh.encoding"
 
 //! Forward declaration
 class XrdMqSharedObjectManager;
@@ -500,6 +502,25 @@ private:
   //----------------------------------------------------------------------------
   void AddDeletionsToEnvString(XrdOucString& out);
 
+  //----------------------------------------------------------------------------
+  //! Encode the transactions as compact message - this must be called with
+  //! the mTransactMutex locked.
+  //!
+  //! @param out output string
+  //! @param cmd update or broadcast reply command
+  //! @param clear_after if true clear transactions afterward, otherwise not
+  //----------------------------------------------------------------------------
+  void EncodeTransactions(std::string& out, XrdMqSharedHashCodec::Command cmd,
+                          bool clear_after = true);
+
+  //----------------------------------------------------------------------------
+  //! Encode the deletions as compact message - this must be called with the
+  //! mTransactMutex locked.
+  //!
+  //! @param out output string
+  //----------------------------------------------------------------------------
+  void EncodeDeletions(std::string& out);
+
   //----------------------------------------------------------------------------
   //! Broadcast hash as env string
   //!
@@ -773,10 +794,35 @@ public:
   void DumpSharedObjects(XrdOucString& out);
 
   //----------------------------------------------------------------------------
+  //! Parse shared object message in env or compact encoding and apply it
+  //!
+  //! @param message received message
+  //! @param error error message if parsing failed
   //!
+  //! @return true if successful, otherwise false
   //----------------------------------------------------------------------------
   bool ParseEnvMessage(XrdMqMessage* message, XrdOucString& error);
 
+  //----------------------------------------------------------------------------
+  //! Record the shared hash encoding understood by a peer. Peers announce it
+  //! in their broadcast requests.
+  //!
+  //! @param peer peer queue name
+  //! @param version encoding version, 0 for the env encoding
+  //----------------------------------------------------------------------------
+  void SetPeerEncoding(const std::string& peer, int version);
+
+  //----------------------------------------------------------------------------
+  //! Get the shared hash encoding to use for messages sent to a target. The
+  //! compact encoding is only used if all known peers matching the target
+  //! announced it.
+  //!
+  //! @param target receiver queue, may contain wildcards
+  //!
+  //! @return encoding version, 0 for the env encoding
+  //----------------------------------------------------------------------------
+  int GetEncoding(const std::string& target);
+
   //----------------------------------------------------------------------------
   //! Set debug level
   //!
@@ -824,6 +870,14 @@ public:
   //----------------------------------------------------------------------------
   void AddMuxTransactionEnvString(XrdOucString& out);
 
+  //----------------------------------------------------------------------------
+  //! Encode the multiplexed transactions as compact message - this must be
+  //! called with the MuxTransactionsMutex locked.
+  //!
+  //! @param out output string
+  //----------------------------------------------------------------------------
+  void EncodeMuxTransactions(std::string& out);
+
 protected:
   XrdSysMutex MuxTransactionsMutex; ///< protects the mux transaction map
   std::string MuxTransactionType; ///<
@@ -849,6 +903,49 @@ private:
   //! True if the reply queue is derived from the subject e.g. the subject
   // "/eos/<host>/fst/<path>" derives as "/eos/<host>/fst"
   bool AutoReplyQueueDerive;
+  //! Send compact encoded messages to peers supporting it, default on
+  bool mCompactEncoding;
+  XrdSysMutex mEncodingMutex; ///< Mutex protecting the encoding maps
+  //! Map of peer queues to the encoding version they announced
+  std::map<std::string, int> mPeerEncodings;
+  //! Cache of target queues to the encoding used for them
+  std::map<std::string, int> mTargetEncodings;
+
+  //----------------------------------------------------------------------------
+  //! Create the subjects of a received message which are not known yet
+  //!
+  //! @param subject message subject
+  //! @param subjectlist list of subjects to create
+  //! @param type shared object type
+  //! @param error error message if creation failed
+  //!
+  //! @return true if successful, otherwise false
+  //----------------------------------------------------------------------------
+  bool CreateMessageSubjects(const std::string& subject,
+                             const std::vector<std::string>& subjectlist,
+                             const std::string& type, XrdOucString& error);
+
+  //----------------------------------------------------------------------------
+  //! Apply a message in compact encoding
+  //!
+  //! @param msg decoded message
+  //! @param error error message if applying failed
+  //!
+  //! @return true if successful, otherwise false
+  //----------------------------------------------------------------------------
+  bool ApplyEncodedMessage(const XrdMqSharedHashCodec::Message& msg,
+                           XrdOucString& error);
+
+  //----------------------------------------------------------------------------
+  //! Apply a multiplexed update in compact encoding
+  //!
+  //! @param msg decoded message
+  //! @param error error message if applying failed
+  //!
+  //! @return true if successful, otherwise false
+  //----------------------------------------------------------------------------
+  bool ApplyEncodedMuxMessage(const XrdMqSharedHashCodec::Message& msg,
+                              XrdOucString& error);
 };
 
 //------------------------------------------------------------------------------
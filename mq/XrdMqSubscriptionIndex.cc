@@ -0,0 +1,218 @@
+// ----------------------------------------------------------------------
+// File: XrdMqSubscriptionIndex.cc
+// ----------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2019 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "mq/XrdMqSubscriptionIndex.hh"
+#include <algorithm>
+
+constexpr size_t XrdMqSubscriptionIndex::kMaxCachedPatterns;
+
+//------------------------------------------------------------------------------
+// Add queue
+//------------------------------------------------------------------------------
+void
+XrdMqSubscriptionIndex::Add(const std::string& name, XrdMqMessageOut* out,
+                            bool advisory_status, bool advisory_query)
+{
+  Remove(name);
+  mQueues[name] = out;
+  mByLastComponent[LastComponent(name)].insert(name);
+
+  if (advisory_status) {
+    mStatusQueues.emplace_back(name, out);
+  }
+
+  if (advisory_query) {
+    mQueryQueues.emplace_back(name, out);
+  }
+
+  // Keep the resolved patterns up to date instead of resolving them again
+  for (auto& elem : mCache) {
+    if (Matches(name, elem.first)) {
+      elem.second.emplace_back(name, out);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Remove queue
+//------------------------------------------------------------------------------
+void
+XrdMqSubscriptionIndex::Remove(const std::string& name)
+{
+  if (!mQueues.erase(name)) {
+    return;
+  }
+
+  auto it = mByLastComponent.find(LastComponent(name));
+
+  if (it != mByLastComponent.end()) {
+    it->second.erase(name);
+
+    if (it->second.empty()) {
+      mByLastComponent.erase(it);
+    }
+  }
+
+  RemoveFromList(mStatusQueues, name);
+  RemoveFromList(mQueryQueues, name);
+
+  for (auto& elem : mCache) {
+    if (Matches(name, elem.first)) {
+      RemoveFromList(elem.second, name);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Get queues matching a wildcard pattern
+//------------------------------------------------------------------------------
+const XrdMqSubscriptionIndex::QueueList&
+XrdMqSubscriptionIndex::Match(const std::string& pattern)
+{
+  auto it_cache = mCache.find(pattern);
+
+  if (it_cache != mCache.end()) {
+    ++mCacheHits;
+    return it_cache->second;
+  }
+
+  ++mCacheMisses;
+
+  if (mCache.size() >= kMaxCachedPatterns) {
+    mCache.clear();
+  }
+
+  QueueList& result = mCache[pattern];
+  size_t first_wildcard = pattern.find('*');
+
+  if (first_wildcard == std::string::npos) {
+    auto it = mQueues.find(pattern);
+
+    if (it != mQueues.end()) {
+      result.emplace_back(it->first, it->second);
+    }
+
+    return result;
+  }
+
+  // Candidates sharing the literal prefix are a contiguous range of the
+  // sorted queue map
+  const std::string prefix = pattern.substr(0, first_wildcard);
+  auto it_begin = mQueues.lower_bound(prefix);
+  auto it_end = it_begin;
+  size_t num_prefix = 0;
+
+  while ((it_end != mQueues.end()) &&
+         (it_end->first.compare(0, prefix.length(), prefix) == 0)) {
+    ++it_end;
+    ++num_prefix;
+  }
+
+  // If the literal suffix contains a complete last path component then only
+  // the queues ending with that component can match e.g. "/eos/*/fst"
+  const std::string suffix = pattern.substr(pattern.rfind('*') + 1);
+  size_t pos_slash = suffix.rfind('/');
+
+  if (pos_slash != std::string::npos) {
+    auto it_bucket = mByLastComponent.find(suffix.substr(pos_slash + 1));
+
+    if (it_bucket == mByLastComponent.end()) {
+      return result;
+    }
+
+    if (it_bucket->second.size() < num_prefix) {
+      for (const auto& name : it_bucket->second) {
+        if (Matches(name, pattern)) {
+          result.emplace_back(name, mQueues[name]);
+        }
+      }
+
+      return result;
+    }
+  }
+
+  for (auto it = it_begin; it != it_end; ++it) {
+    if (Matches(it->first, pattern)) {
+      result.emplace_back(it->first, it->second);
+    }
+  }
+
+  return result;
+}
+
+//------------------------------------------------------------------------------
+// Check if a queue name matches a wildcard pattern
+//------------------------------------------------------------------------------
+bool
+XrdMqSubscriptionIndex::Matches(const std::string& name,
+                                const std::string& pattern)
+{
+  size_t n = 0;
+  size_t p = 0;
+  size_t star_p = std::string::npos;
+  size_t star_n = 0;
+
+  while (n < name.length()) {
+    if ((p < pattern.length()) && (pattern[p] == '*')) {
+      // Remember the wildcard and first try to match an empty sequence
+      star_p = p++;
+      star_n = n;
+    } else if ((p < pattern.length()) && (pattern[p] == name[n])) {
+      ++p;
+      ++n;
+    } else if (star_p != std::string::npos) {
+      // Let the last wildcard swallow one more character
+      p = star_p + 1;
+      n = ++star_n;
+    } else {
+      return false;
+    }
+  }
+
+  while ((p < pattern.length()) && (pattern[p] == '*')) {
+    ++p;
+  }
+
+  return (p == pattern.length());
+}
+
+//------------------------------------------------------------------------------
+// Get the last path component of a name
+//------------------------------------------------------------------------------
+std::string
+XrdMqSubscriptionIndex::LastComponent(const std::string& name)
+{
+  size_t pos = name.rfind('/');
+  return ((pos == std::string::npos) ? name : name.substr(pos + 1));
+}
+
+//------------------------------------------------------------------------------
+// Remove queue from a queue list
+//------------------------------------------------------------------------------
+void
+XrdMqSubscriptionIndex::RemoveFromList(QueueList& list, const std::string& name)
+{
+  list.erase(std::remove_if(list.begin(), list.end(),
+  [&](const QueueList::value_type & elem) {
+    return (elem.first == name);
+  }), list.end());
+}
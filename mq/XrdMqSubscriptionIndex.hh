@@ -0,0 +1,156 @@
+// ----------------------------------------------------------------------
+// File: XrdMqSubscriptionIndex.hh
+// ----------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2019 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#ifndef __XRDMQ_SUBSCRIPTIONINDEX_HH__
+#define __XRDMQ_SUBSCRIPTIONINDEX_HH__
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+//! Forward declaration
+class XrdMqMessageOut;
+
+//------------------------------------------------------------------------------
+//! Class XrdMqSubscriptionIndex - index of the queues connected to the broker
+//! used to find the receivers of a message without looking at every queue.
+//!
+//! Advisory receivers are kept in separate lists. Wildcard patterns are
+//! resolved once against the candidates sharing the literal prefix of the
+//! pattern or the last path component of its literal suffix, whichever set is
+//! smaller. The result is cached and updated when queues connect or
+//! disconnect.
+//! The class is not thread-safe, the broker protects it with the same mutex
+//! as the queue map.
+//------------------------------------------------------------------------------
+class XrdMqSubscriptionIndex
+{
+public:
+  //! List of matching queue names and their output objects
+  using QueueList = std::vector<std::pair<std::string, XrdMqMessageOut*>>;
+
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //----------------------------------------------------------------------------
+  XrdMqSubscriptionIndex() = default;
+
+  //----------------------------------------------------------------------------
+  //! Add queue
+  //!
+  //! @param name queue name
+  //! @param out queue output object
+  //! @param advisory_status queue wants advisory status messages
+  //! @param advisory_query queue wants advisory query messages
+  //----------------------------------------------------------------------------
+  void Add(const std::string& name, XrdMqMessageOut* out,
+           bool advisory_status, bool advisory_query);
+
+  //----------------------------------------------------------------------------
+  //! Remove queue
+  //!
+  //! @param name queue name
+  //----------------------------------------------------------------------------
+  void Remove(const std::string& name);
+
+  //----------------------------------------------------------------------------
+  //! Get queues matching a wildcard pattern
+  //!
+  //! @param pattern queue name pattern where '*' matches any sequence
+  //!
+  //! @return list of matching queues, valid until the next call to any
+  //!         non-const method
+  //----------------------------------------------------------------------------
+  const QueueList& Match(const std::string& pattern);
+
+  //----------------------------------------------------------------------------
+  //! Get queues which want advisory status messages
+  //----------------------------------------------------------------------------
+  const QueueList& GetAdvisoryStatusQueues() const
+  {
+    return mStatusQueues;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get queues which want advisory query messages
+  //----------------------------------------------------------------------------
+  const QueueList& GetAdvisoryQueryQueues() const
+  {
+    return mQueryQueues;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get number of pattern lookups served from the cache
+  //----------------------------------------------------------------------------
+  uint64_t GetCacheHits() const
+  {
+    return mCacheHits;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get number of pattern lookups which had to be resolved
+  //----------------------------------------------------------------------------
+  uint64_t GetCacheMisses() const
+  {
+    return mCacheMisses;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Check if a queue name matches a wildcard pattern
+  //!
+  //! @param name queue name
+  //! @param pattern queue name pattern where '*' matches any sequence
+  //!
+  //! @return true if the whole name matches, otherwise false
+  //----------------------------------------------------------------------------
+  static bool Matches(const std::string& name, const std::string& pattern);
+
+private:
+  //! Max number of cached patterns before the cache is dropped
+  static constexpr size_t kMaxCachedPatterns = 4096;
+  //! All queues sorted by name
+  std::map<std::string, XrdMqMessageOut*> mQueues;
+  //! Queue names grouped by their last path component
+  std::unordered_map<std::string, std::set<std::string>> mByLastComponent;
+  QueueList mStatusQueues; ///< Queues taking advisory status messages
+  QueueList mQueryQueues; ///< Queues taking advisory query messages
+  //! Resolved wildcard patterns
+  std::unordered_map<std::string, QueueList> mCache;
+  std::atomic<uint64_t> mCacheHits {0}; ///< Patterns served from the cache
+  std::atomic<uint64_t> mCacheMisses {0}; ///< Patterns resolved
+
+  //----------------------------------------------------------------------------
+  //! Get the last path component of a name
+  //----------------------------------------------------------------------------
+  static std::string LastComponent(const std::string& name);
+
+  //----------------------------------------------------------------------------
+  //! Remove queue from a queue list
+  //----------------------------------------------------------------------------
+  static void RemoveFromList(QueueList& list, const std::string& name);
+};
+
+#endif
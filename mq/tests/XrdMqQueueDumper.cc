@@ -23,7 +23,46 @@
 
 #include "mq/XrdMqClient.hh"
 #include <stdio.h>
+#include <algorithm>
 #include <chrono>
+#include <vector>
+
+//------------------------------------------------------------------------------
+// Print number of received messages, receive rate and the latency between
+// sending and receiving a message
+//------------------------------------------------------------------------------
+static void
+PrintSummary(const XrdMqClient& mqc, std::vector<double>& latencies,
+             std::chrono::steady_clock::time_point first,
+             std::chrono::steady_clock::time_point last)
+{
+  double rate = 0;
+  double elapsed = std::chrono::duration_cast<std::chrono::microseconds>
+                   (last - first).count() / 1000000.0;
+
+  if ((latencies.size() > 1) && (elapsed > 0)) {
+    rate = (latencies.size() - 1) / elapsed;
+  }
+
+  std::cout << "info: summary mode=" << (mqc.IsPushActive() ? "push" : "poll")
+            << " msgs=" << latencies.size() << " rate=" << rate << " msg/s";
+
+  if (latencies.size()) {
+    double sum = 0;
+
+    for (auto latency : latencies) {
+      sum += latency;
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    std::cout << " latency_ms avg=" << sum / latencies.size()
+              << " p50=" << latencies[latencies.size() / 2]
+              << " p99=" << latencies[(latencies.size() * 99) / 100]
+              << " max=" << latencies.back();
+  }
+
+  std::cout << std::endl;
+}
 
 int main(int argc, char* argv[])
 {
@@ -79,12 +118,22 @@ int main(int argc, char* argv[])
   XrdMqMessage message("");
   message.Configure(0); // Creates a logger object for the message
   uint64_t dumped = 0ull;
+  std::vector<double> latencies;
+  std::chrono::steady_clock::time_point first, last;
 
   while (true) {
     std::unique_ptr<XrdMqMessage> new_msg {mqc.RecvMessage()};
 
     if (new_msg) {
       ++dumped;
+      const XrdMqMessageHeader& hdr = new_msg->kMessageHeader;
+      latencies.push_back((hdr.kReceiverTime_sec - hdr.kSenderTime_sec) * 1000.0 +
+                          (hdr.kReceiverTime_nsec - hdr.kSenderTime_nsec) / 1000000.0);
+      last = std::chrono::steady_clock::now();
+
+      if (dumped == 1) {
+        first = last;
+      }
 
       if (!debug) {
         std::cout << "info: msg #" << dumped << " contents: "
@@ -93,17 +142,20 @@ int main(int argc, char* argv[])
         std::cout << "info: " << dumped << "/" << max_dumps << ", msg size:"
                   << strlen(new_msg->GetBody()) << std::endl;
       }
-    } else {
+    } else if (!mqc.IsPushActive()) {
+      // In push mode the broker already held the request until timeout
       std::this_thread::sleep_for(std::chrono::milliseconds(ms_sleep));
     }
 
     // Exit after max_dumps messages
     if (max_dumps && (dumped >= max_dumps)) {
+      PrintSummary(mqc, latencies, first, last);
       exit(0);
     }
 
     // Exist if deadline given and expired
     if (max_timeout && (std::chrono::steady_clock::now() > deadline)) {
+      PrintSummary(mqc, latencies, first, last);
       exit(ETIME);
     }
   }
@@ -89,6 +89,7 @@ int main(int argc, char* argv[])
   message.Configure(0); // Creates a logger object for the message
   std::string body;
   uint64_t successful_feeds = 0ull;
+  auto start = std::chrono::steady_clock::now();
 
   for (uint64_t i = 0; i < msg_size; ++i) {
     body += "a";
@@ -110,8 +111,13 @@ int main(int argc, char* argv[])
 
     // Exit after max_feeds messages
     if (max_feeds && (num_feeds >= max_feeds)) {
+      double elapsed = std::chrono::duration_cast<std::chrono::microseconds>
+                       (std::chrono::steady_clock::now() - start).count() / 1000000.0;
       std::cout << "info: successfully sent " << successful_feeds
                 << "/" << num_feeds << " feeds" << std::endl;
+      std::cout << "info: summary sent=" << successful_feeds << " rate="
+                << (elapsed > 0 ? successful_feeds / elapsed : 0) << " msg/s"
+                << std::endl;
       exit(0);
     }
 
@@ -0,0 +1,166 @@
+// ----------------------------------------------------------------------
+// File: XrdMqSharedHashBenchmark.cc
+// ----------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2019 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "mq/XrdMqMessage.hh"
+#include "mq/XrdMqSharedObject.hh"
+#include "mq/XrdMqSharedHashCodec.hh"
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <stdio.h>
+
+//------------------------------------------------------------------------------
+// Encode an update in env format the same way XrdMqSharedHash does
+//------------------------------------------------------------------------------
+static void
+EncodeEnv(XrdOucString& out, const std::string& subject,
+          const std::map<std::string, std::string>& pairs)
+{
+  out = XRDMQSHAREDHASH_UPDATE;
+  out += "&";
+  out += XRDMQSHAREDHASH_SUBJECT;
+  out += "=";
+  out += subject.c_str();
+  out += "&";
+  out += XRDMQSHAREDHASH_TYPE;
+  out += "=hash&";
+  out += XRDMQSHAREDHASH_PAIRS;
+  out += "=";
+  // Change ids of real hashes are global counters with many digits
+  unsigned long long cid = 1000000;
+  char scid[32];
+
+  for (const auto& pair : pairs) {
+    out += "|";
+    out += pair.first.c_str();
+    out += "~";
+    out += pair.second.c_str();
+    out += "%";
+    snprintf(scid, sizeof(scid) - 1, "%llu", cid++);
+    out += scid;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Encode an update in compact format
+//------------------------------------------------------------------------------
+static void
+EncodeCompact(std::string& out, const std::string& subject,
+              const std::map<std::string, std::string>& pairs)
+{
+  XrdMqSharedHashCodec codec(XrdMqSharedHashCodec::Command::kUpdate, subject,
+                             "hash");
+
+  for (const auto& pair : pairs) {
+    codec.AddPair(pair.first, pair.second);
+  }
+
+  out = codec.GetMessage();
+}
+
+//------------------------------------------------------------------------------
+// Parse and apply a message body the given number of times
+//
+// @return elapsed time in seconds
+//------------------------------------------------------------------------------
+static double
+Parse(XrdMqSharedObjectManager& som, const char* body, uint64_t iterations)
+{
+  XrdOucString error;
+  auto start = std::chrono::steady_clock::now();
+
+  for (uint64_t i = 0; i < iterations; ++i) {
+    XrdMqMessage message("XrdMqSharedHashMessage");
+    message.SetBody(body);
+
+    if (!som.ParseEnvMessage(&message, error)) {
+      std::cerr << "error: failed to parse message: " << error.c_str()
+                << std::endl;
+      exit(-1);
+    }
+  }
+
+  return std::chrono::duration_cast<std::chrono::microseconds>
+         (std::chrono::steady_clock::now() - start).count() / 1000000.0;
+}
+
+int main(int argc, char* argv[])
+{
+  uint64_t num_keys = 64;
+  uint64_t iterations = 100000;
+
+  if (argc > 3) {
+    std::cerr << "Usage: " << argv[0] << " [num_keys] [iterations]"
+              << std::endl;
+    exit(-1);
+  }
+
+  if (argc >= 2) {
+    num_keys = std::stoull(argv[1]);
+  }
+
+  if (argc >= 3) {
+    iterations = std::stoull(argv[2]);
+  }
+
+  // Keys and values resembling the statistics published by the FSTs
+  std::string subject = "/eos/fsthost.cern.ch:1095/fst/data01";
+  std::map<std::string, std::string> pairs;
+
+  for (uint64_t i = 0; i < num_keys; ++i) {
+    pairs["stat.benchmark.key" + std::to_string(i)] =
+      std::to_string(1000000007ull * (i + 1));
+  }
+
+  XrdOucString env_body;
+  std::string compact_body;
+  auto start = std::chrono::steady_clock::now();
+
+  for (uint64_t i = 0; i < iterations; ++i) {
+    EncodeEnv(env_body, subject, pairs);
+  }
+
+  double env_encode = std::chrono::duration_cast<std::chrono::microseconds>
+                      (std::chrono::steady_clock::now() - start).count() / 1000000.0;
+  start = std::chrono::steady_clock::now();
+
+  for (uint64_t i = 0; i < iterations; ++i) {
+    EncodeCompact(compact_body, subject, pairs);
+  }
+
+  double compact_encode = std::chrono::duration_cast<std::chrono::microseconds>
+                          (std::chrono::steady_clock::now() - start).count() / 1000000.0;
+  XrdMqSharedObjectManager som;
+  som.EnableBroadCast(false);
+  double env_parse = Parse(som, env_body.c_str(), iterations);
+  double compact_parse = Parse(som, compact_body.c_str(), iterations);
+  auto report = [&](const char* name, size_t size, double encode, double parse) {
+    std::cout << "info: format=" << name << " keys=" << num_keys
+              << " msg_size=" << size << " bytes"
+              << " encode=" << (encode > 0 ? iterations / encode : 0) << " msg/s"
+              << " parse=" << (parse > 0 ? iterations / parse : 0) << " msg/s"
+              << std::endl;
+  };
+  report("env", env_body.length(), env_encode, env_parse);
+  report("compact", compact_body.length(), compact_encode, compact_parse);
+  return 0;
+}
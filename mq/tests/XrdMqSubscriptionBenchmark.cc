@@ -0,0 +1,181 @@
+// ----------------------------------------------------------------------
+// File: XrdMqSubscriptionBenchmark.cc
+// ----------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2019 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "mq/XrdMqSubscriptionIndex.hh"
+#include "XrdOuc/XrdOucString.hh"
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <set>
+#include <stdio.h>
+
+//------------------------------------------------------------------------------
+// Match a pattern by looking at every queue the way the broker used to do
+//------------------------------------------------------------------------------
+static void
+LinearMatch(const std::map<std::string, XrdMqMessageOut*>& queues,
+            const std::string& pattern, std::set<std::string>& result)
+{
+  XrdOucString nowildcard = pattern.c_str();
+  nowildcard.replace("*", "");
+
+  for (const auto& elem : queues) {
+    XrdOucString key = elem.first.c_str();
+
+    if (key.matches(pattern.c_str(), '*') == nowildcard.length()) {
+      result.insert(elem.first);
+    }
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  uint64_t num_fst = 2000;
+  uint64_t num_fuse = 5000;
+  uint64_t iterations = 1000;
+
+  if (argc > 4) {
+    std::cerr << "Usage: " << argv[0] << " [num_fst] [num_fuse] [iterations]"
+              << std::endl;
+    exit(-1);
+  }
+
+  if (argc >= 2) {
+    num_fst = std::stoull(argv[1]);
+  }
+
+  if (argc >= 3) {
+    num_fuse = std::stoull(argv[2]);
+  }
+
+  if (argc >= 4) {
+    iterations = std::stoull(argv[3]);
+  }
+
+  // Queues of a large instance, the output objects are never dereferenced
+  std::map<std::string, XrdMqMessageOut*> queues;
+  XrdMqSubscriptionIndex index;
+  char name[256];
+  auto add = [&](const std::string & queue, bool advisory) {
+    XrdMqMessageOut* out = reinterpret_cast<XrdMqMessageOut*>(queues.size() + 1);
+    queues[queue] = out;
+    index.Add(queue, out, advisory, advisory);
+  };
+  add("/eos/mgmhost.cern.ch:1094/mgm", true);
+  add("/eos/mgmhost.cern.ch:1094/mgm-slave", true);
+
+  for (uint64_t i = 0; i < num_fst; ++i) {
+    snprintf(name, sizeof(name), "/eos/fst%05llu.cern.ch:1095/fst",
+             (unsigned long long) i);
+    add(name, false);
+  }
+
+  for (uint64_t i = 0; i < num_fuse; ++i) {
+    snprintf(name, sizeof(name), "/eos/fuse%05llu.cern.ch/fusex/%llu",
+             (unsigned long long) i, (unsigned long long) i);
+    add(name, false);
+  }
+
+  // Receivers addressed by the MGM and the FSTs
+  std::vector<std::string> patterns = {
+    "/eos/*/mgm", "/eos/*/fst", "/eos/*", "/eos/fst00001.cern.ch:1095/*",
+    "/eos/fuse0000*/fusex/*", "/eos/*.cern.ch:1095/fst"
+  };
+
+  // Both methods have to agree on the receivers
+  for (const auto& pattern : patterns) {
+    std::set<std::string> linear;
+    std::set<std::string> indexed;
+    LinearMatch(queues, pattern, linear);
+
+    for (const auto& elem : index.Match(pattern)) {
+      indexed.insert(elem.first);
+    }
+
+    if (linear != indexed) {
+      std::cerr << "error: different receivers for pattern " << pattern
+                << " linear=" << linear.size() << " index=" << indexed.size()
+                << std::endl;
+      exit(-1);
+    }
+
+    std::cout << "info: pattern=" << pattern << " receivers=" << linear.size()
+              << std::endl;
+  }
+
+  uint64_t num_receivers = 0;
+  auto start = std::chrono::steady_clock::now();
+
+  for (uint64_t i = 0; i < iterations; ++i) {
+    for (const auto& pattern : patterns) {
+      std::set<std::string> result;
+      LinearMatch(queues, pattern, result);
+      num_receivers += result.size();
+    }
+  }
+
+  double linear_time = std::chrono::duration_cast<std::chrono::microseconds>
+                       (std::chrono::steady_clock::now() - start).count() / 1000000.0;
+  start = std::chrono::steady_clock::now();
+
+  for (uint64_t i = 0; i < iterations; ++i) {
+    for (const auto& pattern : patterns) {
+      num_receivers += index.Match(pattern).size();
+    }
+
+    num_receivers += index.GetAdvisoryStatusQueues().size();
+  }
+
+  double index_time = std::chrono::duration_cast<std::chrono::microseconds>
+                      (std::chrono::steady_clock::now() - start).count() / 1000000.0;
+  // Queues connecting and disconnecting while messages are delivered
+  start = std::chrono::steady_clock::now();
+
+  for (uint64_t i = 0; i < iterations; ++i) {
+    snprintf(name, sizeof(name), "/eos/fuse%05llu.cern.ch/fusex/%llu",
+             (unsigned long long)(i % num_fuse), (unsigned long long) i);
+    index.Add(name, nullptr, false, false);
+
+    for (const auto& pattern : patterns) {
+      num_receivers += index.Match(pattern).size();
+    }
+
+    index.Remove(name);
+  }
+
+  double churn_time = std::chrono::duration_cast<std::chrono::microseconds>
+                      (std::chrono::steady_clock::now() - start).count() / 1000000.0;
+  uint64_t num_matches = iterations * patterns.size();
+  auto report = [&](const char* method, double elapsed) {
+    std::cout << "info: method=" << method << " queues=" << queues.size()
+              << " matches=" << num_matches
+              << " rate=" << (elapsed > 0 ? num_matches / elapsed : 0)
+              << " matches/s" << std::endl;
+  };
+  report("linear", linear_time);
+  report("index", index_time);
+  report("index-churn", churn_time);
+  std::cout << "info: cache_hits=" << index.GetCacheHits()
+            << " cache_misses=" << index.GetCacheMisses()
+            << " receivers=" << num_receivers << std::endl;
+  return 0;
+}
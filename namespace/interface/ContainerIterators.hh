@@ -27,6 +27,7 @@
 #include "namespace/Namespace.hh"
 #include "namespace/interface/IContainerMD.hh"
 #include "namespace/interface/IFileMD.hh"
+#include <vector>
 
 EOSNSNAMESPACE_BEGIN
 
@@ -90,6 +91,85 @@ private:
   eos::IContainerMD::ContainerMap::const_iterator iter;
 };
 
+//------------------------------------------------------------------------------
+//! Class ContainerListingCursor
+//!
+//! Lists the files and then the subcontainers of a container in batches. The
+//! position in the maps is kept between the batches, so that the namespace
+//! lock can be released in between. If a map was rehashed in the meantime the
+//! listing continues after the same number of entries of the new map, some
+//! entries can then be missed or listed twice.
+//------------------------------------------------------------------------------
+class ContainerListingCursor {
+public:
+  ContainerListingCursor(IContainerMDPtr cont)
+  : container(cont), inFiles(true), started(false), done(false), listed(0) { }
+
+  //----------------------------------------------------------------------------
+  //! Append the names of the next entries, needs the namespace read lock
+  //!
+  //! @param names names of the entries
+  //! @param max maximum number of names to append
+  //!
+  //! @return false if all the entries have been listed
+  //----------------------------------------------------------------------------
+  bool next(std::vector<std::string>& names, size_t max) {
+    std::shared_lock<std::shared_timed_mutex> lock(container->mMutex);
+    size_t count = 0;
+
+    while (!done && (count < max)) {
+      IContainerMD::FileMap::const_iterator begin = inFiles ?
+        container->filesBegin() : container->subcontainersBegin();
+      IContainerMD::FileMap::const_iterator end = inFiles ?
+        container->filesEnd() : container->subcontainersEnd();
+      IContainerMD::FileMap::const_iterator iter = begin;
+
+      if (started && (end == mapEnd)) {
+        // Skips the entries deleted since the last batch
+        iter = last;
+        ++iter;
+      } else if (started) {
+        for (uint64_t i = 0; (i < listed) && (iter != end); ++i) {
+          ++iter;
+        }
+      }
+
+      started = true;
+      mapEnd = end;
+
+      for (; (iter != end) && (count < max); ++iter) {
+        names.push_back(iter->first);
+        last = iter;
+        ++count;
+        ++listed;
+      }
+
+      if (iter != end) {
+        break;
+      }
+
+      if (inFiles) {
+        inFiles = false;
+        started = false;
+        listed = 0;
+      } else {
+        done = true;
+      }
+    }
+
+    return !done;
+  }
+
+private:
+  IContainerMDPtr container;
+  bool inFiles; ///< listing the files, the subcontainers otherwise
+  bool started; ///< the current map has been positioned
+  bool done; ///< all the entries have been listed
+  uint64_t listed; ///< entries listed from the current map
+  IContainerMD::FileMap::const_iterator last; ///< last entry listed
+  IContainerMD::FileMap::const_iterator mapEnd; ///< end of the current map
+};
+
 EOSNSNAMESPACE_END
 
 #endif
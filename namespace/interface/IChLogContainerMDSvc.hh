@@ -25,6 +25,7 @@
 #define __EOS_NS_ICHLOGCONTAINERMDSVC_HH__
 
 #include "namespace/Namespace.hh"
+#include "namespace/interface/Misc.hh"
 #include <map>
 #include <vector>
 #include <string>
@@ -92,6 +93,64 @@ public:
   //----------------------------------------------------------------------------
   virtual void compactCommit(void* comp_data, bool autorepair = false) = 0;
 
+  //----------------------------------------------------------------------------
+  //! Prepare for incremental online compacting.
+  //!
+  //! Unlike compactPrepare this does not collect the records to be copied,
+  //! the log is compacted segment by segment by compactSegment. Needs a read
+  //! lock on the namespace.
+  //!
+  //! @param  newLogFileName name for the compacted log file
+  //! @return                compacting information that needs to be passed
+  //!                        to other functions
+  //----------------------------------------------------------------------------
+  virtual void* compactIncrementalPrepare(const std::string& newLogFileName) = 0;
+
+  //----------------------------------------------------------------------------
+  //! Compact the next segment of the log.
+  //!
+  //! Must be called without holding the namespace lock, the lock handler is
+  //! used to take the read lock while selecting the live records of the
+  //! segment and the write lock while pointing the metadata to the copies.
+  //!
+  //! @param comp_data  state information returned by compactIncrementalPrepare
+  //! @param lock       namespace lock
+  //! @param autorepair indicates to skip broken records
+  //!
+  //! @return true if the rest of the log is small enough to be committed
+  //----------------------------------------------------------------------------
+  virtual bool compactSegment(void* comp_data, LockHandler* lock,
+                              bool autorepair = false) = 0;
+
+  //----------------------------------------------------------------------------
+  //! Commit the incremental compacting.
+  //!
+  //! Compacts the rest of the log and switches to the new log. Needs an
+  //! exclusive lock on the namespace.
+  //!
+  //! @param comp_data  state information returned by compactIncrementalPrepare
+  //! @param autorepair indicates to skip broken records
+  //----------------------------------------------------------------------------
+  virtual void compactIncrementalCommit(void* comp_data,
+                                        bool autorepair = false) = 0;
+
+  //----------------------------------------------------------------------------
+  //! Abort the incremental compacting.
+  //!
+  //! Points the metadata back to the original log and releases the
+  //! compacting information. Needs an exclusive lock on the namespace.
+  //!
+  //! @param comp_data  state information returned by compactIncrementalPrepare
+  //----------------------------------------------------------------------------
+  virtual void compactIncrementalAbort(void* comp_data) = 0;
+
+  //----------------------------------------------------------------------------
+  //! Get the progress of an incremental compacting
+  //!
+  //! @param comp_data state information returned by compactIncrementalPrepare
+  //----------------------------------------------------------------------------
+  virtual CompactingProgress getCompactingProgress(void* comp_data) = 0;
+
   //----------------------------------------------------------------------------
   //! Make transition from slave to master
   //!
@@ -401,6 +401,7 @@ public:
 private:
   friend class FileMapIterator;
   friend class ContainerMapIterator;
+  friend class ContainerListingCursor;
 
   //----------------------------------------------------------------------------
   //! Make copy constructor and assignment operator private to avoid "slicing"
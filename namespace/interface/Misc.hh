@@ -25,6 +25,7 @@
 #define EOS_NS_MISC_H
 
 #include "namespace/Namespace.hh"
+#include <stdint.h>
 
 EOSNSNAMESPACE_BEGIN
 
@@ -38,6 +39,18 @@ struct CacheStatistics {
   int64_t inFlight = 0;
 };
 
+//------------------------------------------------------------------------------
+//! Struct to retrieve the progress of an incremental changelog compaction
+//------------------------------------------------------------------------------
+struct CompactingProgress {
+  uint64_t processed = 0; ///< bytes of the original log already compacted
+  uint64_t total = 0; ///< current size of the original log
+  uint64_t copied = 0; ///< records copied to the new log
+  uint64_t segments = 0; ///< segments compacted
+  uint64_t lastPauseUs = 0; ///< write lock hold time of the last segment
+  uint64_t maxPauseUs = 0; ///< max. write lock hold time of a segment
+};
+
 EOSNSNAMESPACE_END
 
 #endif
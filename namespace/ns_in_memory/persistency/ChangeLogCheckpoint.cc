@@ -0,0 +1,320 @@
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2019 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+//------------------------------------------------------------------------------
+// desc:   Checkpoint of the record index of a change log
+//------------------------------------------------------------------------------
+
+#include "namespace/ns_in_memory/persistency/ChangeLogCheckpoint.hh"
+#include "namespace/utils/DataHelper.hh"
+#include "namespace/utils/Locking.hh"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+
+namespace
+{
+//! "EOSNSCKP"
+const uint64_t CHECKPOINT_MAGIC = 0x504b43534e534f45ULL;
+const uint32_t CHECKPOINT_VERSION = 1;
+//! Amount of change log data before the covered offset in the checksum
+const uint64_t CHECKPOINT_LOG_TAIL = 64 * 1024;
+//! Max. size passed to a single crc32 update
+const uint64_t CHECKPOINT_CRC_CHUNK = 64 * 1024 * 1024;
+
+//------------------------------------------------------------------------------
+// Checksum of a memory area of any size
+//------------------------------------------------------------------------------
+uint32_t checksum(const char* data, uint64_t len)
+{
+  uint32_t crc = eos::DataHelper::computeCRC32((void*) data, 0);
+
+  while (len) {
+    uint64_t chunk = std::min(len, CHECKPOINT_CRC_CHUNK);
+    crc = eos::DataHelper::updateCRC32(crc, (void*) data, chunk);
+    data += chunk;
+    len -= chunk;
+  }
+
+  return crc;
+}
+
+//------------------------------------------------------------------------------
+// Write a full buffer
+//------------------------------------------------------------------------------
+bool writeAll(int fd, const char* data, uint64_t len)
+{
+  while (len) {
+    ssize_t nwrite = ::write(fd, data, std::min(len, CHECKPOINT_CRC_CHUNK));
+
+    if (nwrite < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+
+      return false;
+    }
+
+    data += nwrite;
+    len -= nwrite;
+  }
+
+  return true;
+}
+}
+
+EOSNSNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+// Checksum of the change log header and of the data before an offset
+//------------------------------------------------------------------------------
+bool ChangeLogCheckpoint::logChecksum(int fd, uint64_t logEnd, uint32_t& crc)
+{
+  char logHeader[8];
+  uint64_t start = (logEnd > CHECKPOINT_LOG_TAIL) ?
+                   (logEnd - CHECKPOINT_LOG_TAIL) : 0;
+  std::vector<char> tail(logEnd - start);
+
+  if ((::pread(fd, logHeader, sizeof(logHeader), 0) != sizeof(logHeader)) ||
+      (::pread(fd, tail.data(), tail.size(), start) != (ssize_t) tail.size())) {
+    return false;
+  }
+
+  crc = checksum(logHeader, sizeof(logHeader));
+  crc = DataHelper::updateCRC32(crc, tail.data(), tail.size());
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Map a checkpoint and check that it matches the change log
+//------------------------------------------------------------------------------
+bool ChangeLogCheckpoint::open(const std::string& path,
+                               const std::string& logPath,
+                               uint16_t contentFlag, std::string& err)
+{
+  close();
+  struct stat st;
+  pFd = ::open(path.c_str(), O_RDONLY);
+
+  if ((pFd < 0) || ::fstat(pFd, &st)) {
+    err = "unable to open " + path + ": " + strerror(errno);
+    close();
+    return false;
+  }
+
+  if ((size_t) st.st_size < sizeof(Header)) {
+    err = "checkpoint is truncated";
+    close();
+    return false;
+  }
+
+  pDataLen = st.st_size;
+  pData = (char*)::mmap(0, pDataLen, PROT_READ, MAP_SHARED, pFd, 0);
+
+  if (pData == MAP_FAILED) {
+    pData = 0;
+    err = std::string("unable to map the checkpoint: ") + strerror(errno);
+    close();
+    return false;
+  }
+
+  const Header* h = header();
+
+  if ((h->magic != CHECKPOINT_MAGIC) || (h->version != CHECKPOINT_VERSION) ||
+      (h->contentFlag != contentFlag)) {
+    err = "checkpoint has a wrong magic, version or content flag";
+    close();
+    return false;
+  }
+
+  if (pDataLen != (sizeof(Header) + h->count * sizeof(Entry))) {
+    err = "checkpoint size does not match the number of entries";
+    close();
+    return false;
+  }
+
+  // The checkpoint has to belong to this very change log, a compacted or
+  // repaired log is a new file
+  int logFd = ::open(logPath.c_str(), O_RDONLY);
+  uint32_t logCrc = 0;
+  bool logOk = ((logFd >= 0) && !::fstat(logFd, &st) &&
+                ((uint64_t) st.st_ino == h->logInode) &&
+                ((uint64_t) st.st_size >= h->logEnd) &&
+                logChecksum(logFd, h->logEnd, logCrc) && (logCrc == h->logCrc));
+
+  if (logFd >= 0) {
+    ::close(logFd);
+  }
+
+  if (!logOk) {
+    err = "checkpoint does not match the change log " + logPath;
+    close();
+    return false;
+  }
+
+  if (checksum((const char*) entries(), h->count * sizeof(Entry)) !=
+      h->entriesCrc) {
+    err = "checkpoint checksum mismatch";
+    close();
+    return false;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Unmap the checkpoint
+//------------------------------------------------------------------------------
+void ChangeLogCheckpoint::close()
+{
+  if (pData) {
+    ::munmap(pData, pDataLen);
+    pData = 0;
+    pDataLen = 0;
+  }
+
+  if (pFd >= 0) {
+    ::close(pFd);
+    pFd = -1;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Accessors
+//------------------------------------------------------------------------------
+uint64_t ChangeLogCheckpoint::getLogEnd() const
+{
+  return pData ? header()->logEnd : 0;
+}
+
+uint64_t ChangeLogCheckpoint::getLargestId() const
+{
+  return pData ? header()->largestId : 0;
+}
+
+uint64_t ChangeLogCheckpoint::size() const
+{
+  return pData ? header()->count : 0;
+}
+
+const ChangeLogCheckpoint::Entry* ChangeLogCheckpoint::entries() const
+{
+  return pData ? (const Entry*)(pData + sizeof(Header)) : 0;
+}
+
+//------------------------------------------------------------------------------
+// Identify the change log a checkpoint is taken of
+//------------------------------------------------------------------------------
+bool ChangeLogCheckpoint::identifyLog(const std::string& logPath,
+                                      uint64_t logEnd, uint64_t& logInode,
+                                      uint32_t& logCrc, std::string& err)
+{
+  struct stat st;
+  int logFd = ::open(logPath.c_str(), O_RDONLY);
+  bool logOk = ((logFd >= 0) && !::fstat(logFd, &st) &&
+                logChecksum(logFd, logEnd, logCrc));
+  logInode = logOk ? st.st_ino : 0;
+
+  if (logFd >= 0) {
+    ::close(logFd);
+  }
+
+  if (!logOk) {
+    err = "unable to read the change log " + logPath;
+    return false;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Write a checkpoint
+//------------------------------------------------------------------------------
+bool ChangeLogCheckpoint::write(const std::string& path, uint16_t contentFlag,
+                                uint64_t logEnd, uint64_t largestId,
+                                uint64_t logInode, uint32_t logCrc,
+                                std::vector<Entry>& entries, std::string& err)
+{
+  // Reading the records in offset order makes the boot sequential
+  std::sort(entries.begin(), entries.end(),
+  [](const Entry & a, const Entry & b) {
+    return a.offset < b.offset;
+  });
+  Header h;
+  memset(&h, 0, sizeof(h));
+  h.magic = CHECKPOINT_MAGIC;
+  h.version = CHECKPOINT_VERSION;
+  h.contentFlag = contentFlag;
+  h.logEnd = logEnd;
+  h.largestId = largestId;
+  h.count = entries.size();
+  h.entriesCrc = checksum((const char*) entries.data(),
+                          entries.size() * sizeof(Entry));
+  h.logInode = logInode;
+  h.logCrc = logCrc;
+
+  std::string tmpPath = path + ".tmp";
+  int fd = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+  if (fd < 0) {
+    err = "unable to create " + tmpPath + ": " + strerror(errno);
+    return false;
+  }
+
+  if (!writeAll(fd, (const char*) &h, sizeof(h)) ||
+      !writeAll(fd, (const char*) entries.data(), entries.size() * sizeof(Entry)) ||
+      ::fsync(fd)) {
+    err = "unable to write " + tmpPath + ": " + strerror(errno);
+    ::close(fd);
+    ::unlink(tmpPath.c_str());
+    return false;
+  }
+
+  ::close(fd);
+
+  if (::rename(tmpPath.c_str(), path.c_str())) {
+    err = "unable to rename " + tmpPath + ": " + strerror(errno);
+    ::unlink(tmpPath.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Take the namespace read lock for copying a chunk of the id map
+//------------------------------------------------------------------------------
+bool ChangeLogCheckpoint::readLock(LockHandler* lock,
+                                   const std::atomic<bool>& stop)
+{
+  while (!stop) {
+    if (!lock || lock->timedReadLock(100000000ull)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+EOSNSNAMESPACE_END
@@ -0,0 +1,200 @@
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2019 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+//------------------------------------------------------------------------------
+// desc:   Checkpoint of the record index of a change log
+//------------------------------------------------------------------------------
+
+#ifndef EOS_NS_CHANGE_LOG_CHECKPOINT_HH
+#define EOS_NS_CHANGE_LOG_CHECKPOINT_HH
+
+#include "namespace/Namespace.hh"
+#include <atomic>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+EOSNSNAMESPACE_BEGIN
+
+class LockHandler;
+
+//------------------------------------------------------------------------------
+//! Checkpoint of the id to record offset map of a change log
+//!
+//! The checkpoint is a binary file with a fixed size header followed by an
+//! array of (id, offset) entries sorted by offset, so it can be mapped and
+//! used directly. It is tied to one change log file by the inode, the log
+//! offset it covers and a checksum of the log data right before that
+//! offset. A boot loads the entries from the checkpoint and only scans the
+//! part of the change log written after it.
+//------------------------------------------------------------------------------
+class ChangeLogCheckpoint
+{
+public:
+  struct Entry {
+    uint64_t id;
+    uint64_t offset;
+  };
+
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //----------------------------------------------------------------------------
+  ChangeLogCheckpoint(): pFd(-1), pData(0), pDataLen(0) {}
+
+  //----------------------------------------------------------------------------
+  //! Destructor
+  //----------------------------------------------------------------------------
+  ~ChangeLogCheckpoint()
+  {
+    close();
+  }
+
+  //----------------------------------------------------------------------------
+  //! Map a checkpoint and check that it matches the change log
+  //!
+  //! @param path        checkpoint file
+  //! @param logPath     change log file
+  //! @param contentFlag content flag of the change log
+  //! @param err         reason if the checkpoint can not be used
+  //!
+  //! @return true if the checkpoint can be used
+  //----------------------------------------------------------------------------
+  bool open(const std::string& path, const std::string& logPath,
+            uint16_t contentFlag, std::string& err);
+
+  //----------------------------------------------------------------------------
+  //! Unmap the checkpoint
+  //----------------------------------------------------------------------------
+  void close();
+
+  //----------------------------------------------------------------------------
+  //! Get the change log offset up to which the checkpoint is valid
+  //----------------------------------------------------------------------------
+  uint64_t getLogEnd() const;
+
+  //----------------------------------------------------------------------------
+  //! Get the largest id used when the checkpoint was written
+  //----------------------------------------------------------------------------
+  uint64_t getLargestId() const;
+
+  //----------------------------------------------------------------------------
+  //! Get the number of entries
+  //----------------------------------------------------------------------------
+  uint64_t size() const;
+
+  //----------------------------------------------------------------------------
+  //! Get the entries sorted by offset
+  //----------------------------------------------------------------------------
+  const Entry* entries() const;
+
+  //----------------------------------------------------------------------------
+  //! Identify the change log a checkpoint is taken of. Only the data before
+  //! logEnd is read, which is never modified by appends. If the log can be
+  //! replaced (e.g. by a compaction) while this runs, the caller has to
+  //! detect it and drop the checkpoint.
+  //!
+  //! @param logPath     change log file
+  //! @param logEnd      change log offset covered by the entries
+  //! @param logInode    inode of the change log
+  //! @param logCrc      checksum of the change log data before logEnd
+  //! @param err         error message
+  //!
+  //! @return true if successful
+  //----------------------------------------------------------------------------
+  static bool identifyLog(const std::string& logPath, uint64_t logEnd,
+                          uint64_t& logInode, uint32_t& logCrc,
+                          std::string& err);
+
+  //----------------------------------------------------------------------------
+  //! Write a checkpoint
+  //!
+  //! The file is written under a temporary name and renamed when complete.
+  //!
+  //! @param path        checkpoint file
+  //! @param contentFlag content flag of the change log
+  //! @param logEnd      change log offset covered by the entries
+  //! @param largestId   largest id used so far
+  //! @param logInode    change log inode given by identifyLog
+  //! @param logCrc      change log checksum given by identifyLog
+  //! @param entries     entries, sorted by offset by this function
+  //! @param err         error message
+  //!
+  //! @return true if successful
+  //----------------------------------------------------------------------------
+  static bool write(const std::string& path, uint16_t contentFlag,
+                    uint64_t logEnd, uint64_t largestId, uint64_t logInode,
+                    uint32_t logCrc, std::vector<Entry>& entries,
+                    std::string& err);
+
+  //----------------------------------------------------------------------------
+  //! Take the namespace read lock for copying a chunk of the id map. The lock
+  //! is tried with a timeout so that a checkpoint waiting for it can be
+  //! stopped by a thread holding the write lock.
+  //!
+  //! @param lock namespace lock, nothing is locked if null
+  //! @param stop set when the checkpoint has to be given up
+  //!
+  //! @return true if the lock was taken, false if stopped
+  //----------------------------------------------------------------------------
+  static bool readLock(LockHandler* lock, const std::atomic<bool>& stop);
+
+  //----------------------------------------------------------------------------
+  //! Number of ids looked up per namespace read lock when copying the id map
+  //----------------------------------------------------------------------------
+  static const uint64_t sChunkSize = 65536;
+
+  //----------------------------------------------------------------------------
+  //! Get the checkpoint file name of a change log
+  //----------------------------------------------------------------------------
+  static std::string getPath(const std::string& logPath)
+  {
+    return logPath + ".checkpoint";
+  }
+
+private:
+  struct Header {
+    uint64_t magic;
+    uint32_t version;
+    uint16_t contentFlag;
+    uint16_t reserved;
+    uint64_t logInode;
+    uint64_t logEnd;
+    uint64_t largestId;
+    uint64_t count;
+    uint32_t logCrc;
+    uint32_t entriesCrc;
+  };
+
+  //----------------------------------------------------------------------------
+  //! Checksum of the change log header and of the data before an offset
+  //----------------------------------------------------------------------------
+  static bool logChecksum(int fd, uint64_t logEnd, uint32_t& crc);
+
+  const Header* header() const
+  {
+    return (const Header*) pData;
+  }
+
+  int    pFd;
+  char*  pData;
+  size_t pDataLen;
+};
+
+EOSNSNAMESPACE_END
+
+#endif // EOS_NS_CHANGE_LOG_CHECKPOINT_HH
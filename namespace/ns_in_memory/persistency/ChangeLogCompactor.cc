@@ -0,0 +1,131 @@
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2019 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+//------------------------------------------------------------------------------
+// desc:   Incremental compacting of a change log
+//------------------------------------------------------------------------------
+
+#include "namespace/ns_in_memory/persistency/ChangeLogCompactor.hh"
+#include <stdlib.h>
+
+namespace
+{
+//------------------------------------------------------------------------------
+// Collect the records of a segment
+//------------------------------------------------------------------------------
+class SegmentReader: public eos::ILogRecordScanner
+{
+public:
+  SegmentReader(std::vector<eos::ChangeLogCompactor::Record>& records,
+                uint64_t startEnd):
+    pRecords(records), pStartEnd(startEnd) {}
+
+  virtual bool processRecord(uint64_t offset, char type,
+                             const eos::Buffer& buffer)
+  {
+    // Delete records older than the compacting refer to objects which can
+    // not be in the new log
+    if ((type != eos::UPDATE_RECORD_MAGIC) &&
+        ((type != eos::DELETE_RECORD_MAGIC) || (offset < pStartEnd))) {
+      return true;
+    }
+
+    pRecords.emplace_back();
+    eos::ChangeLogCompactor::Record& record = pRecords.back();
+    record.offset = offset;
+    record.newOffset = 0;
+    record.type = type;
+    record.buffer = buffer;
+    buffer.grabData(0, &record.id, sizeof(record.id));
+    return true;
+  }
+
+private:
+  std::vector<eos::ChangeLogCompactor::Record>& pRecords;
+  uint64_t pStartEnd;
+};
+}
+
+EOSNSNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+ChangeLogCompactor::ChangeLogCompactor(ChangeLogFile* originalLog):
+  pNewLog(new ChangeLogFile()), pOriginalLog(originalLog),
+  pStartEnd(originalLog->getNextOffset()),
+  pPosition(originalLog->getFirstOffset()), pEnd(pStartEnd),
+  pSegmentSize(64 * 1024 * 1024), pCatchUpSegments(0)
+{
+  if (getenv("EOS_NS_COMPACT_SEGMENT_MB")) {
+    uint64_t mb = strtoull(getenv("EOS_NS_COMPACT_SEGMENT_MB"), 0, 10);
+
+    if (mb) {
+      pSegmentSize = mb * 1024 * 1024;
+    }
+  }
+
+  pProgress.processed = pPosition;
+  pProgress.total = pEnd;
+}
+
+//------------------------------------------------------------------------------
+// Create the new log
+//------------------------------------------------------------------------------
+void ChangeLogCompactor::open(const std::string& newLogFileName,
+                              uint16_t contentFlag)
+{
+  pNewLog->open(newLogFileName, ChangeLogFile::Create, contentFlag);
+  pLogFileName = newLogFileName;
+}
+
+//------------------------------------------------------------------------------
+// Read the records of the next segment
+//------------------------------------------------------------------------------
+void ChangeLogCompactor::readSegment(bool autorepair)
+{
+  pRecords.clear();
+
+  if (finished()) {
+    return;
+  }
+
+  if (pPosition >= pStartEnd) {
+    ++pCatchUpSegments;
+  }
+
+  SegmentReader reader(pRecords, pStartEnd);
+  // Only records completely written before the end was taken are read, the
+  // last one may extend beyond the segment
+  uint64_t segmentEnd = std::min(pPosition + pSegmentSize, pEnd);
+  pPosition = pOriginalLog->scanRecordRange(&reader, pPosition, segmentEnd,
+              autorepair);
+  pProgress.processed = std::min(pPosition, pEnd);
+}
+
+//------------------------------------------------------------------------------
+// Copy the selected records to the new log
+//------------------------------------------------------------------------------
+void ChangeLogCompactor::copy()
+{
+  for (auto& record : pRecords) {
+    record.newOffset = pNewLog->storeRecord(record.type, record.buffer);
+  }
+}
+
+EOSNSNAMESPACE_END
@@ -0,0 +1,266 @@
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2019 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+//------------------------------------------------------------------------------
+// desc:   Incremental compacting of a change log
+//------------------------------------------------------------------------------
+
+#ifndef EOS_NS_CHANGE_LOG_COMPACTOR_HH
+#define EOS_NS_CHANGE_LOG_COMPACTOR_HH
+
+#include "namespace/Namespace.hh"
+#include "namespace/interface/Misc.hh"
+#include "namespace/ns_in_memory/persistency/ChangeLogFile.hh"
+#include "namespace/ns_in_memory/persistency/ChangeLogConstants.hh"
+#include <stdint.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+EOSNSNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! State of an incremental compacting of a change log
+//!
+//! The original log is processed in segments of a fixed size from the
+//! beginning to the end, including the records appended while compacting.
+//! For every segment the records are read without any lock, the records
+//! still referenced by the id map are selected under the namespace read
+//! lock, copied to the new log without any lock and the id map is pointed to
+//! the copies under the namespace write lock. An offset of the id map refers
+//! to the new log once its record has been copied, the offsets of both logs
+//! can not be confused since a copy never has a larger offset than any
+//! record of the original log which is still to be processed. Delete
+//! records written after the start are copied too, so that objects copied
+//! before they were deleted are not resurrected by the new log. The original
+//! offsets of the remapped entries are kept, so that an aborted compacting
+//! can point the id map back to the original log.
+//------------------------------------------------------------------------------
+class ChangeLogCompactor
+{
+public:
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //!
+  //! @param originalLog log to be compacted
+  //----------------------------------------------------------------------------
+  ChangeLogCompactor(ChangeLogFile* originalLog);
+
+  //----------------------------------------------------------------------------
+  //! Destructor
+  //----------------------------------------------------------------------------
+  ~ChangeLogCompactor()
+  {
+    if (pNewLog && pNewLog->isOpen()) {
+      pNewLog->close();
+    }
+
+    delete pNewLog;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Create the new log
+  //----------------------------------------------------------------------------
+  void open(const std::string& newLogFileName, uint16_t contentFlag);
+
+  //----------------------------------------------------------------------------
+  //! Read the records of the next segment, needs no lock
+  //----------------------------------------------------------------------------
+  void readSegment(bool autorepair);
+
+  //----------------------------------------------------------------------------
+  //! Keep only the records of the segment still referenced by the id map,
+  //! needs the namespace read lock
+  //----------------------------------------------------------------------------
+  template<typename IdMap>
+  void select(const IdMap& idMap)
+  {
+    size_t n = 0;
+
+    for (size_t i = 0; i < pRecords.size(); ++i) {
+      if (pRecords[i].type == UPDATE_RECORD_MAGIC) {
+        auto it = idMap.find(pRecords[i].id);
+
+        if ((it == idMap.end()) || (it->second.logOffset != pRecords[i].offset)) {
+          continue;
+        }
+      }
+
+      if (n != i) {
+        pRecords[n] = pRecords[i];
+      }
+
+      ++n;
+    }
+
+    pRecords.resize(n);
+  }
+
+  //----------------------------------------------------------------------------
+  //! Copy the selected records to the new log, needs no lock
+  //----------------------------------------------------------------------------
+  void copy();
+
+  //----------------------------------------------------------------------------
+  //! Point the id map to the copied records unless they were updated in the
+  //! meantime, needs the namespace write lock
+  //----------------------------------------------------------------------------
+  template<typename IdMap>
+  void remap(IdMap& idMap)
+  {
+    for (auto& record : pRecords) {
+      if (record.type != UPDATE_RECORD_MAGIC) {
+        continue;
+      }
+
+      auto it = idMap.find(record.id);
+
+      if ((it != idMap.end()) && (it->second.logOffset == record.offset)) {
+        it.value().logOffset = record.newOffset;
+        pRemapped.push_back(Remapped{record.id, record.offset, record.newOffset});
+      }
+    }
+
+    pProgress.copied += pRecords.size();
+    pProgress.segments++;
+    pRecords.clear();
+  }
+
+  //----------------------------------------------------------------------------
+  //! Point the id map back to the original log for the records which were
+  //! not updated since they were remapped, needs the namespace write lock
+  //----------------------------------------------------------------------------
+  template<typename IdMap>
+  void restore(IdMap& idMap)
+  {
+    for (auto& remapped : pRemapped) {
+      auto it = idMap.find(remapped.id);
+
+      if ((it != idMap.end()) && (it->second.logOffset == remapped.newOffset)) {
+        it.value().logOffset = remapped.offset;
+      }
+    }
+
+    pRemapped.clear();
+  }
+
+  //----------------------------------------------------------------------------
+  //! Update the end of the original log, needs the namespace read lock
+  //----------------------------------------------------------------------------
+  void updateEnd()
+  {
+    pEnd = pOriginalLog->getNextOffset();
+    pProgress.total = pEnd;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Check if the original log has been processed up to its known end
+  //----------------------------------------------------------------------------
+  bool finished() const
+  {
+    return pPosition >= pEnd;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Check if the rest of the original log is small enough to be compacted
+  //! in one go while holding the write lock. The tail is also accepted after
+  //! kMaxCatchUpSegments segments appended since the start, so that a busy
+  //! namespace can not keep the compacting from ever finishing.
+  //----------------------------------------------------------------------------
+  bool tailIsSmall() const
+  {
+    return ((pEnd - std::min(pPosition, pEnd)) <= pSegmentSize) ||
+           (pCatchUpSegments >= kMaxCatchUpSegments);
+  }
+
+  //----------------------------------------------------------------------------
+  //! Record the write lock hold time of a segment
+  //----------------------------------------------------------------------------
+  void recordPause(uint64_t us)
+  {
+    pProgress.lastPauseUs = us;
+
+    if (us > pProgress.maxPauseUs) {
+      pProgress.maxPauseUs = us;
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  //! Release the new log to the caller
+  //----------------------------------------------------------------------------
+  ChangeLogFile* releaseNewLog()
+  {
+    ChangeLogFile* log = pNewLog;
+    pNewLog = 0;
+    return log;
+  }
+
+  const std::string& getLogFileName() const
+  {
+    return pLogFileName;
+  }
+
+  ChangeLogFile* getOriginalLog() const
+  {
+    return pOriginalLog;
+  }
+
+  const CompactingProgress& getProgress() const
+  {
+    return pProgress;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Copy of a record of the original log
+  //----------------------------------------------------------------------------
+  struct Record {
+    uint64_t offset;
+    uint64_t newOffset;
+    uint64_t id;
+    uint8_t  type;
+    Buffer   buffer;
+  };
+
+private:
+  //----------------------------------------------------------------------------
+  //! Id map entry pointed to a copy
+  //----------------------------------------------------------------------------
+  struct Remapped {
+    uint64_t id;
+    uint64_t offset;
+    uint64_t newOffset;
+  };
+
+  static constexpr uint64_t kMaxCatchUpSegments = 16;
+
+  std::string         pLogFileName;
+  ChangeLogFile*      pNewLog;
+  ChangeLogFile*      pOriginalLog;
+  uint64_t            pStartEnd; ///< end of the original log at the start
+  uint64_t            pPosition; ///< next offset to process
+  uint64_t            pEnd; ///< known end of the original log
+  uint64_t            pSegmentSize;
+  uint64_t            pCatchUpSegments; ///< segments read beyond pStartEnd
+  std::vector<Record> pRecords; ///< records of the current segment
+  std::vector<Remapped> pRemapped; ///< original offsets of the copies
+  CompactingProgress  pProgress;
+};
+
+EOSNSNAMESPACE_END
+
+#endif // EOS_NS_CHANGE_LOG_COMPACTOR_HH
@@ -45,6 +45,9 @@
 #include <stdio.h>
 #include <fcntl.h>
 #include <sys/mman.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
 
 #define CHANGELOG_MAGIC 0x45434847
 #define RECORD_MAGIC    0x4552
@@ -626,13 +629,37 @@ uint64_t ChangeLogFile::scanAllRecordsAtOffset(ILogRecordScanner* scanner,
     checksum = false;
   }
 
+  //--------------------------------------------------------------------------
+  // Verify the checksums of a mmaped file in parallel first, the records are
+  // then applied in order without checksumming them again as long as the
+  // scan follows the chain of records verified by the threads
+  //--------------------------------------------------------------------------
+  std::vector<VerifiedRange> verified;
+  size_t range = 0;
+  uint64_t verifiedEnd = 0;
+
+  if (pData && checksum) {
+    verified = verifyMappedRecords(offset, std::min(end, pDataLen));
+  }
+
   while (offset < end) {
     bool proceed = false;
     bool readerror = false;
 
+    while ((range < verified.size()) &&
+           (verified[range].start < (uint64_t) offset)) {
+      ++range;
+    }
+
+    if ((range < verified.size()) &&
+        (verified[range].start == (uint64_t) offset)) {
+      verifiedEnd = verified[range].end;
+    }
+
     try {
       if (pData) {
-        type = readMappedRecord(offset, data, checksum);
+        type = readMappedRecord(offset, data,
+                                checksum && ((uint64_t) offset >= verifiedEnd));
       } else {
         type = readRecord(offset, data, true);
       }
@@ -645,51 +672,8 @@ uint64_t ChangeLogFile::scanAllRecordsAtOffset(ILogRecordScanner* scanner,
     }
 
     if (readerror) {
-      if (autorepair) {
-        // evt. try to skip this record
-        off_t newOffset = ChangeLogFile::findRecordMagic(pFd, offset + 4, (off_t)0);
-
-        if (newOffset == (off_t) - 1) {
-          char msg[4096];
-          snprintf(msg, 4096,
-                   "error: definite corruption in file changelog after offset %llx\n",
-                   (long long)offset);
-          addWarningMessage(msg);
-          MDException ex(EIO);
-          ex.getMessage() <<
-                          "error: Changelog file has a corruption at end of file - check synchronization or repair the file manually";
-          throw ex;
-        }
-
-        if ((newOffset - offset) < 1024) {
-          char msg[4096];
-          snprintf(msg, 4096,
-                   "error: discarded block from offset [ %llx <=> %llx ] [ len=%lu ] \n",
-                   (long long)offset, (long long)newOffset, (unsigned long)(newOffset - offset));
-          addWarningMessage(msg);
-          offset = newOffset;
-          continue;
-        } else {
-          char msg[4096];
-          snprintf(msg, 4096,
-                   "error: large block corruption at offset [ %llx <=> %llx ] [ len=%lu ] \n",
-                   (long long)offset, (long long)newOffset, (unsigned long)(newOffset - offset));
-          addWarningMessage(msg);
-          MDException ex(EIO);
-          ex.getMessage() <<
-                          "error: Changelog file has a >1kb corruption - too risky - repair the file manually";
-          throw ex;
-        }
-      } else {
-        char msg[4096];
-        snprintf(msg, 4096, "error: corruption in file changelog at offset %llx\n",
-                 (long long)offset);
-        addWarningMessage(msg);
-        MDException ex(EIO);
-        ex.getMessage() <<
-                        "error: Changelog file has corruption - autorepair is disabled";
-        throw ex;
-      }
+      offset = skipCorruptedRecord(offset, autorepair);
+      continue;
     }
 
     if (!proceed) {
@@ -722,6 +706,94 @@ uint64_t ChangeLogFile::scanAllRecordsAtOffset(ILogRecordScanner* scanner,
   return offset;
 }
 
+//----------------------------------------------------------------------------
+// Find the record following a corrupted one
+//----------------------------------------------------------------------------
+off_t ChangeLogFile::skipCorruptedRecord(off_t offset, bool autorepair)
+{
+  if (autorepair) {
+    // evt. try to skip this record
+    off_t newOffset = ChangeLogFile::findRecordMagic(pFd, offset + 4, (off_t)0);
+
+    if (newOffset == (off_t) - 1) {
+      char msg[4096];
+      snprintf(msg, 4096,
+               "error: definite corruption in file changelog after offset %llx\n",
+               (long long)offset);
+      addWarningMessage(msg);
+      MDException ex(EIO);
+      ex.getMessage() <<
+                      "error: Changelog file has a corruption at end of file - check synchronization or repair the file manually";
+      throw ex;
+    }
+
+    if ((newOffset - offset) < 1024) {
+      char msg[4096];
+      snprintf(msg, 4096,
+               "error: discarded block from offset [ %llx <=> %llx ] [ len=%lu ] \n",
+               (long long)offset, (long long)newOffset, (unsigned long)(newOffset - offset));
+      addWarningMessage(msg);
+      return newOffset;
+    }
+
+    char msg[4096];
+    snprintf(msg, 4096,
+             "error: large block corruption at offset [ %llx <=> %llx ] [ len=%lu ] \n",
+             (long long)offset, (long long)newOffset, (unsigned long)(newOffset - offset));
+    addWarningMessage(msg);
+    MDException ex(EIO);
+    ex.getMessage() <<
+                    "error: Changelog file has a >1kb corruption - too risky - repair the file manually";
+    throw ex;
+  }
+
+  char msg[4096];
+  snprintf(msg, 4096, "error: corruption in file changelog at offset %llx\n",
+           (long long)offset);
+  addWarningMessage(msg);
+  MDException ex(EIO);
+  ex.getMessage() <<
+                  "error: Changelog file has corruption - autorepair is disabled";
+  throw ex;
+}
+
+//----------------------------------------------------------------------------
+// Scan the records starting in a range of the changelog file
+//----------------------------------------------------------------------------
+uint64_t ChangeLogFile::scanRecordRange(ILogRecordScanner* scanner,
+                                        uint64_t startOffset,
+                                        uint64_t endOffset, bool autorepair)
+{
+  if (!pIsOpen) {
+    MDException ex(EFAULT);
+    ex.getMessage() << "Scan: Changelog file is not open";
+    throw ex;
+  }
+
+  off_t offset = startOffset;
+  Buffer data;
+
+  while ((uint64_t) offset < endOffset) {
+    uint8_t type;
+
+    try {
+      type = readRecord(offset, data);
+    } catch (MDException& e) {
+      offset = skipCorruptedRecord(offset, autorepair);
+      continue;
+    }
+
+    if (!scanner->processRecord(offset, type, data)) {
+      break;
+    }
+
+    offset += data.getSize();
+    offset += 24;
+  }
+
+  return offset;
+}
+
 //----------------------------------------------------------------------------
 // Follow a file
 //----------------------------------------------------------------------------
@@ -876,6 +948,137 @@ off_t ChangeLogFile::findRecordMagic(int fd, off_t offset, off_t offsetLimit)
   return -1;
 }
 
+//----------------------------------------------------------------------------
+// Find the record header starting at offset in a mmaped changelog file
+//----------------------------------------------------------------------------
+off_t ChangeLogFile::findRecordMagic(const char* data, off_t offset,
+                                     off_t offsetLimit)
+{
+  uint32_t magic = 0;
+
+  for (; offset + 4 <= offsetLimit; offset += 4) {
+    memcpy(&magic, data + offset, 4);
+
+    if ((magic & 0x0000ffff) == RECORD_MAGIC) {
+      return offset;
+    }
+  }
+
+  return -1;
+}
+
+//----------------------------------------------------------------------------
+// Check the record at given offset when changelog file is mmaped
+//----------------------------------------------------------------------------
+uint64_t ChangeLogFile::checkMappedRecord(uint64_t offset, uint64_t end) const
+{
+  if (offset + 24 > end) {
+    return 0;
+  }
+
+  const char* buffer = pData + offset;
+  uint16_t magic;
+  uint16_t size;
+  uint32_t chkSum1;
+  uint32_t chkSum2;
+  memcpy(&magic, buffer, 2);
+  memcpy(&size, buffer + 2, 2);
+  memcpy(&chkSum1, buffer + 4, 4);
+
+  if ((magic != RECORD_MAGIC) || (offset + 24 + size > end)) {
+    return 0;
+  }
+
+  memcpy(&chkSum2, buffer + 20 + size, 4);
+  uint32_t crc = DataHelper::computeCRC32((void*)(buffer + 8), 8); // seq
+  crc = DataHelper::updateCRC32(crc, (void*)(buffer + 16), 4); // opts
+  crc = DataHelper::updateCRC32(crc, (void*)(buffer + 20), size);
+
+  if (chkSum1 != crc || chkSum1 != chkSum2) {
+    return 0;
+  }
+
+  return offset + 24 + size;
+}
+
+//----------------------------------------------------------------------------
+// Verify the checksums of the records of a mmaped changelog file in parallel
+//----------------------------------------------------------------------------
+std::vector<ChangeLogFile::VerifiedRange>
+ChangeLogFile::verifyMappedRecords(uint64_t startOffset, uint64_t end)
+{
+  static const uint64_t minRangeSize = 16 * 1024 * 1024;
+  std::vector<VerifiedRange> ranges;
+  unsigned int nthreads = std::thread::hardware_concurrency();
+
+  if (getenv("EOS_NS_SCAN_THREADS")) {
+    nthreads = strtoul(getenv("EOS_NS_SCAN_THREADS"), 0, 10);
+  }
+
+  if ((nthreads < 2) || (end < startOffset + 2 * minRangeSize)) {
+    return ranges;
+  }
+
+  // A few ranges per thread to balance the load, the first one starts at a
+  // known record boundary and the others at the first valid record
+  // following their nominal start. A record found like that might still
+  // be the payload of another record, in which case the scan simply does
+  // not pass through its start and checksums the records on its own.
+  uint64_t nranges = std::min<uint64_t>(4 * nthreads,
+                                        (end - startOffset) / minRangeSize);
+  uint64_t rangeSize = ((end - startOffset) / nranges) & ~((uint64_t) 3);
+  ranges.push_back(VerifiedRange{startOffset, startOffset});
+
+  for (uint64_t i = 1; i < nranges; ++i) {
+    off_t offset = ((startOffset + i * rangeSize) + 3) & ~((uint64_t) 3);
+    off_t limit = std::min(end, startOffset + (i + 1) * rangeSize);
+
+    while ((offset = findRecordMagic(pData, offset, limit)) != -1) {
+      if (checkMappedRecord(offset, end)) {
+        ranges.push_back(VerifiedRange{(uint64_t) offset, (uint64_t) offset});
+        break;
+      }
+
+      offset += 4;
+    }
+  }
+
+  std::atomic<size_t> next(0);
+  std::vector<std::thread> workers;
+  time_t start_time = time(0);
+
+  for (unsigned int t = 0; t < std::min<size_t>(nthreads, ranges.size()); ++t) {
+    workers.emplace_back([&]() {
+      size_t i;
+
+      while ((i = next++) < ranges.size()) {
+        uint64_t limit = (i + 1 < ranges.size()) ? ranges[i + 1].start : end;
+        uint64_t offset = ranges[i].start;
+        uint64_t nextOffset;
+
+        while ((offset < limit) && (nextOffset = checkMappedRecord(offset, end))) {
+          offset = nextOffset;
+        }
+
+        ranges[i].end = offset;
+      }
+    });
+  }
+
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  std::string fname = pFileName;
+  fname.erase(0, pFileName.rfind("/") + 1);
+  fprintf(stderr, "INFO     [ verified %lu MB of %s in %lu ranges with %u "
+          "threads in %ds ]\n", (unsigned long)((end - startOffset) >> 20),
+          fname.c_str(), (unsigned long) ranges.size(),
+          (unsigned int) std::min<size_t>(nthreads, ranges.size()),
+          (int)(time(0) - start_time));
+  return ranges;
+}
+
 //----------------------------------------------------------------------------
 // Wait for a modification event in a changelog file with inotify or if not
 // available wait <polltime> micro seconds
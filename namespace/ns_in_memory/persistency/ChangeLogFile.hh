@@ -28,6 +28,7 @@
 #include <stdint.h>
 #include <ctime>
 #include <pthread.h>
+#include <vector>
 
 #include "namespace/MDException.hh"
 #include "namespace/utils/Buffer.hh"
@@ -208,6 +209,16 @@ public:
                                   uint64_t           startOffset,
                                   bool               autorepair = false);
 
+  //------------------------------------------------------------------------
+  //! Scan the records starting in the range [startOffset, endOffset), the
+  //! last record may extend beyond endOffset. No progress is reported so
+  //! it can be used for small parts of a log which is in use.
+  //!
+  //! @return offset of the record following the last scanned record
+  //------------------------------------------------------------------------
+  uint64_t scanRecordRange(ILogRecordScanner* scanner, uint64_t startOffset,
+                           uint64_t endOffset, bool autorepair = false);
+
   //------------------------------------------------------------------------
   //! Follow the new records in a file starting at a given offset and
   //! ignore incomplete records at the end
@@ -280,6 +291,11 @@ public:
   //------------------------------------------------------------------------
   static off_t findRecordMagic(int fd, off_t offset, off_t limit);
 
+  //------------------------------------------------------------------------
+  // Find forward the next record magic in a mmaped changelog file
+  //------------------------------------------------------------------------
+  static off_t findRecordMagic(const char* data, off_t offset, off_t limit);
+
   //------------------------------------------------------------------------
   // Add Warning Message
   //------------------------------------------------------------------------
@@ -340,11 +356,50 @@ private:
   //------------------------------------------------------------------------
   void cleanUpInotify();
 
+  //------------------------------------------------------------------------
+  //! Find the record following a corrupted one
+  //!
+  //! @param offset     offset of the corrupted record
+  //! @param autorepair skip the corruption if it is small enough
+  //!
+  //! @return offset of the next record, throws if the corruption can not
+  //!         be skipped
+  //------------------------------------------------------------------------
+  off_t skipCorruptedRecord(off_t offset, bool autorepair);
+
   //------------------------------------------------------------------------
   //! Read the record at given offset when changelog file is mmaped
   //------------------------------------------------------------------------
   uint8_t readMappedRecord(uint64_t offset, Buffer& record, bool checksum = true);
 
+  //------------------------------------------------------------------------
+  //! Check the magic, the size and the checksums of the record at given
+  //! offset when changelog file is mmaped
+  //!
+  //! @return offset of the following record or 0 if the record is broken
+  //------------------------------------------------------------------------
+  uint64_t checkMappedRecord(uint64_t offset, uint64_t end) const;
+
+  //------------------------------------------------------------------------
+  //! Part of a mmaped changelog file verified by a scanner thread: all the
+  //! records following each other from start up to end have valid checksums
+  //------------------------------------------------------------------------
+  struct VerifiedRange {
+    uint64_t start;
+    uint64_t end;
+  };
+
+  //------------------------------------------------------------------------
+  //! Verify the checksums of the records of a mmaped changelog file in
+  //! parallel. The file is split into ranges starting at record boundaries
+  //! found with findRecordMagic and every range is verified by one thread.
+  //!
+  //! @return verified ranges sorted by offset, empty if the file is too
+  //!         small to be worth it
+  //------------------------------------------------------------------------
+  std::vector<VerifiedRange> verifyMappedRecords(uint64_t startOffset,
+      uint64_t end);
+
   //------------------------------------------------------------------------
   // Read function with prefetching to speed-up things
   //------------------------------------------------------------------------
@@ -34,6 +34,7 @@
 #include "XrdSys/XrdSysTimer.hh"
 
 #include <algorithm>
+#include <chrono>
 #include <utility>
 #include <set>
 #include <features.h>
@@ -742,9 +743,12 @@ void ChangeLogFileMDSvc::initialize()
 
   if (!pSlaveMode || logIsCompacted) {
     FileMDScanner scanner(pIdMap, pSlaveMode);
+    uint64_t startOffset = pChangeLog->getFirstOffset();
+    uint64_t checkpointLargestId = 0;
+    loadCheckpoint(startOffset, checkpointLargestId);
     pChangeLog->mmap();
-    pFollowStart = pChangeLog->scanAllRecords(&scanner);
-    pFirstFreeId = scanner.getLargestId() + 1;
+    pFollowStart = pChangeLog->scanAllRecordsAtOffset(&scanner, startOffset);
+    pFirstFreeId = std::max(scanner.getLargestId(), checkpointLargestId) + 1;
     time_t start_time = time(0);
     time_t now = start_time;
     uint64_t end = pIdMap.size();
@@ -964,6 +968,205 @@ void ChangeLogFileMDSvc::initialize()
     // If we have a new changelog file in master mode we add the compaction mark
     pChangeLog->addCompactionMark();
   }
+
+  if (!pSlaveMode) {
+    checkpoint();
+  }
+}
+
+//------------------------------------------------------------------------------
+// Fill the id map from the checkpoint of the change log
+//------------------------------------------------------------------------------
+bool ChangeLogFileMDSvc::loadCheckpoint(uint64_t& startOffset,
+                                        uint64_t& largestId)
+{
+  std::string path = ChangeLogCheckpoint::getPath(pChangeLogPath);
+
+  if (pSlaveMode || getenv("EOS_NS_BOOT_NOCHECKPOINT") ||
+      ::access(path.c_str(), F_OK)) {
+    return false;
+  }
+
+  ChangeLogCheckpoint ckp;
+  std::string err;
+
+  if (!ckp.open(path, pChangeLogPath, FILE_LOG_MAGIC, err)) {
+    fprintf(stderr, "ALERT    [ ignoring file checkpoint: %s ]\n", err.c_str());
+    return false;
+  }
+
+  time_t start_time = time(0);
+  const ChangeLogCheckpoint::Entry* entries = ckp.entries();
+
+  try {
+    // The entries are sorted by offset, so the records are read sequentially
+    // and the read cache of the change log is effective
+    for (uint64_t i = 0; i < ckp.size(); ++i) {
+      DataInfo& d = pIdMap[entries[i].id];
+      d.logOffset = entries[i].offset;
+      d.buffer = new Buffer(0);
+      IFileMD::id_t id = 0;
+
+      if (pChangeLog->readRecord(entries[i].offset, *d.buffer, true) !=
+          UPDATE_RECORD_MAGIC) {
+        MDException e(EFAULT);
+        e.getMessage() << "no update record at offset " << entries[i].offset;
+        throw e;
+      }
+
+      d.buffer->grabData(0, &id, sizeof(IFileMD::id_t));
+
+      if (id != entries[i].id) {
+        MDException e(EFAULT);
+        e.getMessage() << "record at offset " << entries[i].offset
+                       << " does not belong to file #" << entries[i].id;
+        throw e;
+      }
+    }
+  } catch (MDException& e) {
+    fprintf(stderr, "ALERT    [ ignoring file checkpoint: %s ]\n",
+            e.getMessage().str().c_str());
+
+    for (auto it = pIdMap.begin(); it != pIdMap.end(); ++it) {
+      delete it->second.buffer;
+    }
+
+    pIdMap.clear();
+    return false;
+  }
+
+  startOffset = ckp.getLogEnd();
+  largestId = ckp.getLargestId();
+  fprintf(stderr, "ALERT    [ %-64s ] loaded %lu files in %ds, replaying the "
+          "change log from offset=%lu\n", "file-checkpoint",
+          (unsigned long) ckp.size(), (int)(time(0) - start_time),
+          (unsigned long) startOffset);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Write a checkpoint of the id map in the background
+//------------------------------------------------------------------------------
+void ChangeLogFileMDSvc::checkpoint()
+{
+  if (pSlaveMode || !pCheckpointInterval || pCheckpointRunning ||
+      pIncrementalCompacting) {
+    return;
+  }
+
+  if (pCheckpointThread.joinable()) {
+    pCheckpointThread.join();
+  }
+
+  pNextCheckpoint = time(0) + pCheckpointInterval;
+  std::string logPath;
+  uint64_t logEnd = 0;
+  uint64_t largestId = 0;
+  uint64_t logInode = 0;
+  uint32_t logCrc = 0;
+  std::vector<ChangeLogCheckpoint::Entry> entries;
+  std::string err;
+  pCheckpointStop = false;
+
+  // Without a namespace lock nothing else may access the id map, it is
+  // copied before returning
+  if (!pSlaveLock && !copyIdMap(0, logPath, logEnd, largestId, logInode,
+                                logCrc, entries, err)) {
+    fprintf(stderr, "ALERT    [ failed to write file checkpoint: %s ]\n",
+            err.c_str());
+    return;
+  }
+
+  LockHandler* lock = pSlaveLock;
+  pCheckpointRunning = true;
+  pCheckpointThread = std::thread([this, lock, logPath, logEnd, largestId,
+  logInode, logCrc, entries = std::move(entries)]() mutable {
+    std::string err;
+    time_t start_time = time(0);
+
+    if ((!lock || copyIdMap(lock, logPath, logEnd, largestId, logInode,
+                            logCrc, entries, err)) &&
+        ChangeLogCheckpoint::write(ChangeLogCheckpoint::getPath(logPath),
+                                   FILE_LOG_MAGIC, logEnd, largestId,
+                                   logInode, logCrc, entries, err)) {
+      fprintf(stderr, "INFO     [ wrote file checkpoint of %s with %lu entries "
+              "at offset=%lu in %ds ]\n", logPath.c_str(),
+              (unsigned long) entries.size(), (unsigned long) logEnd,
+              (int)(time(0) - start_time));
+    } else {
+      fprintf(stderr, "ALERT    [ failed to write file checkpoint: %s ]\n",
+              err.c_str());
+    }
+
+    pCheckpointRunning = false;
+  });
+}
+
+//------------------------------------------------------------------------------
+// Copy the record index of the id map for a checkpoint
+//------------------------------------------------------------------------------
+bool ChangeLogFileMDSvc::copyIdMap(LockHandler* lock, std::string& logPath,
+    uint64_t& logEnd, uint64_t& largestId, uint64_t& logInode,
+    uint32_t& logCrc, std::vector<ChangeLogCheckpoint::Entry>& entries,
+    std::string& err)
+{
+  if (!ChangeLogCheckpoint::readLock(lock, pCheckpointStop)) {
+    err = "checkpoint stopped";
+    return false;
+  }
+
+  logPath = pChangeLogPath;
+  logEnd = pChangeLog->getNextOffset();
+  largestId = pFirstFreeId - 1;
+  uint64_t generation = pLogGeneration;
+  entries.reserve(pIdMap.size());
+
+  if (lock) {
+    lock->unLock();
+  }
+
+  if (!ChangeLogCheckpoint::identifyLog(logPath, logEnd, logInode, logCrc,
+                                        err)) {
+    return false;
+  }
+
+  // The map is walked by id and not by iterator, an insert between two
+  // chunks may rehash it. Entries changed after logEnd are left out, their
+  // records are replayed by the boot anyway.
+  for (uint64_t first = 0; first <= largestId;
+       first += ChangeLogCheckpoint::sChunkSize) {
+    if (!ChangeLogCheckpoint::readLock(lock, pCheckpointStop)) {
+      err = "checkpoint stopped";
+      return false;
+    }
+
+    if (pIncrementalCompacting || (generation != pLogGeneration)) {
+      if (lock) {
+        lock->unLock();
+      }
+
+      err = "change log compacted while copying the id map";
+      return false;
+    }
+
+    uint64_t last = std::min(largestId,
+                             first + ChangeLogCheckpoint::sChunkSize - 1);
+
+    for (uint64_t id = first; id <= last; ++id) {
+      auto it = pIdMap.find(id);
+
+      if ((it != pIdMap.end()) && it->second.logOffset &&
+          (it->second.logOffset < logEnd)) {
+        entries.push_back(ChangeLogCheckpoint::Entry{id, it->second.logOffset});
+      }
+    }
+
+    if (lock) {
+      lock->unLock();
+    }
+  }
+
+  return true;
 }
 
 //------------------------------------------------------------------------------
@@ -1064,6 +1267,11 @@ void ChangeLogFileMDSvc::configure(
     throw e;
   }
 
+  if (pChangeLogPath != it->second) {
+    // A renamed change log (e.g. after compacting) gets a new checkpoint
+    pNextCheckpoint = 0;
+  }
+
   pChangeLogPath = it->second;
   // Check whether we should run in the slave mode
   it = config.find("slave_mode");
@@ -1087,6 +1295,12 @@ void ChangeLogFileMDSvc::configure(
   if (it != config.end()) {
     pResSize = strtoull(it->second.c_str(), 0, 10);
   }
+
+  it = config.find("checkpoint_interval");
+
+  if (it != config.end()) {
+    pCheckpointInterval = strtoull(it->second.c_str(), 0, 10);
+  }
 }
 
 //------------------------------------------------------------------------------
@@ -1094,6 +1308,7 @@ void ChangeLogFileMDSvc::configure(
 //------------------------------------------------------------------------------
 void ChangeLogFileMDSvc::finalize()
 {
+  stopCheckpoint();
   pChangeLog->close();
   pIdMap.clear();
 }
@@ -1174,6 +1389,7 @@ void ChangeLogFileMDSvc::updateStore(IFileMD* obj)
                          buffer);
   IFileMDChangeListener::Event e(obj, IFileMDChangeListener::Updated);
   notifyListeners(&e);
+  checkpointIfDue();
 }
 
 //------------------------------------------------------------------------------
@@ -1199,6 +1415,7 @@ void ChangeLogFileMDSvc::removeFile(IFileMD* obj)
   IFileMDChangeListener::Event e(obj, IFileMDChangeListener::Deleted);
   notifyListeners(&e);
   pIdMap.erase(it);
+  checkpointIfDue();
 }
 
 //------------------------------------------------------------------------------
@@ -1450,6 +1667,129 @@ void ChangeLogFileMDSvc::compactCommit(void* compactingData, bool autorepair)
   data->newLog = 0;
   data->originalLog->close();
   delete data;
+  ++pLogGeneration;
+  // The compacted log is checkpointed once it got its final name
+  pNextCheckpoint = time(0) + pCheckpointInterval;
+}
+
+//------------------------------------------------------------------------------
+// Prepare for incremental online compacting
+//------------------------------------------------------------------------------
+void* ChangeLogFileMDSvc::compactIncrementalPrepare(const std::string& newLogFileName)
+{
+  ChangeLogCompactor* data = new ChangeLogCompactor(pChangeLog);
+
+  try {
+    data->open(newLogFileName, FILE_LOG_MAGIC);
+  } catch (MDException& e) {
+    delete data;
+    throw;
+  }
+
+  // The id map points partially to the new log until the commit so no
+  // checkpoint can be taken
+  pIncrementalCompacting = true;
+  return data;
+}
+
+//------------------------------------------------------------------------------
+// Compact the next segment of the log
+//------------------------------------------------------------------------------
+bool ChangeLogFileMDSvc::compactSegment(void* compactingData,
+                                        LockHandler* lock, bool autorepair)
+{
+  ChangeLogCompactor* data = (ChangeLogCompactor*)compactingData;
+
+  if (!data || !lock) {
+    MDException e(EINVAL);
+    e.getMessage() << "Compacting data incorrect";
+    throw e;
+  }
+
+  data->readSegment(autorepair);
+  lock->readLock();
+  data->select(pIdMap);
+  data->updateEnd();
+  lock->unLock();
+  data->copy();
+  lock->writeLock();
+  auto start = std::chrono::steady_clock::now();
+  data->remap(pIdMap);
+  auto pause = std::chrono::duration_cast<std::chrono::microseconds>
+               (std::chrono::steady_clock::now() - start).count();
+  lock->unLock();
+  data->recordPause(pause);
+  return data->tailIsSmall();
+}
+
+//------------------------------------------------------------------------------
+// Commit the incremental compacting
+//------------------------------------------------------------------------------
+void ChangeLogFileMDSvc::compactIncrementalCommit(void* compactingData,
+    bool autorepair)
+{
+  ChangeLogCompactor* data = (ChangeLogCompactor*)compactingData;
+
+  if (!data) {
+    MDException e(EINVAL);
+    e.getMessage() << "Compacting data incorrect";
+    throw e;
+  }
+
+  // Copy whatever has been appended since the last segment, on failure the
+  // caller has to abort the compacting
+  data->updateEnd();
+
+  while (!data->finished()) {
+    data->readSegment(autorepair);
+    data->select(pIdMap);
+    data->copy();
+    data->remap(pIdMap);
+  }
+
+  // Replace the logs
+  ChangeLogFile* originalLog = data->getOriginalLog();
+  pChangeLog = data->releaseNewLog();
+  pChangeLog->addCompactionMark();
+  pChangeLogPath = data->getLogFileName();
+  originalLog->close();
+  delete data;
+  pIncrementalCompacting = false;
+  ++pLogGeneration;
+  // The compacted log is checkpointed once it got its final name
+  pNextCheckpoint = time(0) + pCheckpointInterval;
+}
+
+//------------------------------------------------------------------------------
+// Abort the incremental compacting
+//------------------------------------------------------------------------------
+void ChangeLogFileMDSvc::compactIncrementalAbort(void* compactingData)
+{
+  ChangeLogCompactor* data = (ChangeLogCompactor*)compactingData;
+
+  if (data) {
+    // The namespace was never switched to the new log, only the entries
+    // pointed to the copies have to be restored
+    std::string logFileName = data->getLogFileName();
+    data->restore(pIdMap);
+    delete data;
+
+    if (!logFileName.empty()) {
+      ::unlink(logFileName.c_str());
+    }
+  }
+
+  ++pLogGeneration;
+  pIncrementalCompacting = false;
+}
+
+//------------------------------------------------------------------------------
+// Get the progress of an incremental compacting
+//------------------------------------------------------------------------------
+CompactingProgress ChangeLogFileMDSvc::getCompactingProgress(void* compactingData)
+{
+  ChangeLogCompactor* data = (ChangeLogCompactor*)compactingData;
+  return data ? data->getProgress() : CompactingProgress();
 }
 
 //------------------------------------------------------------------------------
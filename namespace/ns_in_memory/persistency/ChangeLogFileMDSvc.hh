@@ -30,6 +30,8 @@
 #include "namespace/interface/IChLogFileMDSvc.hh"
 #include "namespace/interface/IQuota.hh"
 #include "namespace/ns_in_memory/persistency/ChangeLogFile.hh"
+#include "namespace/ns_in_memory/persistency/ChangeLogCheckpoint.hh"
+#include "namespace/ns_in_memory/persistency/ChangeLogCompactor.hh"
 #include "common/Murmur3.hh"
 #include "common/hopscotch_map.hh"
 #include <google/sparse_hash_map>
@@ -37,6 +39,8 @@
 #include <list>
 #include <limits>
 #include <functional>
+#include <atomic>
+#include <thread>
 
 EOSNSNAMESPACE_BEGIN
 
@@ -58,10 +62,14 @@ public:
     pFirstFreeId(1), pChangeLog(0), pFollowerThread(0), pSlaveLock(0),
     pSlaveMode(false), pSlaveStarted(false), pSlavePoll(1000),
     pFollowStart(0), pFollowPending(0), pContSvc(0), pQuotaStats(0),
-    pAutoRepair(0), pResSize(1000000)
+    pAutoRepair(0), pResSize(1000000), pNextCheckpoint(0),
+    pCheckpointRunning(false), pCheckpointStop(false),
+    pLogGeneration(0), pIncrementalCompacting(false)
   {
     pChangeLog = new ChangeLogFile;
     pthread_mutex_init(&pFollowStartMutex, 0);
+    pCheckpointInterval = getenv("EOS_NS_CHECKPOINT_INTERVAL") ?
+                          strtoull(getenv("EOS_NS_CHECKPOINT_INTERVAL"), 0, 10) : 3600;
   }
 
   //----------------------------------------------------------------------------
@@ -69,6 +77,8 @@ public:
   //----------------------------------------------------------------------------
   virtual ~ChangeLogFileMDSvc()
   {
+    stopCheckpoint();
+
     delete pChangeLog;
   }
 
@@ -211,7 +221,57 @@ public:
   void compactCommit(void* compactingData, bool autorepair = false) override;
 
   //----------------------------------------------------------------------------
-  //! Register slave lock
+  //! Prepare for incremental online compacting, needs a read lock on the
+  //! namespace
+  //!
+  //! @param  newLogFileName name for the compacted log file
+  //! @return                compacting information that needs to be passed
+  //!                        to other functions
+  //----------------------------------------------------------------------------
+  void* compactIncrementalPrepare(const std::string& newLogFileName) override;
+
+  //----------------------------------------------------------------------------
+  //! Compact the next segment of the log, the namespace lock is taken
+  //! through the lock handler
+  //!
+  //! @param compactingData state information returned by
+  //!                       compactIncrementalPrepare
+  //! @param lock           namespace lock, must not be held by the caller
+  //! @param autorepair     indicate that broken records should be skipped
+  //!
+  //! @return true if the rest of the log is small enough to be committed
+  //----------------------------------------------------------------------------
+  bool compactSegment(void* compactingData, LockHandler* lock,
+                      bool autorepair = false) override;
+
+  //----------------------------------------------------------------------------
+  //! Compact the rest of the log and switch to the new log, needs an
+  //! exclusive lock on the namespace
+  //!
+  //! @param compactingData state information returned by
+  //!                       compactIncrementalPrepare
+  //! @param autorepair     indicate that broken records should be skipped
+  //----------------------------------------------------------------------------
+  void compactIncrementalCommit(void* compactingData,
+                                bool autorepair = false) override;
+
+  //----------------------------------------------------------------------------
+  //! Point the id map back to the original log and drop the new log, needs
+  //! an exclusive lock on the namespace
+  //!
+  //! @param compactingData state information returned by
+  //!                       compactIncrementalPrepare
+  //----------------------------------------------------------------------------
+  void compactIncrementalAbort(void* compactingData) override;
+
+  //----------------------------------------------------------------------------
+  //! Get the progress of an incremental compacting
+  //----------------------------------------------------------------------------
+  CompactingProgress getCompactingProgress(void* compactingData) override;
+
+  //----------------------------------------------------------------------------
+  //! Register the namespace lock, used by the slave follower and by the
+  //! checkpoint thread of a master
   //----------------------------------------------------------------------------
   void setSlaveLock(LockHandler* slaveLock) override
   {
@@ -403,6 +463,69 @@ private:
   //----------------------------------------------------------------------------
   void attachBroken(const std::string& parent, IFileMD* file);
 
+  //----------------------------------------------------------------------------
+  //! Fill the id map from the checkpoint of the change log
+  //!
+  //! @param startOffset change log offset to continue the scan at
+  //! @param largestId   largest id used when the checkpoint was written
+  //!
+  //! @return true if the checkpoint was used, otherwise the id map is empty
+  //----------------------------------------------------------------------------
+  bool loadCheckpoint(uint64_t& startOffset, uint64_t& largestId);
+
+  //----------------------------------------------------------------------------
+  //! Write a checkpoint of the id map in the background. With a namespace
+  //! lock the id map is copied by the checkpoint thread, without one it is
+  //! copied right away and the caller has to prevent any modification of the
+  //! namespace while this runs (end of the boot).
+  //----------------------------------------------------------------------------
+  void checkpoint();
+
+  //----------------------------------------------------------------------------
+  //! Start a checkpoint if the checkpoint interval has passed, only done when
+  //! the id map can be copied in the background
+  //----------------------------------------------------------------------------
+  void checkpointIfDue()
+  {
+    if (pCheckpointInterval && pSlaveLock && (time(0) >= pNextCheckpoint)) {
+      checkpoint();
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  //! Stop a running checkpoint and wait for its thread
+  //----------------------------------------------------------------------------
+  void stopCheckpoint()
+  {
+    pCheckpointStop = true;
+
+    if (pCheckpointThread.joinable()) {
+      pCheckpointThread.join();
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  //! Copy the record index of the id map for a checkpoint. With a lock, the
+  //! ids are looked up in chunks under the read lock so writers are only
+  //! held off for one chunk at a time. Records written while copying lie
+  //! behind the covered offset and are replayed by the boot.
+  //!
+  //! @param lock      namespace lock, null if the id map can not change
+  //! @param logPath   change log file
+  //! @param logEnd    change log offset covered by the entries
+  //! @param largestId largest id used so far
+  //! @param logInode  inode of the change log
+  //! @param logCrc    checksum of the change log data before logEnd
+  //! @param entries   record index
+  //! @param err       error message
+  //!
+  //! @return true if successful, false if the log was compacted meanwhile
+  //----------------------------------------------------------------------------
+  bool copyIdMap(LockHandler* lock, std::string& logPath, uint64_t& logEnd,
+                 uint64_t& largestId, uint64_t& logInode, uint32_t& logCrc,
+                 std::vector<ChangeLogCheckpoint::Entry>& entries,
+                 std::string& err);
+
   //----------------------------------------------------------------------------
   // Data
   //----------------------------------------------------------------------------
@@ -423,6 +546,15 @@ private:
   IQuotaStats*       pQuotaStats;
   bool               pAutoRepair;
   uint64_t           pResSize;
+  uint64_t           pCheckpointInterval; ///< seconds, 0 disables checkpoints
+  time_t             pNextCheckpoint;
+  std::thread        pCheckpointThread;
+  std::atomic<bool>  pCheckpointRunning;
+  std::atomic<bool>  pCheckpointStop;
+  //! changed whenever the log is replaced or the id map offsets are remapped
+  uint64_t           pLogGeneration;
+  //! offsets of the id map point to two logs while compacting incrementally
+  bool               pIncrementalCompacting;
 };
 
 EOSNSNAMESPACE_END
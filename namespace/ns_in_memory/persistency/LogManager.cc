@@ -140,7 +140,10 @@ void LogManager::compactLog(const std::string&      oldLogName,
   map.set_deleted_key(0);
   map.set_empty_key(std::numeric_limits<uint64_t>::max());
   map.resize(10000000);
+  // The scan of a mmaped file verifies the records in parallel
+  inputFile.mmap();
   inputFile.scanAllRecords(&scanner);
+  inputFile.munmap();
   stats.recordsKept = map.size();
 
   if (feedback) {
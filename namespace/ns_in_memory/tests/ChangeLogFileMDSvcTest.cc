@@ -38,9 +38,11 @@ class ChangeLogFileMDSvcTest: public CppUnit::TestCase
   public:
     CPPUNIT_TEST_SUITE( ChangeLogFileMDSvcTest );
     CPPUNIT_TEST( reloadTest );
+    CPPUNIT_TEST( checkpointTest );
     CPPUNIT_TEST_SUITE_END();
 
     void reloadTest();
+    void checkpointTest();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION( ChangeLogFileMDSvcTest );
@@ -114,4 +116,87 @@ void ChangeLogFileMDSvcTest::reloadTest()
 
   delete fileSvc;
   unlink( fileName.c_str() );
+  unlink( eos::ChangeLogCheckpoint::getPath( fileName ).c_str() );
+}
+
+//------------------------------------------------------------------------------
+// Boot from a checkpoint and the tail of the change log
+//------------------------------------------------------------------------------
+void ChangeLogFileMDSvcTest::checkpointTest()
+{
+  eos::ChangeLogContainerMDSvc *contSvc = new eos::ChangeLogContainerMDSvc;
+  eos::ChangeLogFileMDSvc      *fileSvc = new eos::ChangeLogFileMDSvc;
+  fileSvc->setContMDService( contSvc );
+
+  std::map<std::string, std::string> config;
+  std::string fileName = getTempName( "/tmp", "eosns" );
+  std::string checkpointName = eos::ChangeLogCheckpoint::getPath( fileName );
+  config["changelog_path"] = fileName;
+  fileSvc->configure( config );
+  CPPUNIT_ASSERT_NO_THROW( fileSvc->initialize() );
+
+  std::vector<eos::IFileMD::id_t> ids;
+
+  for( int i = 0; i < 10; ++i )
+  {
+    std::shared_ptr<eos::IFileMD> file = fileSvc->createFile();
+    file->setName( "file" + std::to_string( i ) );
+    fileSvc->updateStore( file.get() );
+    ids.push_back( file->getId() );
+  }
+
+  //----------------------------------------------------------------------------
+  // The boot writes a checkpoint covering the files so far
+  //----------------------------------------------------------------------------
+  fileSvc->finalize();
+  CPPUNIT_ASSERT_NO_THROW( fileSvc->initialize() );
+  CPPUNIT_ASSERT( access( checkpointName.c_str(), F_OK ) == 0 );
+
+  //----------------------------------------------------------------------------
+  // Modify the namespace after the checkpoint
+  //----------------------------------------------------------------------------
+  std::shared_ptr<eos::IFileMD> file = fileSvc->getFileMD( ids[3] );
+  file->setName( "renamed" );
+  fileSvc->updateStore( file.get() );
+  fileSvc->removeFile( fileSvc->getFileMD( ids[5] ).get() );
+  file = fileSvc->createFile();
+  file->setName( "file10" );
+  fileSvc->updateStore( file.get() );
+  ids.push_back( file->getId() );
+  fileSvc->finalize();
+
+  //----------------------------------------------------------------------------
+  // Boot from the checkpoint and the tail, the result has to be the same as
+  // with a full scan
+  //----------------------------------------------------------------------------
+  for( int boot = 0; boot < 2; ++boot )
+  {
+    if( boot == 1 )
+    {
+      // Invalidate the checkpoint - falls back to a full scan
+      CPPUNIT_ASSERT( truncate( checkpointName.c_str(), 10 ) == 0 );
+    }
+
+    CPPUNIT_ASSERT_NO_THROW( fileSvc->initialize() );
+
+    for( size_t i = 0; i < ids.size(); ++i )
+    {
+      if( i == 5 )
+      {
+        CPPUNIT_ASSERT_THROW( fileSvc->getFileMD( ids[i] ), eos::MDException );
+        continue;
+      }
+
+      std::string name = ( i == 3 ) ? "renamed" : "file" + std::to_string( i );
+      CPPUNIT_ASSERT( fileSvc->getFileMD( ids[i] )->getName() == name );
+    }
+
+    CPPUNIT_ASSERT( fileSvc->getFirstFreeId() == ids.back() + 1 );
+    fileSvc->finalize();
+  }
+
+  delete fileSvc;
+  delete contSvc;
+  unlink( fileName.c_str() );
+  unlink( checkpointName.c_str() );
 }
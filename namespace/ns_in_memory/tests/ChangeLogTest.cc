@@ -59,10 +59,12 @@ public:
   CPPUNIT_TEST(readWriteCorrectness);
   CPPUNIT_TEST(followingTest);
   CPPUNIT_TEST(fsckTest);
+  CPPUNIT_TEST(parallelScanTest);
   CPPUNIT_TEST_SUITE_END();
   void readWriteCorrectness();
   void followingTest();
   void fsckTest();
+  void parallelScanTest();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(ChangeLogTest);
@@ -589,3 +591,53 @@ void ChangeLogTest::fsckTest()
   unlink(fileNameBroken.c_str());
   unlink(fileNameRepaired.c_str());
 }
+
+//------------------------------------------------------------------------------
+// Scan a mmaped log with and without parallel verification
+//------------------------------------------------------------------------------
+void ChangeLogTest::parallelScanTest()
+{
+  eos::ChangeLogFile file;
+  std::string        fileName = getTempName("/tmp", "eosns");
+  CPPUNIT_ASSERT_NO_THROW(file.open(fileName, eos::ChangeLogFile::Create,
+                                    0x1212));
+  //----------------------------------------------------------------------------
+  // Store about 48MB of records, every tenth of them starts with a record
+  // magic to fool the search for the range boundaries
+  //----------------------------------------------------------------------------
+  eos::Buffer buffer;
+  uint16_t magic = 0x4552;
+
+  for (int i = 0; i < 12000; ++i) {
+    std::string data(1000 + (i * 37) % 6000, 'a' + i % 26);
+
+    if (i % 10 == 0) {
+      data.replace(0, sizeof(magic), (char*) &magic, sizeof(magic));
+    }
+
+    buffer.clear();
+    buffer.putData(data.data(), data.size());
+    CPPUNIT_ASSERT_NO_THROW(file.storeRecord(1, buffer));
+  }
+
+  file.close();
+  //----------------------------------------------------------------------------
+  // Both scans have to see the same records
+  //----------------------------------------------------------------------------
+  FileScanner sequential;
+  FileScanner parallel;
+  setenv("EOS_NS_SCAN_THREADS", "1", 1);
+  CPPUNIT_ASSERT_NO_THROW(file.open(fileName, eos::ChangeLogFile::ReadOnly));
+  file.mmap();
+  CPPUNIT_ASSERT_NO_THROW(file.scanAllRecords(&sequential));
+  file.munmap();
+  setenv("EOS_NS_SCAN_THREADS", "4", 1);
+  file.mmap();
+  CPPUNIT_ASSERT_NO_THROW(file.scanAllRecords(&parallel));
+  file.munmap();
+  file.close();
+  unsetenv("EOS_NS_SCAN_THREADS");
+  CPPUNIT_ASSERT(sequential.getRecords().size() == 12000);
+  CPPUNIT_ASSERT(sequential.getRecords() == parallel.getRecords());
+  unlink(fileName.c_str());
+}
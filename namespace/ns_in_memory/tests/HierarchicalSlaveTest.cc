@@ -83,6 +83,14 @@ public:
     pLock.ReadLock();
   }
 
+  //------------------------------------------------------------------------
+  // Try to take a read lock
+  //------------------------------------------------------------------------
+  virtual bool timedReadLock(uint64_t timeout_ns)
+  {
+    return pLock.CondReadLock();
+  }
+
   //------------------------------------------------------------------------
   // Take a write lock
   //------------------------------------------------------------------------
@@ -32,6 +32,7 @@
 #include <pthread.h>
 
 #include "namespace/utils/TestHelpers.hh"
+#include "namespace/utils/Locking.hh"
 #include "namespace/interface/IContainerMD.hh"
 #include "namespace/interface/ContainerIterators.hh"
 #include "namespace/ns_in_memory/views/HierarchicalView.hh"
@@ -51,12 +52,16 @@ public:
   CPPUNIT_TEST(quotaTest);
   CPPUNIT_TEST(lostContainerTest);
   CPPUNIT_TEST(onlineCompactingTest);
+  CPPUNIT_TEST(incrementalCompactingTest);
+  CPPUNIT_TEST(listingCursorTest);
   CPPUNIT_TEST_SUITE_END();
 
   void reloadTest();
   void quotaTest();
   void lostContainerTest();
   void onlineCompactingTest();
+  void incrementalCompactingTest();
+  void listingCursorTest();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(HierarchicalViewTest);
@@ -827,3 +832,237 @@ void HierarchicalViewTest::onlineCompactingTest()
   unlink(fileNameContMD.c_str());
   unlink(newFileLogName.c_str());
 }
+
+//------------------------------------------------------------------------------
+// Namespace lock of a single threaded test
+//------------------------------------------------------------------------------
+class NoLock: public eos::LockHandler
+{
+public:
+  virtual void readLock() {}
+  virtual bool timedReadLock(uint64_t timeout_ns)
+  {
+    return true;
+  }
+  virtual void writeLock() {}
+  virtual void unLock() {}
+};
+
+//------------------------------------------------------------------------------
+// Incremental compacting test
+//------------------------------------------------------------------------------
+void HierarchicalViewTest::incrementalCompactingTest()
+{
+  //----------------------------------------------------------------------------
+  // Initializer
+  //----------------------------------------------------------------------------
+  std::shared_ptr<eos::IContainerMDSvc> contSvc =
+    std::shared_ptr<eos::IContainerMDSvc>(new eos::ChangeLogContainerMDSvc());
+  std::shared_ptr<eos::IFileMDSvc> fileSvc =
+    std::shared_ptr<eos::IFileMDSvc>(new eos::ChangeLogFileMDSvc());
+  std::shared_ptr<eos::IView> view =
+    std::shared_ptr<eos::IView>(new eos::HierarchicalView());
+  fileSvc->setContMDService(contSvc.get());
+  contSvc->setFileMDService(fileSvc.get());
+  std::map<std::string, std::string> fileSettings;
+  std::map<std::string, std::string> contSettings;
+  std::map<std::string, std::string> settings;
+  std::string fileNameFileMD = getTempName("/tmp", "eosns");
+  std::string fileNameContMD = getTempName("/tmp", "eosns");
+  contSettings["changelog_path"] = fileNameContMD;
+  contSvc->configure(contSettings);
+  fileSettings["changelog_path"] = fileNameFileMD;
+  fileSvc->configure(fileSettings);
+  view->setContainerMDSvc(contSvc.get());
+  view->setFileMDSvc(fileSvc.get());
+  view->configure(settings);
+  view->initialize();
+  //----------------------------------------------------------------------------
+  // Create some files and modify them a few times to get a log spanning
+  // several segments
+  //----------------------------------------------------------------------------
+  std::shared_ptr<eos::IContainerMD> cont;
+  std::shared_ptr<eos::IFileMD> fmd;
+  CPPUNIT_ASSERT_NO_THROW(cont = view->createContainer("/test/", true));
+
+  for (int i = 0; i < 10000; ++i) {
+    std::ostringstream s;
+    s << "/test/file" << i;
+    CPPUNIT_ASSERT_NO_THROW(fmd = view->createFile(s.str()));
+
+    for (int j = 0; j < 5; ++j) {
+      fmd->setCTimeNow();
+      CPPUNIT_ASSERT_NO_THROW(view->updateFileStore(fmd.get()));
+    }
+  }
+
+  std::string newFileLogName = getTempName("/tmp", "eosns");
+  eos::ChangeLogFileMDSvc* clFileSvc = dynamic_cast<eos::ChangeLogFileMDSvc*>
+                                       (view->getFileMDSvc());
+  CPPUNIT_ASSERT(clFileSvc);
+  setenv("EOS_NS_COMPACT_SEGMENT_MB", "1", 1);
+  void* compData = 0;
+  //----------------------------------------------------------------------------
+  // Abort a compacting after a few segments, the records pointed to the
+  // aborted copies would otherwise be dropped by the next compacting
+  //----------------------------------------------------------------------------
+  NoLock lock;
+  CPPUNIT_ASSERT_NO_THROW(compData =
+                            clFileSvc->compactIncrementalPrepare(newFileLogName));
+
+  for (int i = 0; i < 2; ++i) {
+    CPPUNIT_ASSERT_NO_THROW(clFileSvc->compactSegment(compData, &lock));
+  }
+
+  CPPUNIT_ASSERT(clFileSvc->getCompactingProgress(compData).copied > 0);
+  CPPUNIT_ASSERT_NO_THROW(clFileSvc->compactIncrementalAbort(compData));
+  CPPUNIT_ASSERT(access(newFileLogName.c_str(), F_OK));
+  CPPUNIT_ASSERT_NO_THROW(compData =
+                            clFileSvc->compactIncrementalPrepare(newFileLogName));
+  unsetenv("EOS_NS_COMPACT_SEGMENT_MB");
+
+  //----------------------------------------------------------------------------
+  // Create, modify and remove files between the segments
+  //----------------------------------------------------------------------------
+  bool done = false;
+  int total = 10000;
+  int removed = 0;
+  int changed = 0;
+
+  while (!done) {
+    CPPUNIT_ASSERT_NO_THROW(done = clFileSvc->compactSegment(compData, &lock));
+
+    for (int i = 0; i < 500; ++i) {
+      std::ostringstream s;
+      s << "/test/file" << total++;
+      CPPUNIT_ASSERT_NO_THROW(view->createFile(s.str()));
+    }
+
+    for (int i = 0; i < 100; ++i, ++removed) {
+      std::ostringstream s;
+      s << "/test/file" << removed;
+      CPPUNIT_ASSERT_NO_THROW(fmd = view->getFile(s.str()));
+
+      if (fmd->getSize() == 99999) {
+        changed--;
+      }
+
+      CPPUNIT_ASSERT_NO_THROW(view->removeFile(fmd.get()));
+    }
+
+    for (auto fit = eos::FileMapIterator(cont); fit.valid(); fit.next()) {
+      fmd = cont->findFile(fit.key());
+
+      if ((fmd->getSize() == 0) && (random() % 100 < 5)) {
+        fmd->setSize(99999);
+        CPPUNIT_ASSERT_NO_THROW(view->updateFileStore(fmd.get()));
+        changed++;
+      }
+    }
+  }
+
+  eos::CompactingProgress progress = clFileSvc->getCompactingProgress(compData);
+  CPPUNIT_ASSERT(progress.segments > 1);
+  CPPUNIT_ASSERT(progress.processed <= progress.total);
+  CPPUNIT_ASSERT_NO_THROW(clFileSvc->compactIncrementalCommit(compData));
+  CheckOnlineComp(view, total - removed, changed);
+  //----------------------------------------------------------------------------
+  // Reinitialize and check again
+  //----------------------------------------------------------------------------
+  view->finalize();
+  fileSettings["changelog_path"] = newFileLogName;
+  fileSvc->configure(fileSettings);
+  view->initialize();
+  CheckOnlineComp(view, total - removed, changed);
+  view->finalize();
+  //----------------------------------------------------------------------------
+  // Cleanup
+  //----------------------------------------------------------------------------
+  unlink(fileNameFileMD.c_str());
+  unlink(fileNameContMD.c_str());
+  unlink(newFileLogName.c_str());
+}
+
+//------------------------------------------------------------------------------
+// Listing a container in batches
+//------------------------------------------------------------------------------
+void HierarchicalViewTest::listingCursorTest()
+{
+  std::shared_ptr<eos::IContainerMDSvc> contSvc =
+    std::shared_ptr<eos::IContainerMDSvc>(new eos::ChangeLogContainerMDSvc());
+  std::shared_ptr<eos::IFileMDSvc> fileSvc =
+    std::shared_ptr<eos::IFileMDSvc>(new eos::ChangeLogFileMDSvc());
+  std::shared_ptr<eos::IView> view =
+    std::shared_ptr<eos::IView>(new eos::HierarchicalView());
+  fileSvc->setContMDService(contSvc.get());
+  contSvc->setFileMDService(fileSvc.get());
+  std::map<std::string, std::string> fileSettings;
+  std::map<std::string, std::string> contSettings;
+  std::map<std::string, std::string> settings;
+  std::string fileNameFileMD = getTempName("/tmp", "eosns");
+  std::string fileNameContMD = getTempName("/tmp", "eosns");
+  contSettings["changelog_path"] = fileNameContMD;
+  contSvc->configure(contSettings);
+  fileSettings["changelog_path"] = fileNameFileMD;
+  fileSvc->configure(fileSettings);
+  view->setContainerMDSvc(contSvc.get());
+  view->setFileMDSvc(fileSvc.get());
+  view->configure(settings);
+  view->initialize();
+  std::shared_ptr<eos::IContainerMD> cont;
+  CPPUNIT_ASSERT_NO_THROW(cont = view->createContainer("/test/", true));
+
+  for (int i = 0; i < 1000; ++i) {
+    CPPUNIT_ASSERT_NO_THROW(view->createFile("/test/file" + std::to_string(i)));
+  }
+
+  for (int i = 0; i < 100; ++i) {
+    CPPUNIT_ASSERT_NO_THROW(view->createContainer("/test/dir" +
+                            std::to_string(i)));
+  }
+
+  //----------------------------------------------------------------------------
+  // Remove files between the batches, all the others are listed once
+  //----------------------------------------------------------------------------
+  eos::ContainerListingCursor cursor(cont);
+  std::vector<std::string> names;
+  std::set<std::string> removed;
+  bool more = true;
+  int batches = 0;
+
+  while (more) {
+    size_t before = names.size();
+    more = cursor.next(names, 64);
+    CPPUNIT_ASSERT(names.size() - before <= 64);
+    ++batches;
+
+    for (int i = batches * 7; i < 1000; i += 97) {
+      std::string name = "file" + std::to_string(i);
+
+      if (removed.insert(name).second) {
+        std::shared_ptr<eos::IFileMD> fmd = view->getFile("/test/" + name);
+        CPPUNIT_ASSERT_NO_THROW(view->removeFile(fmd.get()));
+      }
+    }
+  }
+
+  CPPUNIT_ASSERT(batches > 1);
+  std::set<std::string> unique(names.begin(), names.end());
+  CPPUNIT_ASSERT_EQUAL(names.size(), unique.size());
+
+  for (int i = 0; i < 1000; ++i) {
+    std::string name = "file" + std::to_string(i);
+    CPPUNIT_ASSERT(removed.count(name) || unique.count(name));
+  }
+
+  for (int i = 0; i < 100; ++i) {
+    CPPUNIT_ASSERT(unique.count("dir" + std::to_string(i)));
+  }
+
+  std::vector<std::string> rest;
+  CPPUNIT_ASSERT(!cursor.next(rest, 64));
+  CPPUNIT_ASSERT(rest.empty());
+  view->finalize();
+  unlink(fileNameFileMD.c_str());
+  unlink(fileNameContMD.c_str());
+}
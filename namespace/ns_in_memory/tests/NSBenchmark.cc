@@ -87,6 +87,28 @@ void closeNamespace(eos::IView* view)
   delete fileSvc;
 }
 
+//------------------------------------------------------------------------------
+// Boot and close the namespace and print the boot time
+//------------------------------------------------------------------------------
+double timeBoot(const std::string& dirLog, const std::string& fileLog,
+                const std::string& label)
+{
+  std::cerr << "[i] Booting up (" << label << ")..." << std::endl;
+  zeroTimer(CLOCK_PROCESS_CPUTIME_ID);
+  uint64_t realTimeStart = clockGetTime(CLOCK_REALTIME);
+  eos::IView* view = bootNamespace(dirLog, fileLog);
+  uint64_t realTimeStop = clockGetTime(CLOCK_REALTIME);
+  uint64_t cpuTimeStop = clockGetTime(CLOCK_PROCESS_CPUTIME_ID);
+  double realTime = (double)(realTimeStop - realTimeStart) / 1000000.0;
+  double cpuTime  = (double)cpuTimeStop / 1000000.0;
+  std::cerr << "[i] Booted." << std::endl;
+  std::cerr << "[i] Real time: " << realTime << std::endl;
+  std::cerr << "[i] CPU time: "  << cpuTime  << std::endl;
+  // Waits for the checkpoints written at the end of the boot
+  closeNamespace(view);
+  return realTime;
+}
+
 int main(int argc, char** argv)
 {
   //----------------------------------------------------------------------------
@@ -99,21 +121,19 @@ int main(int argc, char** argv)
   };
 
   //----------------------------------------------------------------------------
-  // Do things
+  // Do things - the first boot scans the full change logs and writes the
+  // checkpoints, the second one starts from the checkpoints
   //----------------------------------------------------------------------------
   try {
-    std::cerr << "[i] Booting up..." << std::endl;
-    zeroTimer(CLOCK_PROCESS_CPUTIME_ID);
-    uint64_t realTimeStart = clockGetTime(CLOCK_REALTIME);
-    eos::IView* view = bootNamespace(argv[1], argv[2]);
-    uint64_t realTimeStop = clockGetTime(CLOCK_REALTIME);
-    uint64_t cpuTimeStop = clockGetTime(CLOCK_PROCESS_CPUTIME_ID);
-    double realTime = (double)(realTimeStop - realTimeStart) / 1000000.0;
-    double cpuTime  = (double)cpuTimeStop / 1000000.0;
-    std::cerr << "[i] Booted." << std::endl;
-    std::cerr << "[i] Real time: " << realTime << std::endl;
-    std::cerr << "[i] CPU time: "  << cpuTime  << std::endl;
-    closeNamespace(view);
+    setenv("EOS_NS_BOOT_NOCHECKPOINT", "1", 1);
+    double scanTime = timeBoot(argv[1], argv[2], "full scan");
+    unsetenv("EOS_NS_BOOT_NOCHECKPOINT");
+    double checkpointTime = timeBoot(argv[1], argv[2], "checkpoint");
+
+    if (checkpointTime > 0) {
+      std::cerr << "[i] Checkpoint speedup: " << scanTime / checkpointTime
+                << std::endl;
+    }
   } catch (eos::MDException& e) {
     std::cerr << "[!] Error: " << e.getMessage().str() << std::endl;
     return 2;
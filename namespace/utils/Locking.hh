@@ -23,6 +23,8 @@
 #ifndef EOS_NS_LOCKING_HH
 #define EOS_NS_LOCKING_HH
 
+#include <stdint.h>
+
 namespace eos
 {
   class LockHandler
@@ -38,6 +40,13 @@ namespace eos
       //------------------------------------------------------------------------
       virtual void readLock() = 0;
 
+      //------------------------------------------------------------------------
+      //! Take a read lock, give up after the timeout
+      //!
+      //! @return true if the lock was taken
+      //------------------------------------------------------------------------
+      virtual bool timedReadLock(uint64_t timeout_ns) = 0;
+
       //------------------------------------------------------------------------
       //! Take a write lock
       //------------------------------------------------------------------------
@@ -107,6 +107,10 @@ int main(int argc, char* argv[])
       blocksize.push_back(4 * 1024 * 1024);
       blocksize.push_back(128 * 1024 * 1024);
 
+      // GB/s indexed by [blocksize][algorithm]
+      std::vector<std::vector<double>> rates(blocksize.size(),
+                                             std::vector<double>(checksumnames.size(), 0));
+
       for (size_t bs = 0; bs < blocksize.size(); bs++) {
         for (size_t i = 0; i < checksumnames.size(); i++) {
           eos_static_info("benchmarking checksum algorithm %s", checksumnames[i].c_str());
@@ -132,14 +136,41 @@ int main(int argc, char* argv[])
             XrdOucString sizestring;
             eos::common::StringConversion::GetReadableSizeString(sizestring, blocksize[bs],
                 "B");
-            eos_static_info("checksum( %-10s ) = %s realtime=%.02f [ms] blocksize=%s rate=%.02f",
+            rates[bs][i] = MEMORYBUFFERSIZE / tm.RealTime() / 1000000.0;
+            eos_static_info("checksum( %-10s ) = %s realtime=%.02f [ms] blocksize=%s rate=%.02f [GB/s]",
                             checksumnames[i].c_str(), checksum->GetHexChecksum(), tm.RealTime(),
-                            sizestring.c_str(), MEMORYBUFFERSIZE / tm.RealTime() / 1000.0);
+                            sizestring.c_str(), rates[bs][i]);
             delete checksum;
           }
         }
       }
 
+      // Summary table with one row per block size and one column per algorithm
+      fprintf(stdout, "# ------------------------------------------------------\n");
+      fprintf(stdout, "# checksum rates [GB/s] pid=%u\n", (unsigned int) getpid());
+      fprintf(stdout, "%-12s", "blocksize");
+
+      for (size_t i = 0; i < checksumnames.size(); i++) {
+        fprintf(stdout, " %10s", checksumnames[i].c_str());
+      }
+
+      fprintf(stdout, "\n");
+
+      for (size_t bs = 0; bs < blocksize.size(); bs++) {
+        XrdOucString sizestring;
+        eos::common::StringConversion::GetReadableSizeString(sizestring, blocksize[bs],
+            "B");
+        fprintf(stdout, "%-12s", sizestring.c_str());
+
+        for (size_t i = 0; i < checksumnames.size(); i++) {
+          fprintf(stdout, " %10.02f", rates[bs][i]);
+        }
+
+        fprintf(stdout, "\n");
+      }
+
+      fflush(stdout);
+
       exit(0);
     }
   }
@@ -0,0 +1,229 @@
+// ----------------------------------------------------------------------
+// File: EosIoUringBenchmark.cc
+// ----------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2019 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+//------------------------------------------------------------------------------
+// Compare the IOPS of 4k random vector reads on a local file done through
+// the classic pread path and through the io_uring engine of FsIo
+//------------------------------------------------------------------------------
+#include "common/Logging.hh"
+#include "common/Timing.hh"
+#include "fst/io/local/FsIo.hh"
+#include <fcntl.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <random>
+#include <thread>
+#include <vector>
+#include <atomic>
+
+static void
+usage(const char* prog)
+{
+  fprintf(stderr, "usage: %s -f <file> [-s <file-size-MB>] [-c <chunks-per-readv>]"
+          " [-b <chunk-size>] [-n <readv-per-thread>] [-t <threads>] [-d]\n"
+          "       -d : open the file with O_DIRECT to measure the device\n",
+          prog);
+}
+
+//------------------------------------------------------------------------------
+// Run the random readv workload with the given engine
+//
+// @return number of chunks read per second
+//------------------------------------------------------------------------------
+static double
+RunWorkload(const std::string& path, const std::string& engine, int flags,
+            uint64_t file_size, size_t chunk_size, size_t nchunks,
+            size_t nreadv, size_t nthreads)
+{
+  std::atomic<uint64_t> ndone {0};
+  std::atomic<bool> failed {false};
+  std::vector<std::thread> workers;
+  eos::common::Timing tm("readv");
+  COMMONTIMING("start", &tm);
+
+  for (size_t t = 0; t < nthreads; ++t) {
+    workers.emplace_back([&, t]() {
+      eos::fst::FsIo io(path);
+      io.SetIoEngine(engine);
+
+      if (io.fileOpen(flags)) {
+        fprintf(stderr, "error: failed to open %s errno=%d\n", path.c_str(), errno);
+        failed = true;
+        return;
+      }
+
+      char* buffer = nullptr;
+
+      if (posix_memalign((void**)&buffer, 4096, nchunks * chunk_size)) {
+        failed = true;
+        return;
+      }
+
+      std::mt19937_64 gen(t + 1);
+      std::uniform_int_distribution<uint64_t> dist(0, file_size / chunk_size - 1);
+      XrdCl::ChunkList chunks(nchunks);
+
+      for (size_t i = 0; i < nreadv; ++i) {
+        for (size_t j = 0; j < nchunks; ++j) {
+          chunks[j] = XrdCl::ChunkInfo(dist(gen) * chunk_size, chunk_size,
+                                       buffer + j * chunk_size);
+        }
+
+        if (io.fileReadV(chunks) != (int64_t)(nchunks * chunk_size)) {
+          fprintf(stderr, "error: readv failed errno=%d\n", errno);
+          failed = true;
+          break;
+        }
+
+        ndone += nchunks;
+      }
+
+      free(buffer);
+      io.fileClose();
+    });
+  }
+
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  COMMONTIMING("stop", &tm);
+
+  if (failed) {
+    return -1;
+  }
+
+  return ndone * 1000.0 / tm.RealTime();
+}
+
+int main(int argc, char* argv[])
+{
+  std::string path;
+  uint64_t file_size = 1024ull * 1024 * 1024;
+  size_t chunk_size = 4096;
+  size_t nchunks = 32;
+  size_t nreadv = 10000;
+  size_t nthreads = 1;
+  int flags = O_RDONLY;
+  int c;
+
+  while ((c = getopt(argc, argv, "f:s:c:b:n:t:d")) != -1) {
+    switch (c) {
+    case 'f':
+      path = optarg;
+      break;
+
+    case 's':
+      file_size = strtoull(optarg, 0, 10) * 1024 * 1024;
+      break;
+
+    case 'c':
+      nchunks = strtoul(optarg, 0, 10);
+      break;
+
+    case 'b':
+      chunk_size = strtoul(optarg, 0, 10);
+      break;
+
+    case 'n':
+      nreadv = strtoul(optarg, 0, 10);
+      break;
+
+    case 't':
+      nthreads = strtoul(optarg, 0, 10);
+      break;
+
+    case 'd':
+      flags |= O_DIRECT;
+      break;
+
+    default:
+      usage(argv[0]);
+      return EINVAL;
+    }
+  }
+
+  if (path.empty() || !nchunks || !chunk_size || !nthreads ||
+      (file_size < chunk_size)) {
+    usage(argv[0]);
+    return EINVAL;
+  }
+
+  eos::common::Logging& g_logging = eos::common::Logging::GetInstance();
+  g_logging.SetUnit("eosiouringbench@localhost");
+  g_logging.gShortFormat = true;
+  g_logging.SetLogPriority(LOG_WARNING);
+  struct stat buf;
+
+  // Create the test file if it does not exist or is too small
+  if (::stat(path.c_str(), &buf) || ((uint64_t) buf.st_size < file_size)) {
+    fprintf(stdout, "info: creating %s with size %llu MB\n", path.c_str(),
+            (unsigned long long)(file_size / 1024 / 1024));
+    eos::fst::FsIo io(path);
+
+    if (io.fileOpen(O_CREAT | O_WRONLY | O_TRUNC, S_IRUSR | S_IWUSR)) {
+      fprintf(stderr, "error: failed to create %s errno=%d\n", path.c_str(), errno);
+      return errno;
+    }
+
+    std::vector<char> block(4 * 1024 * 1024);
+    std::mt19937 gen(0);
+
+    for (auto& ch : block) {
+      ch = (char) gen();
+    }
+
+    for (uint64_t off = 0; off < file_size; off += block.size()) {
+      size_t len = std::min((uint64_t) block.size(), file_size - off);
+
+      if (io.fileWrite(off, block.data(), len) != (int64_t) len) {
+        fprintf(stderr, "error: failed to write %s errno=%d\n", path.c_str(), errno);
+        return errno;
+      }
+    }
+
+    io.fileSync();
+    io.fileClose();
+  }
+
+  fprintf(stdout, "# file=%s size=%llu MB chunk=%zu chunks/readv=%zu "
+          "readv/thread=%zu threads=%zu direct=%d\n", path.c_str(),
+          (unsigned long long)(file_size / 1024 / 1024), chunk_size, nchunks,
+          nreadv, nthreads, (flags & O_DIRECT) ? 1 : 0);
+  fprintf(stdout, "# %-8s %14s %14s\n", "engine", "IOPS", "MB/s");
+
+  for (const auto& engine : {
+         "psync", "uring"
+       }) {
+    double iops = RunWorkload(path, engine, flags, file_size, chunk_size,
+                              nchunks, nreadv, nthreads);
+
+    if (iops < 0) {
+      return EIO;
+    }
+
+    fprintf(stdout, "  %-8s %14.0f %14.2f\n", engine, iops,
+            iops * chunk_size / 1024.0 / 1024.0);
+  }
+
+  return 0;
+}
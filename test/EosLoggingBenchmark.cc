@@ -0,0 +1,140 @@
+// ----------------------------------------------------------------------
+// File: EosLoggingBenchmark.cc
+// ----------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2019 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+//------------------------------------------------------------------------------
+// Compare the logging throughput of the synchronous and asynchronous mode of
+// eos::common::Logging with several threads logging concurrently
+//------------------------------------------------------------------------------
+#include "common/Logging.hh"
+#include <fcntl.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+static void
+usage(const char* prog)
+{
+  fprintf(stderr, "usage: %s [-t <threads>] [-n <msgs-per-thread>]\n", prog);
+}
+
+//------------------------------------------------------------------------------
+// Log the messages in the given mode
+//
+// @param log_time time until all the threads are done logging
+// @param total_time time until all the messages are written
+//------------------------------------------------------------------------------
+static void
+Run(bool async, size_t nthreads, size_t nmsgs, double& log_time,
+    double& total_time)
+{
+  using namespace eos::common;
+  gLogging.SetAsync(async);
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+
+  for (size_t t = 0; t < nthreads; ++t) {
+    threads.emplace_back([t, nmsgs]() {
+      for (size_t i = 0; i < nmsgs; ++i) {
+        eos_static_info("msg=\"benchmark line\" thread=%zu count=%zu", t, i);
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  log_time = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+             start).count();
+  // disabling the asynchronous mode writes all pending messages
+  gLogging.SetAsync(false);
+  total_time = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+               start).count();
+}
+
+int main(int argc, char* argv[])
+{
+  using namespace eos::common;
+  size_t nthreads = 8;
+  size_t nmsgs = 20000;
+  int c;
+
+  while ((c = getopt(argc, argv, "t:n:")) != -1) {
+    switch (c) {
+    case 't':
+      nthreads = strtoul(optarg, 0, 10);
+      break;
+
+    case 'n':
+      nmsgs = strtoul(optarg, 0, 10);
+      break;
+
+    default:
+      usage(argv[0]);
+      return EINVAL;
+    }
+  }
+
+  if (!nthreads || !nmsgs) {
+    usage(argv[0]);
+    return EINVAL;
+  }
+
+  gLogging.SetLogPriority(LOG_INFO);
+  // keep the log lines out of the benchmark output
+  fflush(stderr);
+  int saved_stderr = dup(STDERR_FILENO);
+  int devnull = open("/dev/null", O_WRONLY);
+
+  if (devnull < 0) {
+    fprintf(stderr, "error: failed to open /dev/null errno=%d\n", errno);
+    return errno;
+  }
+
+  dup2(devnull, STDERR_FILENO);
+  close(devnull);
+  double sync_log = 0, sync_total = 0, async_log = 0, async_total = 0;
+  unsigned long start_index = gLogging.gLogCircularIndex[LOG_INFO];
+  Run(false, nthreads, nmsgs, sync_log, sync_total);
+  unsigned long sync_index = gLogging.gLogCircularIndex[LOG_INFO];
+  unsigned long long dropped = gLogging.GetDropped(LOG_INFO);
+  Run(true, nthreads, nmsgs, async_log, async_total);
+  unsigned long async_index = gLogging.gLogCircularIndex[LOG_INFO];
+  dropped = gLogging.GetDropped(LOG_INFO) - dropped;
+  fflush(stderr);
+  dup2(saved_stderr, STDERR_FILENO);
+  close(saved_stderr);
+  const double total = nthreads * nmsgs;
+  fprintf(stdout, "# threads=%zu msgs=%.0f\n", nthreads, total);
+  fprintf(stdout, "# %-6s %14s %14s %10s\n", "mode", "log msg/s", "write msg/s",
+          "written");
+  fprintf(stdout, "  %-6s %14.0f %14.0f %10lu\n", "sync",
+          sync_log > 0 ? total / sync_log : 0,
+          sync_total > 0 ? total / sync_total : 0, sync_index - start_index);
+  fprintf(stdout, "  %-6s %14.0f %14.0f %10lu\n", "async",
+          async_log > 0 ? total / async_log : 0,
+          async_total > 0 ? total / async_total : 0, async_index - sync_index);
+  fprintf(stdout, "# async dropped=%llu\n", dropped);
+  return 0;
+}
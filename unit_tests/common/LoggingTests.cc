@@ -42,4 +42,96 @@ TEST(Logging, Log)
   function_using_logging();
 }
 
+//------------------------------------------------------------------------------
+// Test that asynchronous messages end up in the in-memory log
+//------------------------------------------------------------------------------
+TEST(Logging, Async)
+{
+  using namespace eos::common;
+  gLogging.SetLogPriority(LOG_INFO);
+  unsigned long index = gLogging.gLogCircularIndex[LOG_INFO];
+  gLogging.SetAsync(true);
+  ASSERT_TRUE(gLogging.IsAsync());
+  std::string line = eos_static_info("msg=\"%s\"", "asynchronous test line");
+  ASSERT_NE(std::string::npos, line.find("asynchronous test line"));
+  // messages below the log level are not queued
+  eos_static_debug("msg=\"%s\"", "masked test line");
+  gLogging.SetAsync(false);
+  ASSERT_FALSE(gLogging.IsAsync());
+  ASSERT_EQ(index + 1, gLogging.gLogCircularIndex[LOG_INFO]);
+  ASSERT_STREQ(line.c_str(),
+               gLogging.gLogMemory[LOG_INFO][index %
+                                             gLogging.gCircularIndexSize].c_str());
+}
+
+//------------------------------------------------------------------------------
+// Test the call site rate limits configured through the log filter
+//------------------------------------------------------------------------------
+TEST(Logging, CallSiteRateLimit)
+{
+  using namespace eos::common;
+  gLogging.SetLogPriority(LOG_INFO);
+  ASSERT_EQ(2u, gLogging.SetRateLimits({"rate:LoggingTests:5/3600",
+                                        "sample:function_using_logging:10",
+                                        "rate:NoLimit", "sample:NoLimit:0"}));
+  gLogging.SetFilter("rate:LoggingTests:5/3600,sample:function_using_logging:10");
+  unsigned long index = gLogging.gLogCircularIndex[LOG_INFO];
+  unsigned long long suppressed = gLogging.GetSuppressed();
+
+  for (int i = 0; i < 100; ++i) {
+    eos_static_info("msg=\"rate limited line\" count=%d", i);
+  }
+
+  ASSERT_EQ(index + 5, gLogging.gLogCircularIndex[LOG_INFO]);
+  ASSERT_EQ(suppressed + 95, gLogging.GetSuppressed());
+
+  for (int i = 0; i < 11; ++i) {
+    function_using_logging();
+  }
+
+  // the second sampled message reports the ones suppressed in between
+  ASSERT_EQ(index + 7, gLogging.gLogCircularIndex[LOG_INFO]);
+  std::string last = gLogging.gLogMemory[LOG_INFO][(index + 6) %
+                     gLogging.gCircularIndexSize].c_str();
+  ASSERT_NE(std::string::npos, last.find("[9 messages suppressed]"));
+  // the remaining entries are still used as function filter
+  gLogging.SetFilter("rate:*:1/3600,TestBody");
+  eos_static_info("msg=\"filtered line\"");
+  ASSERT_EQ(index + 7, gLogging.gLogCircularIndex[LOG_INFO]);
+  gLogging.SetFilter("");
+
+  for (int i = 0; i < 10; ++i) {
+    eos_static_info("msg=\"unlimited line\" count=%d", i);
+  }
+
+  ASSERT_EQ(index + 17, gLogging.gLogCircularIndex[LOG_INFO]);
+}
+
+//------------------------------------------------------------------------------
+// Test the periodic summary of the suppressed messages
+//------------------------------------------------------------------------------
+TEST(Logging, SuppressedSummary)
+{
+  using namespace eos::common;
+  gLogging.SetLogPriority(LOG_INFO);
+  ASSERT_EQ(1u, gLogging.SetRateLimits({"rate:LoggingTests:2/3600"}));
+  // report what previous tests left behind
+  gLogging.FlushSuppressed();
+  unsigned long index = gLogging.gLogCircularIndex[LOG_INFO];
+
+  for (int i = 0; i < 10; ++i) {
+    eos_static_info("msg=\"summarized line\" count=%d", i);
+  }
+
+  ASSERT_EQ(index + 2, gLogging.gLogCircularIndex[LOG_INFO]);
+  ASSERT_EQ(1u, gLogging.FlushSuppressed());
+  ASSERT_EQ(index + 3, gLogging.gLogCircularIndex[LOG_INFO]);
+  std::string last = gLogging.gLogMemory[LOG_INFO][(index + 2) %
+                     gLogging.gCircularIndexSize].c_str();
+  ASSERT_NE(std::string::npos, last.find("[8 messages suppressed]"));
+  // the counts are reset
+  ASSERT_EQ(0u, gLogging.FlushSuppressed());
+  gLogging.SetRateLimits({});
+}
+
 EOSCOMMONTESTING_END
@@ -0,0 +1,78 @@
+//------------------------------------------------------------------------------
+// File: LruCacheTests.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2019 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "gtest/gtest.h"
+#include "Namespace.hh"
+#include "common/LruCache.hh"
+#include <string>
+
+EOSCOMMONTESTING_BEGIN
+
+TEST(LruCache, EvictsLeastRecentlyUsed)
+{
+  using namespace eos::common;
+  LruCache<int, std::string> cache(3);
+  std::string value;
+  cache.Put(1, "one");
+  cache.Put(2, "two");
+  cache.Put(3, "three");
+  // Touch 1 so that 2 becomes the oldest entry
+  ASSERT_TRUE(cache.Get(1, &value));
+  ASSERT_EQ("one", value);
+  cache.Put(4, "four");
+  ASSERT_EQ(3u, cache.Size());
+  ASSERT_FALSE(cache.Get(2, nullptr));
+  ASSERT_TRUE(cache.Get(1, nullptr));
+  ASSERT_TRUE(cache.Get(3, nullptr));
+  ASSERT_TRUE(cache.Get(4, &value));
+  ASSERT_EQ("four", value);
+}
+
+TEST(LruCache, UpdateEraseClear)
+{
+  using namespace eos::common;
+  LruCache<int, std::string> cache(2);
+  std::string value;
+  cache.Put(1, "one");
+  cache.Put(1, "uno");
+  ASSERT_EQ(1u, cache.Size());
+  ASSERT_TRUE(cache.Get(1, &value));
+  ASSERT_EQ("uno", value);
+  cache.Put(2, "two");
+  cache.Erase(1);
+  ASSERT_FALSE(cache.Get(1, nullptr));
+  ASSERT_EQ(1u, cache.Size());
+  cache.Clear();
+  ASSERT_EQ(0u, cache.Size());
+  ASSERT_FALSE(cache.Get(2, nullptr));
+}
+
+TEST(LruCache, ZeroSizeDisablesCache)
+{
+  using namespace eos::common;
+  LruCache<int, int> cache(0);
+  cache.Put(1, 1);
+  ASSERT_EQ(0u, cache.Size());
+  ASSERT_FALSE(cache.Get(1, nullptr));
+}
+
+EOSCOMMONTESTING_END
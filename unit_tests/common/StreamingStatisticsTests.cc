@@ -0,0 +1,85 @@
+//------------------------------------------------------------------------------
+// File: StreamingStatisticsTests.cc
+// Author: Andreas-Joachim Peters - CERN
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2018 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "gtest/gtest.h"
+#include "Namespace.hh"
+#include "common/StreamingStatistics.hh"
+#include <cmath>
+#include <vector>
+
+EOSCOMMONTESTING_BEGIN
+
+TEST(StreamingStatistics, MatchesTwoPass)
+{
+  using namespace eos::common;
+  StreamingStatistics stats;
+  std::vector<uint64_t> values {4096, 1048576, 0, 17, 4096, 65536, 131072, 3};
+  double sum = 0;
+
+  for (auto value : values) {
+    stats.Add(value);
+    sum += value;
+  }
+
+  double avg = sum / values.size();
+  double sum2 = 0;
+
+  for (auto value : values) {
+    sum2 += std::pow(value - avg, 2);
+  }
+
+  ASSERT_EQ(values.size(), stats.GetCount());
+  ASSERT_EQ(sum, stats.GetSum());
+  ASSERT_EQ(0u, stats.GetMin());
+  ASSERT_EQ(1048576u, stats.GetMax());
+  ASSERT_NEAR(std::sqrt(sum2 / values.size()), stats.GetSigma(), 1e-6);
+}
+
+TEST(StreamingStatistics, Empty)
+{
+  eos::common::StreamingStatistics stats;
+  ASSERT_EQ(0u, stats.GetCount());
+  ASSERT_EQ(0u, stats.GetMin());
+  ASSERT_EQ(0u, stats.GetMax());
+  ASSERT_EQ(0, stats.GetSigma());
+  ASSERT_EQ("", stats.GetHistogram().ToString());
+}
+
+TEST(LogHistogram, Buckets)
+{
+  using eos::common::LogHistogram;
+  ASSERT_EQ(0, LogHistogram::GetBucket(0));
+  ASSERT_EQ(1, LogHistogram::GetBucket(1));
+  ASSERT_EQ(2, LogHistogram::GetBucket(2));
+  ASSERT_EQ(2, LogHistogram::GetBucket(3));
+  ASSERT_EQ(13, LogHistogram::GetBucket(4096));
+  ASSERT_EQ(64, LogHistogram::GetBucket(UINT64_MAX));
+  LogHistogram hist;
+  hist.Add(0);
+  hist.Add(4096);
+  hist.Add(5000);
+  hist.Add(1);
+  ASSERT_EQ("0:1,1:1,13:2", hist.ToString());
+}
+
+EOSCOMMONTESTING_END
@@ -0,0 +1,155 @@
+//------------------------------------------------------------------------------
+// File: ChecksumCombineTests.cc
+// Author: Andreas-Joachim Peters - CERN
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2018 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "gtest/gtest.h"
+#include "fst/checksum/Adler.hh"
+#include "fst/checksum/CRC32.hh"
+#include "fst/checksum/CRC32C.hh"
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+#include <map>
+
+namespace
+{
+//------------------------------------------------------------------------------
+// Build the checksum objects under test
+//------------------------------------------------------------------------------
+std::vector<std::unique_ptr<eos::fst::CheckSum>>
+GetChecksums()
+{
+  std::vector<std::unique_ptr<eos::fst::CheckSum>> xs;
+  xs.emplace_back(new eos::fst::Adler());
+  xs.emplace_back(new eos::fst::CRC32());
+  xs.emplace_back(new eos::fst::CRC32C());
+  return xs;
+}
+
+//------------------------------------------------------------------------------
+// Split [0, size) into pieces at random offsets, like test/XrdCpRandom.cc
+//------------------------------------------------------------------------------
+std::map<off_t, off_t>
+GetRandomPieces(off_t size, size_t npieces, std::mt19937& gen)
+{
+  std::uniform_int_distribution<off_t> dist(1, size - 1);
+  std::map<off_t, off_t> pieces;
+  pieces[0] = 0;
+
+  for (size_t i = 0; i < npieces - 1; ++i) {
+    pieces[dist(gen)] = 0;
+  }
+
+  for (auto it = pieces.begin(); it != pieces.end(); ++it) {
+    auto next = std::next(it);
+    it->second = ((next == pieces.end()) ? size : next->first) - it->first;
+  }
+
+  return pieces;
+}
+}
+
+//------------------------------------------------------------------------------
+// Writes of random pieces in random order combine to the sequential checksum
+//------------------------------------------------------------------------------
+TEST(ChecksumCombine, RandomOrderWrites)
+{
+  const off_t size = 10 * 1000 * 1000;
+  std::mt19937 gen(1234);
+  std::vector<char> buffer(size);
+
+  for (off_t i = 0; i < size; ++i) {
+    buffer[i] = i % 255;
+  }
+
+  auto seq = GetChecksums();
+  auto rnd = GetChecksums();
+  auto pieces = GetRandomPieces(size, 100, gen);
+  std::vector<std::pair<off_t, off_t>> order(pieces.begin(), pieces.end());
+  std::shuffle(order.begin(), order.end(), gen);
+
+  for (size_t i = 0; i < seq.size(); ++i) {
+    ASSERT_TRUE(seq[i]->Add(buffer.data(), size, 0));
+
+    for (const auto& piece : order) {
+      ASSERT_TRUE(rnd[i]->Add(buffer.data() + piece.first, piece.second,
+                              piece.first));
+    }
+
+    ASSERT_EQ(size, rnd[i]->GetMaxOffset());
+    rnd[i]->Finalize();
+    seq[i]->Finalize();
+    ASSERT_FALSE(rnd[i]->NeedsRecalculation());
+    ASSERT_STREQ(seq[i]->GetHexChecksum(), rnd[i]->GetHexChecksum());
+  }
+}
+
+//------------------------------------------------------------------------------
+// Holes or overlapping writes still require a re-scan
+//------------------------------------------------------------------------------
+TEST(ChecksumCombine, HolesAndOverlaps)
+{
+  std::vector<char> buffer(4096, 'a');
+
+  for (auto& xs : GetChecksums()) {
+    xs->Add(buffer.data(), 1024, 0);
+    xs->Add(buffer.data(), 1024, 2048);
+    xs->Finalize();
+    ASSERT_TRUE(xs->NeedsRecalculation());
+    // Closing the hole makes the checksum computable again
+    xs->Add(buffer.data(), 1024, 1024);
+    xs->Finalize();
+    ASSERT_FALSE(xs->NeedsRecalculation());
+    // A partial overwrite can not be combined
+    xs->Add(buffer.data(), 1024, 512);
+    xs->Finalize();
+    ASSERT_TRUE(xs->NeedsRecalculation());
+  }
+}
+
+//------------------------------------------------------------------------------
+// Appending to a file with a known checksum combines with the preset value
+//------------------------------------------------------------------------------
+TEST(ChecksumCombine, AppendAfterResetInit)
+{
+  std::vector<char> buffer(8192);
+
+  for (size_t i = 0; i < buffer.size(); ++i) {
+    buffer[i] = (i * 7) % 251;
+  }
+
+  auto full = GetChecksums();
+  auto head = GetChecksums();
+  auto tail = GetChecksums();
+
+  for (size_t i = 0; i < full.size(); ++i) {
+    full[i]->Add(buffer.data(), buffer.size(), 0);
+    head[i]->Add(buffer.data(), 5000, 0);
+    tail[i]->ResetInit(0, 5000, head[i]->GetHexChecksum());
+    // Append the remainder out of order
+    tail[i]->Add(buffer.data() + 7000, 1192, 7000);
+    tail[i]->Add(buffer.data() + 5000, 2000, 5000);
+    ASSERT_STREQ(full[i]->GetHexChecksum(), tail[i]->GetHexChecksum());
+    ASSERT_FALSE(tail[i]->NeedsRecalculation());
+  }
+}
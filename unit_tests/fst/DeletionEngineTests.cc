@@ -0,0 +1,76 @@
+//------------------------------------------------------------------------------
+// File: DeletionEngineTests.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2019 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "gtest/gtest.h"
+#include "fst/DeletionEngine.hh"
+#include <algorithm>
+
+using eos::fst::DeletionEngine;
+
+TEST(DeletionEngine, ParseIoPriority)
+{
+  int ioprio = -1;
+  // Class is stored in the bits above 13, level in the low bits
+  ASSERT_TRUE(DeletionEngine::ParseIoPriority("idle", ioprio));
+  ASSERT_EQ(3 << 13, ioprio);
+  ASSERT_TRUE(DeletionEngine::ParseIoPriority("be:4", ioprio));
+  ASSERT_EQ((2 << 13) | 4, ioprio);
+  ASSERT_TRUE(DeletionEngine::ParseIoPriority("rt:0", ioprio));
+  ASSERT_EQ(1 << 13, ioprio);
+  ioprio = -1;
+  ASSERT_FALSE(DeletionEngine::ParseIoPriority("", ioprio));
+  ASSERT_FALSE(DeletionEngine::ParseIoPriority("be", ioprio));
+  ASSERT_FALSE(DeletionEngine::ParseIoPriority("be:8", ioprio));
+  ASSERT_FALSE(DeletionEngine::ParseIoPriority("xx:1", ioprio));
+  ASSERT_FALSE(DeletionEngine::ParseIoPriority("be:12", ioprio));
+  ASSERT_EQ(-1, ioprio);
+}
+
+TEST(DeletionEngine, BuildDropRequests)
+{
+  std::vector<std::string> hexfids;
+  ASSERT_TRUE(DeletionEngine::BuildDropRequests(1, hexfids, "/data").empty());
+  hexfids = {"0000000a", "0000000b"};
+  auto requests = DeletionEngine::BuildDropRequests(3, hexfids, "/data01");
+  ASSERT_EQ(1u, requests.size());
+  ASSERT_EQ("/?mgm.pcmd=drop&mgm.fsid=3&mgm.fids=0000000a,0000000b"
+            "&mgm.localprefix=/data01", requests[0]);
+  // Long lists are split over several messages without losing any fid
+  hexfids.clear();
+
+  for (int i = 0; i < 2000; ++i) {
+    hexfids.push_back(std::to_string(100000000 + i));
+  }
+
+  requests = DeletionEngine::BuildDropRequests(3, hexfids, "/data01");
+  ASSERT_LT(1u, requests.size());
+  size_t count = 0;
+
+  for (const auto& request : requests) {
+    ASSERT_LT(request.length(), 4096u + 128u);
+    size_t pos = request.find("mgm.fids=") + 9;
+    std::string list = request.substr(pos, request.find('&', pos) - pos);
+    count += std::count(list.begin(), list.end(), ',') + 1;
+  }
+
+  ASSERT_EQ(hexfids.size(), count);
+}
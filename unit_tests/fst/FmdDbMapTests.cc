@@ -0,0 +1,66 @@
+//------------------------------------------------------------------------------
+// File: FmdDbMapTests.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2019 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+
+#include "gtest/gtest.h"
+#include "fst/FmdDbMap.hh"
+#include <cstdlib>
+#include <memory>
+
+using eos::fst::gFmdDbMapHandler;
+
+//------------------------------------------------------------------------------
+// Batch deletion removes and counts only the existing records
+//------------------------------------------------------------------------------
+TEST(FmdDbMapHandler, LocalDeleteFmdBatch)
+{
+  char tmpl[] = "/tmp/eos-fmd-dbmap-XXXXXX";
+  ASSERT_NE(nullptr, mkdtemp(tmpl));
+  const eos::common::FileSystem::fsid_t fsid = 17;
+  ASSERT_TRUE(gFmdDbMapHandler.SetDBFile(tmpl, fsid));
+
+  for (eos::common::FileId::fileid_t fid = 1; fid <= 10; ++fid) {
+    std::unique_ptr<eos::fst::FmdHelper> fmd
+    (gFmdDbMapHandler.LocalGetFmd(fid, fsid, 0, 0, 0, true));
+    ASSERT_NE(nullptr, fmd);
+  }
+
+  ASSERT_EQ(10, gFmdDbMapHandler.GetNumFiles(fsid));
+  // fid 100 does not exist and is not counted
+  std::vector<eos::common::FileId::fileid_t> fids {1, 2, 3, 4, 5, 100};
+  ASSERT_EQ(5u, gFmdDbMapHandler.LocalDeleteFmd(fids, fsid));
+  ASSERT_EQ(5, gFmdDbMapHandler.GetNumFiles(fsid));
+
+  for (eos::common::FileId::fileid_t fid = 1; fid <= 10; ++fid) {
+    std::unique_ptr<eos::fst::FmdHelper> fmd
+    (gFmdDbMapHandler.LocalGetFmd(fid, fsid, 0, 0, 0, false));
+    ASSERT_EQ(fid > 5, fmd != nullptr);
+  }
+
+  // Deleting again finds nothing
+  ASSERT_EQ(0u, gFmdDbMapHandler.LocalDeleteFmd(fids, fsid));
+  // The records are gone from the DB file and not only from the queue
+  ASSERT_TRUE(gFmdDbMapHandler.ShutdownDB(fsid, true));
+  ASSERT_TRUE(gFmdDbMapHandler.SetDBFile(tmpl, fsid));
+  ASSERT_EQ(5, gFmdDbMapHandler.GetNumFiles(fsid));
+  ASSERT_TRUE(gFmdDbMapHandler.ShutdownDB(fsid, true));
+}
@@ -0,0 +1,94 @@
+//------------------------------------------------------------------------------
+// File: PublishFilterTests.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2019 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "gtest/gtest.h"
+#include "fst/PublishFilter.hh"
+#include "fst/HotFileIndex.hh"
+
+using eos::fst::PublishFilter;
+using eos::fst::HotFileIndex;
+
+TEST(PublishFilter, Thresholds)
+{
+  PublishFilter filter(std::chrono::seconds(300));
+  filter.SetThreshold("stat.disk.", 0.05);
+  filter.SetThreshold("stat.disk.iops", 0);
+  filter.SetThreshold("stat.publishtimestamp", PublishFilter::kAlways);
+  auto now = std::chrono::steady_clock::now();
+  // First value is always broadcast
+  ASSERT_TRUE(filter.Check("stat.disk.load", 100.0, now));
+  ASSERT_FALSE(filter.Check("stat.disk.load", 104.0, now));
+  ASSERT_TRUE(filter.Check("stat.disk.load", 106.0, now));
+  // Longest prefix wins
+  ASSERT_TRUE(filter.Check("stat.disk.iops", 100.0, now));
+  ASSERT_TRUE(filter.Check("stat.disk.iops", 101.0, now));
+  ASSERT_FALSE(filter.Check("stat.disk.iops", 101.0, now));
+  // Keys without threshold are broadcast on any change
+  ASSERT_TRUE(filter.Check("stat.ropen", 0.0, now));
+  ASSERT_FALSE(filter.Check("stat.ropen", 0.0, now));
+  ASSERT_TRUE(filter.Check("stat.ropen", 1.0, now));
+  ASSERT_TRUE(filter.Check("stat.publishtimestamp", 1.0, now));
+  ASSERT_TRUE(filter.Check("stat.publishtimestamp", 1.0, now));
+  ASSERT_TRUE(filter.Check("stat.boot", std::string("booted"), now));
+  ASSERT_FALSE(filter.Check("stat.boot", std::string("booted"), now));
+  ASSERT_TRUE(filter.Check("stat.boot", std::string("opserror"), now));
+  uint64_t bytes = 0;
+  ASSERT_EQ(10u, filter.TakeCounters(bytes));
+  ASSERT_NE(0u, bytes);
+  ASSERT_EQ(0u, filter.TakeCounters(bytes));
+  ASSERT_EQ(0u, bytes);
+}
+
+TEST(PublishFilter, Refresh)
+{
+  PublishFilter filter(std::chrono::seconds(10));
+  auto now = std::chrono::steady_clock::now();
+  ASSERT_TRUE(filter.Check("stat.ropen", 5.0, now));
+  ASSERT_FALSE(filter.Check("stat.ropen", 5.0, now + std::chrono::seconds(9)));
+  ASSERT_TRUE(filter.Check("stat.ropen", 5.0, now + std::chrono::seconds(10)));
+  ASSERT_FALSE(filter.Check("stat.ropen", 5.0, now + std::chrono::seconds(11)));
+  filter.Reset();
+  ASSERT_TRUE(filter.Check("stat.ropen", 5.0, now + std::chrono::seconds(12)));
+}
+
+TEST(HotFileIndex, OpenClose)
+{
+  HotFileIndex index;
+  ASSERT_EQ("", index.GetHotFiles(1, 10));
+  index.Open(1, 0x10);
+  index.Open(1, 0x20);
+  index.Open(1, 0x20);
+  index.Open(1, 0x30);
+  index.Open(2, 0x40);
+  ASSERT_EQ("2:00000020 1:00000010 1:00000030 ", index.GetHotFiles(1, 10));
+  ASSERT_EQ("2:00000020 ", index.GetHotFiles(1, 1));
+  ASSERT_EQ("1:00000040 ", index.GetHotFiles(2, 10));
+  index.Close(1, 0x20);
+  index.Close(1, 0x10);
+  ASSERT_EQ("1:00000020 1:00000030 ", index.GetHotFiles(1, 10));
+  index.Close(1, 0x20);
+  index.Close(1, 0x30);
+  // Unknown files are ignored
+  index.Close(1, 0x30);
+  ASSERT_EQ("", index.GetHotFiles(1, 10));
+  ASSERT_EQ("1:00000040 ", index.GetHotFiles(2, 10));
+}
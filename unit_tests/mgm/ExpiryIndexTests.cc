@@ -0,0 +1,119 @@
+//------------------------------------------------------------------------------
+// File: ExpiryIndexTests.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2019 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "mgm/ExpiryIndex.hh"
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+//------------------------------------------------------------------------------
+// Entries are returned in time order and updates move them
+//------------------------------------------------------------------------------
+TEST(ExpiryIndex, Order)
+{
+  using namespace eos::mgm;
+  ExpiryIndex index("test");
+  index.Insert("/c", 30);
+  index.Insert("/a", 10);
+  index.Insert("/b", 20);
+  index.Insert("/d", 20);
+  ASSERT_EQ(4u, index.Size());
+  std::string key;
+  time_t ts;
+  ASSERT_TRUE(index.Front(key, ts));
+  ASSERT_EQ("/a", key);
+  ASSERT_EQ(10, ts);
+  auto due = index.Due(21, 10);
+  ASSERT_EQ(3u, due.size());
+  ASSERT_EQ("/a", due[0].second);
+  ASSERT_EQ("/b", due[1].second);
+  ASSERT_EQ("/d", due[2].second);
+  ASSERT_EQ(1u, index.Due(21, 1).size());
+  // an update replaces the timestamp
+  index.Insert("/a", 40);
+  ASSERT_EQ(4u, index.Size());
+  ASSERT_TRUE(index.Front(key, ts));
+  ASSERT_EQ("/b", key);
+  ASSERT_TRUE(index.Remove("/b"));
+  ASSERT_FALSE(index.Remove("/b"));
+  ASSERT_TRUE(index.Front(key, ts));
+  ASSERT_EQ("/d", key);
+  ASSERT_TRUE(index.Due(20, 10).empty());
+  index.Clear();
+  ASSERT_EQ(0u, index.Size());
+  ASSERT_FALSE(index.Front(key, ts));
+}
+
+//------------------------------------------------------------------------------
+// The journal restores the entries and the complete flag
+//------------------------------------------------------------------------------
+TEST(ExpiryIndex, Journal)
+{
+  using namespace eos::mgm;
+  char tmpl[] = "/tmp/eos-expiry-index-XXXXXX";
+  ASSERT_NE(nullptr, mkdtemp(tmpl));
+  std::string path = std::string(tmpl) + "/index";
+  {
+    ExpiryIndex index("test");
+    ASSERT_FALSE(index.Load(path));
+    ASSERT_FALSE(index.IsComplete());
+    index.Insert("/eos/path with spaces", 100);
+    index.Insert("/eos/b", 200);
+    index.SetComplete();
+    index.RecordScan(1.5, 2);
+
+    // enough records to trigger a compaction
+    for (int i = 0; i < 5000; ++i) {
+      index.Insert("/eos/tmp", i);
+      index.Remove("/eos/tmp");
+    }
+
+    index.Insert("/eos/c", 50);
+    index.Remove("/eos/b");
+  }
+  {
+    ExpiryIndex index("test");
+    ASSERT_TRUE(index.Load(path));
+    ASSERT_TRUE(index.IsComplete());
+    ASSERT_EQ(2u, index.Size());
+    auto due = index.Due(1000, 10);
+    ASSERT_EQ(2u, due.size());
+    ASSERT_EQ("/eos/c", due[0].second);
+    ASSERT_EQ(50, due[0].first);
+    ASSERT_EQ("/eos/path with spaces", due[1].second);
+    // the last scan survives the compactions and the restart
+    ExpiryIndex::Stats stats = index.GetStats();
+    ASSERT_NE(0, stats.scan_ts);
+    ASSERT_EQ(2u, stats.scan_entries);
+    ASSERT_DOUBLE_EQ(1.5, stats.scan_time);
+    // an index cleared for a rescan is not complete anymore
+    index.Clear();
+  }
+  {
+    ExpiryIndex index("test");
+    ASSERT_TRUE(index.Load(path));
+    ASSERT_FALSE(index.IsComplete());
+    ASSERT_EQ(0u, index.Size());
+  }
+  unlink(path.c_str());
+  rmdir(tmpl);
+}
@@ -0,0 +1,213 @@
+//------------------------------------------------------------------------------
+// File: S3StoreTests.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2019 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "mgm/http/s3/S3Store.hh"
+#include <gtest/gtest.h>
+#include <openssl/md5.h>
+#include <zlib.h>
+#include <stdio.h>
+
+using eos::mgm::S3Store;
+
+namespace
+{
+//------------------------------------------------------------------------------
+// Hex MD5 of a string
+//------------------------------------------------------------------------------
+std::string
+HexMD5(const std::string& data)
+{
+  unsigned char digest[MD5_DIGEST_LENGTH];
+  MD5((const unsigned char*) data.c_str(), data.length(), digest);
+  std::string hex;
+
+  for (int i = 0; i < MD5_DIGEST_LENGTH; ++i) {
+    char buf[3];
+    snprintf(buf, sizeof(buf), "%02x", digest[i]);
+    hex += buf;
+  }
+
+  return hex;
+}
+
+//------------------------------------------------------------------------------
+// Part info as recorded by the part commit
+//------------------------------------------------------------------------------
+S3Store::PartInfo
+MakePart(unsigned long long offset, const std::string& data)
+{
+  S3Store::PartInfo part;
+  part.offset = offset;
+  part.size = data.length();
+  part.md5 = HexMD5(data);
+  part.adler = adler32(adler32(0L, Z_NULL, 0),
+                       (const Bytef*) data.c_str(), data.length());
+  return part;
+}
+}
+
+//------------------------------------------------------------------------------
+// The part list is returned in order with the ETags unquoted
+//------------------------------------------------------------------------------
+TEST(S3Store, ParsePartList)
+{
+  std::vector<std::pair<int, std::string>> parts;
+  std::string xml = "<CompleteMultipartUpload>"
+                    "<Part><PartNumber>1</PartNumber>"
+                    "<ETag>\"aaaa\"</ETag></Part>"
+                    "<Part><ETag>&quot;bbbb&quot;</ETag>"
+                    "<PartNumber>2</PartNumber></Part>"
+                    "<Part><PartNumber>3</PartNumber><ETag>cccc</ETag></Part>"
+                    "</CompleteMultipartUpload>";
+  ASSERT_TRUE(S3Store::ParsePartList(xml, parts));
+  ASSERT_EQ(3u, parts.size());
+  ASSERT_EQ(1, parts[0].first);
+  ASSERT_EQ("aaaa", parts[0].second);
+  ASSERT_EQ(2, parts[1].first);
+  ASSERT_EQ("bbbb", parts[1].second);
+  ASSERT_EQ(3, parts[2].first);
+  ASSERT_EQ("cccc", parts[2].second);
+  // empty, unterminated or incomplete parts are malformed
+  ASSERT_FALSE(S3Store::ParsePartList("", parts));
+  ASSERT_TRUE(parts.empty());
+  ASSERT_FALSE(S3Store::ParsePartList("<CompleteMultipartUpload>"
+                                      "</CompleteMultipartUpload>", parts));
+  ASSERT_FALSE(S3Store::ParsePartList("<Part><PartNumber>1</PartNumber>"
+                                      "<ETag>aaaa</ETag>", parts));
+  ASSERT_TRUE(parts.empty());
+  ASSERT_FALSE(S3Store::ParsePartList("<Part><PartNumber>1</PartNumber>"
+                                      "</Part>", parts));
+  ASSERT_FALSE(S3Store::ParsePartList("<Part><PartNumber>x</PartNumber>"
+                                      "<ETag>aaaa</ETag></Part>", parts));
+  ASSERT_FALSE(S3Store::ParsePartList("<Part><PartNumber>-1</PartNumber>"
+                                      "<ETag>aaaa</ETag></Part>", parts));
+}
+
+//------------------------------------------------------------------------------
+// Part attributes need offset, size, a hex MD5 and a hex adler32
+//------------------------------------------------------------------------------
+TEST(S3Store, ParsePartInfo)
+{
+  S3Store::PartInfo part;
+  std::string md5 = HexMD5("part");
+  ASSERT_TRUE(S3Store::ParsePartInfo("5242880 1024 " + md5 + " 1a2b3c4d",
+                                     part));
+  ASSERT_EQ(5242880ull, part.offset);
+  ASSERT_EQ(1024ull, part.size);
+  ASSERT_EQ(md5, part.md5);
+  ASSERT_EQ(0x1a2b3c4du, part.adler);
+  ASSERT_FALSE(S3Store::ParsePartInfo("", part));
+  ASSERT_FALSE(S3Store::ParsePartInfo("0 1024 " + md5, part));
+  ASSERT_FALSE(S3Store::ParsePartInfo("0 1024 " + md5 + " 1 2", part));
+  ASSERT_FALSE(S3Store::ParsePartInfo("0 1024 abcd 1a2b3c4d", part));
+  ASSERT_FALSE(S3Store::ParsePartInfo("0x 1024 " + md5 + " 1a2b3c4d", part));
+  ASSERT_FALSE(S3Store::ParsePartInfo("0 1024 " + md5 + " xyz", part));
+  md5[0] = 'z';
+  ASSERT_FALSE(S3Store::ParsePartInfo("0 1024 " + md5 + " 1a2b3c4d", part));
+}
+
+//------------------------------------------------------------------------------
+// Parts sit at index * partsize and only the last one may be smaller
+//------------------------------------------------------------------------------
+TEST(S3Store, CheckPartLayout)
+{
+  const unsigned long long partsize = 1000;
+  S3Store::PartInfo part;
+  part.offset = 1000;
+  part.size = 1000;
+  ASSERT_TRUE(S3Store::CheckPartLayout(1, 3, partsize, part));
+  ASSERT_FALSE(S3Store::CheckPartLayout(0, 3, partsize, part));
+  ASSERT_FALSE(S3Store::CheckPartLayout(2, 3, partsize, part));
+  // a short part is only valid at the end
+  part.size = 10;
+  ASSERT_FALSE(S3Store::CheckPartLayout(1, 3, partsize, part));
+  ASSERT_TRUE(S3Store::CheckPartLayout(1, 2, partsize, part));
+  // no part exceeds the part size
+  part.size = 1001;
+  ASSERT_FALSE(S3Store::CheckPartLayout(1, 2, partsize, part));
+  // a single part upload
+  part.offset = 0;
+  part.size = 1000;
+  ASSERT_TRUE(S3Store::CheckPartLayout(0, 1, partsize, part));
+}
+
+//------------------------------------------------------------------------------
+// The combined adler32 matches the adler32 of the whole file and the ETag is
+// the MD5 of the binary part MD5s with the number of parts
+//------------------------------------------------------------------------------
+TEST(S3Store, Checksums)
+{
+  std::string data;
+
+  for (int i = 0; i < 2500; ++i) {
+    data += (char)(i * 7 + 3);
+  }
+
+  std::vector<S3Store::PartInfo> parts;
+
+  for (size_t offset = 0; offset < data.length(); offset += 1000) {
+    parts.push_back(MakePart(offset, data.substr(offset, 1000)));
+  }
+
+  ASSERT_EQ(3u, parts.size());
+  uint32_t adler = adler32(adler32(0L, Z_NULL, 0),
+                           (const Bytef*) data.c_str(), data.length());
+  ASSERT_EQ(adler, S3Store::CombineAdler32(parts));
+  std::string md5s;
+
+  for (size_t i = 0; i < parts.size(); ++i) {
+    unsigned char digest[MD5_DIGEST_LENGTH];
+    std::string part = data.substr(i * 1000, 1000);
+    MD5((const unsigned char*) part.c_str(), part.length(), digest);
+    md5s.append((const char*) digest, sizeof(digest));
+  }
+
+  ASSERT_EQ(HexMD5(md5s) + "-3", S3Store::MultipartETag(parts));
+  // an empty upload has the adler32 of no data
+  ASSERT_EQ(1u, S3Store::CombineAdler32(std::vector<S3Store::PartInfo>()));
+}
+
+//------------------------------------------------------------------------------
+// A completion has to wait for redirected part writes until they commit or
+// are abandoned
+//------------------------------------------------------------------------------
+TEST(S3Store, PartsInFlight)
+{
+  const unsigned long long fid = 0x1234;
+  const time_t now = 1000000;
+  ASSERT_FALSE(S3Store::PartsInFlight(fid, now));
+  S3Store::PartOpened(fid, 1, now);
+  S3Store::PartOpened(fid, 2, now + 10);
+  ASSERT_TRUE(S3Store::PartsInFlight(fid, now + 10));
+  ASSERT_FALSE(S3Store::PartsInFlight(fid + 1, now + 10));
+  S3Store::PartCommitted(fid, 1);
+  ASSERT_TRUE(S3Store::PartsInFlight(fid, now + 10));
+  // a write which never commits does not block the upload forever
+  ASSERT_FALSE(S3Store::PartsInFlight(fid, now + 10 +
+                                      S3Store::sPartWriteTimeout));
+  S3Store::PartCommitted(fid, 2);
+  ASSERT_FALSE(S3Store::PartsInFlight(fid, now + 10));
+  // completion and abort drop all parts of the upload
+  S3Store::PartOpened(fid, 3, now);
+  S3Store::ForgetParts(fid);
+  ASSERT_FALSE(S3Store::PartsInFlight(fid, now));
+}
@@ -0,0 +1,147 @@
+//------------------------------------------------------------------------------
+// File: XrdMqSharedHashCodecTests.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2019 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "gtest/gtest.h"
+#include "mq/XrdMqSharedHashCodec.hh"
+#include "mq/XrdMqMessage.hh"
+
+using Command = XrdMqSharedHashCodec::Command;
+
+TEST(XrdMqSharedHashCodec, UpdateRoundTrip)
+{
+  XrdMqSharedHashCodec codec(Command::kUpdate, "/eos/host:1095/fst/data01",
+                             "hash");
+  codec.AddPair("stat.disk.load", "0.75");
+  codec.AddPair("stat.disk.readratemb", "12");
+  codec.AddPair("stat.disk.writeratemb", "");
+  // Delimiters of the env encoding are valid characters in this encoding
+  codec.AddPair("stat.odd|key~", "va%lue:12,3");
+  ASSERT_EQ(4u, codec.GetNumRecords());
+  ASSERT_TRUE(XrdMqSharedHashCodec::IsEncoded(codec.GetMessage().c_str()));
+  XrdMqSharedHashCodec::Message msg;
+  std::string error;
+  ASSERT_TRUE(XrdMqSharedHashCodec::Decode(codec.GetMessage(), msg, error))
+      << error;
+  ASSERT_TRUE(msg.mCmd == Command::kUpdate);
+  ASSERT_EQ("/eos/host:1095/fst/data01", msg.mSubject);
+  ASSERT_EQ("hash", msg.mType);
+  ASSERT_EQ(4u, msg.mEntries.size());
+  ASSERT_EQ("stat.disk.load", msg.mEntries[0].first);
+  ASSERT_EQ("0.75", msg.mEntries[0].second);
+  ASSERT_EQ("stat.disk.readratemb", msg.mEntries[1].first);
+  ASSERT_EQ("12", msg.mEntries[1].second);
+  ASSERT_EQ("stat.disk.writeratemb", msg.mEntries[2].first);
+  ASSERT_EQ("", msg.mEntries[2].second);
+  ASSERT_EQ("stat.odd|key~", msg.mEntries[3].first);
+  ASSERT_EQ("va%lue:12,3", msg.mEntries[3].second);
+}
+
+TEST(XrdMqSharedHashCodec, DeleteRoundTrip)
+{
+  XrdMqSharedHashCodec codec(Command::kDelete, "/eos/host:1095/fst", "queue");
+  codec.AddKey("a");
+  codec.AddKey("ab");
+  codec.AddKey("b");
+  XrdMqSharedHashCodec::Message msg;
+  std::string error;
+  ASSERT_TRUE(XrdMqSharedHashCodec::Decode(codec.GetMessage(), msg, error));
+  ASSERT_TRUE(msg.mCmd == Command::kDelete);
+  ASSERT_EQ("queue", msg.mType);
+  ASSERT_EQ(3u, msg.mEntries.size());
+  ASSERT_EQ("a", msg.mEntries[0].first);
+  ASSERT_EQ("ab", msg.mEntries[1].first);
+  ASSERT_EQ("b", msg.mEntries[2].first);
+}
+
+TEST(XrdMqSharedHashCodec, MuxUpdateRoundTrip)
+{
+  XrdMqSharedHashCodec codec(Command::kMuxUpdate,
+                             "/eos/host:1095/fst/data01%/eos/host:1095/fst/data02",
+                             "hash");
+  codec.AddPair("#0#stat.disk.load", "0.75");
+  codec.AddPair("#0#stat.disk.readratemb", "12");
+  codec.AddPair("#1#stat.disk.load", "0.10");
+  XrdMqSharedHashCodec::Message msg;
+  std::string error;
+  ASSERT_TRUE(XrdMqSharedHashCodec::Decode(codec.GetMessage(), msg, error))
+      << error;
+  ASSERT_TRUE(msg.mCmd == Command::kMuxUpdate);
+  ASSERT_EQ("/eos/host:1095/fst/data01%/eos/host:1095/fst/data02",
+            msg.mSubject);
+  ASSERT_EQ(3u, msg.mEntries.size());
+  ASSERT_EQ("#0#stat.disk.readratemb", msg.mEntries[1].first);
+  ASSERT_EQ("12", msg.mEntries[1].second);
+  ASSERT_EQ("#1#stat.disk.load", msg.mEntries[2].first);
+  ASSERT_EQ("0.10", msg.mEntries[2].second);
+}
+
+TEST(XrdMqSharedHashCodec, SealRoundTrip)
+{
+  XrdMqSharedHashCodec codec(Command::kUpdate, "/eos/host#and#:1095", "hash");
+  codec.AddPair("#0#key", "a#and#b&c#23#");
+  codec.AddPair("#0#key&", "&and#");
+  // The message body is sealed for the transport and unsealed on arrival
+  XrdOucString body = codec.GetMessage().c_str();
+  XrdMqMessage::Seal(body);
+  XrdMqMessage::UnSeal(body);
+  XrdMqSharedHashCodec::Message msg;
+  std::string error;
+  ASSERT_TRUE(XrdMqSharedHashCodec::Decode(body.c_str(), msg, error)) << error;
+  ASSERT_EQ("/eos/host#and#:1095", msg.mSubject);
+  ASSERT_EQ(2u, msg.mEntries.size());
+  ASSERT_EQ("#0#key", msg.mEntries[0].first);
+  ASSERT_EQ("a#and#b&c#23#", msg.mEntries[0].second);
+  ASSERT_EQ("#0#key&", msg.mEntries[1].first);
+  ASSERT_EQ("&and#", msg.mEntries[1].second);
+  // A '#' which is not escaped is corrupted data
+  ASSERT_FALSE(XrdMqSharedHashCodec::Decode("mqsb1u1:s4:hash0,3:a#b1:v", msg,
+               error));
+}
+
+TEST(XrdMqSharedHashCodec, RejectCorrupted)
+{
+  XrdMqSharedHashCodec::Message msg;
+  std::string error;
+  ASSERT_FALSE(XrdMqSharedHashCodec::IsEncoded("mqsh.cmd=update"));
+  ASSERT_FALSE(XrdMqSharedHashCodec::Decode("mqsh.cmd=update", msg, error));
+  // Unknown version and command
+  ASSERT_FALSE(XrdMqSharedHashCodec::Decode("mqsb9u1:s4:hash", msg, error));
+  ASSERT_FALSE(XrdMqSharedHashCodec::Decode("mqsb1x1:s4:hash", msg, error));
+  XrdMqSharedHashCodec codec(Command::kBroadCastReply, "s", "hash");
+  codec.AddPair("key", "value");
+  const std::string& full = codec.GetMessage();
+
+  // Every truncation of a message is detected
+  for (size_t len = 0; len < full.length(); ++len) {
+    if (len == full.length() - std::string("0,3:key5:value").length()) {
+      // Header only is a valid message without records
+      continue;
+    }
+
+    ASSERT_FALSE(XrdMqSharedHashCodec::Decode(full.substr(0, len), msg, error))
+        << full.substr(0, len);
+  }
+
+  // Shared prefix longer than the previous key
+  ASSERT_FALSE(XrdMqSharedHashCodec::Decode("mqsb1u1:s4:hash2,1:a1:b", msg,
+               error));
+}